@@ -0,0 +1,87 @@
+#ifndef _Benchmarks_H
+#define _Benchmarks_H
+
+#include "GameObject.h"
+#include "Kinematics.h"
+#include "Vector2d.h"
+
+#include <chrono>
+#include <limits>
+
+/** Runs fun a given number of times, repeats that a few times and returns the
+    fastest time per call in microseconds.
+ */
+template<typename Fun>
+double measure(unsigned int calls, Fun&& fun) {
+    auto best = std::numeric_limits<double>::max();
+    for (int round = 0; round < 5; round++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned int i = 0; i < calls; i++) {
+            fun();
+        }
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() / calls < best) {
+            best = elapsed.count() / calls;
+        }
+    }
+    return best;
+}
+
+/** A small moving box that collides with everything.
+ */
+class BenchObject : public GameObject {
+public:
+    BenchObject(Kinematics& kinematics, const Vector2d& position, const Vector2d& velocity)
+    : kinematics_(kinematics)
+    , body_(kinematics_.create(Kinematics::Kind::Bolt, position)) {
+        kinematics_.setVelocity(body_, velocity);
+    }
+
+    ~BenchObject() {
+        kinematics_.destroy(body_);
+    }
+
+    BenchObject(const BenchObject&) = delete;
+
+    BenchObject& operator =(const BenchObject&) = delete;
+
+    void update(float) override {}
+
+    void draw(Renderer&, float) override {}
+
+    void write(Packet* packet) override {
+        getPosition().write(packet);
+        kinematics_.getVelocity(body_).write(packet);
+    }
+
+    void read(Packet*) override {}
+
+    Vector2d getPosition() const override {
+        return kinematics_.getPosition(body_);
+    }
+
+    unsigned int getWidth() const override {
+        return 8;
+    }
+
+    unsigned int getHeight() const override {
+        return 8;
+    }
+
+    uint32_t getClassId() const override {
+        return 2;
+    }
+
+private:
+    Kinematics& kinematics_;
+
+    const uint32_t body_;
+};
+
+void runWorldBenchmark();
+
+void runCollisionBenchmark();
+
+void runLatencyEmulatorBenchmark();
+
+#endif  // _Benchmarks_H
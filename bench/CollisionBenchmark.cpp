@@ -0,0 +1,51 @@
+#include "Benchmarks.h"
+#include "ServerWorld.h"
+#include "TaskScheduler.h"
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace {
+
+// Dense enough that every box overlaps a few others.
+const unsigned int WORLD_SIZE = 4000;
+
+void populate(ServerWorld& world, unsigned int count) {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(0.0f, static_cast<float>(WORLD_SIZE));
+    std::uniform_real_distribution<float> velocity(-1.0f, 1.0f);
+    for (uint32_t objectId = 1; objectId <= count; objectId++) {
+        world.add(objectId, GameObjectPtr(new BenchObject(world.getKinematics(), Vector2d(position(random), position(random)), Vector2d(velocity(random), velocity(random)))));
+    }
+}
+
+}
+
+void runCollisionBenchmark() {
+    const unsigned int threadCounts[] = { 1, 2, 4, 8 };
+
+    std::cout << "ServerWorld::update scaling with the number of threads" << std::endl;
+    std::cout << "(microseconds per call, " << std::thread::hardware_concurrency() << " hardware threads)" << std::endl;
+    std::cout << std::setw(8) << "objects";
+    for (const auto threadCount : threadCounts) {
+        std::cout << std::setw(10) << threadCount << "T";
+    }
+    std::cout << std::endl;
+
+    for (const auto count : { 10000u, 50000u, 200000u }) {
+        ServerWorld world(WORLD_SIZE, WORLD_SIZE,
+            [] (uint32_t, const GameObject*, uint32_t, const GameObject*) { return false; },
+            [] (uint32_t) {});
+        populate(world, count);
+
+        std::cout << std::setw(8) << count << std::fixed << std::setprecision(1);
+        for (const auto threadCount : threadCounts) {
+            TaskScheduler scheduler(threadCount);
+            world.setTaskScheduler(&scheduler);
+            std::cout << std::setw(11) << measure(2000000 / count, [&world] { world.update(1.0f / 60.0f); });
+        }
+        world.setTaskScheduler(nullptr);
+        std::cout << std::endl;
+    }
+}
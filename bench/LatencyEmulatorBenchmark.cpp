@@ -0,0 +1,108 @@
+#include "Benchmarks.h"
+#include "LatencyEmulator.h"
+#include "BufferedQueue.h"
+#include "Histogram.h"
+#include "Clock.h"
+
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+const unsigned int DELAY_MS = 20;
+
+// Each rate is sent for this long, in bursts once per millisecond.
+const double SEND_DURATION = 1.0;
+
+int64_t getSteadyTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/** Records how late each packet comes out of the emulator. The send time
+    travels in the packet.
+ */
+class ReleaseRecorder : public PacketSink {
+public:
+    explicit ReleaseRecorder(uint32_t size)
+    : pool_(size)
+    , errors_(1000, 100000) {
+    }
+
+    void push(Packet* packet) override {
+        pool_.push(packet);
+    }
+
+    Packet* pop() override {
+        return pool_.pop();
+    }
+
+    void enqueue(Packet* packet) override {
+        const auto releaseTime = getSteadyTime();
+        int64_t sendTime = 0;
+        packet->reset();
+        packet->read(sendTime);
+        errors_.add(releaseTime - sendTime - Clock::toNanoseconds(DELAY_MS / 1000.0));
+        pool_.push(packet);
+    }
+
+    Packet* dequeue() override {
+        return nullptr;
+    }
+
+    const Histogram& getErrors() const {
+        return errors_;
+    }
+
+private:
+    BufferedQueue pool_;
+
+    // In nanoseconds, in buckets of 1 us up to 100 ms.
+    Histogram errors_;
+};
+
+}
+
+void runLatencyEmulatorBenchmark() {
+    std::cout << "LatencyEmulator release time error at " << DELAY_MS << " ms delay" << std::endl;
+    std::cout << "(microseconds, enqueue in nanoseconds per call)" << std::endl;
+    std::cout << std::setw(10) << "packets/s" << std::setw(10) << "enqueue" << std::setw(10) << "mean"
+              << std::setw(10) << "P50" << std::setw(10) << "P99" << std::setw(10) << "max" << std::endl;
+
+    for (const auto rate : { 1000u, 10000u, 50000u, 200000u }) {
+        // Enough packets for twice the delay.
+        ReleaseRecorder recorder(rate * 2 * DELAY_MS / 1000 + 1000);
+        int64_t enqueueTime = 0;
+        uint32_t sent = 0;
+        {
+            Impairment inbound;
+            inbound.latency = static_cast<float>(DELAY_MS) / 1000.0f;
+            LatencyEmulator emulator(recorder, inbound, Impairment());
+            const auto perBurst = rate / 1000;
+            const auto start = std::chrono::steady_clock::now();
+            for (unsigned int burst = 0; burst < static_cast<unsigned int>(SEND_DURATION * 1000.0); burst++) {
+                std::this_thread::sleep_until(start + std::chrono::milliseconds(burst));
+                for (unsigned int i = 0; i < perBurst; i++) {
+                    auto packet = recorder.pop();
+                    if (packet) {
+                        packet->clear();
+                        const auto sendTime = getSteadyTime();
+                        packet->write(sendTime);
+                        emulator.enqueue(packet);
+                        enqueueTime += getSteadyTime() - sendTime;
+                        sent++;
+                    }
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2 * DELAY_MS));
+        }
+
+        const auto& errors = recorder.getErrors();
+        std::cout << std::setw(10) << rate << std::fixed << std::setprecision(1)
+                  << std::setw(10) << static_cast<double>(enqueueTime) / std::max(sent, 1u)
+                  << std::setw(10) << static_cast<double>(errors.getMean()) / 1000.0
+                  << std::setw(10) << static_cast<double>(errors.getPercentile(0.5)) / 1000.0
+                  << std::setw(10) << static_cast<double>(errors.getPercentile(0.99)) / 1000.0
+                  << std::setw(10) << static_cast<double>(errors.getMax()) / 1000.0 << std::endl;
+    }
+}
@@ -0,0 +1,144 @@
+#include "Benchmarks.h"
+#include "ServerWorld.h"
+#include "HandleAllocator.h"
+#include "Packet.h"
+#include "Vector2d.h"
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const unsigned int WORLD_SIZE = 100000;
+const unsigned int CLIENT_COUNT = 8;
+
+// The container World used before the slot map: an unordered_map whose
+// visitors are std::function callbacks.
+class LegacyWorld {
+public:
+    LegacyWorld()
+    : kinematics_()
+    , gameObjects_() {
+    }
+
+    void add(uint32_t objectId, GameObjectPtr&& gameObject) {
+        gameObjects_.insert(std::make_pair(objectId, std::move(gameObject)));
+    }
+
+    Kinematics& getKinematics() {
+        return kinematics_;
+    }
+
+    void update(float elapsed) {
+        for (auto& gameObject : gameObjects_) {
+            gameObject.second->update(elapsed);
+        }
+        kinematics_.integrate(elapsed);
+    }
+
+    void forEachGameObject(std::function<void (uint32_t, GameObject*)> fun) {
+        for (auto& gameObject : gameObjects_) {
+            fun(gameObject.first, gameObject.second.get());
+        }
+    }
+
+    void removeGameObjectIf(std::function<bool (uint32_t, GameObject*)> predicate) {
+        for (auto itr = begin(gameObjects_); itr != end(gameObjects_);) {
+            if (predicate(itr->first, itr->second.get())) {
+                itr = gameObjects_.erase(itr);
+            } else {
+                ++itr;
+            }
+        }
+    }
+
+private:
+    Kinematics kinematics_;
+
+    std::unordered_map<uint32_t, GameObjectPtr> gameObjects_;
+};
+
+template<typename WorldType>
+void populate(WorldType& world, HandleAllocator& objectIds, unsigned int count) {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(0.0f, static_cast<float>(WORLD_SIZE));
+    std::uniform_real_distribution<float> velocity(-1.0f, 1.0f);
+    for (unsigned int i = 0; i < count; i++) {
+        world.add(objectIds.allocate(), GameObjectPtr(new BenchObject(world.getKinematics(), Vector2d(position(random), position(random)), Vector2d(velocity(random), velocity(random)))));
+    }
+}
+
+// The per-object passes of ServerWorld::update: update, gather the colliders and
+// remove the dead objects.
+template<typename WorldType>
+void updatePasses(WorldType& world, std::vector<std::pair<uint32_t, GameObject*>>& colliders) {
+    world.update(1.0f / 60.0f);
+    colliders.clear();
+    world.forEachGameObject([&colliders] (uint32_t objectId, GameObject* gameObject) {
+        if (gameObject->doesCollide()) {
+            colliders.emplace_back(objectId, gameObject);
+        }
+    });
+    world.removeGameObjectIf([] (uint32_t, GameObject* gameObject) {
+        return gameObject->dead();
+    });
+}
+
+// The body of GameServer::sendStateUpdate for a number of clients.
+template<typename WorldType>
+void encodeState(WorldType& world, Packet& packet, uint32_t count) {
+    for (unsigned int client = 0; client < CLIENT_COUNT; client++) {
+        packet.clear();
+        packet.write(count);
+        world.forEachGameObject([&packet] (uint32_t objectId, GameObject* gameObject) {
+            packet.write(objectId);
+            packet.write(gameObject->getClassId());
+            gameObject->write(&packet);
+        });
+    }
+}
+
+}
+
+void runWorldBenchmark() {
+    std::cout << "World iteration: unordered_map + std::function vs. slot map + template visitors" << std::endl;
+    std::cout << "(microseconds per call, STATE encoded for " << CLIENT_COUNT << " clients)" << std::endl;
+    std::cout << std::setw(8) << "objects"
+              << std::setw(16) << "update (map)" << std::setw(16) << "update (slot)"
+              << std::setw(16) << "state (map)" << std::setw(16) << "state (slot)"
+              << std::setw(22) << "ServerWorld::update" << std::endl;
+
+    for (const auto count : { 100u, 1000u, 10000u }) {
+        HandleAllocator legacyIds, objectIds, serverObjectIds;
+        LegacyWorld legacyWorld;
+        World world;
+        ServerWorld serverWorld(WORLD_SIZE, WORLD_SIZE,
+            [] (uint32_t, const GameObject*, uint32_t, const GameObject*) { return false; },
+            [] (uint32_t) {});
+        populate(legacyWorld, legacyIds, count);
+        populate(world, objectIds, count);
+        populate(serverWorld, serverObjectIds, count);
+
+        std::vector<std::pair<uint32_t, GameObject*>> colliders;
+        colliders.reserve(count);
+        Packet packet(64 * count);
+
+        const auto calls = 1000000 / count;
+        const auto legacyUpdate = measure(calls, [&] { updatePasses(legacyWorld, colliders); });
+        const auto update = measure(calls, [&] { updatePasses(world, colliders); });
+        const auto legacyState = measure(calls, [&] { encodeState(legacyWorld, packet, count); });
+        const auto state = measure(calls, [&] { encodeState(world, packet, count); });
+        const auto serverUpdate = measure(calls, [&] { serverWorld.update(1.0f / 60.0f); });
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::setw(8) << count
+                  << std::setw(16) << legacyUpdate << std::setw(16) << update
+                  << std::setw(16) << legacyState << std::setw(16) << state
+                  << std::setw(22) << serverUpdate << std::endl;
+    }
+}
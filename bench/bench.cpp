@@ -0,0 +1,23 @@
+#include "Benchmarks.h"
+
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv) {
+    struct {
+        const char* name;
+        void (*run)();
+    } benchmarks[] = {
+        { "world", runWorldBenchmark },
+        { "collision", runCollisionBenchmark },
+        { "emulator", runLatencyEmulatorBenchmark }
+    };
+
+    for (const auto& benchmark : benchmarks) {
+        if (argc < 2 || strcmp(argv[1], benchmark.name) == 0) {
+            benchmark.run();
+            std::cout << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef _Aabb_H
+#define _Aabb_H
+
+#include <limits>
+
+/** An axis-aligned bounding box with the same semantics as an integer SDL_Rect.
+
+    Boxes without area never intersect anything.
+ */
+struct Aabb {
+    Aabb()
+    : minX(std::numeric_limits<float>::infinity())
+    , minY(std::numeric_limits<float>::infinity())
+    , maxX(-std::numeric_limits<float>::infinity())
+    , maxY(-std::numeric_limits<float>::infinity()) {
+    }
+
+    Aabb(int x, int y, int width, int height)
+    : Aabb() {
+        if (width > 0 && height > 0) {
+            minX = static_cast<float>(x);
+            minY = static_cast<float>(y);
+            maxX = static_cast<float>(x + width);
+            maxY = static_cast<float>(y + height);
+        }
+    }
+
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
+/** Returns true if the two boxes overlap, otherwise false. Touching edges do not count as overlap.
+ */
+inline bool intersects(const Aabb& a, const Aabb& b) {
+    return a.minX < b.maxX && b.minX < a.maxX &&
+           a.minY < b.maxY && b.minY < a.maxY;
+}
+
+#endif  // _Aabb_H
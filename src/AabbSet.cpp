@@ -0,0 +1,202 @@
+#include "AabbSet.h"
+
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AABB_SET_X86 1
+#include <immintrin.h>
+#else
+#define AABB_SET_X86 0
+#endif
+
+using OverlapKernel = uint32_t (*)(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                                   uint32_t first, uint32_t last, const Aabb& aabb, uint32_t* hits);
+
+static uint32_t findOverlapsScalar(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                                   uint32_t first, uint32_t last, const Aabb& aabb, uint32_t* hits) {
+    uint32_t count = 0;
+    for (uint32_t i = first; i < last; ++i) {
+        if (aabb.minX < maxX[i] && minX[i] < aabb.maxX && aabb.minY < maxY[i] && minY[i] < aabb.maxY) {
+            hits[count++] = i;
+        }
+    }
+    return count;
+}
+
+#if AABB_SET_X86
+
+static uint32_t appendHits(uint32_t mask, uint32_t base, uint32_t* hits, uint32_t count) {
+    while (mask != 0) {
+        hits[count++] = base + static_cast<uint32_t>(__builtin_ctz(mask));
+        mask &= mask - 1;
+    }
+    return count;
+}
+
+__attribute__((target("sse2")))
+static uint32_t findOverlapsSse(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                                uint32_t first, uint32_t last, const Aabb& aabb, uint32_t* hits) {
+    const __m128 aMinX = _mm_set1_ps(aabb.minX);
+    const __m128 aMinY = _mm_set1_ps(aabb.minY);
+    const __m128 aMaxX = _mm_set1_ps(aabb.maxX);
+    const __m128 aMaxY = _mm_set1_ps(aabb.maxY);
+
+    uint32_t count = 0;
+    uint32_t i = first;
+    for (; i + 4 <= last; i += 4) {
+        const __m128 x = _mm_and_ps(_mm_cmplt_ps(aMinX, _mm_loadu_ps(maxX + i)), _mm_cmplt_ps(_mm_loadu_ps(minX + i), aMaxX));
+        const __m128 y = _mm_and_ps(_mm_cmplt_ps(aMinY, _mm_loadu_ps(maxY + i)), _mm_cmplt_ps(_mm_loadu_ps(minY + i), aMaxY));
+        count = appendHits(static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(x, y))), i, hits, count);
+    }
+    return count + findOverlapsScalar(minX, minY, maxX, maxY, i, last, aabb, hits + count);
+}
+
+__attribute__((target("avx")))
+static uint32_t findOverlapsAvx(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                                uint32_t first, uint32_t last, const Aabb& aabb, uint32_t* hits) {
+    const __m256 aMinX = _mm256_set1_ps(aabb.minX);
+    const __m256 aMinY = _mm256_set1_ps(aabb.minY);
+    const __m256 aMaxX = _mm256_set1_ps(aabb.maxX);
+    const __m256 aMaxY = _mm256_set1_ps(aabb.maxY);
+
+    uint32_t count = 0;
+    uint32_t i = first;
+    for (; i + 8 <= last; i += 8) {
+        const __m256 x = _mm256_and_ps(_mm256_cmp_ps(aMinX, _mm256_loadu_ps(maxX + i), _CMP_LT_OQ),
+                                       _mm256_cmp_ps(_mm256_loadu_ps(minX + i), aMaxX, _CMP_LT_OQ));
+        const __m256 y = _mm256_and_ps(_mm256_cmp_ps(aMinY, _mm256_loadu_ps(maxY + i), _CMP_LT_OQ),
+                                       _mm256_cmp_ps(_mm256_loadu_ps(minY + i), aMaxY, _CMP_LT_OQ));
+        count = appendHits(static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(x, y))), i, hits, count);
+    }
+    return count + findOverlapsScalar(minX, minY, maxX, maxY, i, last, aabb, hits + count);
+}
+
+__attribute__((target("avx512f")))
+static uint32_t findOverlapsAvx512(const float* minX, const float* minY, const float* maxX, const float* maxY,
+                                   uint32_t first, uint32_t last, const Aabb& aabb, uint32_t* hits) {
+    const __m512 aMinX = _mm512_set1_ps(aabb.minX);
+    const __m512 aMinY = _mm512_set1_ps(aabb.minY);
+    const __m512 aMaxX = _mm512_set1_ps(aabb.maxX);
+    const __m512 aMaxY = _mm512_set1_ps(aabb.maxY);
+
+    uint32_t count = 0;
+    uint32_t i = first;
+    for (; i + 16 <= last; i += 16) {
+        __mmask16 mask = _mm512_cmp_ps_mask(aMinX, _mm512_loadu_ps(maxX + i), _CMP_LT_OQ);
+        mask = _mm512_mask_cmp_ps_mask(mask, _mm512_loadu_ps(minX + i), aMaxX, _CMP_LT_OQ);
+        mask = _mm512_mask_cmp_ps_mask(mask, aMinY, _mm512_loadu_ps(maxY + i), _CMP_LT_OQ);
+        mask = _mm512_mask_cmp_ps_mask(mask, _mm512_loadu_ps(minY + i), aMaxY, _CMP_LT_OQ);
+        count = appendHits(static_cast<uint32_t>(mask), i, hits, count);
+    }
+    return count + findOverlapsScalar(minX, minY, maxX, maxY, i, last, aabb, hits + count);
+}
+
+#endif
+
+struct OverlapKernelInfo {
+    OverlapKernel kernel;
+    const char* name;
+};
+
+static OverlapKernelInfo selectOverlapKernel() {
+#if AABB_SET_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {findOverlapsAvx512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx")) {
+        return {findOverlapsAvx, "avx"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {findOverlapsSse, "sse2"};
+    }
+#endif
+    return {findOverlapsScalar, "scalar"};
+}
+
+static const OverlapKernelInfo& getOverlapKernel() {
+    static const OverlapKernelInfo info = selectOverlapKernel();
+    return info;
+}
+
+AabbSet::AabbSet()
+: minX_()
+, minY_()
+, maxX_()
+, maxY_() {
+}
+
+void AabbSet::clear() {
+    minX_.clear();
+    minY_.clear();
+    maxX_.clear();
+    maxY_.clear();
+}
+
+void AabbSet::reserve(uint32_t count) {
+    minX_.reserve(count);
+    minY_.reserve(count);
+    maxX_.reserve(count);
+    maxY_.reserve(count);
+}
+
+void AabbSet::resize(uint32_t count) {
+    const Aabb empty;
+    minX_.resize(count, empty.minX);
+    minY_.resize(count, empty.minY);
+    maxX_.resize(count, empty.maxX);
+    maxY_.resize(count, empty.maxY);
+}
+
+void AabbSet::set(uint32_t index, const Aabb& aabb) {
+    minX_[index] = aabb.minX;
+    minY_[index] = aabb.minY;
+    maxX_[index] = aabb.maxX;
+    maxY_[index] = aabb.maxY;
+}
+
+uint32_t AabbSet::add(const Aabb& aabb) {
+    const auto index = getCount();
+    minX_.push_back(aabb.minX);
+    minY_.push_back(aabb.minY);
+    maxX_.push_back(aabb.maxX);
+    maxY_.push_back(aabb.maxY);
+    return index;
+}
+
+Aabb AabbSet::get(uint32_t index) const {
+    Aabb aabb;
+    aabb.minX = minX_[index];
+    aabb.minY = minY_[index];
+    aabb.maxX = maxX_[index];
+    aabb.maxY = maxY_[index];
+    return aabb;
+}
+
+uint32_t AabbSet::getCount() const {
+    return static_cast<uint32_t>(minX_.size());
+}
+
+uint32_t AabbSet::findOverlaps(const Aabb& aabb, uint32_t first, std::vector<uint32_t>& hits) const {
+    return findOverlaps(aabb, first, getCount(), hits);
+}
+
+uint32_t AabbSet::findOverlaps(const Aabb& aabb, uint32_t first, uint32_t last, std::vector<uint32_t>& hits) const {
+    if (first >= last) {
+        hits.clear();
+        return 0;
+    }
+    hits.resize(last - first);
+    const auto count = getOverlapKernel().kernel(minX_.data(), minY_.data(), maxX_.data(), maxY_.data(), first, last, aabb, hits.data());
+    hits.resize(count);
+    return count;
+}
+
+uint32_t AabbSet::findFirstMinX(float x, uint32_t first) const {
+    const auto begin = minX_.begin() + first;
+    return first + static_cast<uint32_t>(std::lower_bound(begin, minX_.end(), x) - begin);
+}
+
+const char* AabbSet::getKernelName() {
+    return getOverlapKernel().name;
+}
@@ -0,0 +1,96 @@
+#ifndef _AabbSet_H
+#define _AabbSet_H
+
+#include "Aabb.h"
+
+#include <vector>
+#include <cstdint>
+
+/** A set of axis-aligned bounding boxes stored as structure of arrays.
+
+    The overlap test runs one box against a packed range of others, using AVX-512,
+    AVX or SSE when the CPU supports it and a scalar loop otherwise. The kernel is
+    selected once at runtime.
+ */
+class AabbSet {
+public:
+    /** Constructor
+     */
+    AabbSet();
+
+    /** Removes all boxes but keeps the allocated memory.
+     */
+    void clear();
+
+    /** Reserves memory for a given number of boxes.
+
+        \param count the number of boxes.
+     */
+    void reserve(uint32_t count);
+
+    /** Resizes the set. New boxes are empty.
+
+        \param count the new number of boxes.
+     */
+    void resize(uint32_t count);
+
+    /** Replaces the box at a given index.
+
+        \param index the index of the box.
+        \param aabb the new box.
+     */
+    void set(uint32_t index, const Aabb& aabb);
+
+    /** Adds a box to the set.
+
+        \param aabb the box to be added.
+        \return the index of the new box.
+     */
+    uint32_t add(const Aabb& aabb);
+
+    /** Returns the box at a given index.
+
+        \param index the index of the box.
+     */
+    Aabb get(uint32_t index) const;
+
+    /** Returns the number of boxes in the set.
+     */
+    uint32_t getCount() const;
+
+    /** Tests a box against all boxes in the range [first, getCount()).
+
+        \param aabb the box to test.
+        \param first the index of the first box to test against.
+        \param hits receives the indices of all overlapping boxes in ascending order.
+        \return the number of overlapping boxes.
+     */
+    uint32_t findOverlaps(const Aabb& aabb, uint32_t first, std::vector<uint32_t>& hits) const;
+
+    /** Tests a box against all boxes in the range [first, last).
+
+        \param aabb the box to test.
+        \param first the index of the first box to test against.
+        \param last one past the index of the last box to test against.
+        \param hits receives the indices of all overlapping boxes in ascending order.
+        \return the number of overlapping boxes.
+     */
+    uint32_t findOverlaps(const Aabb& aabb, uint32_t first, uint32_t last, std::vector<uint32_t>& hits) const;
+
+    /** Returns the first index in [first, getCount()) whose box has a minimum x
+        coordinate of at least x. The boxes must be sorted by their minimum x.
+     */
+    uint32_t findFirstMinX(float x, uint32_t first) const;
+
+    /** Returns the name of the overlap kernel selected for this CPU.
+     */
+    static const char* getKernelName();
+
+private:
+    std::vector<float> minX_;
+    std::vector<float> minY_;
+    std::vector<float> maxX_;
+    std::vector<float> maxY_;
+};
+
+#endif  // _AabbSet_H
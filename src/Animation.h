@@ -18,10 +18,6 @@ public:
      */
     Animation(const char* filename, unsigned int frameWidth, unsigned int frameHeight, const Renderer& renderer);
 
-    /** Destructor
-     */
-    ~Animation();
-
     Animation(const Animation&) = delete;
 
     Animation& operator =(const Animation&) = delete;
@@ -50,8 +46,6 @@ public:
     unsigned int getHeight() const;
 
 private:
-    void tidyup();
-
     bool step();
 
     const unsigned int frameWidth_;
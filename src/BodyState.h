@@ -0,0 +1,49 @@
+#ifndef _BodyState_H
+#define _BodyState_H
+
+#include "Vector2d.h"
+#include "Utilities.h"
+
+/** The kinematic state of a body at one point in time.
+ */
+struct BodyState {
+    BodyState()
+    : position()
+    , velocity()
+    , lookAt()
+    , angle(0)
+    , thrust(false) {
+    }
+
+    BodyState(const Vector2d& pos, const Vector2d& vel, const Vector2d& look, float rotation, bool thrustOn)
+    : position(pos)
+    , velocity(vel)
+    , lookAt(look)
+    , angle(rotation)
+    , thrust(thrustOn) {
+    }
+
+    Vector2d position;
+    Vector2d velocity;
+    Vector2d lookAt;
+    float angle;
+    bool thrust;
+};
+
+/** Interpolates linearly between two states. The discrete thrust flag is taken from the nearer state.
+ */
+inline BodyState interpolate(const BodyState& a, const BodyState& b, float t) {
+    auto lookAt = lerp(a.lookAt, b.lookAt, t);
+    if (lookAt.length() > 0.0f) {
+        lookAt = lookAt.normal();
+    }
+    return BodyState(lerp(a.position, b.position, t), lerp(a.velocity, b.velocity, t), lookAt, lerp(a.angle, b.angle, t), t < 0.5f ? a.thrust : b.thrust);
+}
+
+/** Moves a state forward in time at constant velocity.
+ */
+inline BodyState extrapolate(const BodyState& state, float elapsed) {
+    return BodyState(state.position + elapsed * state.velocity, state.velocity, state.lookAt, state.angle, state.thrust);
+}
+
+#endif  // _BodyState_H
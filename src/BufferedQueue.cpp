@@ -24,4 +24,8 @@ Packet* BufferedQueue::dequeue() {
 
 uint32_t BufferedQueue::getNumEnqueued() {
     return queue_.getCount();
+}
+
+uint32_t BufferedQueue::getNumPooled() {
+    return pool_.getCount();
 }
\ No newline at end of file
@@ -43,6 +43,10 @@ public:
      */
     uint32_t getNumEnqueued();
 
+    /** Return the number of packets in the pool.
+     */
+    uint32_t getNumPooled();
+
 private:
     Queue<Packet> pool_;
 
@@ -1,65 +1,60 @@
 #include "ClientRegistry.h"
 #include "Protocol.h"
+#include "Clock.h"
 
 #include <boost/lexical_cast.hpp>
 
-#include <vector>
-
 ClientRegistry::ClientRegistry()
 : clientSessions_()
-, playerIds_() {
+, playerIds_()
+, disconnectedPlayerIds_() {
 }
 
-ClientSession* ClientRegistry::addClientSession(uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, float timeStamp) {
-    auto newClientSession = std::make_unique<ClientSession>(endpoint, playerId, timeStamp);
-    clientSessions_.insert(std::make_pair(playerId, std::move(newClientSession)));
+ClientSession* ClientRegistry::addClientSession(uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, int64_t timeStamp) {
+    auto& newClientSession = clientSessions_.insert(playerId, std::make_unique<ClientSession>(endpoint, playerId, timeStamp));
     playerIds_.insert(std::make_pair(boost::lexical_cast<std::string>(endpoint), playerId));
-    return clientSessions_[playerId].get();
+    return newClientSession.get();
 }
 
 ClientSession* ClientRegistry::getClientSession(uint32_t playerId) {
-    const auto itr = clientSessions_.find(playerId);
-    if (itr != clientSessions_.end()) {
-        return (*itr).second.get();
-    }
-    return nullptr;
+    const auto clientSession = clientSessions_.find(playerId);
+    return clientSession != nullptr ? clientSession->get() : nullptr;
 }
 
 void ClientRegistry::removeClientSession(uint32_t playerId) {
-    const auto itr = clientSessions_.find(playerId);
-    if (itr != clientSessions_.end()) {
-        playerIds_.erase(playerIds_.find(boost::lexical_cast<std::string>(itr->second->getEndpoint())));
-        clientSessions_.erase(itr);
+    const auto clientSession = clientSessions_.find(playerId);
+    if (clientSession != nullptr) {
+        playerIds_.erase(playerIds_.find(boost::lexical_cast<std::string>((*clientSession)->getEndpoint())));
+        clientSessions_.erase(playerId);
     }
 }
 
 bool ClientRegistry::verifyClientSession(uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint) {
-    if (clientSessions_.find(playerId) != clientSessions_.end()) {
+    if (clientSessions_.contains(playerId)) {
         const auto s = boost::lexical_cast<std::string>(endpoint);
         return playerIds_[s] == playerId;
     }
     return false;
 }
 
+uint32_t ClientRegistry::getClientSessionCount() const {
+    return clientSessions_.size();
+}
+
 bool ClientRegistry::hasClientSession(const boost::asio::ip::udp::endpoint& endpoint) {
     return playerIds_.find(boost::lexical_cast<std::string>(endpoint)) != playerIds_.end();
 }
 
-void ClientRegistry::checkForDisconnects(float currentTime, std::function<void (uint32_t)> fun) {
-    std::vector<uint32_t> clientsToBeRemoved;
-    for (const auto& clientSession : clientSessions_) {
-        if ((currentTime - clientSession.second->getLastSeen()) > PROTOCOL_CLIENT_TIMEOUT) {
-            clientsToBeRemoved.push_back(clientSession.first);
+void ClientRegistry::checkForDisconnects(int64_t currentTime, std::function<void (uint32_t)> fun) {
+    const auto timeout = Clock::toNanoseconds(PROTOCOL_CLIENT_TIMEOUT);
+    disconnectedPlayerIds_.clear();
+    clientSessions_.forEach([this, currentTime, timeout] (uint32_t playerId, const std::unique_ptr<ClientSession>& clientSession) {
+        if ((currentTime - clientSession->getLastSeen()) > timeout) {
+            disconnectedPlayerIds_.push_back(playerId);
         }
-    }
-    for (const auto& playerId : clientsToBeRemoved) {
+    });
+    for (const auto playerId : disconnectedPlayerIds_) {
         removeClientSession(playerId);
         fun(playerId);
     }
 }
-
-void ClientRegistry::forEachClientSession(std::function<void (ClientSession*)> fun) {
-    for (auto& pair : clientSessions_) {
-        fun(pair.second.get());
-    }
-}
@@ -2,12 +2,14 @@
 #define _ClientRegistry_H
 
 #include "ClientSession.h"
+#include "SlotMap.h"
 
 #include <boost/asio.hpp>
 
 #include <unordered_map>
 #include <memory>
 #include <functional>
+#include <vector>
 
 /** Manages client session.
  */
@@ -19,12 +21,12 @@ public:
 
     /** Adds a session to the registry.
 
-        \param playerId the ID of the new player
+        \param playerId the ID of the new player, a handle as produced by HandleAllocator.
         \param endpoint the endpoint of the new player.
-        \param timeStamp the timestamp when this player was seen.
+        \param timeStamp the time in nanoseconds when this player was seen.
         \return the newly created client session.
      */
-    ClientSession* addClientSession(uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, float timeStamp);
+    ClientSession* addClientSession(uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, int64_t timeStamp);
 
     /** Get the client session belonging to a given player.
 
@@ -54,22 +56,32 @@ public:
      */
     bool hasClientSession(const boost::asio::ip::udp::endpoint& endpoint);
 
+    /** Returns the number of client sessions.
+     */
+    uint32_t getClientSessionCount() const;
+
     /** Checks all client session for connectivity and removes disconnected clients.
 
-        \param currentTime the current time.
+        \param currentTime the current time in nanoseconds.
         \param fun a callback function to be called for each removed client.
      */
-    void checkForDisconnects(float currentTime, std::function<void (uint32_t)> fun);
+    void checkForDisconnects(int64_t currentTime, std::function<void (uint32_t)> fun);
 
     /** Iterates over all client sessions and calls a given callback function for each session.
 
         \param fun a callback function.
      */
-    void forEachClientSession(std::function<void (ClientSession*)> fun);
+    template<typename Fun>
+    void forEachClientSession(Fun&& fun) {
+        clientSessions_.forEach([&fun] (uint32_t, std::unique_ptr<ClientSession>& clientSession) {
+            fun(clientSession.get());
+        });
+    }
 
 private:
-    std::unordered_map<uint32_t, std::unique_ptr<ClientSession>> clientSessions_;
+    SlotMap<std::unique_ptr<ClientSession>> clientSessions_;
     std::unordered_map<std::string, uint32_t> playerIds_;
+    std::vector<uint32_t> disconnectedPlayerIds_;
 };
 
 #endif  // _ClientRegistry_H
@@ -4,12 +4,13 @@
 
 #include <boost/log/trivial.hpp>
 
-ClientSession::ClientSession(const boost::asio::ip::udp::endpoint& clientEndpoint, uint32_t playerId, float currenTime)
+ClientSession::ClientSession(const boost::asio::ip::udp::endpoint& clientEndpoint, uint32_t playerId, int64_t currenTime)
 : clientEndpoint_(clientEndpoint)
 , playerId_(playerId)
-, moveList_()
+, inputBuffer_()
 , lastSeen_(currenTime)
-, latestInputTime_(0.0f) {
+, latestInputTick_(0)
+, viewDelay_(0.0f) {
 }
 
 const boost::asio::ip::udp::endpoint ClientSession::getEndpoint() const {
@@ -20,22 +21,30 @@ uint32_t ClientSession::getPlayerId() const {
     return playerId_;
 }
 
-MoveList& ClientSession::getMoveList() {
-    return moveList_;
+InputBuffer& ClientSession::getInputBuffer() {
+    return inputBuffer_;
 }
 
-void ClientSession::setLastSeen(float timeStamp) {
+void ClientSession::setLastSeen(int64_t timeStamp) {
     lastSeen_ = timeStamp;
 }
 
-float ClientSession::getLastSeen() const {
+int64_t ClientSession::getLastSeen() const {
     return lastSeen_;
 }
 
-void ClientSession::setLatestInputTime(float timeStamp) {
-    latestInputTime_ = timeStamp;
+void ClientSession::setLatestInputTick(uint32_t tick) {
+    latestInputTick_ = tick;
 }
 
-float ClientSession::getLatestInputTime() const {
-    return latestInputTime_;
+uint32_t ClientSession::getLatestInputTick() const {
+    return latestInputTick_;
+}
+
+void ClientSession::setViewDelay(float viewDelay) {
+    viewDelay_ = viewDelay;
+}
+
+float ClientSession::getViewDelay() const {
+    return viewDelay_;
 }
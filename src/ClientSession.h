@@ -1,38 +1,54 @@
 #ifndef _ClientSession_H
 #define _ClientSession_H
 
-#include "MoveList.h"
+#include "InputBuffer.h"
 
 #include <boost/asio.hpp>
 
 class ClientSession {
 public:
-    ClientSession(const boost::asio::ip::udp::endpoint& clientEndpoint, uint32_t playerId, float currenTime);
+    ClientSession(const boost::asio::ip::udp::endpoint& clientEndpoint, uint32_t playerId, int64_t currenTime);
 
     const boost::asio::ip::udp::endpoint getEndpoint() const;
 
     uint32_t getPlayerId() const;
 
-    MoveList& getMoveList();
+    InputBuffer& getInputBuffer();
 
-    void setLastSeen(float timeStamp);
+    void setLastSeen(int64_t timeStamp);
 
-    float getLastSeen() const;
+    int64_t getLastSeen() const;
 
-    void setLatestInputTime(float timeStamp);
+    /** Sets the tick of the latest move of the client that has been applied.
+     */
+    void setLatestInputTick(uint32_t tick);
 
-    float getLatestInputTime() const;
+    uint32_t getLatestInputTick() const;
+
+    /** Sets how far the world shown by the client lags behind the server.
+
+        \param viewDelay the server time when the latest INPUT arrived minus the
+               server time of the world the client showed when it sent the INPUT.
+     */
+    void setViewDelay(float viewDelay);
+
+    /** Returns how far the world shown by the client lags behind the server when
+        an INPUT of the client arrives.
+     */
+    float getViewDelay() const;
 
 private:
     const boost::asio::ip::udp::endpoint clientEndpoint_;
 
     const uint32_t playerId_;
 
-    MoveList moveList_;
+    InputBuffer inputBuffer_;
+
+    int64_t lastSeen_;
 
-    float lastSeen_;
+    uint32_t latestInputTick_;
 
-    float latestInputTime_;
+    float viewDelay_;
 };
 
 #endif  // _ClientSession_H
@@ -1,32 +1,70 @@
 #include "Clock.h"
+#include "TimeSource.h"
+
+#include <cmath>
 
 Clock::Clock()
-: startTime(std::chrono::high_resolution_clock::now())
-, lastTime(startTime)
-, currentTime(startTime)
-, elapsed(0) {
+: timeSource_(nullptr)
+, startTime_(std::chrono::steady_clock::now())
+, lastTime_(0)
+, currentTime_(0) {
+}
+
+Clock::Clock(const TimeSource& timeSource)
+: timeSource_(&timeSource)
+, startTime_(timeSource.now())
+, lastTime_(0)
+, currentTime_(0) {
 }
 
 void Clock::update() {
-    currentTime = std::chrono::high_resolution_clock::now();
-    elapsed = static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastTime).count()) / 1000.0f;
-    lastTime = currentTime;
+    lastTime_ = currentTime_;
+    currentTime_ = now();
+}
+
+int64_t Clock::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(readTimeSource() - startTime_).count();
+}
+
+int64_t Clock::toTime(std::chrono::steady_clock::time_point timePoint) const {
+    if (timePoint == std::chrono::steady_clock::time_point()) {
+        return now();
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint - startTime_).count();
+}
+
+int64_t Clock::getFrameStart() const {
+    return currentTime_;
+}
+
+int64_t Clock::getElapsedNanoseconds() const {
+    return currentTime_ - lastTime_;
 }
 
 float Clock::getTime() const {
-    const auto now = std::chrono::high_resolution_clock::now();
-    return static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count()) / 1000.0f;
+    return toSeconds(now());
 }
 
 float Clock::getElapsed() const {
-    return elapsed;
+    return toSeconds(getElapsedNanoseconds());
 }
 
 float Clock::getGameTime() const {
-    return static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime).count()) / 1000.0f;
+    return toSeconds(currentTime_);
 }
 
 float Clock::getFrameTime() const {
-    const auto now = std::chrono::high_resolution_clock::now();
-    return static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(now - currentTime).count()) / 1000.0f;
+    return toSeconds(now() - currentTime_);
+}
+
+float Clock::toSeconds(int64_t nanoseconds) {
+    return static_cast<float>(static_cast<double>(nanoseconds) * 1e-9);
+}
+
+int64_t Clock::toNanoseconds(double seconds) {
+    return std::llround(seconds * 1e9);
+}
+
+std::chrono::steady_clock::time_point Clock::readTimeSource() const {
+    return timeSource_ ? timeSource_->now() : std::chrono::steady_clock::now();
 }
@@ -2,8 +2,17 @@
 #define _Clock_H
 
 #include <chrono>
+#include <cstdint>
+
+class TimeSource;
 
 /** A clock to get different timings from.
+
+    Time stamps are integer nanoseconds since the clock was created, taken from
+    a monotonic clock. Unlike float seconds they keep their resolution however
+    long the process runs. Durations within a frame are small enough to be
+    handed out as float seconds. A clock can read another time source than
+    the steady clock, e.g. a VirtualClock in tests.
  */
 class Clock {
 public:
@@ -11,10 +20,37 @@ public:
      */
     Clock();
 
+    /** Constructor
+
+        \param timeSource the time source to read instead of the steady clock.
+               It must outlive the clock.
+     */
+    explicit Clock(const TimeSource& timeSource);
+
     /** Update the clock. This method should be called once at the beginning of each frame.
      */
     void update();
 
+    /** Returns the current time in nanoseconds. Every call reads the system clock.
+     */
+    int64_t now() const;
+
+    /** Returns the time of the last update in nanoseconds. It does not read the
+        system clock, so it is the time stamp to use for everything that happens
+        within one frame.
+     */
+    int64_t getFrameStart() const;
+
+    /** Converts a time point of the steady clock, e.g. the receive time of a
+        packet, into nanoseconds of this clock. The epoch of the steady clock
+        stands for an unknown time and yields the current time.
+     */
+    int64_t toTime(std::chrono::steady_clock::time_point timePoint) const;
+
+    /** Returns the time between the last two updates in nanoseconds.
+     */
+    int64_t getElapsedNanoseconds() const;
+
     /** Returns the current time relative to the time when the clock was created.
      */
     float getTime() const;
@@ -31,14 +67,25 @@ public:
      */
     float getFrameTime() const;
 
+    /** Converts nanoseconds into seconds. Meant for durations; absolute time
+        stamps lose their precision as float seconds.
+     */
+    static float toSeconds(int64_t nanoseconds);
+
+    /** Converts seconds into nanoseconds.
+     */
+    static int64_t toNanoseconds(double seconds);
+
 private:
-    std::chrono::high_resolution_clock::time_point startTime;
+    std::chrono::steady_clock::time_point readTimeSource() const;
+
+    const TimeSource* timeSource_;
 
-    std::chrono::high_resolution_clock::time_point lastTime;
+    std::chrono::steady_clock::time_point startTime_;
 
-    std::chrono::high_resolution_clock::time_point currentTime;
+    int64_t lastTime_;
 
-    float elapsed;
+    int64_t currentTime_;
 };
 
 #endif  // _Clock_H
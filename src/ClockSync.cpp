@@ -0,0 +1,95 @@
+#include "ClockSync.h"
+#include "Clock.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The number of recent exchanges the best sample is picked from.
+static const uint32_t SAMPLE_WINDOW = 8;
+
+// The drift is only derived from best samples that are at least this far apart,
+// so that the noise of the offsets does not dominate.
+static const int64_t MIN_DRIFT_INTERVAL = 2000000000;
+
+// Weight of a new drift measurement.
+static const float DRIFT_GAIN = 0.25f;
+
+// Real clocks drift by a few dozen parts per million; anything larger is noise.
+static const float MAX_DRIFT = 0.0005f;
+
+ClockSync::ClockSync()
+: samples_()
+, next_(0)
+, best_(0)
+, drift_(0) {
+    samples_.reserve(SAMPLE_WINDOW);
+}
+
+void ClockSync::addSample(int64_t localSendTime, int64_t remoteReceiveTime, int64_t remoteSendTime, int64_t localReceiveTime) {
+    const auto delay = (localReceiveTime - localSendTime) - (remoteSendTime - remoteReceiveTime);
+    if (delay < 0) {
+        return;
+    }
+    const Sample sample{localReceiveTime, ((remoteReceiveTime - localSendTime) + (remoteSendTime - localReceiveTime)) / 2, delay};
+
+    const auto hadBest = !samples_.empty();
+    const auto previousBest = hadBest ? getBest() : sample;
+
+    if (samples_.size() < SAMPLE_WINDOW) {
+        samples_.push_back(sample);
+    } else {
+        samples_[next_] = sample;
+    }
+    next_ = (next_ + 1) % SAMPLE_WINDOW;
+
+    best_ = 0;
+    for (uint32_t i = 1; i < samples_.size(); i++) {
+        if (samples_[i].delay < samples_[best_].delay) {
+            best_ = i;
+        }
+    }
+
+    const auto& best = getBest();
+    const auto interval = best.localTime - previousBest.localTime;
+    if (hadBest && interval >= MIN_DRIFT_INTERVAL) {
+        const auto drift = static_cast<float>(static_cast<double>(best.offset - previousBest.offset) / static_cast<double>(interval));
+        drift_ = std::max(-MAX_DRIFT, std::min(drift_ + (drift - drift_) * DRIFT_GAIN, MAX_DRIFT));
+    }
+}
+
+bool ClockSync::isSynchronized() const {
+    return !samples_.empty();
+}
+
+int64_t ClockSync::getOffset(int64_t localTime) const {
+    if (samples_.empty()) {
+        return 0;
+    }
+    const auto& best = getBest();
+    return best.offset + std::llround(drift_ * static_cast<double>(localTime - best.localTime));
+}
+
+float ClockSync::getDrift() const {
+    return drift_;
+}
+
+float ClockSync::getRoundTripTime() const {
+    return samples_.empty() ? 0.0f : Clock::toSeconds(getBest().delay);
+}
+
+float ClockSync::getSyncError() const {
+    return getRoundTripTime() / 2.0f;
+}
+
+int64_t ClockSync::toRemoteTime(int64_t localTime) const {
+    return localTime + getOffset(localTime);
+}
+
+int64_t ClockSync::toLocalTime(int64_t remoteTime) const {
+    // The offset depends on the local time, which is first approximated.
+    return remoteTime - getOffset(remoteTime - getOffset(remoteTime));
+}
+
+const ClockSync::Sample& ClockSync::getBest() const {
+    return samples_[best_];
+}
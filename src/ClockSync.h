@@ -0,0 +1,71 @@
+#ifndef _ClockSync_H
+#define _ClockSync_H
+
+#include <vector>
+#include <cstdint>
+
+/** Estimates the offset and drift of a remote clock from NTP-style exchanges.
+
+    Each TICK/TOCK exchange yields four time stamps: the local send time t0, the
+    remote receive time t1, the remote send time t2 and the local receive time t3.
+    From these follow the clock offset ((t1 - t0) + (t2 - t3)) / 2 and the round
+    trip delay (t3 - t0) - (t2 - t1). As in NTP, the sample with the smallest
+    delay in a short window is trusted most, because queueing only ever adds
+    delay, and usually asymmetrically.
+
+    Time stamps and offsets are in nanoseconds, durations in seconds.
+ */
+class ClockSync {
+public:
+    ClockSync();
+
+    /** Adds the time stamps of a completed exchange. Samples with a negative delay are ignored.
+     */
+    void addSample(int64_t localSendTime, int64_t remoteReceiveTime, int64_t remoteSendTime, int64_t localReceiveTime);
+
+    /** Returns true once at least one exchange has completed.
+     */
+    bool isSynchronized() const;
+
+    /** Returns the estimated offset of the remote clock at a local time, i.e. remote time minus local time.
+     */
+    int64_t getOffset(int64_t localTime) const;
+
+    /** Returns the estimated drift of the remote clock relative to the local one, in seconds per second.
+     */
+    float getDrift() const;
+
+    /** Returns the round trip delay of the best sample, without the processing time at the remote end.
+     */
+    float getRoundTripTime() const;
+
+    /** Returns an upper bound of the offset error. A path whose delay is split
+        unevenly between the two directions can shift the offset by at most half
+        the round trip delay.
+     */
+    float getSyncError() const;
+
+    /** Converts a local time into the remote clock.
+     */
+    int64_t toRemoteTime(int64_t localTime) const;
+
+    /** Converts a remote time into the local clock.
+     */
+    int64_t toLocalTime(int64_t remoteTime) const;
+
+private:
+    struct Sample {
+        int64_t localTime;
+        int64_t offset;
+        int64_t delay;
+    };
+
+    const Sample& getBest() const;
+
+    std::vector<Sample> samples_;
+    uint32_t next_;
+    uint32_t best_;
+    float drift_;
+};
+
+#endif  // _ClockSync_H
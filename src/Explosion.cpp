@@ -14,7 +14,7 @@ void Explosion::update(float elapsed) {
     }
 }
 
-void Explosion::draw(Renderer& renderer) {
+void Explosion::draw(Renderer& renderer, float) {
     animation_.draw(static_cast<int>(position_.getX()), static_cast<int>(position_.getY()), renderer);
 }
 
@@ -26,7 +26,7 @@ void Explosion::read(Packet* packet) {
     position_.read(packet);
 }
 
-const Vector2d& Explosion::getPosition() const {
+Vector2d Explosion::getPosition() const {
     return position_;
 }
 
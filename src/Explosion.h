@@ -28,8 +28,9 @@ public:
     /** Draws the explosion.
 
         \param renderer a reference to the renderer.
+        \param alpha unused, explosions do not move.
      */
-    void draw(Renderer& renderer);
+    void draw(Renderer& renderer, float alpha);
 
     /** Writes the explosion information to the packet.
 
@@ -45,7 +46,7 @@ public:
 
     /** Returns the position of the explosion.
      */
-    const Vector2d& getPosition() const;
+    Vector2d getPosition() const;
 
     /** Returns the width of the explosion.
      */
@@ -0,0 +1,55 @@
+#include "FixedTimestep.h"
+#include "Clock.h"
+
+#include <algorithm>
+
+FixedTimestep::FixedTimestep(unsigned int tickRate, uint32_t maxCatchUpTicks)
+: tickDuration_(Clock::toNanoseconds(1.0 / tickRate))
+, maxBacklog_(tickDuration_ * std::max(maxCatchUpTicks, 1u))
+, accumulator_(0)
+, tick_(0)
+, droppedTicks_(0) {
+}
+
+void FixedTimestep::advance(int64_t elapsed) {
+    accumulator_ += std::max(elapsed, int64_t(0));
+    if (accumulator_ >= maxBacklog_ + tickDuration_) {
+        // Keep the fraction of the current tick so that rendering stays smooth.
+        const auto excess = (accumulator_ - maxBacklog_) / tickDuration_;
+        droppedTicks_ += static_cast<uint64_t>(excess);
+        accumulator_ -= excess * tickDuration_;
+    }
+}
+
+bool FixedTimestep::takeTick() {
+    if (accumulator_ < tickDuration_) {
+        return false;
+    }
+    accumulator_ -= tickDuration_;
+    tick_++;
+    return true;
+}
+
+uint32_t FixedTimestep::getTick() const {
+    return tick_;
+}
+
+int64_t FixedTimestep::getTickDuration() const {
+    return tickDuration_;
+}
+
+float FixedTimestep::getTickSeconds() const {
+    return Clock::toSeconds(tickDuration_);
+}
+
+float FixedTimestep::getAlpha() const {
+    return std::min(static_cast<float>(static_cast<double>(accumulator_) / static_cast<double>(tickDuration_)), 1.0f);
+}
+
+int64_t FixedTimestep::getTimeUntilNextTick() const {
+    return std::max(tickDuration_ - accumulator_, int64_t(0));
+}
+
+uint64_t FixedTimestep::getDroppedTicks() const {
+    return droppedTicks_;
+}
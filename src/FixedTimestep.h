@@ -0,0 +1,70 @@
+#ifndef _FixedTimestep_H
+#define _FixedTimestep_H
+
+#include <cstdint>
+
+/** Turns the irregular time between frames into a sequence of equally long,
+    numbered simulation ticks.
+
+    Real time is added to an accumulator, and each whole tick duration in it
+    becomes one tick. What is left over is the fraction of the next tick that has
+    already passed, which the renderer uses to blend the last two simulated
+    states. If the simulation falls behind by more than a few ticks, e.g. after
+    the process was suspended, the backlog is dropped instead of being caught up
+    in a burst that would only make it fall further behind.
+ */
+class FixedTimestep {
+public:
+    /** Constructor
+
+        \param tickRate the number of ticks per second.
+        \param maxCatchUpTicks the largest number of ticks run to catch up at once.
+     */
+    FixedTimestep(unsigned int tickRate, uint32_t maxCatchUpTicks);
+
+    /** Adds real time to the accumulator.
+
+        \param elapsed the time since the last call in nanoseconds.
+     */
+    void advance(int64_t elapsed);
+
+    /** Takes one due tick from the accumulator.
+
+        \return true if a tick is due, i.e. the caller should simulate it.
+     */
+    bool takeTick();
+
+    /** Returns the number of the latest tick taken. The first tick is 1.
+     */
+    uint32_t getTick() const;
+
+    /** Returns the duration of a tick in nanoseconds.
+     */
+    int64_t getTickDuration() const;
+
+    /** Returns the duration of a tick in seconds.
+     */
+    float getTickSeconds() const;
+
+    /** Returns how far the time has advanced into the next tick, in [0, 1).
+     */
+    float getAlpha() const;
+
+    /** Returns the time until the next tick is due in nanoseconds.
+     */
+    int64_t getTimeUntilNextTick() const;
+
+    /** Returns the number of ticks dropped because the simulation fell behind.
+     */
+    uint64_t getDroppedTicks() const;
+
+private:
+    const int64_t tickDuration_;
+    const int64_t maxBacklog_;
+
+    int64_t accumulator_;
+    uint32_t tick_;
+    uint64_t droppedTicks_;
+};
+
+#endif  // _FixedTimestep_H
@@ -0,0 +1,102 @@
+#include "FramePacer.h"
+#include "Clock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// The spinning phase never gets shorter or longer than this.
+static const int64_t MIN_SPIN_THRESHOLD = 100000;
+static const int64_t MAX_SPIN_THRESHOLD = 4000000;
+
+// Until the observed oversleep says otherwise.
+static const int64_t INITIAL_SPIN_THRESHOLD = 1000000;
+
+// Closer to the deadline than this the pacer busy-waits instead of yielding.
+static const int64_t YIELD_THRESHOLD = 50000;
+
+// The weight of a new oversleep sample in the running mean and deviation.
+static const double OVERSLEEP_GAIN = 1.0 / 16.0;
+
+// The spinning phase covers the mean oversleep plus this many deviations.
+static const double OVERSLEEP_DEVIATIONS = 4.0;
+
+FramePacer::FramePacer()
+: spinning_(true)
+, spinThreshold_(INITIAL_SPIN_THRESHOLD)
+, oversleepMean_(0.0)
+, oversleepDeviation_(static_cast<double>(INITIAL_SPIN_THRESHOLD) / OVERSLEEP_DEVIATIONS)
+, waitCount_(0)
+, totalOvershoot_(0)
+, maxOvershoot_(0) {
+}
+
+void FramePacer::setSpinning(bool spinning) {
+    spinning_ = spinning;
+}
+
+int64_t FramePacer::waitUntil(const Clock& clock, int64_t deadline) {
+    auto now = clock.now();
+    if (!spinning_) {
+        while (now < deadline) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(deadline - now));
+            now = clock.now();
+        }
+        return recordOvershoot(now - deadline);
+    }
+
+    const auto sleepTime = deadline - now - spinThreshold_;
+    if (sleepTime > 0) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(sleepTime));
+        const auto wakeUpTime = clock.now();
+        addOversleep(wakeUpTime - (now + sleepTime));
+        now = wakeUpTime;
+    }
+
+    while (now < deadline) {
+        if (deadline - now > YIELD_THRESHOLD) {
+            std::this_thread::yield();
+        }
+        now = clock.now();
+    }
+
+    return recordOvershoot(now - deadline);
+}
+
+uint64_t FramePacer::getWaitCount() const {
+    return waitCount_;
+}
+
+int64_t FramePacer::getMeanOvershoot() const {
+    return waitCount_ > 0 ? totalOvershoot_ / static_cast<int64_t>(waitCount_) : 0;
+}
+
+int64_t FramePacer::getMaxOvershoot() const {
+    return maxOvershoot_;
+}
+
+int64_t FramePacer::getSpinThreshold() const {
+    return spinThreshold_;
+}
+
+void FramePacer::resetStatistics() {
+    waitCount_ = 0;
+    totalOvershoot_ = 0;
+    maxOvershoot_ = 0;
+}
+
+int64_t FramePacer::recordOvershoot(int64_t overshoot) {
+    waitCount_++;
+    totalOvershoot_ += overshoot;
+    maxOvershoot_ = std::max(maxOvershoot_, overshoot);
+    return overshoot;
+}
+
+void FramePacer::addOversleep(int64_t oversleep) {
+    const auto error = static_cast<double>(oversleep) - oversleepMean_;
+    oversleepMean_ += OVERSLEEP_GAIN * error;
+    oversleepDeviation_ += OVERSLEEP_GAIN * (std::abs(error) - oversleepDeviation_);
+    const auto threshold = std::llround(oversleepMean_ + OVERSLEEP_DEVIATIONS * oversleepDeviation_);
+    spinThreshold_ = std::min(std::max(static_cast<int64_t>(threshold), MIN_SPIN_THRESHOLD), MAX_SPIN_THRESHOLD);
+}
@@ -0,0 +1,72 @@
+#ifndef _FramePacer_H
+#define _FramePacer_H
+
+#include <cstdint>
+
+class Clock;
+
+/** Waits for absolute deadlines with sub-millisecond precision.
+
+    The operating system wakes a sleeping thread up late, by anything from a
+    few microseconds to a few milliseconds. The pacer therefore sleeps only
+    until shortly before the deadline, then yields and finally spins until the
+    deadline has passed. How much time is left for spinning follows the
+    oversleep observed so far, so an idle system spins for little more than the
+    usual wake-up latency. Spinning costs up to a few milliseconds of a core per
+    wait, so loops that can live with the wake-up latency turn it off and only
+    sleep.
+
+    It keeps statistics of the overshoot, i.e. how late each wait returned.
+ */
+class FramePacer {
+public:
+    /** Constructor
+     */
+    FramePacer();
+
+    /** Turns spinning before the deadlines on or off. It is on by default.
+     */
+    void setSpinning(bool spinning);
+
+    /** Blocks until the clock reaches the deadline.
+
+        \param clock the clock the deadline refers to.
+        \param deadline the time to wake up at in nanoseconds.
+        \return the overshoot in nanoseconds, i.e. how late the call returned.
+     */
+    int64_t waitUntil(const Clock& clock, int64_t deadline);
+
+    /** Returns the number of waits since the statistics were reset.
+     */
+    uint64_t getWaitCount() const;
+
+    /** Returns the mean overshoot in nanoseconds.
+     */
+    int64_t getMeanOvershoot() const;
+
+    /** Returns the largest overshoot in nanoseconds.
+     */
+    int64_t getMaxOvershoot() const;
+
+    /** Returns the time before a deadline at which sleeping stops, in nanoseconds.
+     */
+    int64_t getSpinThreshold() const;
+
+    void resetStatistics();
+
+private:
+    int64_t recordOvershoot(int64_t overshoot);
+
+    void addOversleep(int64_t oversleep);
+
+    bool spinning_;
+    int64_t spinThreshold_;
+    double oversleepMean_;
+    double oversleepDeviation_;
+
+    uint64_t waitCount_;
+    int64_t totalOvershoot_;
+    int64_t maxOvershoot_;
+};
+
+#endif  // _FramePacer_H
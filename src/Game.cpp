@@ -1,40 +1,111 @@
 #include "Game.h"
 #include "Clock.h"
 #include "Renderer.h"
+#include "Utilities.h"
+#include "Logging.h"
 
-#include <thread>
+#include <algorithm>
+#include <cmath>
 
-Game::Game(unsigned int frameRate, Renderer& renderer)
+// After a stall the simulation runs at most this many ticks in one frame.
+static const uint32_t MAX_CATCH_UP_TICKS = 5;
+
+// Events older than this many milliseconds are taken as if they just happened.
+static const int64_t MAX_EVENT_AGE = 1000;
+
+// The interval at which the frame pacing statistics are logged, in seconds.
+static const double PACING_REPORT_INTERVAL = 10.0;
+
+Game::Game(unsigned int tickRate, Renderer& renderer)
 : renderer_(renderer)
-, frameDuration_(1.0f / static_cast<float>(frameRate)) {
+, tickDuration_(1.0f / static_cast<float>(tickRate))
+, timestep_(tickRate, MAX_CATCH_UP_TICKS)
+, pacer_()
+, timeScale_(1.0f)
+, pinnedCore_(-1) {
 }
 
 void Game::run() {
     bool running = true;
 
+    if (pinnedCore_ >= 0 && !pinCurrentThreadToCore(static_cast<unsigned int>(pinnedCore_))) {
+        WARN("Failed to pin the game loop to core {0}.", pinnedCore_);
+    }
+
     Clock clock;
+    int64_t lastReport = 0;
     while (running) {
+        // All pending events are handled before the next tick, so that a burst
+        // of events cannot hold up the simulation.
         SDL_Event event;
-        if (SDL_PollEvent(&event)) {
+        while (running && SDL_PollEvent(&event)) {
             if (event.type == SDL_QUIT || (event.type == SDL_WINDOWEVENT && event.window.event == SDL_WINDOWEVENT_CLOSE)) {
                 running = false;
             } else {
-                processEvent(event, running);
+                processEvent(event, clock, running);
             }
-        } else {
+        }
+
+        if (running) {
             clock.update();
+            stepPaced(clock);
 
-            update(clock);
+            // Wait until the next tick is due, in real time.
+            pacer_.waitUntil(clock, clock.getFrameStart() + std::llround(static_cast<double>(timestep_.getTimeUntilNextTick()) / timeScale_));
 
-            const auto currentFrameTime = clock.getFrameTime();
-            if (currentFrameTime < frameDuration_) {
-                const auto delay = static_cast<unsigned int>((frameDuration_ - currentFrameTime) * 1000.0f);
-                std::this_thread::sleep_for(std::chrono::milliseconds(delay));
+            if (clock.getFrameStart() > lastReport + Clock::toNanoseconds(PACING_REPORT_INTERVAL)) {
+                DEBUG("Frame pacing: {0} frames, overshoot mean {1} us, max {2} us, spin threshold {3} us, {4} ticks dropped.",
+                      pacer_.getWaitCount(), pacer_.getMeanOvershoot() / 1000, pacer_.getMaxOvershoot() / 1000,
+                      pacer_.getSpinThreshold() / 1000, timestep_.getDroppedTicks());
+                pacer_.resetStatistics();
+                lastReport = clock.getFrameStart();
             }
         }
     }
 }
 
-void Game::processEvent(SDL_Event &event, bool& running) {
-    handleEvent(event, running);
+void Game::step(const Clock& clock) {
+    simulate(clock);
+    render(timestep_.getAlpha());
+}
+
+void Game::stepPaced(const Clock& clock) {
+    simulate(clock);
+    // Only the overshoot of the pacer is left of the frame, the alpha of the
+    // timestep would be about 0 and draw the tick before the one just simulated.
+    render(1.0f);
+}
+
+void Game::pinToCore(unsigned int core) {
+    pinnedCore_ = static_cast<int>(core);
+}
+
+uint32_t Game::getTick() const {
+    return timestep_.getTick();
+}
+
+void Game::setTimeScale(float timeScale) {
+    timeScale_ = timeScale;
+}
+
+float Game::getTimeScale() const {
+    return timeScale_;
+}
+
+void Game::setPreciseFramePacing(bool precise) {
+    pacer_.setSpinning(precise);
+}
+
+void Game::simulate(const Clock& clock) {
+    timestep_.advance(std::llround(static_cast<double>(clock.getElapsedNanoseconds()) * timeScale_));
+    while (timestep_.takeTick()) {
+        update(clock);
+    }
+}
+
+void Game::processEvent(SDL_Event &event, const Clock& clock, bool& running) {
+    // SDL stamps events in milliseconds of its own clock.
+    const auto age = std::min(static_cast<int64_t>(static_cast<Uint32>(SDL_GetTicks() - event.common.timestamp)), MAX_EVENT_AGE);
+    const auto now = clock.now();
+    handleEvent(event, std::max(now - age * 1000000, int64_t(0)), running);
 }
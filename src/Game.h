@@ -1,31 +1,106 @@
 #ifndef _Game_H
 #define _Game_H
 
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+
 #include <SDL2/SDL.h>
 
 class Renderer;
 class Clock;
 
+/** Runs the main loop. The simulation advances in fixed ticks, however long a
+    frame takes. run() paces each frame to the next tick and draws that tick;
+    step() draws between the last two ticks for frames of any length.
+ */
 class Game {
 public:
-    Game(unsigned int frameRate, Renderer& renderer);
+    /** Constructor
+
+        \param tickRate the number of simulation ticks per second.
+        \param renderer the renderer to draw with.
+     */
+    Game(unsigned int tickRate, Renderer& renderer);
 
     virtual ~Game() = default;
 
     void run();
 
+    /** Runs one frame without waiting: simulates the ticks that are due by
+        the last update of the clock and draws. run() calls it once per frame;
+        tests call it to drive the game from a VirtualClock.
+
+        \param clock the clock, updated by the caller.
+     */
+    void step(const Clock& clock);
+
+    /** Runs one frame of run(): simulates the ticks that are due by the last
+        update of the clock and draws the latest of them. run() waits for the
+        next tick after each frame, so interpolating would draw the tick before.
+
+        \param clock the clock, updated by the caller.
+     */
+    void stepPaced(const Clock& clock);
+
+    /** Pins the thread that calls run() to a core, to keep the frame timing
+        free from migrations between cores.
+
+        \param core the index of the core.
+     */
+    void pinToCore(unsigned int core);
+
 protected:    
+    /** Simulates one tick of tickDuration_ seconds.
+     */
     virtual void update(const Clock& clock) = 0;
 
-    virtual void handleEvent(SDL_Event &event, bool& running) = 0;
+    /** Draws a frame.
+
+        \param alpha how far the time has advanced from the last tick towards the next one, in [0, 1].
+     */
+    virtual void render(float alpha) = 0;
+
+    /** Handles an SDL event.
+
+        \param event the event.
+        \param eventTime the time when the event happened, in nanoseconds of the game clock.
+        \param running is set to false to quit.
+     */
+    virtual void handleEvent(SDL_Event &event, int64_t eventTime, bool& running) = 0;
+
+    /** Returns the number of the tick being simulated.
+     */
+    uint32_t getTick() const;
+
+    /** Makes the ticks run faster or slower than real time.
+     */
+    void setTimeScale(float timeScale);
+
+    float getTimeScale() const;
+
+    /** Turns spinning before each frame on or off, see FramePacer. It is on by
+        default, for the frame timing that a player sees.
+     */
+    void setPreciseFramePacing(bool precise);
 
     Renderer& renderer_;
 
 protected:
-    const float frameDuration_;
+    // The simulated duration of a tick in seconds.
+    const float tickDuration_;
 
 private:
-    void processEvent(SDL_Event &event, bool& running);
+    void simulate(const Clock& clock);
+
+    void processEvent(SDL_Event &event, const Clock& clock, bool& running);
+
+    FixedTimestep timestep_;
+
+    FramePacer pacer_;
+
+    float timeScale_;
+
+    int pinnedCore_;
 };
 
 #endif  // _Game_H
@@ -5,33 +5,56 @@
 #include "GameObjectRegistry.h"
 #include "Packet.h"
 #include "Logging.h"
-#include "LocalSpaceShip.h"
-#include "RemoteSpaceShip.h"
-#include "RemoteLaserBolt.h"
-#include "Explosion.h"
 
-#include <set>
+#include <algorithm>
+#include <utility>
 
-GameClient::GameClient(unsigned int frameRate, unsigned int emulatedLatency, unsigned int stdDevLatencyMean, const char *address, uint16_t port, Renderer& renderer)
+// The interval between two TICKs in seconds.
+static const double TICK_INTERVAL = 0.5;
+
+// The interval at which the latency statistics are logged, in seconds.
+static const double STATISTICS_REPORT_INTERVAL = 10.0;
+
+// The queueing delay of received packets is counted in buckets of 0.1 ms up to 100 ms.
+static const int64_t QUEUEING_DELAY_BUCKET_WIDTH = 100000;
+static const uint32_t QUEUEING_DELAY_BUCKET_COUNT = 1000;
+
+GameClient::GameClient(unsigned int frameRate, const Impairment& inbound, const Impairment& outbound, const char *address, uint16_t port, Renderer& renderer, VirtualNetwork* network)
 : Game(frameRate, renderer)
+, localSpaceShipPool_(1)
+, remoteSpaceShipPool_()
+, remoteLaserBoltPool_()
+, explosionPool_()
 , world_()
-, inputHandler_(30)
+, inputHandler_()
 , latencyEstimator_(10)
+, queueingDelay_(QUEUEING_DELAY_BUCKET_WIDTH, QUEUEING_DELAY_BUCKET_COUNT)
+, clockSync_()
+, snapshotTimeline_()
 , currentState(new GameClient::Connecting{this})
 , nextState(nullptr)
 , bufferedQueue_(1000)
-, latencyEmulator_(bufferedQueue_, emulatedLatency, stdDevLatencyMean)
-, transceiver_(latencyEmulator_)
+, latencyEmulator_(bufferedQueue_, inbound, outbound)
+, transceiver_(0, latencyEmulator_, network)
 , serverEndpoint_(boost::asio::ip::address::from_string(address), port)
 , playerId_(PROTOCOL_INVALID_PLAYER_ID)
 , objectId_(PROTOCOL_INVALID_OBJECT_ID) {
+    transceiver_.setSendEmulator(&latencyEmulator_);
+}
+
+uint32_t GameClient::getPlayerId() const {
+    return playerId_;
+}
+
+const LatencyEstimator& GameClient::getLatencyEstimator() const {
+    return latencyEstimator_;
 }
 
 void GameClient::update(const Clock& clock) {
     currentState->handleWillUpdateWorld(clock);
-    world_.update(frameDuration_);
+    snapshotTimeline_.update(clockSync_.toRemoteTime(clock.getFrameStart()));
+    world_.update(tickDuration_);
     processIncomingPackets(clock);
-    renderFrame();
     currentState->sendOutgoingPackets(clock);
     if (nextState) {
         currentState = nextState;
@@ -39,17 +62,17 @@ void GameClient::update(const Clock& clock) {
     }
 }
 
-void GameClient::handleEvent(SDL_Event& event, bool& running) {
+void GameClient::handleEvent(SDL_Event& event, int64_t eventTime, bool& running) {
     switch(event.type) {
     case SDL_KEYDOWN:
         if (event.key.keysym.sym == SDLK_ESCAPE) {
             running = false;
         } else {
-            inputHandler_.handleInput(KeyAction::Down, event.key.keysym.sym);
+            inputHandler_.handleInput(KeyAction::Down, event.key.keysym.sym, eventTime);
         }
         break;
     case SDL_KEYUP:
-        inputHandler_.handleInput(KeyAction::Up, event.key.keysym.sym);
+        inputHandler_.handleInput(KeyAction::Up, event.key.keysym.sym, eventTime);
         break;
     default:
         break;
@@ -61,8 +84,15 @@ void GameClient::setState(StatePtr& newState) {
 }
 
 void GameClient::processIncomingPackets(const Clock& clock) {
-    auto packet = bufferedQueue_.dequeue();
-    if (packet) {
+    // A STATE update comes in several packets, so all that arrived are handled,
+    // up to one that changes the state, which takes over with the next tick.
+    while (!nextState) {
+        auto packet = bufferedQueue_.dequeue();
+        if (!packet) {
+            break;
+        }
+        // The time from the arrival at the socket until now is spent in queues.
+        queueingDelay_.add(clock.now() - clock.toTime(packet->getReceiveTime()));
         uint32_t magicNumber = 0;
         packet->read(magicNumber);
         if (magicNumber == PROTOCOL_MAGIC_NUMBER) {
@@ -80,28 +110,33 @@ void GameClient::processIncomingPackets(const Clock& clock) {
     }
 }
 
-void GameClient::renderFrame() {
+void GameClient::render(float alpha) {
     renderer_.clear(0.25f, 0.25f, 0.25f);
-    world_.draw(renderer_);
+    world_.draw(renderer_, alpha);
     renderer_.present();
 }
 
 GameObject* GameClient::createNewGameObject(uint32_t classId, uint32_t objectId) {
     GameObjectPtr gameObjectPtr;
     if (objectId == objectId_) {
-        gameObjectPtr = GameObjectPtr(new LocalSpaceShip(renderer_, inputHandler_));
+        gameObjectPtr = localSpaceShipPool_.create(renderer_, world_.getKinematics(), inputHandler_);
     } else {
         if (classId == SpaceShip::ClassId) {
-            gameObjectPtr = GameObjectPtr(new RemoteSpaceShip(renderer_, latencyEstimator_, frameDuration_));
+            gameObjectPtr = remoteSpaceShipPool_.create(renderer_, world_.getKinematics(), snapshotTimeline_);
         } else if (classId == LaserBolt::ClassId) {
-            gameObjectPtr = GameObjectPtr(new RemoteLaserBolt(renderer_, latencyEstimator_, frameDuration_));
+            gameObjectPtr = remoteLaserBoltPool_.create(renderer_, world_.getKinematics(), snapshotTimeline_);
         } else if (classId == Explosion::ClassId) {
-            gameObjectPtr = GameObjectPtr(new Explosion(renderer_, Vector2d(0, 0)));
+            gameObjectPtr = explosionPool_.create(renderer_, Vector2d(0, 0));
         }
-        // gameObjectPtr = GameObjectRegistry::get().createGameObject(classId, renderer_);
+        // gameObjectPtr = GameObjectRegistry::get().createGameObject(classId, renderer_, world_.getKinematics());
     }
-    world_.add(objectId, gameObjectPtr);
-    return gameObjectPtr.get();
+    auto gameObject = gameObjectPtr.get();
+    world_.add(objectId, std::move(gameObjectPtr));
+    return gameObject;
+}
+
+int64_t GameClient::estimateServerTime(int64_t localTime) const {
+    return clockSync_.isSynchronized() ? clockSync_.toRemoteTime(localTime) : snapshotTimeline_.getSnapshotTime();
 }
 
 GameClient::State::State(GameClient* gameClient)
@@ -139,8 +174,8 @@ void GameClient::Connecting::sendOutgoingPackets(const Clock& clock) {
 }
 
 void GameClient::Connecting::sendHello(const Clock& clock) {
-    const auto now = clock.getTime();
-    if (now > lastHelloTime_ + PROTOCOL_HELLO_INTERVAL) {
+    const auto now = clock.getFrameStart();
+    if (now > lastHelloTime_ + Clock::toNanoseconds(PROTOCOL_HELLO_INTERVAL)) {
         auto packet = gameClient_->bufferedQueue_.pop();
         if (packet) {
             createHelloPacket(packet, gameClient_->serverEndpoint_);
@@ -156,12 +191,17 @@ void GameClient::Connecting::sendHello(const Clock& clock) {
 GameClient::Connected::Connected(GameClient* gameClient)
 : State(gameClient)
 , lastInputTime_(0)
+, inputPacketCount_(0)
 , lastTickTime_(0)
-, objectIdToGameObjectMap_() {
+, lastStatisticsReport_(0)
+, hasStateTime_(false)
+, stateTime_(0)
+, receivedParts_()
+, receivedObjectIds_() {
 }
 
-void GameClient::Connected::handleWillUpdateWorld(const Clock& clock) {
-    gameClient_->inputHandler_.update(clock.getGameTime());
+void GameClient::Connected::handleWillUpdateWorld(const Clock&) {
+    gameClient_->inputHandler_.update(gameClient_->getTick(), gameClient_->tickDuration_);
 }
 
 void GameClient::Connected::handleIncomingPacket(Packet* packet, const Clock& clock) {
@@ -169,7 +209,7 @@ void GameClient::Connected::handleIncomingPacket(Packet* packet, const Clock& cl
     packet->read(packetType);
     switch (packetType) {
     case PROTOCOL_PACKET_TYPE_STATE:
-        handleState(packet);
+        handleState(packet, clock);
         break;
     case PROTOCOL_PACKET_TYPE_TOCK:
         handleTock(packet, clock);
@@ -180,24 +220,38 @@ void GameClient::Connected::handleIncomingPacket(Packet* packet, const Clock& cl
     }
 }
 
-void GameClient::Connected::handleState(Packet* packet) {
-    float latestInputTime = 0.0f;
-    packet->read(latestInputTime);
+void GameClient::Connected::handleState(Packet* packet, const Clock& clock) {
+    uint32_t latestInputTick = 0, serverTime = 0;
+    float timeScale = 1.0f;
+    packet->read(latestInputTick);
+    packet->read(timeScale);
+    packet->read(serverTime);
+    uint8_t part = 0, partCount = 1;
+    packet->read(part);
+    packet->read(partCount);
+    // The server asks to run the ticks slightly faster or slower to keep its input buffer shallow.
+    gameClient_->setTimeScale(std::max(0.9f, std::min(timeScale, 1.1f)));
 
     auto& moveList = gameClient_->inputHandler_.getMoveList();
-    moveList.removeMovesUntil(latestInputTime);
+    moveList.removeMovesUntil(latestInputTick);
 
-    std::set<uint32_t> gameObjectsToRemove;
-    gameClient_->world_.forEachGameObject([&gameObjectsToRemove] (uint32_t objectId, GameObject*) {
-        gameObjectsToRemove.insert(objectId);
-    });
+    // A large update comes in several parts. The first part that arrives starts it.
+    if (!hasStateTime_ || serverTime != stateTime_) {
+        hasStateTime_ = true;
+        stateTime_ = serverTime;
+        receivedParts_.reset();
+        receivedObjectIds_.clear();
+        const auto arrivalTime = clock.toTime(packet->getReceiveTime());
+        gameClient_->snapshotTimeline_.addSnapshot(fromProtocolTime(serverTime, gameClient_->estimateServerTime(arrivalTime)), gameClient_->clockSync_.toRemoteTime(arrivalTime));
+    }
+    receivedParts_.set(part);
 
     uint32_t gameObjectCount = 0;
     packet->read(gameObjectCount);
     for (uint32_t i = 0; i < gameObjectCount; i++) {
         uint32_t objectId = 0, classId = 0;
         packet->read(objectId);
-        gameObjectsToRemove.erase(objectId);
+        receivedObjectIds_.push_back(objectId);
         packet->read(classId);
         auto gameObject = gameClient_->world_.getGameObject(objectId);
         if (gameObject == nullptr) {
@@ -206,40 +260,75 @@ void GameClient::Connected::handleState(Packet* packet) {
         gameObject->read(packet);
     }
 
-    for (const auto objectId : gameObjectsToRemove) {
-        gameClient_->world_.remove(objectId);
+    // Objects can only be missing from the update once all of its parts are in.
+    if (receivedParts_.count() < partCount) {
+        return;
     }
+    std::sort(receivedObjectIds_.begin(), receivedObjectIds_.end());
+    gameClient_->world_.removeGameObjectIf([this] (uint32_t objectId, GameObject*) {
+        return !std::binary_search(receivedObjectIds_.begin(), receivedObjectIds_.end(), objectId);
+    });
 }
 
 void GameClient::Connected::handleTock(Packet* packet, const Clock& clock) {
-    float timeStamp = 0.0f;
-    packet->read(timeStamp);
-    const float roundTripTime = clock.getTime() - timeStamp;
+    uint32_t originate = 0, receive = 0, transmit = 0;
+    packet->read(originate);
+    packet->read(receive);
+    packet->read(transmit);
+    // The time the TOCK waited in the queues of the client is not part of the round trip.
+    const auto arrivalTime = clock.toTime(packet->getReceiveTime());
+    const auto originateTime = fromProtocolTime(originate, arrivalTime);
+    const auto receiveTime = fromProtocolTime(receive, gameClient_->estimateServerTime(arrivalTime));
+    const auto transmitTime = fromProtocolTime(transmit, receiveTime);
+    const auto roundTripTime = Clock::toSeconds((arrivalTime - originateTime) - (transmitTime - receiveTime));
     gameClient_->latencyEstimator_.addRTT(roundTripTime);
+
+    // The snapshot timeline runs on the server clock, so it moves along with
+    // every new estimate of the offset.
+    auto& clockSync = gameClient_->clockSync_;
+    const auto oldOffset = clockSync.getOffset(arrivalTime);
+    clockSync.addSample(originateTime, receiveTime, transmitTime, arrivalTime);
+    gameClient_->snapshotTimeline_.shiftArrivalClock(clockSync.getOffset(arrivalTime) - oldOffset);
+    DEBUG("Clock offset {0} s, drift {1} ppm, sync error {2} s, one-way delay {3} s.", Clock::toSeconds(clockSync.getOffset(arrivalTime)), clockSync.getDrift() * 1e6f, clockSync.getSyncError(), Clock::toSeconds(gameClient_->snapshotTimeline_.getTransitTime()));
+    const auto& latency = gameClient_->latencyEstimator_;
+    DEBUG("Round trip time {0} s, variation {1} s, min {2} s, P50 {3} s, P95 {4} s, P99 {5} s.", latency.getSmoothedRTT(), latency.getRTTVariation(), latency.getMinRTT(), latency.getMedianRTT(), latency.getP95RTT(), latency.getP99RTT());
 }
 
 void GameClient::Connected::sendOutgoingPackets(const Clock& clock) {
-    const auto now = clock.getTime();
-    if (now > lastInputTime_ + gameClient_->inputHandler_.getSampleInterval()) {
-        if (sendInput()) {
+    const auto now = clock.getFrameStart();
+    // A change of the input goes out right away, unless INPUT was just sent, in
+    // which case it waits for the changes that follow shortly. Steady input is
+    // only repeated as a heartbeat, because the server keeps applying it.
+    const auto sinceInput = now - lastInputTime_;
+    const auto changed = gameClient_->inputHandler_.hasUnsentChanges();
+    if ((changed && sinceInput >= Clock::toNanoseconds(PROTOCOL_INPUT_COALESCE_WINDOW)) || sinceInput >= Clock::toNanoseconds(PROTOCOL_INPUT_HEARTBEAT)) {
+        if (sendInput(clock)) {
             lastInputTime_ = now;
+            inputPacketCount_++;
         }
     }
 
-    if (now > lastTickTime_ + 0.5f) {
+    if (now > lastTickTime_ + Clock::toNanoseconds(TICK_INTERVAL)) {
         if (sendTick(clock)) {
             lastTickTime_ = now;
         }
     }
+
+    if (now > lastStatisticsReport_ + Clock::toNanoseconds(STATISTICS_REPORT_INTERVAL)) {
+        reportStatistics(clock);
+    }
 }
 
-bool GameClient::Connected::sendInput() {
+bool GameClient::Connected::sendInput(const Clock& clock) {
     auto& moveList = gameClient_->inputHandler_.getMoveList();
     if (moveList.getCount() > 0) {
         auto packet = gameClient_->bufferedQueue_.pop();
         if (packet) {
-            createInputPacket(packet, gameClient_->playerId_, gameClient_->serverEndpoint_, moveList);
+            // Tells the server which moment of its world the player is looking at.
+            const auto viewTime = gameClient_->snapshotTimeline_.getRenderTime();
+            createInputPacket(packet, gameClient_->playerId_, gameClient_->serverEndpoint_, moveList, viewTime);
             gameClient_->transceiver_.sendTo(packet);
+            gameClient_->inputHandler_.handleMovesSent(moveList.getLatestTick(), clock.now());
             return true;
         } else {
             WARN("Failed to send INPUT to server: empty packet pool.");
@@ -251,7 +340,7 @@ bool GameClient::Connected::sendInput() {
 bool GameClient::Connected::sendTick(const Clock& clock) {
     auto packet = gameClient_->bufferedQueue_.pop();
     if (packet) {
-        createTickPacket(packet, gameClient_->playerId_, clock.getTime(), gameClient_->serverEndpoint_);
+        createTickPacket(packet, gameClient_->playerId_, clock.now(), gameClient_->serverEndpoint_);
         gameClient_->transceiver_.sendTo(packet);
         return true;
     } else {
@@ -259,3 +348,26 @@ bool GameClient::Connected::sendTick(const Clock& clock) {
     }
     return false;
 }
+
+void GameClient::Connected::reportStatistics(const Clock& clock) {
+    const auto now = clock.getFrameStart();
+    if (lastStatisticsReport_ > 0) {
+        DEBUG("Sent {0} INPUT packets per second.", static_cast<float>(inputPacketCount_) / Clock::toSeconds(now - lastStatisticsReport_));
+    }
+    inputPacketCount_ = 0;
+    auto& latency = gameClient_->inputHandler_.getInputLatency();
+    if (latency.getCount() > 0) {
+        DEBUG("Input to send latency of {0} changes: mean {1} ms, P50 {2} ms, P95 {3} ms, max {4} ms.", latency.getCount(),
+              Clock::toSeconds(latency.getMean()) * 1000.0f, Clock::toSeconds(latency.getPercentile(0.5)) * 1000.0f,
+              Clock::toSeconds(latency.getPercentile(0.95)) * 1000.0f, Clock::toSeconds(latency.getMax()) * 1000.0f);
+        latency.clear();
+    }
+    auto& queueingDelay = gameClient_->queueingDelay_;
+    if (queueingDelay.getCount() > 0) {
+        DEBUG("Queueing delay of {0} received packets: mean {1} ms, P50 {2} ms, P95 {3} ms, max {4} ms.", queueingDelay.getCount(),
+              Clock::toSeconds(queueingDelay.getMean()) * 1000.0f, Clock::toSeconds(queueingDelay.getPercentile(0.5)) * 1000.0f,
+              Clock::toSeconds(queueingDelay.getPercentile(0.95)) * 1000.0f, Clock::toSeconds(queueingDelay.getMax()) * 1000.0f);
+        queueingDelay.clear();
+    }
+    lastStatisticsReport_ = now;
+}
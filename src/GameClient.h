@@ -3,36 +3,59 @@
 
 #include "Game.h"
 #include "World.h"
+#include "LocalSpaceShip.h"
+#include "RemoteSpaceShip.h"
+#include "RemoteLaserBolt.h"
+#include "Explosion.h"
+#include "GameObjectPool.h"
 #include "BufferedQueue.h"
 #include "InputHandler.h"
 #include "Transceiver.h"
 #include "LatencyEmulator.h"
 #include "LatencyEstimator.h"
+#include "SnapshotTimeline.h"
+#include "ClockSync.h"
+#include "Histogram.h"
 
+#include <bitset>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 class Renderer;
 class Clock;
 class Packet;
+class VirtualNetwork;
 
 class GameClient : public Game {
 public:
-    GameClient(unsigned int frameRate, unsigned int emulatedLatency, unsigned int stdDevLatencyMean, const char *address, uint16_t port, Renderer& renderer);
+    GameClient(unsigned int frameRate, const Impairment& inbound, const Impairment& outbound, const char *address, uint16_t port, Renderer& renderer, VirtualNetwork* network);
 
     GameClient(const GameClient&) = delete;
 
     GameClient& operator =(const GameClient&) = delete;
 
+    /** Returns the player ID the server gave, or PROTOCOL_INVALID_PLAYER_ID
+        while connecting.
+     */
+    uint32_t getPlayerId() const;
+
+    const LatencyEstimator& getLatencyEstimator() const;
+
 private:
     void update(const Clock& clock) override;
-    void handleEvent(SDL_Event& event, bool& running) override;
+    void render(float alpha) override;
+    void handleEvent(SDL_Event& event, int64_t eventTime, bool& running) override;
 
     void processIncomingPackets(const Clock& clock);
-    void renderFrame();
 
     GameObject* createNewGameObject(uint32_t classId, uint32_t objectId);
 
+    /** Returns the best estimate of the server clock at a local time. Time stamps
+        of the server are read relative to it.
+     */
+    int64_t estimateServerTime(int64_t localTime) const;
+
     class State {
     public:
         explicit State(GameClient* gameClient);
@@ -61,7 +84,7 @@ private:
         void sendHello(const Clock& clock);
         void handleWelcome(Packet* packet);
 
-        float lastHelloTime_;
+        int64_t lastHelloTime_;
     };
 
     class Connected : public State {
@@ -72,21 +95,36 @@ private:
         void sendOutgoingPackets(const Clock& clock) override;
 
     private:
-        bool sendInput();
+        bool sendInput(const Clock& clock);
         bool sendTick(const Clock& clock);
-        void handleState(Packet* packet);
+        void reportStatistics(const Clock& clock);
+        void handleState(Packet* packet, const Clock& clock);
         void handleTock(Packet* packet, const Clock& clock);
 
-        float lastInputTime_;
-        float lastTickTime_;
+        int64_t lastInputTime_;
+        uint32_t inputPacketCount_;
+        int64_t lastTickTime_;
+        int64_t lastStatisticsReport_;
 
-        std::unordered_map<uint32_t, GameObjectPtr> objectIdToGameObjectMap_;
+        // The parts of the STATE update being received, and the objects in them.
+        bool hasStateTime_;
+        uint32_t stateTime_;
+        std::bitset<256> receivedParts_;
+        std::vector<uint32_t> receivedObjectIds_;
     };
 
+    GameObjectPool<LocalSpaceShip> localSpaceShipPool_;
+    GameObjectPool<RemoteSpaceShip> remoteSpaceShipPool_;
+    GameObjectPool<RemoteLaserBolt> remoteLaserBoltPool_;
+    GameObjectPool<Explosion> explosionPool_;
+
     World world_;
 
     InputHandler inputHandler_;
     LatencyEstimator latencyEstimator_;
+    Histogram queueingDelay_;
+    ClockSync clockSync_;
+    SnapshotTimeline snapshotTimeline_;
 
     StatePtr currentState;
     StatePtr nextState;
@@ -1,36 +1,33 @@
 #include "GameObject.h"
 #include "Vector2d.h"
-
-#include <SDL2/SDL.h>
+#include "Protocol.h"
 
 GameObject::GameObject()
-: dead_(false) {
+: dead_(false)
+, playerId_(PROTOCOL_INVALID_PLAYER_ID) {
 }
 
 bool GameObject::checkCollision(GameObject* gameObject) const {
-    const auto& pos1 = getPosition();
-    const SDL_Rect rect1 = {
-        static_cast<int>(pos1.getX()),
-        static_cast<int>(pos1.getY()),
-        static_cast<int>(getWidth()),
-        static_cast<int>(getHeight())
-    };
-
-    const auto& pos2 = gameObject->getPosition();
-    const SDL_Rect rect2 = {
-        static_cast<int>(pos2.getX()),
-        static_cast<int>(pos2.getY()),
-        static_cast<int>(gameObject->getWidth()),
-        static_cast<int>(gameObject->getHeight())
-    };
+    return intersects(getBounds(), gameObject->getBounds());
+}
 
-    return SDL_HasIntersection(&rect1, &rect2) == SDL_TRUE;
+Aabb GameObject::getBounds() const {
+    const auto pos = getPosition();
+    return Aabb(static_cast<int>(pos.getX()), static_cast<int>(pos.getY()), static_cast<int>(getWidth()), static_cast<int>(getHeight()));
 }
 
 void GameObject::kill() {
     dead_ = true;
 }
 
+void GameObject::setPlayerId(uint32_t playerId) {
+    playerId_ = playerId;
+}
+
+uint32_t GameObject::getPlayerId() const {
+    return playerId_;
+}
+
 bool GameObject::dead() const {
     return dead_;
 }
@@ -38,3 +35,21 @@ bool GameObject::dead() const {
 bool GameObject::doesCollide() const {
     return true;
 }
+
+GameObjectDeleter::GameObjectDeleter()
+: release_(nullptr)
+, pool_(nullptr) {
+}
+
+GameObjectDeleter::GameObjectDeleter(ReleaseFunction release, void* pool)
+: release_(release)
+, pool_(pool) {
+}
+
+void GameObjectDeleter::operator()(GameObject* gameObject) const {
+    if (release_ != nullptr) {
+        release_(pool_, gameObject);
+    } else {
+        delete gameObject;
+    }
+}
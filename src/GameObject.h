@@ -1,7 +1,10 @@
 #ifndef _GameObject_H
 #define _GameObject_H
 
+#include "Aabb.h"
+
 #include <memory>
+#include <cstdint>
 
 class Renderer;
 class Packet;
@@ -15,17 +18,28 @@ public:
 
     bool checkCollision(GameObject* gameObject) const;
 
+    Aabb getBounds() const;
+
     void kill();
 
+    void setPlayerId(uint32_t playerId);
+
+    uint32_t getPlayerId() const;
+
     virtual void update(float elapsed) = 0;
 
-    virtual void draw(Renderer& renderer) = 0;
+    /** Draws the object.
+
+        \param renderer the renderer to draw with.
+        \param alpha how far the time has advanced from the last tick towards the next one.
+     */
+    virtual void draw(Renderer& renderer, float alpha) = 0;
 
     virtual void write(Packet* packet) = 0;
 
     virtual void read(Packet* packet) = 0;
 
-    virtual const Vector2d& getPosition() const = 0;
+    virtual Vector2d getPosition() const = 0;
 
     virtual unsigned int getWidth() const = 0;
 
@@ -39,8 +53,29 @@ public:
 
 private:
     bool dead_;
+
+    uint32_t playerId_;
+};
+
+/** Destroys a game object, either by handing it back to the pool it was created from
+    or, if it was not created from a pool, by deleting it.
+ */
+class GameObjectDeleter {
+public:
+    using ReleaseFunction = void (*)(void* pool, GameObject* gameObject);
+
+    GameObjectDeleter();
+
+    GameObjectDeleter(ReleaseFunction release, void* pool);
+
+    void operator()(GameObject* gameObject) const;
+
+private:
+    ReleaseFunction release_;
+
+    void* pool_;
 };
 
-using GameObjectPtr = std::shared_ptr<GameObject>;
+using GameObjectPtr = std::unique_ptr<GameObject, GameObjectDeleter>;
 
 #endif  // _GameObject_H
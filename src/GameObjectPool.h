@@ -0,0 +1,113 @@
+#ifndef _GameObjectPool_H
+#define _GameObjectPool_H
+
+#include "GameObject.h"
+
+#include <cassert>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+/** A typed pool of game objects.
+
+    Objects are constructed in place in fixed-size chunks and go back to a free list
+    when their owning pointer is destroyed. Once the pool has grown to the peak number
+    of live objects, creating and destroying objects no longer touches the heap. The
+    pool must outlive all objects created from it.
+ */
+template<typename T>
+class GameObjectPool {
+public:
+    using Ptr = std::unique_ptr<T, GameObjectDeleter>;
+
+    /** Constructor
+
+        \param chunkSize the number of objects allocated at once when the pool grows.
+     */
+    explicit GameObjectPool(uint32_t chunkSize = 64)
+    : chunkSize_(chunkSize)
+    , chunks_()
+    , free_()
+    , count_(0) {
+        assert(chunkSize_ > 0);
+    }
+
+    ~GameObjectPool() {
+        assert(count_ == 0);
+    }
+
+    GameObjectPool(const GameObjectPool&) = delete;
+
+    GameObjectPool& operator =(const GameObjectPool&) = delete;
+
+    /** Grows the pool so that it can hold at least a given number of objects.
+
+        \param count the number of objects.
+     */
+    void reserve(uint32_t count) {
+        while (getCapacity() < count) {
+            grow();
+        }
+    }
+
+    /** Constructs a new object in the pool.
+
+        \param args the arguments passed to the constructor of T.
+        \return an owning pointer that hands the object back to the pool.
+     */
+    template<typename... Args>
+    Ptr create(Args&&... args) {
+        if (free_.empty()) {
+            grow();
+        }
+        auto object = new (free_.back()) T(std::forward<Args>(args)...);
+        free_.pop_back();
+        count_++;
+        return Ptr(object, GameObjectDeleter(&GameObjectPool::release, this));
+    }
+
+    /** Returns the number of live objects.
+     */
+    uint32_t getCount() const {
+        return count_;
+    }
+
+    /** Returns the number of objects the pool can hold without growing.
+     */
+    uint32_t getCapacity() const {
+        return static_cast<uint32_t>(chunks_.size()) * chunkSize_;
+    }
+
+private:
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    void grow() {
+        chunks_.emplace_back(new Storage[chunkSize_]);
+        free_.reserve(getCapacity());
+        auto chunk = chunks_.back().get();
+        for (auto i = chunkSize_; i > 0; i--) {
+            free_.push_back(&chunk[i - 1]);
+        }
+    }
+
+    static void release(void* pool, GameObject* gameObject) {
+        auto self = static_cast<GameObjectPool*>(pool);
+        auto object = static_cast<T*>(gameObject);
+        object->~T();
+        self->free_.push_back(object);
+        self->count_--;
+    }
+
+    const uint32_t chunkSize_;
+
+    std::vector<std::unique_ptr<Storage[]>> chunks_;
+
+    std::vector<void*> free_;
+
+    uint32_t count_;
+};
+
+#endif  // _GameObjectPool_H
@@ -8,8 +8,9 @@
 #include <functional>
 
 class Renderer;
+class Kinematics;
 
-using CreateInstanceFunction = std::function<GameObjectPtr (const Renderer&)>;
+using CreateInstanceFunction = std::function<GameObjectPtr (const Renderer&, Kinematics&)>;
 
 class GameObjectRegistry {
 public:
@@ -19,10 +20,10 @@ public:
         createInstanceFunctionMap_[T::ClassId] = T::createInstance;
     }
 
-    GameObjectPtr createGameObject(uint32_t classId, const Renderer& renderer) const {
+    GameObjectPtr createGameObject(uint32_t classId, const Renderer& renderer, Kinematics& kinematics) const {
         auto itr = createInstanceFunctionMap_.find(classId);
         if (itr != createInstanceFunctionMap_.end()) {
-            return (*itr).second(renderer);
+            return (*itr).second(renderer, kinematics);
         }
         return nullptr;
     }
@@ -11,14 +11,15 @@
 #include "Explosion.h"
 
 #include <unordered_set>
+#include <utility>
 
-GamePeer::GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, unsigned int emulatedLatency, unsigned int stdDevMeanLatency, Renderer& renderer, unsigned short port)
+GamePeer::GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, const Impairment& inbound, const Impairment& outbound, Renderer& renderer, unsigned short port, VirtualNetwork* network)
 : Game(frameRate, renderer)
 , width_(width)
 , height_(height)
 , world_(width, height, [this] (uint32_t objectId1, const GameObject* gameObject1, uint32_t objectId2, const GameObject* gameObject2) { return confirmCollision(objectId1, gameObject1, objectId2, gameObject2); })
 , updateInterval_(1.0f/static_cast<float>(updateRate))
-, inputHandler_(30)
+, inputHandler_()
 , latencyEstimator_(10)
 , currentState(nullptr)
 , nextState(nullptr)
@@ -26,19 +27,20 @@ GamePeer::GamePeer(unsigned int width, unsigned int height, unsigned int frameRa
 , playerId_(1)
 , objectId_(PROTOCOL_INVALID_OBJECT_ID)
 , bufferedQueue_(1000)
-, latencyEmulator_(bufferedQueue_, emulatedLatency, stdDevMeanLatency)
-, transceiver_(port, latencyEmulator_)
+, latencyEmulator_(bufferedQueue_, inbound, outbound)
+, transceiver_(port, latencyEmulator_, network)
 , masterPeerEndpoint_() {
+    transceiver_.setSendEmulator(&latencyEmulator_);
     currentState.reset(new GamePeer::Accepting{this});
 }
 
-GamePeer::GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, unsigned int emulatedLatency, unsigned int stdDevMeanLatency, Renderer& renderer, const char* address, unsigned short port)
+GamePeer::GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, const Impairment& inbound, const Impairment& outbound, Renderer& renderer, const char* address, unsigned short port, VirtualNetwork* network)
 : Game(frameRate, renderer)
 , width_(width)
 , height_(height)
 , world_(width, height, [this] (uint32_t objectId1, const GameObject* gameObject1, uint32_t objectId2, const GameObject* gameObject2) { return confirmCollision(objectId1, gameObject1, objectId2, gameObject2); })
 , updateInterval_(1.0f/static_cast<float>(updateRate))
-, inputHandler_(30)
+, inputHandler_()
 , latencyEstimator_(10)
 , currentState(nullptr)
 , nextState(nullptr)
@@ -46,17 +48,26 @@ GamePeer::GamePeer(unsigned int width, unsigned int height, unsigned int frameRa
 , playerId_(PROTOCOL_INVALID_PLAYER_ID)
 , objectId_(PROTOCOL_INVALID_OBJECT_ID)
 , bufferedQueue_(1000)
-, latencyEmulator_(bufferedQueue_, emulatedLatency, stdDevMeanLatency)
-, transceiver_(latencyEmulator_)
+, latencyEmulator_(bufferedQueue_, inbound, outbound)
+, transceiver_(0, latencyEmulator_, network)
 , masterPeerEndpoint_(boost::asio::ip::address::from_string(address), port) {
+    transceiver_.setSendEmulator(&latencyEmulator_);
     currentState.reset(new GamePeer::Connecting{this});
 }
 
+uint32_t GamePeer::getPlayerId() const {
+    return playerId_;
+}
+
+uint32_t GamePeer::getPeerCount() const {
+    return peerRegistry_.getCount();
+}
+
 void GamePeer::update(const Clock& clock) {
     currentState->handleWillUpdateWorld(clock);
-    world_.update(frameDuration_);
+    peerRegistry_.updateSnapshotTimelines(clock.getFrameStart());
+    world_.update(tickDuration_);
     processIncomingPackets(clock);
-    renderFrame();
     currentState->sendOutgoingPackets(clock);
     if (nextState) {
         currentState = nextState;
@@ -64,17 +75,17 @@ void GamePeer::update(const Clock& clock) {
     }
 }
 
-void GamePeer::handleEvent(SDL_Event &event, bool& running) {
+void GamePeer::handleEvent(SDL_Event &event, int64_t eventTime, bool& running) {
     switch(event.type) {
     case SDL_KEYDOWN:
         if (event.key.keysym.sym == SDLK_ESCAPE) {
             running = false;
         } else {
-            inputHandler_.handleInput(KeyAction::Down, event.key.keysym.sym);
+            inputHandler_.handleInput(KeyAction::Down, event.key.keysym.sym, eventTime);
         }
         break;
     case SDL_KEYUP:
-        inputHandler_.handleInput(KeyAction::Up, event.key.keysym.sym);
+        inputHandler_.handleInput(KeyAction::Up, event.key.keysym.sym, eventTime);
         break;
     default:
         break;
@@ -86,8 +97,13 @@ void GamePeer::setState(StatePtr& newState) {
 }
 
 void GamePeer::processIncomingPackets(const Clock& clock) {
-    auto packet = bufferedQueue_.dequeue();
-    if (packet) {
+    // The packets of all peers share the queue, so all that arrived are handled,
+    // up to one that changes the state, which takes over with the next tick.
+    while (!nextState) {
+        auto packet = bufferedQueue_.dequeue();
+        if (!packet) {
+            break;
+        }
         uint32_t magicNumber = 0;
         packet->read(magicNumber);
         if (magicNumber == PROTOCOL_MAGIC_NUMBER) {
@@ -105,9 +121,9 @@ void GamePeer::processIncomingPackets(const Clock& clock) {
     }
 }
 
-void GamePeer::renderFrame() {
+void GamePeer::render(float alpha) {
     renderer_.clear(0.25f, 0.25f, 0.25f);
-    world_.draw(renderer_);
+    world_.draw(renderer_, alpha);
     renderer_.present();
 }
 
@@ -140,18 +156,17 @@ void GamePeer::Peering::handleIncomingPacket(Packet* packet, const Clock& clock)
     }
 }
 
-void GamePeer::Peering::handleTick(Packet* packet, const Clock&) {
+void GamePeer::Peering::handleTick(Packet* packet, const Clock& clock) {
     uint32_t playerId = PROTOCOL_INVALID_PLAYER_ID;
     packet->read(playerId);
     if (gamePeer_->peerRegistry_.verifyPeer(playerId, packet->getEndpoint())) {
-        // TODO: Store time
-
-        float timeStamp = 0.0f;
+        const auto receiveTime = clock.toTime(packet->getReceiveTime());
+        uint32_t timeStamp = 0;
         packet->read(timeStamp);
 
         auto replyPacket = gamePeer_->bufferedQueue_.pop();
         if (replyPacket) {
-            createTockPacket(replyPacket, timeStamp, packet->getEndpoint());
+            createTockPacket(replyPacket, timeStamp, receiveTime, clock.now(), packet->getEndpoint());
             gamePeer_->transceiver_.sendTo(replyPacket);
         } else {
             WARN("Failed to send TOCK to peer {0}: empty packet pool.", packet->getEndpoint());
@@ -162,15 +177,21 @@ void GamePeer::Peering::handleTick(Packet* packet, const Clock&) {
 }
 
 void GamePeer::Peering::handleTock(Packet* packet, const Clock& clock) {
-    float timeStamp = 0.0f;
-    packet->read(timeStamp);
-    const float roundTripTime = clock.getTime() - timeStamp;
-    gamePeer_->peerRegistry_.addRoundTripTime(packet->getEndpoint(), roundTripTime);
+    uint32_t originate = 0, receive = 0, transmit = 0;
+    packet->read(originate);
+    packet->read(receive);
+    packet->read(transmit);
+    // Only the difference of the two times of the peer is needed, so they are
+    // read relative to each other.
+    const auto now = clock.toTime(packet->getReceiveTime());
+    const auto receiveTime = fromProtocolTime(receive, 0);
+    const auto roundTripTime = (now - fromProtocolTime(originate, now)) - (fromProtocolTime(transmit, receiveTime) - receiveTime);
+    gamePeer_->peerRegistry_.addRoundTripTime(packet->getEndpoint(), Clock::toSeconds(roundTripTime));
 }
 
 void GamePeer::Peering::sendOutgoingPackets(const Clock& clock) {
-    const auto now = clock.getTime();
-    if (now > lastTickTime_ + 1.0f) {
+    const auto now = clock.getFrameStart();
+    if (now > lastTickTime_ + Clock::toNanoseconds(1.0)) {
         sendTick(clock);
         lastTickTime_ = now;
     }
@@ -180,7 +201,7 @@ void GamePeer::Peering::sendTick(const Clock& clock) {
     gamePeer_->peerRegistry_.forEachPeer([this, &clock] (const Peer& peer) {
         auto packet = gamePeer_->bufferedQueue_.pop();
         if (packet) {
-            createTickPacket(packet, gamePeer_->playerId_, clock.getTime(), peer.endpoint);
+            createTickPacket(packet, gamePeer_->playerId_, clock.now(), peer.endpoint);
             gamePeer_->transceiver_.sendTo(packet);
         } else {
             WARN("Failed to send TICK to server: empty packet pool.");
@@ -306,8 +327,8 @@ void GamePeer::Connecting::sendOutgoingPackets(const Clock& clock) {
 }
 
 void GamePeer::Connecting::sendHello(const Clock& clock) {
-    const auto now = clock.getTime();
-    if (now > lastHelloTime_ + PROTOCOL_HELLO_INTERVAL) {
+    const auto now = clock.getFrameStart();
+    if (now > lastHelloTime_ + Clock::toNanoseconds(PROTOCOL_HELLO_INTERVAL)) {
         auto packet = gamePeer_->bufferedQueue_.pop();
         if (packet) {
             createHelloPacket(packet, gamePeer_->masterPeerEndpoint_);
@@ -367,27 +388,27 @@ GamePeer::Playing::Playing(GamePeer* gamePeer)
     INFO("Playing");
 }
 
-void GamePeer::Playing::handleWillUpdateWorld(const Clock& clock) {
+void GamePeer::Playing::handleWillUpdateWorld(const Clock&) {
     static bool initialized_ = false;
 
-    gamePeer_->inputHandler_.update(clock.getGameTime());
+    gamePeer_->inputHandler_.update(gamePeer_->getTick(), gamePeer_->tickDuration_);
 
     if (!initialized_) {
-        auto gameObjectPtr = GameObjectPtr(new LocalSpaceShip(gamePeer_->renderer_, gamePeer_->inputHandler_,
-            [this, &clock] (SpaceShip* spaceShip, float lastShot) -> float {
-                auto laserBolt = GameObjectPtr(new LaserBolt(gamePeer_->renderer_, spaceShip->getPosition(), 50.0f * spaceShip->getLookAt()));
-                gamePeer_->world_.addLocalGameObject(nextObjectId_++, laserBolt);
+        auto gameObjectPtr = GameObjectPtr(new LocalSpaceShip(gamePeer_->renderer_, gamePeer_->world_.getKinematics(), gamePeer_->inputHandler_,
+            [this] (SpaceShip* spaceShip, int64_t lastShot) -> int64_t {
+                auto laserBolt = GameObjectPtr(new LaserBolt(gamePeer_->renderer_, gamePeer_->world_.getKinematics(), spaceShip->getPosition(), 50.0f * spaceShip->getLookAt()));
+                gamePeer_->world_.addLocalGameObject(nextObjectId_++, std::move(laserBolt));
                 return lastShot;
             }, Vector2d(randomValue(gamePeer_->width_), randomValue(gamePeer_->height_))));
-        gamePeer_->world_.addLocalGameObject(nextObjectId_++, gameObjectPtr);
+        gamePeer_->world_.addLocalGameObject(nextObjectId_++, std::move(gameObjectPtr));
         initialized_ = true;
     }
 }
 
-void GamePeer::Playing::handleIncomingPacketType(unsigned char packetType, Packet* packet, const Clock&) {
+void GamePeer::Playing::handleIncomingPacketType(unsigned char packetType, Packet* packet, const Clock& clock) {
     switch (packetType) {
     case PROTOCOL_PACKET_TYPE_STATE:
-        handleState(packet);
+        handleState(packet, clock);
         break;
     default:
         WARN("Received a packet with unexpected packet type {0} from {1}.", static_cast<unsigned int>(packetType), packet->getEndpoint());
@@ -395,10 +416,22 @@ void GamePeer::Playing::handleIncomingPacketType(unsigned char packetType, Packe
     }
 }
 
-void GamePeer::Playing::handleState(Packet* packet) {
-    float latestInputTime = 0.0f;
-    packet->read(latestInputTime);
-    assert(latestInputTime == 0.0f);
+void GamePeer::Playing::handleState(Packet* packet, const Clock& clock) {
+    if (!gamePeer_->peerRegistry_.isRegistered(packet->getEndpoint())) {
+        WARN("Received STATE from unknown peer {0}.", packet->getEndpoint());
+        return;
+    }
+
+    uint32_t latestInputTick = 0, peerTime = 0;
+    float timeScale = 1.0f;
+    packet->read(latestInputTick);
+    assert(latestInputTick == 0);
+    packet->read(timeScale);
+    packet->read(peerTime);
+    // The clock of the peer is only ever compared with itself, so its time
+    // stamps are read relative to the previous one.
+    const auto& timeline = gamePeer_->peerRegistry_.getSnapshotTimeline(packet->getEndpoint());
+    gamePeer_->peerRegistry_.addSnapshot(packet->getEndpoint(), fromProtocolTime(peerTime, timeline.getSnapshotTime()), clock.getFrameStart());
 
     std::unordered_set<uint32_t> gameObjectsToRemove;
     gamePeer_->world_.forEachRemoteGameObject(packet->getEndpoint(), [&gameObjectsToRemove] (uint32_t objectId, GameObject*) {
@@ -414,17 +447,16 @@ void GamePeer::Playing::handleState(Packet* packet) {
         packet->read(classId);
         auto gameObject = gamePeer_->world_.getRemoteGameObject(objectId);
         if (gameObject == nullptr) {
-            const auto& latencyEstimator = gamePeer_->peerRegistry_.getLatencyEstimator(packet->getEndpoint());
             GameObjectPtr gameObjectPtr;
             if (classId == SpaceShip::ClassId) {
-                gameObjectPtr = GameObjectPtr(new RemoteSpaceShip(gamePeer_->renderer_, latencyEstimator, gamePeer_->frameDuration_));
+                gameObjectPtr = GameObjectPtr(new RemoteSpaceShip(gamePeer_->renderer_, gamePeer_->world_.getKinematics(), timeline));
             } else if (classId == LaserBolt::ClassId) {
-                gameObjectPtr = GameObjectPtr(new RemoteLaserBolt(gamePeer_->renderer_, latencyEstimator, gamePeer_->frameDuration_));
+                gameObjectPtr = GameObjectPtr(new RemoteLaserBolt(gamePeer_->renderer_, gamePeer_->world_.getKinematics(), timeline));
             }else if (classId == Explosion::ClassId) {
                 gameObjectPtr = GameObjectPtr(new Explosion(gamePeer_->renderer_, Vector2d(0, 0)));
             }
-            gamePeer_->world_.addRemoteGameObject(objectId, gameObjectPtr, packet->getEndpoint());
             gameObject = gameObjectPtr.get();
+            gamePeer_->world_.addRemoteGameObject(objectId, std::move(gameObjectPtr), packet->getEndpoint());
         }
         gameObject->read(packet);
     }
@@ -437,13 +469,15 @@ void GamePeer::Playing::handleState(Packet* packet) {
 void GamePeer::Playing::sendOutgoingPackets(const Clock& clock) {
     Peering::sendOutgoingPackets(clock);
 
-    const auto now = clock.getTime();
-    if (now > lastStateUpdate_ + gamePeer_->updateInterval_) {
-        gamePeer_->peerRegistry_.forEachPeer([this] (const Peer& peer) {
+    const auto now = clock.getFrameStart();
+    if (now > lastStateUpdate_ + Clock::toNanoseconds(gamePeer_->updateInterval_)) {
+        gamePeer_->peerRegistry_.forEachPeer([this, now] (const Peer& peer) {
             auto packet = gamePeer_->bufferedQueue_.pop();
             if (packet) {
                 createStatePacket(packet, peer.endpoint);
-                packet->write(0.0f);
+                packet->write(uint32_t(0));
+                packet->write(1.0f);
+                packet->write(toProtocolTime(now));
                 packet->write(gamePeer_->world_.getLocalGameObjectCount());
                 gamePeer_->world_.forEachLocalGameObject([this, packet] (uint32_t objectId, GameObject* gameObject) {
                     uint32_t playerId = objectId / 1000;
@@ -465,7 +499,7 @@ void GamePeer::Playing::sendOutgoingPackets(const Clock& clock) {
 bool GamePeer::Playing::confirmCollision(uint32_t, const GameObject* gameObject1, uint32_t, const GameObject*) {
     if (gameObject1->getClassId() == SpaceShip::ClassId) {
         auto explosion = GameObjectPtr(new Explosion(gamePeer_->renderer_, gameObject1->getPosition()));
-        gamePeer_->world_.addLocalGameObject(nextObjectId_++, explosion);
+        gamePeer_->world_.addLocalGameObject(nextObjectId_++, std::move(explosion));
     }
     return true;
 }
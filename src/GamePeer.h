@@ -15,23 +15,33 @@
 class Renderer;
 class Clock;
 class Packet;
+class VirtualNetwork;
 
 class GamePeer : public Game {
 public:
-    GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, unsigned int emulatedLatency, unsigned int stdDevMeanLatency, Renderer& renderer, unsigned short port);
+    GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, const Impairment& inbound, const Impairment& outbound, Renderer& renderer, unsigned short port, VirtualNetwork* network);
 
-    GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, unsigned int emulatedLatency, unsigned int stdDevMeanLatency, Renderer& renderer, const char* masterAddress, unsigned short port);
+    GamePeer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, const Impairment& inbound, const Impairment& outbound, Renderer& renderer, const char* masterAddress, unsigned short port, VirtualNetwork* network);
 
     GamePeer(const GamePeer&) = delete;
 
     GamePeer& operator =(const GamePeer&) = delete;
 
+    /** Returns the player ID of this peer, or PROTOCOL_INVALID_PLAYER_ID
+        before the master invited it.
+     */
+    uint32_t getPlayerId() const;
+
+    /** Returns the number of other peers this peer knows.
+     */
+    uint32_t getPeerCount() const;
+
 private:
     void update(const Clock& clock) override;
-    void handleEvent(SDL_Event &event, bool& running) override;
+    void render(float alpha) override;
+    void handleEvent(SDL_Event &event, int64_t eventTime, bool& running) override;
 
     void processIncomingPackets(const Clock& clock);
-    void renderFrame();
 
     bool confirmCollision(uint32_t objectId1, const GameObject* gameObject1, uint32_t objectId2, const GameObject* gameObject2);
 
@@ -70,7 +80,7 @@ private:
         void handleTock(Packet* packet, const Clock& clock);
         void sendTick(const Clock& clock);
 
-        float lastTickTime_;
+        int64_t lastTickTime_;
     };
 
     class Accepting : public Peering {
@@ -95,7 +105,7 @@ private:
         void sendHello(const Clock& clock);
         void handleInvite(Packet* packet);
 
-        float lastHelloTime_;
+        int64_t lastHelloTime_;
     };
 
     class Waiting : public Peering {
@@ -118,11 +128,11 @@ private:
         bool confirmCollision(uint32_t objectId1, const GameObject* gameObject1, uint32_t objectId2, const GameObject* gameObject2) override;
 
     private:
-        void handleState(Packet* packet);
+        void handleState(Packet* packet, const Clock& clock);
 
         uint32_t nextObjectId_;
 
-        float lastStateUpdate_;
+        int64_t lastStateUpdate_;
     };
 
     const unsigned int width_;
@@ -2,61 +2,44 @@
 #define _GameServer_H
 
 #include "Game.h"
-#include "ServerWorld.h"
+#include "Room.h"
+#include "SnapshotEncoder.h"
+#include "TaskScheduler.h"
 #include "BufferedQueue.h"
-#include "ClientRegistry.h"
 #include "Transceiver.h"
 #include "LatencyEmulator.h"
 
-#include <unordered_map>
-#include <vector>
-
 class Renderer;
 class Clock;
-class Packet;
+class VirtualNetwork;
 
+/** Hosts a single room in a window. The world is simulated on a pool of threads
+    and the STATE packets are built on another one.
+ */
 class GameServer : public Game {
 public:
-    GameServer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, unsigned int emulatedLatency, unsigned int stdDevLatencyMean, uint16_t port, Renderer& renderer);
+    GameServer(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, const Impairment& inbound, const Impairment& outbound, uint16_t port, unsigned int threadCount, unsigned int encoderCount, std::size_t historyBudget, uint32_t seed, Renderer& renderer, VirtualNetwork* network);
+
+    /** Returns the number of clients in the room.
+     */
+    uint32_t getClientCount() const;
 
 private:
     void update(const Clock& clock) override;
-    void handleEvent(SDL_Event &event, bool& running) override;
+    void render(float alpha) override;
+    void handleEvent(SDL_Event &event, int64_t eventTime, bool& running) override;
 
     void processIncomingPackets(const Clock& clock);
-    void handlePacket(Packet* packet, const Clock& clock);
-    void handleHello(Packet* packet, const Clock& clock);
-    void handleInput(Packet* packet, const Clock& clock);
-    void handleTick(Packet* packet, const Clock& clock);
-
-    void checkForDisconnects(const Clock& clock);
-    void renderWorld();
-    void updateWorld();
-    void sendOutgoingPackets(const Clock& clock);
-    void sendStateUpdate(const Clock& clock);
-
-    bool confirmCollision(uint32_t objectId1, const GameObject* gameObject1, uint32_t objectId2, const GameObject* gameObject2);
-    void removedObject(uint32_t objectId);
-
-    const unsigned int width_;
-    const unsigned int height_;
-
-    ServerWorld world_;
-
-    const float updateInterval_;
 
-    uint32_t nextPlayerId_;
-    uint32_t nextObjectId_;
-    std::unordered_map<uint32_t, uint32_t> playerToObjectMap_;
-    std::unordered_map<uint32_t, uint32_t> objectToPlayerMap_;
+    TaskScheduler taskScheduler_;
 
     BufferedQueue bufferedQueue_;
     LatencyEmulator latencyEmulator_;
     Transceiver transceiver_;
 
-    ClientRegistry clientRegistry_;
+    SnapshotEncoder snapshotEncoder_;
 
-    float lastStateUpdate_;
+    Room room_;
 };
 
 #endif  // _GameServer_H
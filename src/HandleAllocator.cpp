@@ -0,0 +1,63 @@
+#include "HandleAllocator.h"
+
+const uint32_t HandleAllocator::IndexBits;
+const uint32_t HandleAllocator::GenerationBits;
+const uint32_t HandleAllocator::MaxCount;
+const uint32_t HandleAllocator::InvalidHandle;
+
+static const uint32_t INDEX_MASK = HandleAllocator::MaxCount - 1;
+static const uint32_t GENERATION_MASK = (1u << HandleAllocator::GenerationBits) - 1;
+
+static uint32_t makeHandle(uint32_t index, uint32_t generation) {
+    return (generation << HandleAllocator::IndexBits) | index;
+}
+
+HandleAllocator::HandleAllocator()
+: generations_()
+, live_()
+, freeIndices_() {
+}
+
+uint32_t HandleAllocator::allocate() {
+    uint32_t index = 0;
+    if (!freeIndices_.empty()) {
+        index = freeIndices_.back();
+        freeIndices_.pop_back();
+    } else if (generations_.size() < MaxCount) {
+        index = static_cast<uint32_t>(generations_.size());
+        generations_.push_back(1);
+        live_.push_back(false);
+    } else {
+        return InvalidHandle;
+    }
+    live_[index] = true;
+    return makeHandle(index, generations_[index]);
+}
+
+void HandleAllocator::release(uint32_t handle) {
+    if (isValid(handle)) {
+        const auto index = getIndex(handle);
+        // Generation 0 is skipped so that no handle is ever 0.
+        auto generation = (generations_[index] + 1) & GENERATION_MASK;
+        generations_[index] = generation == 0 ? 1 : generation;
+        live_[index] = false;
+        freeIndices_.push_back(index);
+    }
+}
+
+bool HandleAllocator::isValid(uint32_t handle) const {
+    const auto index = getIndex(handle);
+    return index < generations_.size() && live_[index] && generations_[index] == getGeneration(handle);
+}
+
+uint32_t HandleAllocator::getCount() const {
+    return static_cast<uint32_t>(generations_.size() - freeIndices_.size());
+}
+
+uint32_t HandleAllocator::getIndex(uint32_t handle) {
+    return handle & INDEX_MASK;
+}
+
+uint32_t HandleAllocator::getGeneration(uint32_t handle) {
+    return handle >> IndexBits;
+}
@@ -0,0 +1,64 @@
+#ifndef _HandleAllocator_H
+#define _HandleAllocator_H
+
+#include <vector>
+#include <cstdint>
+
+/** Hands out 32 bit handles made of a slot index and a generation.
+
+    Released slots are reused, so the handle space stays as small as the peak number
+    of live handles. The generation of a slot is bumped on every release, which makes
+    stale handles to a reused slot distinguishable from the current one. Handles are
+    never 0, so 0 can be used as the invalid handle.
+ */
+class HandleAllocator {
+public:
+    static const uint32_t IndexBits = 20;
+
+    static const uint32_t GenerationBits = 32 - IndexBits;
+
+    static const uint32_t MaxCount = 1u << IndexBits;
+
+    static const uint32_t InvalidHandle = 0;
+
+    /** Constructor
+     */
+    HandleAllocator();
+
+    /** Allocates a new handle.
+
+        \return the new handle, or InvalidHandle if all slots are in use.
+     */
+    uint32_t allocate();
+
+    /** Releases a handle. Releasing a handle that is not valid has no effect.
+
+        \param handle the handle to be released.
+     */
+    void release(uint32_t handle);
+
+    /** Returns true if the handle was allocated and has not been released since, otherwise false.
+     */
+    bool isValid(uint32_t handle) const;
+
+    /** Returns the number of live handles.
+     */
+    uint32_t getCount() const;
+
+    /** Returns the slot index of a handle.
+     */
+    static uint32_t getIndex(uint32_t handle);
+
+    /** Returns the generation of a handle.
+     */
+    static uint32_t getGeneration(uint32_t handle);
+
+private:
+    std::vector<uint32_t> generations_;
+
+    std::vector<bool> live_;
+
+    std::vector<uint32_t> freeIndices_;
+};
+
+#endif  // _HandleAllocator_H
@@ -0,0 +1,66 @@
+#include "Histogram.h"
+
+#include <algorithm>
+
+Histogram::Histogram(int64_t bucketWidth, uint32_t bucketCount)
+: bucketWidth_(std::max(bucketWidth, int64_t(1)))
+, buckets_(std::max(bucketCount, 1u), 0.0)
+, weight_(0.0)
+, sum_(0.0)
+, max_(0) {
+}
+
+void Histogram::add(int64_t value) {
+    value = std::max(value, int64_t(0));
+    const auto index = std::min(static_cast<std::size_t>(value / bucketWidth_), buckets_.size() - 1);
+    buckets_[index] += 1.0;
+    weight_ += 1.0;
+    sum_ += static_cast<double>(value);
+    max_ = std::max(max_, value);
+}
+
+uint64_t Histogram::getCount() const {
+    return static_cast<uint64_t>(weight_);
+}
+
+int64_t Histogram::getMean() const {
+    return weight_ > 0.0 ? static_cast<int64_t>(sum_ / weight_) : 0;
+}
+
+int64_t Histogram::getMax() const {
+    return max_;
+}
+
+int64_t Histogram::getPercentile(double fraction) const {
+    if (weight_ <= 0.0) {
+        return 0;
+    }
+    const auto rank = fraction * weight_;
+    auto cumulative = 0.0;
+    for (std::size_t i = 0; i < buckets_.size(); i++) {
+        cumulative += buckets_[i];
+        if (cumulative >= rank && cumulative > 0.0) {
+            return std::min(static_cast<int64_t>(i + 1) * bucketWidth_, max_);
+        }
+    }
+    return max_;
+}
+
+void Histogram::decay() {
+    weight_ /= 2.0;
+    if (weight_ < 1.0) {
+        clear();
+        return;
+    }
+    for (auto& bucket : buckets_) {
+        bucket /= 2.0;
+    }
+    sum_ /= 2.0;
+}
+
+void Histogram::clear() {
+    std::fill(buckets_.begin(), buckets_.end(), 0.0);
+    weight_ = 0.0;
+    sum_ = 0.0;
+    max_ = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef _Histogram_H
+#define _Histogram_H
+
+#include <vector>
+#include <cstdint>
+
+/** Counts values, e.g. latencies in nanoseconds, in buckets of equal width.
+
+    Values beyond the last bucket are counted in it, so percentiles above the
+    range report the range, while the mean and the maximum stay exact.
+ */
+class Histogram {
+public:
+    /** Constructor
+
+        \param bucketWidth the width of a bucket.
+        \param bucketCount the number of buckets.
+     */
+    Histogram(int64_t bucketWidth, uint32_t bucketCount);
+
+    /** Adds a value. Negative values are counted as 0.
+     */
+    void add(int64_t value);
+
+    /** Returns the number of values, as far as decay() has left them.
+     */
+    uint64_t getCount() const;
+
+    int64_t getMean() const;
+
+    int64_t getMax() const;
+
+    /** Returns the upper edge of the bucket that holds the given fraction of all
+        values, e.g. 0.95 for the 95th percentile, or 0 if there are no values.
+     */
+    int64_t getPercentile(double fraction) const;
+
+    /** Halves the weights of all values, so that older values weigh less than
+        the ones added afterwards. The weights are fractional, so that a single
+        outlier fades instead of vanishing. The mean is scaled along, the maximum
+        is kept. Once less than the weight of one value is left, it clears.
+     */
+    void decay();
+
+    void clear();
+
+private:
+    const int64_t bucketWidth_;
+
+    std::vector<double> buckets_;
+
+    double weight_;
+    double sum_;
+    int64_t max_;
+};
+
+#endif  // _Histogram_H
@@ -0,0 +1,222 @@
+#include "Impairment.h"
+#include "Clock.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+const uint32_t ImpairmentModel::MaxCopies;
+
+Impairment::Impairment()
+: latency(0)
+, jitter(0)
+, loss(0)
+, burstEnter(0)
+, burstExit(0)
+, burstLoss(0)
+, duplication(0)
+, reordering(0)
+, reorderDelay(0)
+, bandwidth(0)
+, queueSize(0)
+, seed(0)
+, trace()
+, traceSpeed(1.0f)
+, traceLoop(false) {
+}
+
+bool Impairment::isNone() const {
+    return latency <= 0.0f && jitter <= 0.0f && loss <= 0.0f && burstEnter <= 0.0f && duplication <= 0.0f && reordering <= 0.0f && bandwidth == 0 && !trace;
+}
+
+template<typename T>
+static T parseValue(const std::string& key, const std::string& value) {
+    try {
+        return boost::lexical_cast<T>(value);
+    } catch (const boost::bad_lexical_cast&) {
+        throw std::invalid_argument("invalid value '" + value + "' of " + key);
+    }
+}
+
+static float parseProbability(const std::string& key, const std::string& value) {
+    const auto probability = parseValue<float>(key, value);
+    if (!(probability >= 0.0f && probability <= 1.0f)) {
+        throw std::invalid_argument(key + " is not a probability");
+    }
+    return probability;
+}
+
+static float parseMilliseconds(const std::string& key, const std::string& value) {
+    const auto milliseconds = parseValue<float>(key, value);
+    if (!(milliseconds >= 0.0f)) {
+        throw std::invalid_argument(key + " is negative");
+    }
+    return milliseconds / 1000.0f;
+}
+
+Impairment parseImpairment(const std::string& settings) {
+    Impairment impairment;
+    std::istringstream stream(settings);
+    std::string setting;
+    while (std::getline(stream, setting, ',')) {
+        if (setting.empty()) {
+            continue;
+        }
+        const auto separator = setting.find('=');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument("missing value of " + setting);
+        }
+        const auto key = setting.substr(0, separator);
+        const auto value = setting.substr(separator + 1);
+        if (key == "latency") {
+            impairment.latency = parseMilliseconds(key, value);
+        } else if (key == "jitter") {
+            impairment.jitter = parseMilliseconds(key, value);
+        } else if (key == "loss") {
+            impairment.loss = parseProbability(key, value);
+        } else if (key == "burst-enter") {
+            impairment.burstEnter = parseProbability(key, value);
+        } else if (key == "burst-exit") {
+            impairment.burstExit = parseProbability(key, value);
+        } else if (key == "burst-loss") {
+            impairment.burstLoss = parseProbability(key, value);
+        } else if (key == "duplicate") {
+            impairment.duplication = parseProbability(key, value);
+        } else if (key == "reorder") {
+            impairment.reordering = parseProbability(key, value);
+        } else if (key == "reorder-delay") {
+            impairment.reorderDelay = parseMilliseconds(key, value);
+        } else if (key == "bandwidth") {
+            impairment.bandwidth = parseValue<uint32_t>(key, value) * 1000 / 8;
+        } else if (key == "queue") {
+            impairment.queueSize = parseValue<uint32_t>(key, value);
+        } else if (key == "seed") {
+            impairment.seed = parseValue<uint64_t>(key, value);
+        } else if (key == "trace") {
+            try {
+                impairment.trace = LatencyTrace::load(value);
+            } catch (const std::runtime_error& ex) {
+                throw std::invalid_argument(ex.what());
+            }
+        } else if (key == "trace-speed") {
+            impairment.traceSpeed = parseValue<float>(key, value);
+            if (!(impairment.traceSpeed > 0.0f)) {
+                throw std::invalid_argument(key + " is not positive");
+            }
+        } else if (key == "trace-loop") {
+            impairment.traceLoop = parseValue<bool>(key, value);
+        } else {
+            throw std::invalid_argument("unknown setting " + key);
+        }
+    }
+    return impairment;
+}
+
+ImpairmentModel::ImpairmentModel(const Impairment& impairment)
+: impairment_(impairment)
+, random_(impairment.seed != 0 ? impairment.seed : std::random_device()())
+, uniform_(0.0f, 1.0f)
+, normal_(0.0f, 1.0f)
+, burst_(false)
+, linkFree_(0)
+, traceStart_(-1)
+, lostCount_(0)
+, droppedCount_(0)
+, duplicatedCount_(0)
+, reorderedCount_(0) {
+}
+
+uint32_t ImpairmentModel::apply(int64_t now, uint32_t size, int64_t* releaseTimes) {
+    const auto traceSample = getTraceSample(now);
+    if (isLost() || (traceSample && traceSample->isLost())) {
+        lostCount_++;
+        return 0;
+    }
+
+    // The link sends one packet after the other at its bandwidth. A packet that
+    // would make the queue in front of it too long is dropped.
+    auto departure = now;
+    if (impairment_.bandwidth > 0) {
+        const auto start = std::max(now, linkFree_);
+        const auto queued = static_cast<double>(start - now) * 1e-9 * impairment_.bandwidth;
+        if (impairment_.queueSize > 0 && queued + size > impairment_.queueSize) {
+            droppedCount_++;
+            return 0;
+        }
+        linkFree_ = start + Clock::toNanoseconds(static_cast<double>(size) / impairment_.bandwidth);
+        departure = linkFree_;
+    }
+
+    if (traceSample) {
+        departure += traceSample->delay;
+    }
+
+    uint32_t count = 1;
+    releaseTimes[0] = departure + getDelay();
+    if (chance(impairment_.reordering)) {
+        releaseTimes[0] += Clock::toNanoseconds(impairment_.reorderDelay);
+        reorderedCount_++;
+    }
+    if (chance(impairment_.duplication)) {
+        releaseTimes[count++] = departure + getDelay();
+        duplicatedCount_++;
+    }
+    return count;
+}
+
+const Impairment& ImpairmentModel::getImpairment() const {
+    return impairment_;
+}
+
+uint64_t ImpairmentModel::getLostCount() const {
+    return lostCount_;
+}
+
+uint64_t ImpairmentModel::getDroppedCount() const {
+    return droppedCount_;
+}
+
+uint64_t ImpairmentModel::getDuplicatedCount() const {
+    return duplicatedCount_;
+}
+
+uint64_t ImpairmentModel::getReorderedCount() const {
+    return reorderedCount_;
+}
+
+bool ImpairmentModel::isLost() {
+    if (impairment_.burstEnter > 0.0f) {
+        burst_ = burst_ ? !chance(impairment_.burstExit) : chance(impairment_.burstEnter);
+    }
+    return chance(burst_ ? impairment_.burstLoss : impairment_.loss);
+}
+
+int64_t ImpairmentModel::getDelay() {
+    auto delay = impairment_.latency;
+    if (impairment_.jitter > 0.0f) {
+        delay += impairment_.jitter * normal_(random_);
+    }
+    return Clock::toNanoseconds(std::max(delay, 0.0f));
+}
+
+const LatencyTrace::Sample* ImpairmentModel::getTraceSample(int64_t now) {
+    const auto& trace = impairment_.trace;
+    if (!trace) {
+        return nullptr;
+    }
+    // The trace starts with the first packet.
+    if (traceStart_ < 0) {
+        traceStart_ = now;
+    }
+    auto time = static_cast<int64_t>(static_cast<double>(now - traceStart_) * impairment_.traceSpeed);
+    if (impairment_.traceLoop && trace->getDuration() > 0) {
+        time %= trace->getDuration();
+    }
+    return &trace->getSample(time);
+}
+
+bool ImpairmentModel::chance(float probability) {
+    return probability > 0.0f && uniform_(random_) < probability;
+}
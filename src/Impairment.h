@@ -0,0 +1,125 @@
+#ifndef _Impairment_H
+#define _Impairment_H
+
+#include "LatencyTrace.h"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+
+/** The conditions of one direction of an emulated network path.
+ */
+struct Impairment {
+    Impairment();
+
+    /** Returns true if packets pass unchanged.
+     */
+    bool isNone() const;
+
+    // The mean delay and its standard deviation in seconds.
+    float latency;
+    float jitter;
+
+    // The probability that a packet is lost at random.
+    float loss;
+
+    // Burst loss after Gilbert-Elliott: the probabilities per packet to enter
+    // and to leave the bad state, and the loss probability in the bad state.
+    float burstEnter;
+    float burstExit;
+    float burstLoss;
+
+    // The probability that a packet arrives twice.
+    float duplication;
+
+    // The probability that a packet is held back, and for how many seconds.
+    float reordering;
+    float reorderDelay;
+
+    // The capacity of the link in bytes per second, or 0 for no limit, and
+    // the number of bytes that may queue up in front of it before packets are dropped.
+    uint32_t bandwidth;
+    uint32_t queueSize;
+
+    // The seed of the random numbers, or 0 for a random seed.
+    uint64_t seed;
+
+    // A recorded trace whose delays and losses are replayed on top of the
+    // settings above, how many times faster than recorded, and whether it
+    // starts over at its end instead of keeping its last sample.
+    std::shared_ptr<const LatencyTrace> trace;
+    float traceSpeed;
+    bool traceLoop;
+};
+
+/** Parses a comma separated list of settings like "latency=50,jitter=5,loss=0.01".
+
+    The keys are latency and jitter in milliseconds, loss, burst-enter,
+    burst-exit, burst-loss, duplicate and reorder as probabilities,
+    reorder-delay in milliseconds, bandwidth in kilobits per second, queue in
+    bytes and seed. trace names a trace file to replay, trace-speed its speed
+    and trace-loop=1 replays it over and over.
+
+    \throws std::invalid_argument if a key or a value is not valid.
+ */
+Impairment parseImpairment(const std::string& settings);
+
+/** Decides the fate of each packet sent over a path with an Impairment.
+
+    The random numbers come from a generator of its own, so a fixed seed
+    reproduces the same losses and delays for the same sequence of packets.
+ */
+class ImpairmentModel {
+public:
+    /** The largest number of copies of a packet that arrive.
+     */
+    static const uint32_t MaxCopies = 2;
+
+    explicit ImpairmentModel(const Impairment& impairment);
+
+    /** Sends a packet over the path.
+
+        \param now the time of sending in nanoseconds.
+        \param size the size of the packet in bytes.
+        \param releaseTimes receives the arrival time of each copy, at most MaxCopies.
+        \return the number of copies that arrive, 0 if the packet is lost.
+     */
+    uint32_t apply(int64_t now, uint32_t size, int64_t* releaseTimes);
+
+    const Impairment& getImpairment() const;
+
+    uint64_t getLostCount() const;
+
+    uint64_t getDroppedCount() const;
+
+    uint64_t getDuplicatedCount() const;
+
+    uint64_t getReorderedCount() const;
+
+private:
+    bool isLost();
+
+    int64_t getDelay();
+
+    const LatencyTrace::Sample* getTraceSample(int64_t now);
+
+    bool chance(float probability);
+
+    const Impairment impairment_;
+
+    std::mt19937_64 random_;
+    std::uniform_real_distribution<float> uniform_;
+    std::normal_distribution<float> normal_;
+
+    bool burst_;
+    int64_t linkFree_;
+    int64_t traceStart_;
+
+    uint64_t lostCount_;
+    uint64_t droppedCount_;
+    uint64_t duplicatedCount_;
+    uint64_t reorderedCount_;
+};
+
+#endif  // _Impairment_H
@@ -0,0 +1,142 @@
+#include "InputBuffer.h"
+
+#include <algorithm>
+#include <limits>
+
+// A move never counts for more than this, e.g. the first move of a client or
+// one after lost packets.
+static const float MAX_MOVE_DURATION = 0.1f;
+
+// Input beyond this depth is consumed right away to bound the latency.
+static const float MAX_DEPTH = 0.2f;
+
+// The latest move is repeated for at most this long when the buffer runs dry.
+// It covers the heartbeat interval of a client whose input is steady.
+static const float MAX_EXTRAPOLATION_TIME = 0.25f;
+
+// The time over which the depth is observed before the time scale is adjusted.
+static const float WINDOW_DURATION = 1.0f;
+
+// The largest deviation of the time scale from 1.
+static const float MAX_DILATION = 0.05f;
+
+// The change of the time scale per second of depth error.
+static const float DILATION_GAIN = 0.5f;
+
+static float getDuration(const Move& move) {
+    return std::min(move.getDeltaTime(), MAX_MOVE_DURATION);
+}
+
+InputBuffer::InputBuffer()
+: moves_()
+, depth_(0)
+, credit_(0)
+, lastDuration_(0)
+, lastMove_()
+, receivedTick_(0)
+, extrapolatedTime_(0)
+, extrapolatedCount_(0)
+, arrived_(false)
+, arrivedLate_(false)
+, windowTime_(0)
+, windowMinDepth_(std::numeric_limits<float>::max())
+, windowStarved_(false)
+, timeScale_(1.0f) {
+}
+
+void InputBuffer::addMove(const Move& move) {
+    const auto tick = move.getTick();
+    if (tick <= receivedTick_) {
+        return;
+    }
+    receivedTick_ = tick;
+    if (tick <= lastMove_.getTick()) {
+        // The tick has already been played back with a repeated move.
+        arrivedLate_ = true;
+        return;
+    }
+    moves_.addMove(move);
+    depth_ += getDuration(move);
+    arrived_ = true;
+}
+
+float InputBuffer::getDepth() const {
+    return depth_;
+}
+
+float InputBuffer::getTimeScale() const {
+    return timeScale_;
+}
+
+uint64_t InputBuffer::getExtrapolatedCount() const {
+    return extrapolatedCount_;
+}
+
+void InputBuffer::beginConsume(float elapsed) {
+    credit_ += elapsed;
+    if (depth_ > MAX_DEPTH) {
+        credit_ += depth_ - MAX_DEPTH;
+    }
+}
+
+bool InputBuffer::takeDueMove(Move& move) {
+    if (moves_.getCount() == 0) {
+        // Steady input is not sent every tick, so the latest move is the best
+        // guess for the ticks that have not arrived yet.
+        if (lastDuration_ <= 0.0f || credit_ < lastDuration_ || extrapolatedTime_ + lastDuration_ > MAX_EXTRAPOLATION_TIME) {
+            return false;
+        }
+        credit_ -= lastDuration_;
+        extrapolatedTime_ += lastDuration_;
+        extrapolatedCount_++;
+        lastMove_ = Move(lastMove_.getInputState(), lastMove_.getTick() + 1, lastMove_.getDeltaTime());
+        move = lastMove_;
+        return true;
+    }
+    const auto& next = *moves_.begin();
+    const auto duration = getDuration(next);
+    if (credit_ < duration) {
+        return false;
+    }
+    credit_ -= duration;
+    depth_ -= duration;
+    lastDuration_ = duration;
+    extrapolatedTime_ = 0;
+    lastMove_ = next;
+    move = next;
+    moves_.removeMovesUntil(move.getTick());
+    return true;
+}
+
+void InputBuffer::endConsume(float elapsed) {
+    if (moves_.getCount() == 0) {
+        // Moves that arrive after the repetition has ended must not be played
+        // back in a burst, so the credit is capped at one move.
+        credit_ = std::min(credit_, lastDuration_);
+        depth_ = 0;
+    }
+    // The input ran dry if moves arrived only for ticks that had to be
+    // repeated. Otherwise the depth right after an arrival tells how early the
+    // moves come in.
+    if (arrived_) {
+        windowMinDepth_ = std::min(windowMinDepth_, depth_);
+    } else if (arrivedLate_) {
+        windowStarved_ = true;
+    }
+    arrived_ = false;
+    arrivedLate_ = false;
+
+    windowTime_ += elapsed;
+    if (windowTime_ >= WINDOW_DURATION) {
+        // Aim for one frame of input left in the buffer when moves arrive.
+        if (windowStarved_) {
+            timeScale_ = 1.0f + MAX_DILATION;
+        } else if (windowMinDepth_ < std::numeric_limits<float>::max()) {
+            const auto error = elapsed - windowMinDepth_;
+            timeScale_ = 1.0f + std::max(-MAX_DILATION, std::min(error * DILATION_GAIN, MAX_DILATION));
+        }
+        windowTime_ = 0;
+        windowMinDepth_ = std::numeric_limits<float>::max();
+        windowStarved_ = false;
+    }
+}
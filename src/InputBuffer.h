@@ -0,0 +1,83 @@
+#ifndef _InputBuffer_H
+#define _InputBuffer_H
+
+#include "MoveList.h"
+
+/** Plays back the moves of a client at the rate at which they were sampled.
+
+    Moves arrive in clumps, but are consumed one after the other as the server
+    time advances. The buffer measures how deep it runs and derives a time scale
+    for the client: a client whose moves run out is asked to run slightly faster,
+    one whose moves pile up slightly slower. This keeps the buffer at the smallest
+    depth that avoids starvation, i.e. at the lowest input latency.
+
+    Clients send their moves only when the input changes and as a heartbeat
+    while it is steady. When the buffer runs dry, the latest move is therefore
+    repeated for a while, and the moves that arrive later for the repeated ticks
+    are dropped. The depth is observed only when moves arrive, so a client that
+    sends rarely is not asked to run ahead by the time between its packets.
+ */
+class InputBuffer {
+public:
+    InputBuffer();
+
+    /** Adds a received move. Moves that are not newer than the latest one, and
+        moves of ticks that have already been played back, are ignored.
+     */
+    void addMove(const Move& move);
+
+    /** Consumes the moves that are due after the given time has passed.
+
+        \param elapsed the time since the last call.
+        \param fun is called with each due move, oldest first.
+     */
+    template<typename Fun>
+    void consume(float elapsed, Fun&& fun) {
+        beginConsume(elapsed);
+        Move move;
+        while (takeDueMove(move)) {
+            fun(move);
+        }
+        endConsume(elapsed);
+    }
+
+    /** Returns the buffered input in seconds.
+     */
+    float getDepth() const;
+
+    /** Returns the factor by which the client should scale its simulation clock.
+     */
+    float getTimeScale() const;
+
+    /** Returns the number of ticks for which the latest move was repeated.
+     */
+    uint64_t getExtrapolatedCount() const;
+
+private:
+    void beginConsume(float elapsed);
+
+    bool takeDueMove(Move& move);
+
+    void endConsume(float elapsed);
+
+    MoveList moves_;
+
+    float depth_;
+    float credit_;
+    float lastDuration_;
+
+    Move lastMove_;
+    uint32_t receivedTick_;
+    float extrapolatedTime_;
+    uint64_t extrapolatedCount_;
+    bool arrived_;
+    bool arrivedLate_;
+
+    float windowTime_;
+    float windowMinDepth_;
+    bool windowStarved_;
+
+    float timeScale_;
+};
+
+#endif  // _InputBuffer_H
@@ -3,51 +3,84 @@
 
 #include <SDL2/SDL.h>
 
-InputHandler::InputHandler(unsigned int sampleRate)
-: sampleInterval_(1.0f / static_cast<float>(sampleRate))
-, nextTimeToSample_(0)
-, inputState_()
+// Changes that have not been sent after this many ticks are not measured.
+static const std::size_t MAX_UNSENT_CHANGES = 64;
+
+// The input latency is counted in buckets of 1 ms up to 200 ms.
+static const int64_t LATENCY_BUCKET_WIDTH = 1000000;
+static const uint32_t LATENCY_BUCKET_COUNT = 200;
+
+InputHandler::InputHandler()
+: inputState_()
+, changeTime_(-1)
+, unsentChanges_()
+, inputLatency_(LATENCY_BUCKET_WIDTH, LATENCY_BUCKET_COUNT)
 , pendingMove_(nullptr)
 , moveList_() {
 }
 
-void InputHandler::handleInput(KeyAction keyAction, int keyCode) {
+void InputHandler::handleInput(KeyAction keyAction, int keyCode, int64_t eventTime) {
+    auto inputState = inputState_;
     if (SDLK_RIGHT == keyCode) {
         if (keyAction == KeyAction::Down) {
-            inputState_.desiredRightAmount = 5;
+            inputState.desiredRightAmount = 5;
         } else {
-            inputState_.desiredRightAmount = 0;
+            inputState.desiredRightAmount = 0;
         }
     } else if (SDLK_LEFT == keyCode) {
         if (keyAction == KeyAction::Down) {
-            inputState_.desiredLeftAmount = 5;
+            inputState.desiredLeftAmount = 5;
         } else {
-            inputState_.desiredLeftAmount = 0;
+            inputState.desiredLeftAmount = 0;
         }
     } else if (SDLK_UP == keyCode) {
         if (keyAction == KeyAction::Down) {
-            inputState_.desiredForwardAmount = 1;
+            inputState.desiredForwardAmount = 1;
         } else {
-            inputState_.desiredForwardAmount = 0;
+            inputState.desiredForwardAmount = 0;
         }
     } else if (SDLK_SPACE == keyCode) {
         if (keyAction == KeyAction::Down) {
-            inputState_.shooting = true;
+            inputState.shooting = true;
         } else {
-            inputState_.shooting = false;
+            inputState.shooting = false;
         }
     }
+    setInputState(inputState, eventTime);
+}
+
+void InputHandler::setInputState(const InputState& inputState, int64_t eventTime) {
+    // Key repeats do not change anything; only the first unsampled change counts.
+    if (inputState != inputState_ && changeTime_ < 0) {
+        changeTime_ = eventTime;
+    }
+    inputState_ = inputState;
 }
 
-void InputHandler::update(float currentTime) {
-    if (currentTime >= nextTimeToSample_) {
-        pendingMove_ = moveList_.addMove(inputState_, currentTime);
-        nextTimeToSample_ += sampleInterval_;
+void InputHandler::update(uint32_t tick, float deltaTime) {
+    pendingMove_ = moveList_.addMove(inputState_, tick, deltaTime);
+    if (changeTime_ >= 0) {
+        if (unsentChanges_.size() == MAX_UNSENT_CHANGES) {
+            unsentChanges_.pop_front();
+        }
+        unsentChanges_.emplace_back(tick, changeTime_);
+        changeTime_ = -1;
     }
 }
 
-float InputHandler::getSampleInterval() const {
-    return sampleInterval_;
+void InputHandler::handleMovesSent(uint32_t latestTick, int64_t sendTime) {
+    while (!unsentChanges_.empty() && unsentChanges_.front().tick <= latestTick) {
+        inputLatency_.add(sendTime - unsentChanges_.front().time);
+        unsentChanges_.pop_front();
+    }
+}
+
+bool InputHandler::hasUnsentChanges() const {
+    return !unsentChanges_.empty();
+}
+
+Histogram& InputHandler::getInputLatency() {
+    return inputLatency_;
 }
 
 const Move* InputHandler::getAndClearPendingMove() {
@@ -3,7 +3,9 @@
 
 #include "InputState.h"
 #include "MoveList.h"
+#include "Histogram.h"
 
+#include <deque>
 #include <memory>
 
 enum class KeyAction {
@@ -14,29 +16,77 @@ class Move;
 
 class InputHandler {
 public:
-    explicit InputHandler(unsigned int sampleRate);
+    InputHandler();
 
     InputHandler(const InputHandler&) = delete;
 
     InputHandler& operator =(const InputHandler&) = delete;
 
-    void handleInput(KeyAction keyAction, int keyCode);
+    /** Applies a key press or release.
 
-    void update(float currentTime);
+        \param keyAction whether the key went down or up.
+        \param keyCode the SDL key code.
+        \param eventTime the time of the key event in nanoseconds.
+     */
+    void handleInput(KeyAction keyAction, int keyCode, int64_t eventTime);
 
-    float getSampleInterval() const;
+    /** Replaces the whole input at once, for callers without key codes.
+
+        \param inputState the new input.
+        \param eventTime the time of the change in nanoseconds.
+     */
+    void setInputState(const InputState& inputState, int64_t eventTime);
+
+    /** Samples the move of a simulation tick. A change of the input goes into
+        the move of the first tick after it.
+
+        \param tick the number of the tick.
+        \param deltaTime the duration of the tick in seconds.
+     */
+    void update(uint32_t tick, float deltaTime);
+
+    /** Tells that the moves up to a tick have been sent for the first time, to
+        measure the latency from a change of the input to its transmission.
+
+        \param latestTick the tick of the latest move sent.
+        \param sendTime the time of sending in nanoseconds.
+     */
+    void handleMovesSent(uint32_t latestTick, int64_t sendTime);
+
+    /** Returns true if a move with a change of the input has not been sent yet.
+     */
+    bool hasUnsentChanges() const;
+
+    /** Returns the distribution of the time from a change of the input until it
+        is sent, in nanoseconds.
+     */
+    Histogram& getInputLatency();
 
     const Move* getAndClearPendingMove();
 
     MoveList& getMoveList();
 
 private:
-    const float sampleInterval_;
+    struct Change {
+        Change(uint32_t moveTick, int64_t eventTime)
+        : tick(moveTick)
+        , time(eventTime) {
+        }
 
-    float nextTimeToSample_;
+        uint32_t tick;
+        int64_t time;
+    };
 
     InputState inputState_;
 
+    // The time of the earliest change that has not made it into a move yet, or -1.
+    int64_t changeTime_;
+
+    // The changes that have made it into a move that has not been sent yet.
+    std::deque<Change> unsentChanges_;
+
+    Histogram inputLatency_;
+
     const Move* pendingMove_;
 
     MoveList moveList_;
@@ -0,0 +1,64 @@
+#include "InterpolationBuffer.h"
+#include "Clock.h"
+
+#include <algorithm>
+
+InterpolationBuffer::InterpolationBuffer(uint32_t capacity)
+: snapshots_(std::max(2u, capacity))
+, oldest_(0)
+, count_(0)
+, cursor_(0) {
+}
+
+void InterpolationBuffer::add(int64_t time, const BodyState& state) {
+    if (count_ > 0 && time <= get(count_ - 1).time) {
+        return;
+    }
+    const auto capacity = static_cast<uint32_t>(snapshots_.size());
+    if (count_ == capacity) {
+        oldest_ = (oldest_ + 1) % capacity;
+        count_--;
+        cursor_ = cursor_ > 0 ? cursor_ - 1 : 0;
+    }
+    snapshots_[(oldest_ + count_) % capacity] = Snapshot(time, state);
+    count_++;
+}
+
+bool InterpolationBuffer::sample(int64_t time, float maxExtrapolation, BodyState& state) {
+    if (count_ == 0) {
+        return false;
+    }
+
+    // Move the cursor to the newest snapshot that is not newer than time.
+    while (cursor_ + 1 < count_ && get(cursor_ + 1).time <= time) {
+        cursor_++;
+    }
+    while (cursor_ > 0 && get(cursor_).time > time) {
+        cursor_--;
+    }
+
+    const auto& from = get(cursor_);
+    if (time <= from.time) {
+        state = from.state;
+    } else if (cursor_ + 1 < count_) {
+        const auto& to = get(cursor_ + 1);
+        state = interpolate(from.state, to.state, static_cast<float>(time - from.time) / static_cast<float>(to.time - from.time));
+    } else {
+        state = extrapolate(from.state, std::min(Clock::toSeconds(time - from.time), maxExtrapolation));
+    }
+    return true;
+}
+
+void InterpolationBuffer::clear() {
+    oldest_ = 0;
+    count_ = 0;
+    cursor_ = 0;
+}
+
+uint32_t InterpolationBuffer::getCount() const {
+    return count_;
+}
+
+const InterpolationBuffer::Snapshot& InterpolationBuffer::get(uint32_t index) const {
+    return snapshots_[(oldest_ + index) % snapshots_.size()];
+}
@@ -0,0 +1,65 @@
+#ifndef _InterpolationBuffer_H
+#define _InterpolationBuffer_H
+
+#include "BodyState.h"
+
+#include <vector>
+#include <cstdint>
+
+/** A fixed-capacity ring of time stamped snapshots of a remote body.
+
+    The render time only moves forward, so sampling keeps a cursor on the last
+    bracketing pair and costs O(1) per frame regardless of the latency.
+ */
+class InterpolationBuffer {
+public:
+    /** Constructor
+
+        \param capacity the maximum number of snapshots.
+     */
+    explicit InterpolationBuffer(uint32_t capacity);
+
+    /** Adds a snapshot. Snapshots that are not newer than the newest one are ignored.
+     */
+    void add(int64_t time, const BodyState& state);
+
+    /** Returns the state at a given time. Between two snapshots the state is
+        interpolated, before the oldest snapshot the oldest is used, and after the
+        newest it is extrapolated for at most maxExtrapolation seconds.
+
+        \param time the time to sample at in nanoseconds.
+        \param maxExtrapolation the maximum time in seconds to extrapolate past the newest snapshot.
+        \param state receives the state.
+        \return false if the buffer is empty, otherwise true.
+     */
+    bool sample(int64_t time, float maxExtrapolation, BodyState& state);
+
+    void clear();
+
+    uint32_t getCount() const;
+
+private:
+    struct Snapshot {
+        Snapshot()
+        : time(0)
+        , state() {
+        }
+
+        Snapshot(int64_t snapshotTime, const BodyState& snapshotState)
+        : time(snapshotTime)
+        , state(snapshotState) {
+        }
+
+        int64_t time;
+        BodyState state;
+    };
+
+    const Snapshot& get(uint32_t index) const;
+
+    std::vector<Snapshot> snapshots_;
+    uint32_t oldest_;
+    uint32_t count_;
+    uint32_t cursor_;
+};
+
+#endif  // _InterpolationBuffer_H
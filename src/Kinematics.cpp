@@ -0,0 +1,255 @@
+#include "Kinematics.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+static const float SHIP_ACCELERATION = 50.0f;
+// Speed and spin keep this fraction per second; it used to be 0.99 per frame at 60 frames per second.
+static const double SHIP_DAMPING = std::pow(0.99, 60.0);
+static const float SHIP_MIN_SPEED = 0.8f;
+
+static void integrateShips(float* __restrict positionX, float* __restrict positionY,
+                           float* __restrict velocityX, float* __restrict velocityY,
+                           float* __restrict lookatX, float* __restrict lookatY,
+                           float* __restrict angle, const float* __restrict thrust,
+                           uint32_t first, uint32_t last, float elapsed) {
+    // Damping by the elapsed time rather than per call keeps the motion the same
+    // whatever the tick rate.
+    const auto damping = static_cast<float>(std::pow(SHIP_DAMPING, static_cast<double>(elapsed)));
+
+    // The rotation needs sin/cos and stays scalar; splitting it off lets the
+    // compiler vectorize the velocity and position update below (the speed
+    // threshold select needs -fno-trapping-math to be if-converted).
+    for (uint32_t i = first; i < last; ++i) {
+        angle[i] *= damping;
+        const auto cs = std::cos(angle[i] * elapsed);
+        const auto sn = std::sin(angle[i] * elapsed);
+        const auto lx = lookatX[i] * cs - lookatY[i] * sn;
+        const auto ly = lookatX[i] * sn + lookatY[i] * cs;
+        lookatX[i] = lx;
+        lookatY[i] = ly;
+    }
+
+    for (uint32_t i = first; i < last; ++i) {
+        auto vx = velocityX[i] * damping;
+        auto vy = velocityY[i] * damping;
+        const auto keep = (vx * vx + vy * vy) < (SHIP_MIN_SPEED * SHIP_MIN_SPEED) ? 0.0f : 1.0f;
+        const auto acceleration = elapsed * SHIP_ACCELERATION * thrust[i];
+        vx = vx * keep + acceleration * lookatX[i];
+        vy = vy * keep + acceleration * lookatY[i];
+        velocityX[i] = vx;
+        velocityY[i] = vy;
+
+        positionX[i] += elapsed * vx;
+        positionY[i] += elapsed * vy;
+    }
+}
+
+static void integrateBolts(float* __restrict positionX, float* __restrict positionY,
+                           const float* __restrict velocityX, const float* __restrict velocityY,
+                           uint32_t first, uint32_t last, float elapsed) {
+    for (uint32_t i = first; i < last; ++i) {
+        positionX[i] += elapsed * velocityX[i];
+        positionY[i] += elapsed * velocityY[i];
+    }
+}
+
+Kinematics::Table::Table()
+: positionX()
+, positionY()
+, previousX()
+, previousY()
+, velocityX()
+, velocityY()
+, lookatX()
+, lookatY()
+, angle()
+, thrust()
+, body() {
+}
+
+uint32_t Kinematics::Table::size() const {
+    return static_cast<uint32_t>(body.size());
+}
+
+void Kinematics::Table::push(uint32_t newBody, const Vector2d& position) {
+    positionX.push_back(position.getX());
+    positionY.push_back(position.getY());
+    previousX.push_back(position.getX());
+    previousY.push_back(position.getY());
+    velocityX.push_back(0.0f);
+    velocityY.push_back(0.0f);
+    lookatX.push_back(0.0f);
+    lookatY.push_back(-1.0f);
+    angle.push_back(0.0f);
+    thrust.push_back(0.0f);
+    body.push_back(newBody);
+}
+
+void Kinematics::Table::moveLastTo(uint32_t index) {
+    const auto last = size() - 1;
+    positionX[index] = positionX[last];
+    positionY[index] = positionY[last];
+    previousX[index] = previousX[last];
+    previousY[index] = previousY[last];
+    velocityX[index] = velocityX[last];
+    velocityY[index] = velocityY[last];
+    lookatX[index] = lookatX[last];
+    lookatY[index] = lookatY[last];
+    angle[index] = angle[last];
+    thrust[index] = thrust[last];
+    body[index] = body[last];
+}
+
+void Kinematics::Table::pop() {
+    positionX.pop_back();
+    positionY.pop_back();
+    previousX.pop_back();
+    previousY.pop_back();
+    velocityX.pop_back();
+    velocityY.pop_back();
+    lookatX.pop_back();
+    lookatY.pop_back();
+    angle.pop_back();
+    thrust.pop_back();
+    body.pop_back();
+}
+
+Kinematics::Kinematics()
+: ships_()
+, bolts_()
+, slots_()
+, freeSlots_() {
+}
+
+uint32_t Kinematics::create(Kind kind, const Vector2d& position) {
+    auto& table = getTable(kind);
+    uint32_t body = 0;
+    if (freeSlots_.empty()) {
+        body = static_cast<uint32_t>(slots_.size());
+        slots_.push_back(Slot{kind, table.size()});
+    } else {
+        body = freeSlots_.back();
+        freeSlots_.pop_back();
+        slots_[body] = Slot{kind, table.size()};
+    }
+    table.push(body, position);
+    return body;
+}
+
+void Kinematics::destroy(uint32_t body) {
+    assert(body < slots_.size());
+    const auto slot = slots_[body];
+    auto& table = getTable(slot.kind);
+    if (slot.index != table.size() - 1) {
+        table.moveLastTo(slot.index);
+        slots_[table.body[slot.index]].index = slot.index;
+    }
+    table.pop();
+    freeSlots_.push_back(body);
+}
+
+uint32_t Kinematics::getCount(Kind kind) const {
+    return getTable(kind).size();
+}
+
+Vector2d Kinematics::getPosition(uint32_t body) const {
+    const auto& slot = slots_[body];
+    const auto& table = getTable(slot.kind);
+    return Vector2d(table.positionX[slot.index], table.positionY[slot.index]);
+}
+
+Vector2d Kinematics::getPosition(uint32_t body, float alpha) const {
+    const auto& slot = slots_[body];
+    const auto& table = getTable(slot.kind);
+    return Vector2d(table.previousX[slot.index] + alpha * (table.positionX[slot.index] - table.previousX[slot.index]),
+                    table.previousY[slot.index] + alpha * (table.positionY[slot.index] - table.previousY[slot.index]));
+}
+
+void Kinematics::setPosition(uint32_t body, const Vector2d& position) {
+    const auto& slot = slots_[body];
+    auto& table = getTable(slot.kind);
+    table.positionX[slot.index] = position.getX();
+    table.positionY[slot.index] = position.getY();
+    table.previousX[slot.index] = position.getX();
+    table.previousY[slot.index] = position.getY();
+}
+
+Vector2d Kinematics::getVelocity(uint32_t body) const {
+    const auto& slot = slots_[body];
+    const auto& table = getTable(slot.kind);
+    return Vector2d(table.velocityX[slot.index], table.velocityY[slot.index]);
+}
+
+void Kinematics::setVelocity(uint32_t body, const Vector2d& velocity) {
+    const auto& slot = slots_[body];
+    auto& table = getTable(slot.kind);
+    table.velocityX[slot.index] = velocity.getX();
+    table.velocityY[slot.index] = velocity.getY();
+}
+
+Vector2d Kinematics::getLookAt(uint32_t body) const {
+    const auto& slot = slots_[body];
+    const auto& table = getTable(slot.kind);
+    return Vector2d(table.lookatX[slot.index], table.lookatY[slot.index]);
+}
+
+void Kinematics::setLookAt(uint32_t body, const Vector2d& lookat) {
+    const auto& slot = slots_[body];
+    auto& table = getTable(slot.kind);
+    table.lookatX[slot.index] = lookat.getX();
+    table.lookatY[slot.index] = lookat.getY();
+}
+
+float Kinematics::getAngle(uint32_t body) const {
+    const auto& slot = slots_[body];
+    return getTable(slot.kind).angle[slot.index];
+}
+
+void Kinematics::setAngle(uint32_t body, float angle) {
+    const auto& slot = slots_[body];
+    getTable(slot.kind).angle[slot.index] = angle;
+}
+
+bool Kinematics::getThrust(uint32_t body) const {
+    const auto& slot = slots_[body];
+    return getTable(slot.kind).thrust[slot.index] > 0.0f;
+}
+
+void Kinematics::setThrust(uint32_t body, bool onOff) {
+    const auto& slot = slots_[body];
+    getTable(slot.kind).thrust[slot.index] = onOff ? 1.0f : 0.0f;
+}
+
+void Kinematics::integrate(float elapsed) {
+    integrate(Kind::Ship, 0, ships_.size(), elapsed);
+    integrate(Kind::Bolt, 0, bolts_.size(), elapsed);
+}
+
+void Kinematics::integrate(Kind kind, uint32_t first, uint32_t last, float elapsed) {
+    auto& table = getTable(kind);
+    std::copy(table.positionX.begin() + first, table.positionX.begin() + last, table.previousX.begin() + first);
+    std::copy(table.positionY.begin() + first, table.positionY.begin() + last, table.previousY.begin() + first);
+    if (kind == Kind::Ship) {
+        integrateShips(table.positionX.data(), table.positionY.data(), table.velocityX.data(), table.velocityY.data(),
+                       table.lookatX.data(), table.lookatY.data(), table.angle.data(), table.thrust.data(),
+                       first, last, elapsed);
+    } else {
+        integrateBolts(table.positionX.data(), table.positionY.data(), table.velocityX.data(), table.velocityY.data(),
+                       first, last, elapsed);
+    }
+}
+
+void Kinematics::integrate(uint32_t body, float elapsed) {
+    const auto& slot = slots_[body];
+    integrate(slot.kind, slot.index, slot.index + 1, elapsed);
+}
+
+Kinematics::Table& Kinematics::getTable(Kind kind) {
+    return kind == Kind::Ship ? ships_ : bolts_;
+}
+
+const Kinematics::Table& Kinematics::getTable(Kind kind) const {
+    return kind == Kind::Ship ? ships_ : bolts_;
+}
@@ -0,0 +1,145 @@
+#ifndef _Kinematics_H
+#define _Kinematics_H
+
+#include "Vector2d.h"
+
+#include <vector>
+#include <cstdint>
+
+/** Dense structure-of-arrays storage for the physical state of game objects.
+
+    Each body kind lives in its own table with one array per component (position,
+    previous position, velocity, lookat, angle, thrust), so a whole
+    table is advanced by one batched kernel instead of one virtual call per
+    object. Bodies are addressed by stable IDs; removing a body moves the last
+    body of its table into the hole. The previous position is the one before the
+    last integration, so that frames can be rendered between two ticks.
+ */
+class Kinematics {
+public:
+    /** The kinds of bodies, each with its own integration kernel.
+     */
+    enum class Kind : uint8_t {
+        Ship, Bolt
+    };
+
+    /** Constructor
+     */
+    Kinematics();
+
+    Kinematics(const Kinematics&) = delete;
+
+    Kinematics& operator =(const Kinematics&) = delete;
+
+    /** Creates a new body at rest.
+
+        \param kind the kind of the body.
+        \param position the initial position.
+        \return the ID of the new body.
+     */
+    uint32_t create(Kind kind, const Vector2d& position);
+
+    /** Destroys a body. Its ID may be reused afterwards.
+
+        \param body the ID of the body.
+     */
+    void destroy(uint32_t body);
+
+    /** Returns the number of bodies of a given kind.
+     */
+    uint32_t getCount(Kind kind) const;
+
+    Vector2d getPosition(uint32_t body) const;
+
+    /** Returns the position blended between before and after the last integration
+        of the body, to render between two ticks.
+
+        \param body the ID of the body.
+        \param alpha 0 for the position before the integration, 1 for the current one.
+     */
+    Vector2d getPosition(uint32_t body, float alpha) const;
+
+    /** Moves a body. It is rendered at the new position right away, i.e. not
+        blended with the previous one.
+     */
+    void setPosition(uint32_t body, const Vector2d& position);
+
+    Vector2d getVelocity(uint32_t body) const;
+
+    void setVelocity(uint32_t body, const Vector2d& velocity);
+
+    Vector2d getLookAt(uint32_t body) const;
+
+    void setLookAt(uint32_t body, const Vector2d& lookat);
+
+    float getAngle(uint32_t body) const;
+
+    void setAngle(uint32_t body, float angle);
+
+    bool getThrust(uint32_t body) const;
+
+    void setThrust(uint32_t body, bool onOff);
+
+    /** Advances all bodies.
+
+        \param elapsed the elapsed time in seconds.
+     */
+    void integrate(float elapsed);
+
+    /** Advances the bodies of one kind in the index range [first, last), so that
+        a table can be split across threads. Indices are positions in the table
+        of that kind, not body IDs; valid indices are [0, getCount(kind)).
+
+        \param kind the kind of the bodies.
+        \param first the first index.
+        \param last one past the last index.
+        \param elapsed the elapsed time in seconds.
+     */
+    void integrate(Kind kind, uint32_t first, uint32_t last, float elapsed);
+
+    /** Advances a single body, e.g. to replay moves or to extrapolate.
+
+        \param body the ID of the body.
+        \param elapsed the elapsed time in seconds.
+     */
+    void integrate(uint32_t body, float elapsed);
+
+private:
+    struct Table {
+        Table();
+
+        uint32_t size() const;
+        void push(uint32_t body, const Vector2d& position);
+        void moveLastTo(uint32_t index);
+        void pop();
+
+        std::vector<float> positionX;
+        std::vector<float> positionY;
+        std::vector<float> previousX;
+        std::vector<float> previousY;
+        std::vector<float> velocityX;
+        std::vector<float> velocityY;
+        std::vector<float> lookatX;
+        std::vector<float> lookatY;
+        std::vector<float> angle;
+        std::vector<float> thrust;
+        std::vector<uint32_t> body;
+    };
+
+    struct Slot {
+        Kind kind;
+        uint32_t index;
+    };
+
+    Table& getTable(Kind kind);
+
+    const Table& getTable(Kind kind) const;
+
+    Table ships_;
+    Table bolts_;
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> freeSlots_;
+};
+
+#endif  // _Kinematics_H
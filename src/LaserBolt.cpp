@@ -1,38 +1,47 @@
 #include "LaserBolt.h"
 
-LaserBolt::LaserBolt(const Renderer& renderer, const Vector2d& position, const Vector2d& velocity)
+LaserBolt::LaserBolt(const Renderer& renderer, Kinematics& kinematics, const Vector2d& position, const Vector2d& velocity)
 : sprite_("data/shoot1.png", renderer)
-, position_(position)
-, velocity_(velocity)
-, lookat_(velocity_.normal()) {
+, kinematics_(kinematics)
+, body_(kinematics_.create(Kinematics::Kind::Bolt, position)) {
+    kinematics_.setVelocity(body_, velocity);
+    kinematics_.setLookAt(body_, velocity.normal());
 }
 
-void LaserBolt::update(float elapsed) {
-    position_ += (elapsed * velocity_);
+LaserBolt::~LaserBolt() {
+    kinematics_.destroy(body_);
 }
 
-void LaserBolt::draw(Renderer &renderer) {
+void LaserBolt::update(float) {
+}
+
+void LaserBolt::draw(Renderer &renderer, float alpha) {
+    const auto position = kinematics_.getPosition(body_, alpha);
     sprite_.draw(
-        static_cast<int>(position_.getX() - static_cast<float>(sprite_.getWidth()) / 2.0f),
-        static_cast<int>(position_.getY() - static_cast<float>(sprite_.getHeight()) / 2.0f),
-        -angle(Vector2d{0, -1}, lookat_),
+        static_cast<int>(position.getX() - static_cast<float>(sprite_.getWidth()) / 2.0f),
+        static_cast<int>(position.getY() - static_cast<float>(sprite_.getHeight()) / 2.0f),
+        -angle(Vector2d{0, -1}, kinematics_.getLookAt(body_)),
         renderer);
 }
 
 void LaserBolt::write(Packet* packet) {
-    position_.write(packet);
-    velocity_.write(packet);
-    lookat_.write(packet);
+    getPosition().write(packet);
+    kinematics_.getVelocity(body_).write(packet);
+    kinematics_.getLookAt(body_).write(packet);
 }
 
 void LaserBolt::read(Packet* packet) {
-    position_.read(packet);
-    velocity_.read(packet);
-    lookat_.read(packet);
+    Vector2d position, velocity, lookat;
+    position.read(packet);
+    velocity.read(packet);
+    lookat.read(packet);
+    setPosition(position);
+    kinematics_.setVelocity(body_, velocity);
+    kinematics_.setLookAt(body_, lookat);
 }
 
-const Vector2d& LaserBolt::getPosition() const {
-    return position_;
+Vector2d LaserBolt::getPosition() const {
+    return kinematics_.getPosition(body_);
 }
 
 unsigned int LaserBolt::getWidth() const {
@@ -46,3 +55,21 @@ unsigned int LaserBolt::getHeight() const {
 uint32_t LaserBolt::getClassId() const {
     return ClassId;
 }
+
+void LaserBolt::integrate(float elapsed) {
+    kinematics_.integrate(body_, elapsed);
+}
+
+void LaserBolt::setPosition(const Vector2d& position) {
+    kinematics_.setPosition(body_, position);
+}
+
+BodyState LaserBolt::getBodyState() const {
+    return BodyState(getPosition(), kinematics_.getVelocity(body_), kinematics_.getLookAt(body_), 0.0f, false);
+}
+
+void LaserBolt::setBodyState(const BodyState& state) {
+    setPosition(state.position);
+    kinematics_.setVelocity(body_, state.velocity);
+    kinematics_.setLookAt(body_, state.lookAt);
+}
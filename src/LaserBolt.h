@@ -4,23 +4,31 @@
 #include "GameObject.h"
 #include "Sprite.h"
 #include "Vector2d.h"
+#include "Kinematics.h"
+#include "BodyState.h"
 
 class Renderer;
 class Packet;
 
 class LaserBolt : public GameObject {
 public:
-    LaserBolt(const Renderer& renderer, const Vector2d& position, const Vector2d& velocity);
+    LaserBolt(const Renderer& renderer, Kinematics& kinematics, const Vector2d& position, const Vector2d& velocity);
+
+    LaserBolt(const LaserBolt&) = delete;
+
+    LaserBolt& operator =(const LaserBolt&) = delete;
+
+    virtual ~LaserBolt();
 
     virtual void update(float elapsed) override;
 
-    void draw(Renderer &renderer) override;
+    void draw(Renderer &renderer, float alpha) override;
 
     void write(Packet* packet) override;
 
     virtual void read(Packet* packet) override;
 
-    const Vector2d& getPosition() const override;
+    Vector2d getPosition() const override;
 
     unsigned int getWidth() const override;
 
@@ -31,13 +39,19 @@ public:
     enum { ClassId = 2 };
 
 protected:
-    Sprite sprite_;
+    void integrate(float elapsed);
 
-    Vector2d position_;
+    void setPosition(const Vector2d& position);
+
+    BodyState getBodyState() const;
+
+    void setBodyState(const BodyState& state);
+
+    Sprite sprite_;
 
-    Vector2d velocity_;
+    Kinematics& kinematics_;
 
-    Vector2d lookat_;
+    const uint32_t body_;
 };
 
 #endif  // _LaserBolt_H
@@ -1,22 +1,61 @@
 #include "LatencyEmulator.h"
+#include "Packet.h"
 #include "Logging.h"
 
-#include <memory>
+#include <chrono>
 
-LatencyEmulator::LatencyEmulator(PacketSink& packetSink, unsigned int latencyMs, unsigned int stdDevMean)
+// The timing wheels have slots of 100 us and turn once per 0.8192 s. Longer
+// delays cost an extra visit per turn.
+static const int64_t WHEEL_RESOLUTION = 100000;
+static const uint32_t WHEEL_SLOT_COUNT = 8192;
+
+// The number of packets that can be delayed at the same time per direction.
+static const uint32_t WHEEL_CAPACITY = 65536;
+
+static int64_t getSteadyTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+LatencyEmulator::Direction::Direction(const Impairment& impairment, int64_t startTime)
+: model(impairment)
+, timingWheel(WHEEL_RESOLUTION, WHEEL_SLOT_COUNT, WHEEL_CAPACITY, startTime) {
+}
+
+LatencyEmulator::LatencyEmulator(PacketSink& packetSink, const Impairment& inbound, const Impairment& outbound)
 : packetSink_(packetSink)
-, latencyMs_(latencyMs)
-, randomDevice_()
-, randomGenerator_(randomDevice_())
-, normalDistribution_(0.0f, static_cast<float>(stdDevMean))
-, io_service_()
-, work_(io_service_)
-, thread_([this] () { io_service_.run(); }) {
+, mutex_()
+, condition_()
+, inbound_(inbound, getSteadyTime())
+, outbound_(outbound, getSteadyTime())
+, released_()
+, sent_()
+, wakeTime_(TimingWheel::NoRelease)
+, stopped_(false)
+, senderMutex_()
+, sender_()
+, thread_([this] () { run(); }) {
 }
 
 LatencyEmulator::~LatencyEmulator() {
-    io_service_.stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    condition_.notify_one();
     thread_.join();
+
+    // The packets still on their way go back to the pool.
+    const auto release = [this] (Packet* packet) { packetSink_.push(packet); };
+    inbound_.timingWheel.advance(TimingWheel::NoRelease, release);
+    outbound_.timingWheel.advance(TimingWheel::NoRelease, release);
+
+    for (auto direction : { &inbound_, &outbound_ }) {
+        const auto& model = direction->model;
+        if (!model.getImpairment().isNone()) {
+            INFO("Emulated {0}: {1} lost, {2} dropped by the queue, {3} duplicated, {4} reordered.", direction == &inbound_ ? "inbound" : "outbound",
+                 model.getLostCount(), model.getDroppedCount(), model.getDuplicatedCount(), model.getReorderedCount());
+        }
+    }
 }
 
 void LatencyEmulator::push(Packet* packet) {
@@ -28,14 +67,111 @@ Packet* LatencyEmulator::pop() {
 }
 
 void LatencyEmulator::enqueue(Packet* packet) {
-    auto timer = std::make_shared<boost::asio::deadline_timer>(io_service_);
-    const auto jitter = static_cast<int>(std::round(normalDistribution_(randomGenerator_)));
-    timer->expires_from_now(boost::posix_time::milliseconds(static_cast<int>(latencyMs_) + jitter));
-    timer->async_wait([this, timer, packet] (const boost::system::error_code&) {
-        packetSink_.enqueue(packet);                    
-    });
+    if (inbound_.model.getImpairment().isNone()) {
+        packetSink_.enqueue(packet);
+    } else {
+        impair(inbound_, packet);
+    }
 }
 
 Packet* LatencyEmulator::dequeue() {
     return packetSink_.dequeue();
 }
+
+void LatencyEmulator::send(Packet* packet) {
+    if (outbound_.model.getImpairment().isNone()) {
+        deliver(packet, true);
+    } else {
+        impair(outbound_, packet);
+    }
+}
+
+void LatencyEmulator::setSender(SendFunc sender) {
+    std::lock_guard<std::mutex> lock(senderMutex_);
+    sender_ = sender;
+}
+
+bool LatencyEmulator::impairsOutbound() const {
+    return !outbound_.model.getImpairment().isNone();
+}
+
+void LatencyEmulator::impair(Direction& direction, Packet* packet) {
+    int64_t releaseTimes[ImpairmentModel::MaxCopies];
+    uint32_t count = 0;
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = getSteadyTime();
+        count = direction.model.apply(now, packet->getSize(), releaseTimes);
+        for (uint32_t i = 0; i < count; i++) {
+            auto copy = packet;
+            if (i > 0) {
+                copy = packetSink_.pop();
+                if (!copy) {
+                    break;
+                }
+                copy->copyDataFrom(*packet);
+                copy->setEndpoint(packet->getEndpoint());
+            }
+            if (direction.timingWheel.schedule(copy, releaseTimes[i])) {
+                // The thread only needs to wake up if it sleeps past the new packet.
+                wake = wake || releaseTimes[i] < wakeTime_;
+            } else {
+                WARN("Too many delayed packets. Drop a packet.");
+                packetSink_.push(copy);
+            }
+        }
+    }
+    if (count == 0) {
+        packetSink_.push(packet);
+    } else if (wake) {
+        condition_.notify_one();
+    }
+}
+
+void LatencyEmulator::deliver(Packet* packet, bool outbound) {
+    if (!outbound) {
+        // The packet arrives only now as far as the receiver is concerned.
+        packet->setReceiveTime(std::chrono::steady_clock::now());
+        packetSink_.enqueue(packet);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(senderMutex_);
+    if (sender_) {
+        sender_(packet);
+    } else {
+        packetSink_.push(packet);
+    }
+}
+
+void LatencyEmulator::run() {
+    released_.reserve(1024);
+    sent_.reserve(1024);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+        wakeTime_ = std::min(inbound_.timingWheel.getNextReleaseTime(), outbound_.timingWheel.getNextReleaseTime());
+        if (wakeTime_ == TimingWheel::NoRelease) {
+            condition_.wait(lock);
+        } else {
+            condition_.wait_until(lock, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(wakeTime_)));
+        }
+        wakeTime_ = 0;
+
+        const auto now = getSteadyTime();
+        inbound_.timingWheel.advance(now, [this] (Packet* packet) { released_.push_back(packet); });
+        outbound_.timingWheel.advance(now, [this] (Packet* packet) { sent_.push_back(packet); });
+        if (!released_.empty() || !sent_.empty()) {
+            // The receiving and sending sides are not kept waiting for the lock.
+            lock.unlock();
+            for (auto packet : released_) {
+                deliver(packet, false);
+            }
+            for (auto packet : sent_) {
+                deliver(packet, true);
+            }
+            released_.clear();
+            sent_.clear();
+            lock.lock();
+        }
+    }
+}
@@ -2,18 +2,41 @@
 #define _LatencyEmulator_H
 
 #include "PacketSink.h"
+#include "TimingWheel.h"
+#include "Impairment.h"
 
-#include <boost/asio.hpp>
-
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <thread>
-#include <random>
+#include <vector>
+
+/** Emulates a bad network path in both directions.
 
+    Received packets pass the inbound Impairment before they are handed on to
+    a packet sink, sent packets pass the outbound one before the sender gets
+    them. Delayed packets wait in timing wheels that a thread of its own
+    releases, so that even tens of thousands of packets per second cost no
+    allocation and no timer each.
+ */
 class LatencyEmulator : public PacketSink {
 public:
-    LatencyEmulator(PacketSink& packetSink, unsigned int latencyMs, unsigned int stdDevMean);
+    typedef std::function<void(Packet*)> SendFunc;
+
+    /** Constructor
+
+        \param packetSink the sink that receives the inbound packets and owns the pool.
+        \param inbound the conditions of received packets.
+        \param outbound the conditions of sent packets.
+     */
+    LatencyEmulator(PacketSink& packetSink, const Impairment& inbound, const Impairment& outbound);
 
     ~LatencyEmulator();
 
+    LatencyEmulator(const LatencyEmulator&) = delete;
+
+    LatencyEmulator& operator =(const LatencyEmulator&) = delete;
+
     void push(Packet* packet) override;
 
     Packet* pop() override;
@@ -22,16 +45,48 @@ public:
 
     Packet* dequeue() override;
 
+    /** Sends a packet over the outbound path.
+     */
+    void send(Packet* packet);
+
+    /** Sets the function that actually sends the outbound packets. Without one
+        they are returned to the pool.
+     */
+    void setSender(SendFunc sender);
+
+    /** Returns true if the outbound packets are impaired at all. If not, a
+        sender can skip the emulator and its lock altogether.
+     */
+    bool impairsOutbound() const;
+
 private:
+    struct Direction {
+        Direction(const Impairment& impairment, int64_t startTime);
+
+        ImpairmentModel model;
+        TimingWheel timingWheel;
+    };
+
+    void impair(Direction& direction, Packet* packet);
+
+    void deliver(Packet* packet, bool outbound);
+
+    void run();
+
     PacketSink& packetSink_;
 
-    const unsigned int latencyMs_;
-    std::random_device randomDevice_;
-    std::mt19937 randomGenerator_;
-    std::normal_distribution<> normalDistribution_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    Direction inbound_;
+    Direction outbound_;
+    std::vector<Packet*> released_;
+    std::vector<Packet*> sent_;
+    int64_t wakeTime_;
+    bool stopped_;
+
+    std::mutex senderMutex_;
+    SendFunc sender_;
 
-    boost::asio::io_service io_service_;
-    boost::asio::io_service::work work_;
     std::thread thread_;
 };
 
@@ -1,13 +1,99 @@
 #include "LatencyEstimator.h"
+#include "Clock.h"
+
+#include <algorithm>
+#include <cmath>
+
+// The gains of the smoothed round trip time and of its variation, see RFC 6298.
+static const float RTT_ALPHA = 1.0f / 8.0f;
+static const float RTT_BETA = 1.0f / 4.0f;
+
+// Samples beyond this are measurement errors, e.g. from a wrapped time stamp.
+static const float MAX_RTT = 10.0f;
+
+// The timeout is never shorter than this.
+static const float MIN_TIMEOUT = 0.01f;
+
+// The percentiles have a resolution of 1 ms up to 1 s.
+static const int64_t BUCKET_WIDTH = 1000000;
+static const uint32_t BUCKET_COUNT = 1000;
+
+// The histogram is halved after this many samples, so that it follows changes.
+static const uint64_t DECAY_INTERVAL = 64;
 
 LatencyEstimator::LatencyEstimator(unsigned int windowSize)
-: accu_(boost::accumulators::tag::rolling_window::window_size = windowSize) {
+: window_()
+, windowIndex_(0)
+, histogram_(BUCKET_WIDTH, BUCKET_COUNT)
+, sampleCount_(0)
+, smoothedRTT_(0)
+, rttVariation_(0)
+, minRTT_(0)
+, medianRTT_(0)
+, p95RTT_(0)
+, p99RTT_(0) {
+    window_.reserve(std::max(windowSize, 1u));
 }
 
 void LatencyEstimator::addRTT(float value) {
-    accu_(value);
+    if (!(value >= 0.0f && value <= MAX_RTT)) {
+        return;
+    }
+
+    if (sampleCount_ == 0) {
+        smoothedRTT_ = value;
+        rttVariation_ = value / 2.0f;
+    } else {
+        rttVariation_ = (1.0f - RTT_BETA) * rttVariation_ + RTT_BETA * std::fabs(smoothedRTT_ - value);
+        smoothedRTT_ = (1.0f - RTT_ALPHA) * smoothedRTT_ + RTT_ALPHA * value;
+    }
+    sampleCount_++;
+
+    if (window_.size() < window_.capacity()) {
+        window_.push_back(value);
+    } else {
+        window_[windowIndex_] = value;
+        windowIndex_ = (windowIndex_ + 1) % window_.size();
+    }
+    minRTT_ = *std::min_element(window_.begin(), window_.end());
+
+    if (sampleCount_ % DECAY_INTERVAL == 0) {
+        histogram_.decay();
+    }
+    histogram_.add(Clock::toNanoseconds(value));
+    medianRTT_ = Clock::toSeconds(histogram_.getPercentile(0.5));
+    p95RTT_ = Clock::toSeconds(histogram_.getPercentile(0.95));
+    p99RTT_ = Clock::toSeconds(histogram_.getPercentile(0.99));
+}
+
+uint64_t LatencyEstimator::getSampleCount() const {
+    return sampleCount_;
+}
+
+float LatencyEstimator::getSmoothedRTT() const {
+    return smoothedRTT_;
+}
+
+float LatencyEstimator::getRTTVariation() const {
+    return rttVariation_;
+}
+
+float LatencyEstimator::getTimeout() const {
+    return std::max(smoothedRTT_ + 4.0f * rttVariation_, MIN_TIMEOUT);
+}
+
+float LatencyEstimator::getMinRTT() const {
+    return minRTT_;
+}
+
+float LatencyEstimator::getMedianRTT() const {
+    return medianRTT_;
+}
+
+float LatencyEstimator::getP95RTT() const {
+    return p95RTT_;
 }
 
-float LatencyEstimator::getMeanRTT() const {
-    return boost::accumulators::rolling_mean(accu_);
+float LatencyEstimator::getP99RTT() const {
+    return p99RTT_;
 }
@@ -1,20 +1,68 @@
 #ifndef _LatencyEstimator_H
 #define _LatencyEstimator_H
 
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics/stats.hpp>
-#include <boost/accumulators/statistics/rolling_mean.hpp>
+#include "Histogram.h"
 
+#include <vector>
+
+/** Keeps statistics of the round trip time to a remote end.
+
+    The smoothed round trip time and its variation follow RFC 6298, the
+    minimum is taken over the latest samples, and the percentiles come from a
+    histogram whose old samples fade out. All statistics are updated when a
+    sample is added, so reading them is cheap.
+ */
 class LatencyEstimator {
 public:
+    /** Constructor
+
+        \param windowSize the number of latest samples over which the minimum is taken.
+     */
     explicit LatencyEstimator(unsigned int windowSize);
 
+    /** Adds a measured round trip time in seconds. Negative and implausibly
+        large values are ignored.
+     */
     void addRTT(float value);
 
-    float getMeanRTT() const;
+    /** Returns the number of samples added so far.
+     */
+    uint64_t getSampleCount() const;
+
+    /** Returns the smoothed round trip time in seconds, or 0 without samples.
+     */
+    float getSmoothedRTT() const;
+
+    /** Returns the smoothed deviation of the round trip time in seconds, i.e.
+        the jitter.
+     */
+    float getRTTVariation() const;
+
+    /** Returns the time after which a reply can be considered lost, in seconds.
+     */
+    float getTimeout() const;
+
+    float getMinRTT() const;
+
+    float getMedianRTT() const;
+
+    float getP95RTT() const;
+
+    float getP99RTT() const;
 
 private:
-    boost::accumulators::accumulator_set<float, boost::accumulators::stats<boost::accumulators::tag::rolling_mean>> accu_;
+    std::vector<float> window_;
+    std::size_t windowIndex_;
+
+    Histogram histogram_;
+
+    uint64_t sampleCount_;
+    float smoothedRTT_;
+    float rttVariation_;
+    float minRTT_;
+    float medianRTT_;
+    float p95RTT_;
+    float p99RTT_;
 };
 
 #endif  // _LatencyEstimator_H
@@ -0,0 +1,122 @@
+#include "LatencyTrace.h"
+#include "ByteSwap.h"
+#include "Clock.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+// The binary format starts with this, followed by the number of samples and
+// then the time and the delay of each in microseconds, all in the byte order
+// of packets. A delay of -1 marks a lost packet.
+static const char BINARY_MAGIC[4] = { 'H', 'L', 'T', 'R' };
+
+static const int64_t NANOSECONDS_PER_MICROSECOND = 1000;
+
+template<typename T>
+static void writeValue(std::ostream& stream, T value) {
+    const auto swapped = ByteSwap(value);
+    stream.write(reinterpret_cast<const char*>(&swapped), sizeof(swapped));
+}
+
+template<typename T>
+static T readValue(std::istream& stream) {
+    T value{};
+    if (!stream.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+        throw std::runtime_error("truncated latency trace");
+    }
+    return ByteSwap(value);
+}
+
+LatencyTrace::LatencyTrace(std::vector<Sample> samples)
+: samples_(std::move(samples)) {
+    if (samples_.empty()) {
+        throw std::runtime_error("empty latency trace");
+    }
+    std::stable_sort(samples_.begin(), samples_.end(), [] (const Sample& a, const Sample& b) { return a.time < b.time; });
+}
+
+std::shared_ptr<LatencyTrace> LatencyTrace::read(std::istream& stream) {
+    char magic[sizeof(BINARY_MAGIC)] = {};
+    stream.read(magic, sizeof(magic));
+    if (stream && memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0) {
+        return readBinary(stream);
+    }
+    stream.clear();
+    stream.seekg(0);
+    return readCsv(stream);
+}
+
+std::shared_ptr<LatencyTrace> LatencyTrace::load(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        throw std::runtime_error("cannot open latency trace " + path);
+    }
+    return read(stream);
+}
+
+void LatencyTrace::write(std::ostream& stream) const {
+    stream.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeValue(stream, static_cast<uint32_t>(samples_.size()));
+    for (const auto& sample : samples_) {
+        writeValue(stream, static_cast<uint32_t>(sample.time / NANOSECONDS_PER_MICROSECOND));
+        writeValue(stream, static_cast<int32_t>(sample.isLost() ? -1 : sample.delay / NANOSECONDS_PER_MICROSECOND));
+    }
+}
+
+const LatencyTrace::Sample& LatencyTrace::getSample(int64_t time) const {
+    auto itr = std::upper_bound(samples_.begin(), samples_.end(), time, [] (int64_t t, const Sample& sample) { return t < sample.time; });
+    return itr == samples_.begin() ? *itr : *(itr - 1);
+}
+
+int64_t LatencyTrace::getDuration() const {
+    return samples_.back().time;
+}
+
+std::size_t LatencyTrace::getSampleCount() const {
+    return samples_.size();
+}
+
+std::shared_ptr<LatencyTrace> LatencyTrace::readBinary(std::istream& stream) {
+    const auto count = readValue<uint32_t>(stream);
+    // The count is not trusted to reserve memory, a corrupt file ends as a truncated one.
+    std::vector<Sample> samples;
+    for (uint32_t i = 0; i < count; i++) {
+        const auto time = static_cast<int64_t>(readValue<uint32_t>(stream)) * NANOSECONDS_PER_MICROSECOND;
+        const auto delay = readValue<int32_t>(stream);
+        samples.emplace_back(time, delay < 0 ? -1 : static_cast<int64_t>(delay) * NANOSECONDS_PER_MICROSECOND);
+    }
+    return std::make_shared<LatencyTrace>(std::move(samples));
+}
+
+std::shared_ptr<LatencyTrace> LatencyTrace::readCsv(std::istream& stream) {
+    std::vector<Sample> samples;
+    std::string line;
+    unsigned int lineNumber = 0;
+    while (std::getline(stream, line)) {
+        lineNumber++;
+        line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        const auto separator = line.find(',');
+        const auto time = line.substr(0, separator);
+        const auto delay = separator == std::string::npos ? std::string() : line.substr(separator + 1);
+        try {
+            const auto sampleTime = Clock::toNanoseconds(boost::lexical_cast<double>(time) / 1000.0);
+            const auto sampleDelay = delay == "lost" ? -1.0 : boost::lexical_cast<double>(delay);
+            samples.emplace_back(sampleTime, sampleDelay < 0.0 ? -1 : Clock::toNanoseconds(sampleDelay / 1000.0));
+        } catch (const boost::bad_lexical_cast&) {
+            // A header names the columns.
+            if (samples.empty() && lineNumber == 1) {
+                continue;
+            }
+            throw std::runtime_error("malformed latency trace in line " + std::to_string(lineNumber));
+        }
+    }
+    return std::make_shared<LatencyTrace>(std::move(samples));
+}
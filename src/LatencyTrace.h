@@ -0,0 +1,79 @@
+#ifndef _LatencyTrace_H
+#define _LatencyTrace_H
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/** A recording of the delays and losses of the packets on a network path.
+
+    Each sample holds the time at which a packet was sent, relative to the
+    start of the recording, and its one-way delay or that it was lost. During
+    a replay, a packet sent at some time of the trace gets the fate of the
+    latest sample at or before that time.
+
+    Traces are read from CSV, one "time,delay" line per packet in milliseconds
+    with "lost" or a negative delay for a lost packet, or from a compact binary
+    file of 8 bytes per packet.
+ */
+class LatencyTrace {
+public:
+    struct Sample {
+        Sample(int64_t sampleTime, int64_t sampleDelay)
+        : time(sampleTime)
+        , delay(sampleDelay) {
+        }
+
+        bool isLost() const {
+            return delay < 0;
+        }
+
+        // In nanoseconds, the delay negative for a lost packet.
+        int64_t time;
+        int64_t delay;
+    };
+
+    /** Constructor
+
+        \param samples the samples, ordered by their time.
+     */
+    explicit LatencyTrace(std::vector<Sample> samples);
+
+    /** Reads a trace in either format.
+
+        \throws std::runtime_error if the trace is empty or malformed.
+     */
+    static std::shared_ptr<LatencyTrace> read(std::istream& stream);
+
+    /** Reads a trace from a file in either format.
+
+        \throws std::runtime_error if the file cannot be read.
+     */
+    static std::shared_ptr<LatencyTrace> load(const std::string& path);
+
+    /** Writes the trace in the binary format.
+     */
+    void write(std::ostream& stream) const;
+
+    /** Returns the sample in effect at a time of the trace in nanoseconds.
+     */
+    const Sample& getSample(int64_t time) const;
+
+    /** Returns the time of the last sample in nanoseconds.
+     */
+    int64_t getDuration() const;
+
+    std::size_t getSampleCount() const;
+
+private:
+    static std::shared_ptr<LatencyTrace> readBinary(std::istream& stream);
+
+    static std::shared_ptr<LatencyTrace> readCsv(std::istream& stream);
+
+    std::vector<Sample> samples_;
+};
+
+#endif  // _LatencyTrace_H
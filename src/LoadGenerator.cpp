@@ -0,0 +1,443 @@
+#include "LoadGenerator.h"
+#include "Protocol.h"
+#include "Logging.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+const uint8_t LoadGenerator::KeyUp;
+const uint8_t LoadGenerator::KeyLeft;
+const uint8_t LoadGenerator::KeyRight;
+const uint8_t LoadGenerator::KeySpace;
+
+// The interval between two TICKs in seconds, as sent by the GameClient.
+static const double TICK_INTERVAL = 0.5;
+
+// The interval at which the statistics are logged, in seconds.
+static const double REPORT_INTERVAL = 5.0;
+
+// Random keys are held for this many seconds on average.
+static const float MEAN_RANDOM_KEYS_TIME = 0.3f;
+
+// Moves the server has not acknowledged are resent with each INPUT. Beyond
+// this many the oldest are given up, so that INPUT still fits into a packet
+// while the server drops STATE updates.
+static const uint32_t MAX_UNACKNOWLEDGED_MOVES = 32;
+
+// The round trip time is counted in buckets of 0.1 ms up to 1 s.
+static const int64_t ROUND_TRIP_TIME_BUCKET_WIDTH = 100000;
+static const uint32_t ROUND_TRIP_TIME_BUCKET_COUNT = 10000;
+
+// A client whose socket cannot be opened, e.g. for lack of file descriptors,
+// tries again after this many seconds.
+static const double CONNECT_RETRY_INTERVAL = 1.0;
+
+LoadGenerator::Statistics::Statistics()
+: connects(0)
+, disconnects(0)
+, helloPackets(0)
+, inputPackets(0)
+, tickPackets(0)
+, tockPackets(0)
+, statePackets(0)
+, stateBytes(0)
+, sendErrors(0)
+, connectedTime(0) {
+}
+
+LoadGenerator::Client::Client(boost::asio::io_service& ioService, int64_t clientStartTime)
+: socket(ioService)
+, inputHandler()
+, session(0)
+, playerId(PROTOCOL_INVALID_PLAYER_ID)
+, tick(0)
+, serverTime(0)
+, step(0)
+, startTime(clientStartTime)
+, helloTime(0)
+, inputTime(0)
+, tickTime(0)
+, nextKeysTime(0)
+, leaveTime(std::numeric_limits<int64_t>::max()) {
+}
+
+LoadGenerator::LoadGenerator(const boost::asio::ip::udp::endpoint& server, uint32_t clientCount, const std::vector<InputStep>& inputScript,
+                             float sessionTime, float rampUpTime, unsigned int tickRate)
+: server_(server)
+, inputScript_(inputScript)
+, sessionTime_(sessionTime)
+, tickDuration_(Clock::toNanoseconds(1.0 / tickRate))
+, io_service_()
+, frameTimer_(io_service_)
+, clock_()
+, clients_()
+, packet_(1500)
+, random_(std::random_device()())
+, statistics_()
+, reported_()
+, roundTripTime_(ROUND_TRIP_TIME_BUCKET_WIDTH, ROUND_TRIP_TIME_BUCKET_COUNT)
+, intervalRoundTripTime_(ROUND_TRIP_TIME_BUCKET_WIDTH, ROUND_TRIP_TIME_BUCKET_COUNT)
+, lastReport_(0)
+, endTime_(0)
+, running_(nullptr) {
+    // The clients connect one after the other over the ramp up time, and each
+    // starts at another step of the script.
+    for (uint32_t i = 0; i < clientCount; i++) {
+        const auto startTime = Clock::toNanoseconds(rampUpTime * static_cast<double>(i) / static_cast<double>(clientCount));
+        clients_.push_back(std::make_unique<Client>(io_service_, startTime));
+        if (!inputScript_.empty()) {
+            clients_.back()->step = random_() % inputScript_.size();
+        }
+    }
+}
+
+void LoadGenerator::run(const std::atomic<bool>& running, float duration) {
+    running_ = &running;
+    clock_.update();
+    const auto start = clock_.getFrameStart();
+    lastReport_ = start;
+    endTime_ = duration > 0.0f ? start + Clock::toNanoseconds(duration) : 0;
+    for (auto& client : clients_) {
+        client->startTime += start;
+    }
+    INFO("Running {0} clients against {1}.", clients_.size(), server_);
+
+    io_service_.reset();
+    frameTimer_.expires_from_now(std::chrono::nanoseconds(0));
+    frameTimer_.async_wait([this] (const boost::system::error_code& ec) {
+        if (!ec) {
+            update();
+        }
+    });
+    io_service_.run();
+
+    clock_.update();
+    INFO("In total:");
+    report(Statistics(), roundTripTime_, clock_.getFrameStart() - start);
+}
+
+const LoadGenerator::Statistics& LoadGenerator::getStatistics() const {
+    return statistics_;
+}
+
+const Histogram& LoadGenerator::getRoundTripTime() const {
+    return roundTripTime_;
+}
+
+uint32_t LoadGenerator::getConnectedCount() const {
+    return static_cast<uint32_t>(std::count_if(clients_.begin(), clients_.end(), [] (const std::unique_ptr<Client>& client) {
+        return client->socket.is_open() && client->playerId != PROTOCOL_INVALID_PLAYER_ID;
+    }));
+}
+
+std::vector<LoadGenerator::InputStep> LoadGenerator::parseInputPattern(const std::string& pattern) {
+    if (pattern == "random") {
+        return {};
+    }
+    if (pattern == "idle") {
+        return { InputStep(0, 1.0f) };
+    }
+    if (pattern == "steady") {
+        return { InputStep(KeyUp | KeyLeft, 1.0f) };
+    }
+
+    std::vector<InputStep> steps;
+    std::istringstream stream(pattern);
+    std::string step;
+    while (std::getline(stream, step, ',')) {
+        const auto separator = step.find(':');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument("input step '" + step + "' has no duration");
+        }
+        uint8_t keys = 0;
+        for (auto key : step.substr(0, separator)) {
+            switch (key) {
+            case 'u':
+                keys = static_cast<uint8_t>(keys | KeyUp);
+                break;
+            case 'l':
+                keys = static_cast<uint8_t>(keys | KeyLeft);
+                break;
+            case 'r':
+                keys = static_cast<uint8_t>(keys | KeyRight);
+                break;
+            case 's':
+                keys = static_cast<uint8_t>(keys | KeySpace);
+                break;
+            case '-':
+                break;
+            default:
+                throw std::invalid_argument("unknown key '" + std::string(1, key) + "' in input step '" + step + "'");
+            }
+        }
+        float duration = 0.0f;
+        try {
+            duration = boost::lexical_cast<float>(step.substr(separator + 1));
+        } catch (const boost::bad_lexical_cast&) {
+            throw std::invalid_argument("invalid duration of input step '" + step + "'");
+        }
+        if (!(duration > 0.0f)) {
+            throw std::invalid_argument("input step '" + step + "' is not positive");
+        }
+        steps.emplace_back(keys, duration);
+    }
+    if (steps.empty()) {
+        throw std::invalid_argument("empty input pattern");
+    }
+    return steps;
+}
+
+void LoadGenerator::connect(Client& client, int64_t now) {
+    using namespace boost::asio::ip;
+    // A new socket is a new endpoint, and thus a new player for the server.
+    boost::system::error_code ec;
+    client.socket.open(udp::v4(), ec);
+    if (!ec) {
+        client.socket.bind(udp::endpoint(udp::v4(), 0), ec);
+    }
+    if (!ec) {
+        client.socket.non_blocking(true, ec);
+    }
+    if (ec) {
+        WARN("Failed to open the socket of a client: {0}", ec.message());
+        client.socket.close(ec);
+        client.startTime = now + Clock::toNanoseconds(CONNECT_RETRY_INTERVAL);
+        return;
+    }
+
+    client.session++;
+    client.playerId = PROTOCOL_INVALID_PLAYER_ID;
+    client.inputHandler.getMoveList().clear();
+    client.helloTime = now - Clock::toNanoseconds(PROTOCOL_HELLO_INTERVAL);
+    client.nextKeysTime = now;
+    client.leaveTime = sessionTime_ > 0.0f ? now + getSessionTime() : std::numeric_limits<int64_t>::max();
+    waitForPackets(client);
+}
+
+void LoadGenerator::disconnect(Client& client, int64_t now) {
+    // The client simply goes silent, like a player whose game crashed.
+    boost::system::error_code ec;
+    client.socket.close(ec);
+    client.startTime = now;
+    statistics_.disconnects++;
+}
+
+void LoadGenerator::waitForPackets(Client& client) {
+    const auto session = client.session;
+    client.socket.async_wait(boost::asio::ip::udp::socket::wait_read, [this, &client, session] (const boost::system::error_code& ec) {
+        // A handler of a closed socket can still be pending.
+        if (!ec && client.session == session && client.socket.is_open()) {
+            receive(client);
+            waitForPackets(client);
+        }
+    });
+}
+
+void LoadGenerator::receive(Client& client) {
+    boost::asio::ip::udp::endpoint sender;
+    boost::system::error_code ec;
+    while (true) {
+        const auto size = client.socket.receive_from(boost::asio::buffer(packet_.getData(), packet_.getCapacity()), sender, 0, ec);
+        if (ec) {
+            break;
+        }
+        packet_.setSize(static_cast<uint32_t>(size));
+        packet_.reset();
+        try {
+            handlePacket(client);
+        } catch (const std::out_of_range&) {
+            DEBUG("Received a truncated packet from {0}.", sender);
+        }
+    }
+}
+
+void LoadGenerator::handlePacket(Client& client) {
+    uint32_t magicNumber = 0;
+    unsigned char protocolVersion = 0, packetType = PROTOCOL_PACKET_TYPE_INVALID;
+    packet_.read(magicNumber);
+    packet_.read(protocolVersion);
+    if (magicNumber != PROTOCOL_MAGIC_NUMBER || protocolVersion != PROTOCOL_VERSION) {
+        return;
+    }
+    packet_.read(packetType);
+    switch (packetType) {
+    case PROTOCOL_PACKET_TYPE_WELCOME:
+        if (client.playerId == PROTOCOL_INVALID_PLAYER_ID) {
+            packet_.read(client.playerId);
+            // The first INPUT and TICK go out with the next update.
+            client.inputTime = clock_.getFrameStart() - Clock::toNanoseconds(PROTOCOL_INPUT_HEARTBEAT);
+            client.tickTime = clock_.getFrameStart() - Clock::toNanoseconds(TICK_INTERVAL);
+            statistics_.connects++;
+        }
+        break;
+    case PROTOCOL_PACKET_TYPE_STATE: {
+        uint32_t latestInputTick = 0;
+        float timeScale = 1.0f;
+        packet_.read(latestInputTick);
+        packet_.read(timeScale);
+        packet_.read(client.serverTime);
+        client.inputHandler.getMoveList().removeMovesUntil(latestInputTick);
+        statistics_.statePackets++;
+        statistics_.stateBytes += packet_.getSize();
+        break;
+    }
+    case PROTOCOL_PACKET_TYPE_TOCK: {
+        uint32_t originate = 0, receive = 0, transmit = 0;
+        packet_.read(originate);
+        packet_.read(receive);
+        packet_.read(transmit);
+        // Only the difference of the server's time stamps matters.
+        const auto arrivalTime = clock_.now();
+        const auto originateTime = fromProtocolTime(originate, arrivalTime);
+        const auto receiveTime = fromProtocolTime(receive, 0);
+        const auto transmitTime = fromProtocolTime(transmit, receiveTime);
+        const auto roundTripTime = (arrivalTime - originateTime) - (transmitTime - receiveTime);
+        roundTripTime_.add(roundTripTime);
+        intervalRoundTripTime_.add(roundTripTime);
+        statistics_.tockPackets++;
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void LoadGenerator::update() {
+    clock_.update();
+    const auto now = clock_.getFrameStart();
+    for (auto& client : clients_) {
+        if (!client->socket.is_open()) {
+            if (now < client->startTime) {
+                continue;
+            }
+            connect(*client, now);
+            if (!client->socket.is_open()) {
+                continue;
+            }
+        }
+        updateClient(*client, now);
+    }
+
+    if (now - lastReport_ >= Clock::toNanoseconds(REPORT_INTERVAL)) {
+        report(reported_, intervalRoundTripTime_, now - lastReport_);
+        reported_ = statistics_;
+        intervalRoundTripTime_.clear();
+        lastReport_ = now;
+    }
+
+    if (!*running_ || (endTime_ > 0 && now >= endTime_)) {
+        io_service_.stop();
+        return;
+    }
+
+    frameTimer_.expires_from_now(std::chrono::nanoseconds(std::max(now + tickDuration_ - clock_.now(), int64_t(0))));
+    frameTimer_.async_wait([this] (const boost::system::error_code& ec) {
+        if (!ec) {
+            update();
+        }
+    });
+}
+
+void LoadGenerator::updateClient(Client& client, int64_t now) {
+    if (now >= client.leaveTime) {
+        disconnect(client, now);
+        return;
+    }
+
+    if (client.playerId == PROTOCOL_INVALID_PLAYER_ID) {
+        if (now - client.helloTime >= Clock::toNanoseconds(PROTOCOL_HELLO_INTERVAL)) {
+            createHelloPacket(&packet_, server_);
+            send(client);
+            statistics_.helloPackets++;
+            client.helloTime = now;
+        }
+        return;
+    }
+    statistics_.connectedTime += tickDuration_;
+
+    updateKeys(client, now);
+    client.tick++;
+    client.inputHandler.update(client.tick, Clock::toSeconds(tickDuration_));
+    auto& moveList = client.inputHandler.getMoveList();
+    if (moveList.getCount() > MAX_UNACKNOWLEDGED_MOVES) {
+        moveList.removeMovesUntil(moveList.getLatestTick() - MAX_UNACKNOWLEDGED_MOVES);
+    }
+
+    // Like the GameClient, a change goes out right away and steady input as a
+    // heartbeat. The player looks at the latest STATE update.
+    const auto sinceInput = now - client.inputTime;
+    const auto changed = client.inputHandler.hasUnsentChanges();
+    if ((changed && sinceInput >= Clock::toNanoseconds(PROTOCOL_INPUT_COALESCE_WINDOW)) || sinceInput >= Clock::toNanoseconds(PROTOCOL_INPUT_HEARTBEAT)) {
+        createInputPacket(&packet_, client.playerId, server_, moveList, static_cast<int64_t>(client.serverTime) * 1000);
+        send(client);
+        client.inputHandler.handleMovesSent(moveList.getLatestTick(), now);
+        client.inputTime = now;
+        statistics_.inputPackets++;
+    }
+
+    if (now - client.tickTime > Clock::toNanoseconds(TICK_INTERVAL)) {
+        createTickPacket(&packet_, client.playerId, clock_.now(), server_);
+        send(client);
+        client.tickTime = now;
+        statistics_.tickPackets++;
+    }
+}
+
+void LoadGenerator::updateKeys(Client& client, int64_t now) {
+    if (now < client.nextKeysTime) {
+        return;
+    }
+
+    uint8_t keys = 0;
+    float duration = 0.0f;
+    if (inputScript_.empty()) {
+        keys = static_cast<uint8_t>(random_() % 16);
+        duration = std::exponential_distribution<float>(1.0f / MEAN_RANDOM_KEYS_TIME)(random_);
+    } else {
+        const auto& step = inputScript_[client.step];
+        keys = step.keys;
+        duration = step.duration;
+        client.step = (client.step + 1) % inputScript_.size();
+    }
+    client.nextKeysTime = now + Clock::toNanoseconds(duration);
+
+    // The same amounts as the keys of a GameClient.
+    InputState inputState;
+    inputState.desiredForwardAmount = (keys & KeyUp) ? 1.0f : 0.0f;
+    inputState.desiredLeftAmount = (keys & KeyLeft) ? 5.0f : 0.0f;
+    inputState.desiredRightAmount = (keys & KeyRight) ? 5.0f : 0.0f;
+    inputState.shooting = (keys & KeySpace) != 0;
+    client.inputHandler.setInputState(inputState, now);
+}
+
+void LoadGenerator::send(Client& client) {
+    boost::system::error_code ec;
+    client.socket.send_to(boost::asio::buffer(packet_.getData(), packet_.getSize()), server_, 0, ec);
+    if (ec) {
+        statistics_.sendErrors++;
+    }
+}
+
+int64_t LoadGenerator::getSessionTime() {
+    return Clock::toNanoseconds(std::exponential_distribution<double>(1.0 / sessionTime_)(random_));
+}
+
+void LoadGenerator::report(const Statistics& since, const Histogram& roundTripTime, int64_t duration) const {
+    const auto connectedTime = Clock::toSeconds(statistics_.connectedTime - since.connectedTime);
+    const auto ticks = statistics_.tickPackets - since.tickPackets;
+    const auto tocks = statistics_.tockPackets - since.tockPackets;
+    const auto stateBytes = static_cast<float>(statistics_.stateBytes - since.stateBytes);
+    const auto statePackets = static_cast<float>(statistics_.statePackets - since.statePackets);
+    // The TICKs of the last round trip are still on their way.
+    const auto loss = ticks > tocks ? 100.0f * static_cast<float>(ticks - tocks) / static_cast<float>(ticks) : 0.0f;
+    INFO("{0} of {1} clients welcome. Round trip time P50 {2} ms, P95 {3} ms, P99 {4} ms, max {5} ms.", getConnectedCount(), clients_.size(),
+         Clock::toSeconds(roundTripTime.getPercentile(0.5)) * 1000.0f, Clock::toSeconds(roundTripTime.getPercentile(0.95)) * 1000.0f,
+         Clock::toSeconds(roundTripTime.getPercentile(0.99)) * 1000.0f, Clock::toSeconds(roundTripTime.getMax()) * 1000.0f);
+    INFO("STATE {0} bytes/s and {1} packets/s per client, {2}% of TICKs unanswered, {3} connects and {4} disconnects in {5} s, {6} send errors.",
+         connectedTime > 0.0f ? stateBytes / connectedTime : 0.0f, connectedTime > 0.0f ? statePackets / connectedTime : 0.0f, loss,
+         statistics_.connects - since.connects, statistics_.disconnects - since.disconnects, Clock::toSeconds(duration), statistics_.sendErrors - since.sendErrors);
+}
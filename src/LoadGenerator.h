@@ -0,0 +1,181 @@
+#ifndef _LoadGenerator_H
+#define _LoadGenerator_H
+
+#include "Clock.h"
+#include "Histogram.h"
+#include "InputHandler.h"
+#include "Packet.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/** Drives a server with many simulated clients in one process.
+
+    Each client has a UDP socket of its own and speaks the protocol of the
+    GameClient: it says HELLO until it is welcome, samples a move per tick from
+    its input pattern, sends INPUT on changes and as a heartbeat, and
+    measures the round trip time with TICK and TOCK. Clients neither simulate
+    nor render the world; a STATE update is only counted and acknowledged.
+    A client can leave after a random time, whereupon a new one takes its
+    place, to churn the connections of the server.
+
+    All clients run on the thread that calls run().
+ */
+class LoadGenerator {
+public:
+    /** Keys held by a client, as a combination of the Key... flags.
+     */
+    static const uint8_t KeyUp = 1;
+    static const uint8_t KeyLeft = 2;
+    static const uint8_t KeyRight = 4;
+    static const uint8_t KeySpace = 8;
+
+    /** A step of an input script: the keys held for a while.
+     */
+    struct InputStep {
+        InputStep(uint8_t stepKeys, float stepDuration)
+        : keys(stepKeys)
+        , duration(stepDuration) {
+        }
+
+        uint8_t keys;
+        float duration;
+    };
+
+    struct Statistics {
+        Statistics();
+
+        uint64_t connects;
+        uint64_t disconnects;
+        uint64_t helloPackets;
+        uint64_t inputPackets;
+        uint64_t tickPackets;
+        uint64_t tockPackets;
+        uint64_t statePackets;
+        uint64_t stateBytes;
+        uint64_t sendErrors;
+        // The sum of the times the clients were connected, in nanoseconds.
+        int64_t connectedTime;
+    };
+
+    /** Constructor
+
+        \param server the endpoint of the server.
+        \param clientCount the number of clients connected at the same time.
+        \param inputScript the steps the clients loop through, or an empty
+               script for keys that change at random.
+        \param sessionTime the mean time in seconds a client stays before it
+               is replaced by a new one, 0 for clients that stay.
+        \param rampUpTime the time in seconds over which the clients connect.
+        \param tickRate the number of ticks per second of each client.
+     */
+    LoadGenerator(const boost::asio::ip::udp::endpoint& server, uint32_t clientCount, const std::vector<InputStep>& inputScript,
+                  float sessionTime, float rampUpTime, unsigned int tickRate);
+
+    LoadGenerator(const LoadGenerator&) = delete;
+
+    LoadGenerator& operator =(const LoadGenerator&) = delete;
+
+    /** Runs the clients until running becomes false or the duration is over.
+        Must only be called once.
+
+        \param running the flag to stop the clients with.
+        \param duration the duration in seconds, 0 to run until stopped.
+     */
+    void run(const std::atomic<bool>& running, float duration);
+
+    /** Returns the counters since the start. Only valid while run() does not run.
+     */
+    const Statistics& getStatistics() const;
+
+    /** Returns the round trip times measured since the start, in nanoseconds.
+        Only valid while run() does not run.
+     */
+    const Histogram& getRoundTripTime() const;
+
+    /** Returns the number of clients that are welcome. Only valid while run()
+        does not run.
+     */
+    uint32_t getConnectedCount() const;
+
+    /** Parses an input pattern: "idle", "steady" for thrusting in circles,
+        "random", or a script of comma separated steps "<keys>:<seconds>",
+        where the keys are any of u, l, r and s for up, left, right and space,
+        or - for none, e.g. "ul:1,s:0.2,-:0.5".
+
+        \return the steps, empty for random keys.
+        \throws std::invalid_argument if the pattern is not valid.
+     */
+    static std::vector<InputStep> parseInputPattern(const std::string& pattern);
+
+private:
+    struct Client {
+        Client(boost::asio::io_service& ioService, int64_t startTime);
+
+        boost::asio::ip::udp::socket socket;
+        InputHandler inputHandler;
+        uint32_t session;
+        uint32_t playerId;
+        uint32_t tick;
+        uint32_t serverTime;
+        std::size_t step;
+        int64_t startTime;
+        int64_t helloTime;
+        int64_t inputTime;
+        int64_t tickTime;
+        int64_t nextKeysTime;
+        int64_t leaveTime;
+    };
+
+    void connect(Client& client, int64_t now);
+
+    void disconnect(Client& client, int64_t now);
+
+    void waitForPackets(Client& client);
+
+    void receive(Client& client);
+
+    void handlePacket(Client& client);
+
+    void update();
+
+    void updateClient(Client& client, int64_t now);
+
+    void updateKeys(Client& client, int64_t now);
+
+    void send(Client& client);
+
+    void report(const Statistics& since, const Histogram& roundTripTime, int64_t duration) const;
+
+    int64_t getSessionTime();
+
+    const boost::asio::ip::udp::endpoint server_;
+    const std::vector<InputStep> inputScript_;
+    const float sessionTime_;
+    const int64_t tickDuration_;
+
+    boost::asio::io_service io_service_;
+    boost::asio::steady_timer frameTimer_;
+    Clock clock_;
+
+    std::vector<std::unique_ptr<Client>> clients_;
+
+    Packet packet_;
+    std::mt19937 random_;
+
+    Statistics statistics_;
+    Statistics reported_;
+    Histogram roundTripTime_;
+    Histogram intervalRoundTripTime_;
+    int64_t lastReport_;
+    int64_t endTime_;
+    const std::atomic<bool>* running_;
+};
+
+#endif  // _LoadGenerator_H
@@ -3,22 +3,41 @@
 #include "Renderer.h"
 #include "Utilities.h"
 #include "Sound.h"
+#include "MoveList.h"
 
-LocalSpaceShip::LocalSpaceShip(const Renderer& renderer, InputHandler& inputHandler, ShootFunc shootFunc, const Vector2d& position)
-: SpaceShip(renderer, position)
+#include <cmath>
+
+// About four seconds of moves at one move per tick and 60 ticks per second.
+static const uint32_t PREDICTION_HISTORY_SIZE = 256;
+
+// The server state matches a prediction if it differs by less than this.
+static const float PREDICTION_EPSILON = 0.01f;
+
+static bool isClose(const Vector2d& a, const Vector2d& b) {
+    return std::abs(a.getX() - b.getX()) < PREDICTION_EPSILON && std::abs(a.getY() - b.getY()) < PREDICTION_EPSILON;
+}
+
+static bool matches(const BodyState& a, const BodyState& b) {
+    return isClose(a.position, b.position) && isClose(a.velocity, b.velocity) && isClose(a.lookAt, b.lookAt) &&
+           std::abs(a.angle - b.angle) < PREDICTION_EPSILON && a.thrust == b.thrust;
+}
+
+LocalSpaceShip::LocalSpaceShip(const Renderer& renderer, Kinematics& kinematics, InputHandler& inputHandler, ShootFunc shootFunc, const Vector2d& position)
+: SpaceShip(renderer, kinematics, position)
 , inputHandler_(inputHandler)
+, predictionHistory_(PREDICTION_HISTORY_SIZE)
 , shootFunc_(shootFunc)
 , lastShot_(0)
 , length(std::max(getWidth(), getHeight()))
 , created_(true) {
 }
 
-LocalSpaceShip::LocalSpaceShip(const Renderer& renderer, InputHandler& inputHandler, ShootFunc shootFunc)
-: LocalSpaceShip(renderer, inputHandler, shootFunc, Vector2d(0, 0)) {
+LocalSpaceShip::LocalSpaceShip(const Renderer& renderer, Kinematics& kinematics, InputHandler& inputHandler, ShootFunc shootFunc)
+: LocalSpaceShip(renderer, kinematics, inputHandler, shootFunc, Vector2d(0, 0)) {
 }
 
-LocalSpaceShip::LocalSpaceShip(const Renderer& renderer, InputHandler& inputHandler)
-: LocalSpaceShip(renderer, inputHandler, nullptr) {
+LocalSpaceShip::LocalSpaceShip(const Renderer& renderer, Kinematics& kinematics, InputHandler& inputHandler)
+: LocalSpaceShip(renderer, kinematics, inputHandler, nullptr) {
 }
 
 void LocalSpaceShip::update(float elapsed) {
@@ -29,9 +48,11 @@ void LocalSpaceShip::update(float elapsed) {
 
     auto move = inputHandler_.getAndClearPendingMove();
     if (move) {
+        // The move is applied exactly as it is replayed and as the server applies it.
         const auto& inputState = move->getInputState();
-        rotate(inputState.desiredRightAmount * elapsed);
-        rotate(-inputState.desiredLeftAmount * elapsed);
+        const auto deltaTime = move->getDeltaTime();
+        rotate(inputState.desiredRightAmount * deltaTime);
+        rotate(-inputState.desiredLeftAmount * deltaTime);
         thrust(inputState.desiredForwardAmount > 0);
         if (inputState.shooting) {
             if (currentTime > lastTime + 0.5f) {
@@ -43,39 +64,57 @@ void LocalSpaceShip::update(float elapsed) {
             }
         }
     }
-
-    SpaceShip::update(elapsed);
 }
 
-void LocalSpaceShip::draw(Renderer& renderer) {
-    SpaceShip::draw(renderer);
-    renderer.drawRect(getPosition(), length, length);
+void LocalSpaceShip::draw(Renderer& renderer, float alpha) {
+    SpaceShip::draw(renderer, alpha);
+    renderer.drawRect(kinematics_.getPosition(body_, alpha), length, length);
 }
 
 void LocalSpaceShip::read(Packet* packet) {
-    const auto oldPosition = position_;
-    const auto oldVelocity = velocity_;
-    const auto oldLookat = lookat_;
-    const auto oldAcceleration = acceleration_;
+    const auto oldPosition = getPosition();
+    const auto oldVelocity = getVelocity();
+    const auto oldLookat = getLookAt();
 
     SpaceShip::read(packet);
 
-    MoveList& moveList = inputHandler_.getMoveList();
-    for (auto& move : moveList) {
-        const auto& inputState = move.getInputState();
-        float deltaTime = move.getDeltaTime();
-        rotate(inputState.desiredRightAmount * deltaTime);
-        rotate(-inputState.desiredLeftAmount * deltaTime);
-        thrust(inputState.desiredForwardAmount > 0);
-        SpaceShip::update(deltaTime);
-    }
+    replayMoves(inputHandler_.getMoveList());
 
     if (created_) {
         created_ = false;
     } else {
-        position_ = lerp(position_, oldPosition, 0.5f);
-        velocity_ = lerp(velocity_, oldVelocity, 0.5f);
-        lookat_ = lerp(lookat_, oldLookat, 0.5f);
-        acceleration_ = lerp(acceleration_, oldAcceleration, 0.5f);
+        setPosition(lerp(getPosition(), oldPosition, 0.5f));
+        setVelocity(lerp(getVelocity(), oldVelocity, 0.5f));
+        setLookAt(lerp(getLookAt(), oldLookat, 0.5f));
+    }
+}
+
+void LocalSpaceShip::replayMoves(const MoveList& moveList) {
+    // The moves acknowledged by the server have already been removed, so the
+    // checkpoint of the last acknowledged move is the newest one before the
+    // first remaining move.
+    const auto firstMove = moveList.begin();
+    const auto acknowledged = firstMove != moveList.end() ? predictionHistory_.findLatestBefore(firstMove->getTick()) : predictionHistory_.getNewest();
+
+    auto move = firstMove;
+    if (acknowledged && matches(acknowledged->state, getBodyState())) {
+        // The server agrees with the prediction, so the checkpoints of the later
+        // moves are still valid and only the moves after them are replayed.
+        predictionHistory_.removeBefore(acknowledged->tick);
+        const auto newest = predictionHistory_.getNewest();
+        setBodyState(newest->state);
+        move = moveList.findFirstMoveAfter(newest->tick);
+    } else {
+        predictionHistory_.clear();
+    }
+
+    for (; move != moveList.end(); ++move) {
+        const auto& inputState = move->getInputState();
+        float deltaTime = move->getDeltaTime();
+        rotate(inputState.desiredRightAmount * deltaTime);
+        rotate(-inputState.desiredLeftAmount * deltaTime);
+        thrust(inputState.desiredForwardAmount > 0);
+        integrate(deltaTime);
+        predictionHistory_.add(move->getTick(), getBodyState());
     }
 }
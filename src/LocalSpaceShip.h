@@ -2,33 +2,43 @@
 #define _LocalSpaceShip_H
 
 #include "SpaceShip.h"
+#include "PredictionHistory.h"
 
 #include <functional>
 
 class InputHandler;
+class MoveList;
 
-using ShootFunc = std::function<float (SpaceShip*, float)>;
+using ShootFunc = std::function<int64_t (SpaceShip*, int64_t)>;
 
 class LocalSpaceShip : public SpaceShip {
 public:
-    LocalSpaceShip(const Renderer& renderer, InputHandler& inputHandler, ShootFunc shootFunc, const Vector2d& position);
+    LocalSpaceShip(const Renderer& renderer, Kinematics& kinematics, InputHandler& inputHandler, ShootFunc shootFunc, const Vector2d& position);
 
-    LocalSpaceShip(const Renderer& renderer, InputHandler& inputHandler, ShootFunc shootFunc);
+    LocalSpaceShip(const Renderer& renderer, Kinematics& kinematics, InputHandler& inputHandler, ShootFunc shootFunc);
 
-    LocalSpaceShip(const Renderer& renderer, InputHandler& inputHandler);
+    LocalSpaceShip(const Renderer& renderer, Kinematics& kinematics, InputHandler& inputHandler);
 
     void update(float elapsed) override;
 
-    void draw(Renderer& renderer) override;
+    void draw(Renderer& renderer, float alpha) override;
 
     void read(Packet* packet) override;
 
 private:
+    /** Predicts the state after all unacknowledged moves, starting from the state
+        received from the server. Moves whose predicted states are still valid are
+        not replayed.
+     */
+    void replayMoves(const MoveList& moveList);
+
     InputHandler& inputHandler_;
 
+    PredictionHistory predictionHistory_;
+
     ShootFunc shootFunc_;
 
-    float lastShot_;
+    int64_t lastShot_;
 
     const unsigned int length;
 
@@ -6,7 +6,7 @@
 #define LOG_LEVEL_DEBUG spdlog::level::debug
 #define LOG_LEVEL_INFO spdlog::level::info
 #define LOG_LEVEL_WARN spdlog::level::warn
-#define LOG_LEVEL_ERROR spdlog::level::error
+#define LOG_LEVEL_ERROR spdlog::level::err
 
 #define INIT_LOGGING(level) \
     spdlog::stdout_logger_mt("console", true); \
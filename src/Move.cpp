@@ -3,25 +3,25 @@
 
 Move::Move()
 : inputState_()
-, timeStamp_(0)
+, tick_(0)
 , deltaTime_(0) {
 }
 
-Move::Move(const InputState& inputState, float timeStamp, float deltaTime)
+Move::Move(const InputState& inputState, uint32_t tick, float deltaTime)
 : inputState_(inputState)
-, timeStamp_(timeStamp)
+, tick_(tick)
 , deltaTime_(deltaTime) {
 }
 
 Move::Move(const Move& rhs)
 : inputState_(rhs.inputState_)
-, timeStamp_(rhs.timeStamp_)
+, tick_(rhs.tick_)
 , deltaTime_(rhs.deltaTime_) {
 }
 
 Move& Move::operator =(const Move& rhs) {
     inputState_ = rhs.inputState_;
-    timeStamp_ = rhs.timeStamp_;
+    tick_ = rhs.tick_;
     deltaTime_ = rhs.deltaTime_;
     return *this;
 }
@@ -30,8 +30,8 @@ const InputState& Move::getInputState() const {
     return inputState_;
 }
 
-float Move::getTimeStamp() const {
-    return timeStamp_;
+uint32_t Move::getTick() const {
+    return tick_;
 }
 
 float Move::getDeltaTime() const {
@@ -40,12 +40,12 @@ float Move::getDeltaTime() const {
 
 void Move::write(Packet* packet) const {
     inputState_.write(packet);
-    packet->write(timeStamp_);
+    packet->write(tick_);
     packet->write(deltaTime_);
 }
 
 void Move::read(Packet* packet) {
     inputState_.read(packet);
-    packet->read(timeStamp_);
+    packet->read(tick_);
     packet->read(deltaTime_);
 }
@@ -3,13 +3,17 @@
 
 #include "InputState.h"
 
+#include <cstdint>
+
 class Packet;
 
+/** The input of a player during one simulation tick.
+ */
 class Move {
 public:
     Move();
 
-    Move(const InputState &inputState, float timeStamp, float deltaTime);
+    Move(const InputState &inputState, uint32_t tick, float deltaTime);
 
     Move(const Move& rhs);
 
@@ -17,7 +21,9 @@ public:
 
     const InputState& getInputState() const;
 
-    float getTimeStamp() const;
+    /** Returns the number of the tick of the player in which the move was sampled.
+     */
+    uint32_t getTick() const;
 
     float getDeltaTime() const;
 
@@ -27,7 +33,7 @@ public:
 
 private:
     InputState inputState_;
-    float timeStamp_;
+    uint32_t tick_;
     float deltaTime_;
 };
 
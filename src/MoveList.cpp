@@ -1,8 +1,10 @@
 #include "MoveList.h"
 #include "Packet.h"
 
+#include <algorithm>
+
 MoveList::MoveList()
-: lastMoveTime_(0)
+: lastMoveTick_(0)
 , moves_() {
 }
 
@@ -10,19 +12,16 @@ uint32_t MoveList::getCount() const {
     return static_cast<uint32_t>(moves_.size());
 }
 
-const Move* MoveList::addMove(const InputState& inputState, float timeStamp) {
-    const auto deltaTime = timeStamp - lastMoveTime_;
-    moves_.emplace_back(inputState, timeStamp, deltaTime);
-    lastMoveTime_ = timeStamp;
+const Move* MoveList::addMove(const InputState& inputState, uint32_t tick, float deltaTime) {
+    moves_.emplace_back(inputState, tick, deltaTime);
+    lastMoveTick_ = tick;
     return &moves_.back();
 }
 
 void MoveList::addMove(const Move& move) {
-    const auto timeStamp = move.getTimeStamp();
-    if (timeStamp > lastMoveTime_) {
-        const auto deltaTime = timeStamp - lastMoveTime_;
-        moves_.emplace_back(move.getInputState(), timeStamp, deltaTime);
-        lastMoveTime_ = timeStamp;
+    if (move.getTick() > lastMoveTick_) {
+        moves_.push_back(move);
+        lastMoveTick_ = move.getTick();
     }
 }
 
@@ -33,14 +32,22 @@ const Move* MoveList::getLatestMove() const {
     return &moves_.back();
 }
 
-float MoveList::getLatestTimeStamp() const {
-    return moves_.back().getTimeStamp();
+uint32_t MoveList::getLatestTick() const {
+    return moves_.back().getTick();
+}
+
+void MoveList::removeMovesUntil(uint32_t tick) {
+    // Moves are ordered by their ticks, so the acknowledged ones are a prefix.
+    const auto count = std::distance(moves_.cbegin(), findFirstMoveAfter(tick));
+    for (auto i = count; i > 0; i--) {
+        moves_.pop_front();
+    }
 }
 
-void MoveList::removeMovesUntil(float timeStamp) {
-    moves_.erase(std::remove_if(moves_.begin(), moves_.end(), [timeStamp] (const Move& move) {
-        return move.getTimeStamp() <= timeStamp;
-    }), moves_.end());
+MoveList::const_iterator MoveList::findFirstMoveAfter(uint32_t tick) const {
+    return std::upper_bound(moves_.begin(), moves_.end(), tick, [] (uint32_t value, const Move& move) {
+        return value < move.getTick();
+    });
 }
 
 void MoveList::clear() {
@@ -16,20 +16,34 @@ public:
 
     uint32_t getCount() const;
 
-    const Move* addMove(const InputState& inputState, float timeStamp);
+    /** Adds the move of a tick.
 
+        \param inputState the input during the tick.
+        \param tick the number of the tick, larger than that of the latest move.
+        \param deltaTime the duration of the tick in seconds.
+     */
+    const Move* addMove(const InputState& inputState, uint32_t tick, float deltaTime);
+
+    /** Adds a received move. Moves that are not newer than the latest one are ignored.
+     */
     void addMove(const Move& move);
 
     const Move* getLatestMove() const;
 
-    float getLatestTimeStamp() const;
+    uint32_t getLatestTick() const;
+
+    void removeMovesUntil(uint32_t tick);
 
-    void removeMovesUntil(float timeStamp);
+    /** Returns the first move with a tick larger than the given one, or end().
+     */
+    const_iterator findFirstMoveAfter(uint32_t tick) const;
 
     void clear();
 
     void write(Packet* packet) const;
 
+    /** Reads moves and adds those that are newer than the latest one.
+     */
     void read(Packet* packet);
 
     const_iterator begin() const {
@@ -41,7 +55,7 @@ public:
     }
 
 private:
-    float lastMoveTime_;
+    uint32_t lastMoveTick_;
     std::deque<Move> moves_;
 };
 
@@ -0,0 +1,450 @@
+#include "NetworkProxy.h"
+#include "Packet.h"
+#include "Logging.h"
+
+#include <sys/socket.h>
+#include <cerrno>
+#include <chrono>
+
+// The number of datagrams read or written with one system call.
+static const uint32_t BATCH_SIZE = 64;
+
+// A socket is read at most this many batches at a time, so that a flood on
+// one socket does not starve the others.
+static const uint32_t MAX_BATCHES_PER_WAKE = 16;
+
+// The number of packets that can be on their way at the same time.
+static const uint32_t PACKET_POOL_SIZE = 60000;
+
+static const int SOCKET_BUFFER_SIZE = 4 * 1024 * 1024;
+
+// The timing wheels have slots of 100 us and turn once per 0.8192 s, like
+// those of the LatencyEmulator.
+static const int64_t WHEEL_RESOLUTION = 100000;
+static const uint32_t WHEEL_SLOT_COUNT = 8192;
+static const uint32_t WHEEL_CAPACITY = 65536;
+
+// A flow that has not seen a packet from its client for this long is closed.
+static const int64_t FLOW_TIMEOUT = 10000000000;
+
+static const std::chrono::milliseconds HOUSEKEEPING_INTERVAL(100);
+static const int64_t SWEEP_INTERVAL = 1000000000;
+static const int64_t STATUS_INTERVAL = 10000000000;
+
+static int64_t getSteadyTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t getFlowKey(const boost::asio::ip::udp::endpoint& endpoint) {
+    return (static_cast<uint64_t>(endpoint.address().to_v4().to_ulong()) << 16) | endpoint.port();
+}
+
+/** Reads up to count datagrams without blocking.
+
+    \return the number of datagrams read.
+ */
+static uint32_t receiveBatch(int socket, Packet** packets, uint32_t count) {
+#ifdef __linux__
+    mmsghdr messages[BATCH_SIZE];
+    iovec data[BATCH_SIZE];
+    for (uint32_t i = 0; i < count; i++) {
+        auto& endpoint = packets[i]->getEndpoint();
+        data[i] = iovec{packets[i]->getData(), packets[i]->getCapacity()};
+        messages[i] = mmsghdr{};
+        messages[i].msg_hdr.msg_name = endpoint.data();
+        messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(endpoint.capacity());
+        messages[i].msg_hdr.msg_iov = &data[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    const auto received = recvmmsg(socket, messages, count, MSG_DONTWAIT, nullptr);
+    if (received <= 0) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < static_cast<uint32_t>(received); i++) {
+        packets[i]->getEndpoint().resize(messages[i].msg_hdr.msg_namelen);
+        packets[i]->setSize(messages[i].msg_len);
+        packets[i]->reset();
+    }
+    return static_cast<uint32_t>(received);
+#else
+    uint32_t received = 0;
+    for (; received < count; received++) {
+        auto& endpoint = packets[received]->getEndpoint();
+        auto length = static_cast<socklen_t>(endpoint.capacity());
+        const auto size = recvfrom(socket, packets[received]->getData(), packets[received]->getCapacity(), MSG_DONTWAIT, endpoint.data(), &length);
+        if (size < 0) {
+            break;
+        }
+        endpoint.resize(length);
+        packets[received]->setSize(static_cast<uint32_t>(size));
+        packets[received]->reset();
+    }
+    return received;
+#endif
+}
+
+/** Writes datagrams without blocking, to their endpoints unless the socket is
+    connected.
+
+    \return the number of datagrams written.
+ */
+static uint32_t sendBatch(int socket, Packet* const* packets, uint32_t count, bool connected) {
+#ifdef __linux__
+    mmsghdr messages[BATCH_SIZE];
+    iovec data[BATCH_SIZE];
+    for (uint32_t i = 0; i < count; i++) {
+        auto& endpoint = packets[i]->getEndpoint();
+        data[i] = iovec{packets[i]->getData(), packets[i]->getSize()};
+        messages[i] = mmsghdr{};
+        messages[i].msg_hdr.msg_name = connected ? nullptr : endpoint.data();
+        messages[i].msg_hdr.msg_namelen = connected ? 0 : static_cast<socklen_t>(endpoint.size());
+        messages[i].msg_hdr.msg_iov = &data[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    uint32_t sent = 0;
+    while (sent < count) {
+        const auto result = sendmmsg(socket, messages + sent, count - sent, MSG_DONTWAIT);
+        if (result <= 0) {
+            break;
+        }
+        sent += static_cast<uint32_t>(result);
+    }
+    return sent;
+#else
+    uint32_t sent = 0;
+    for (; sent < count; sent++) {
+        auto& endpoint = packets[sent]->getEndpoint();
+        if (sendto(socket, packets[sent]->getData(), packets[sent]->getSize(), MSG_DONTWAIT,
+                   connected ? nullptr : endpoint.data(), connected ? 0 : static_cast<socklen_t>(endpoint.size())) < 0) {
+            break;
+        }
+    }
+    return sent;
+#endif
+}
+
+NetworkProxy::Statistics::Statistics()
+: upstreamPackets(0)
+, downstreamPackets(0)
+, discardedPackets(0)
+, openedFlows(0)
+, closedFlows(0) {
+}
+
+NetworkProxy::Flow::Flow(boost::asio::io_service& ioService, uint64_t flowId, const boost::asio::ip::udp::endpoint& clientEndpoint,
+                         const Impairment& upstreamImpairment, const Impairment& downstreamImpairment, int64_t now)
+: id(flowId)
+, client(clientEndpoint)
+, socket(ioService, boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), 0))
+, upstream(upstreamImpairment)
+, downstream(downstreamImpairment)
+, lastSeen(now) {
+}
+
+NetworkProxy::NetworkProxy(uint16_t port, const boost::asio::ip::udp::endpoint& server, const Impairment& upstream, const Impairment& downstream)
+: server_(server)
+, upstreamImpairment_(upstream)
+, downstreamImpairment_(downstream)
+, packetPool_(PACKET_POOL_SIZE)
+, io_service_()
+, socket_(io_service_, boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), port))
+, releaseTimer_(io_service_)
+, housekeepingTimer_(io_service_)
+, releaseTime_(TimingWheel::NoRelease)
+, upstream_(WHEEL_RESOLUTION, WHEEL_SLOT_COUNT, WHEEL_CAPACITY, getSteadyTime())
+, downstream_(WHEEL_RESOLUTION, WHEEL_SLOT_COUNT, WHEEL_CAPACITY, getSteadyTime())
+, flows_()
+, batch_()
+, released_()
+, scratch_(1500)
+, statistics_()
+, lastSweep_(0)
+, lastStatus_(0) {
+    boost::system::error_code ec;
+    socket_.set_option(boost::asio::socket_base::receive_buffer_size(SOCKET_BUFFER_SIZE), ec);
+    socket_.set_option(boost::asio::socket_base::send_buffer_size(SOCKET_BUFFER_SIZE), ec);
+    batch_.reserve(BATCH_SIZE);
+    released_.reserve(WHEEL_CAPACITY);
+}
+
+NetworkProxy::~NetworkProxy() {
+    // The packets still on their way go back to the pool.
+    const auto release = [this] (Packet* packet) { packetPool_.push(packet); };
+    upstream_.advance(TimingWheel::NoRelease, release);
+    downstream_.advance(TimingWheel::NoRelease, release);
+    for (auto packet : batch_) {
+        packetPool_.push(packet);
+    }
+}
+
+void NetworkProxy::run(const std::atomic<bool>& running) {
+    const auto now = getSteadyTime();
+    lastSweep_ = now;
+    lastStatus_ = now;
+    INFO("Forwarding UDP port {0} to {1}.", getPort(), server_);
+
+    io_service_.reset();
+    waitForClients();
+    housekeeping(running);
+    io_service_.run();
+
+    INFO("Forwarded {0} packets to the server and {1} to the clients, discarded {2}, opened {3} flows.",
+         statistics_.upstreamPackets, statistics_.downstreamPackets, statistics_.discardedPackets, statistics_.openedFlows);
+}
+
+uint16_t NetworkProxy::getPort() const {
+    return socket_.local_endpoint().port();
+}
+
+std::size_t NetworkProxy::getFlowCount() const {
+    return flows_.size();
+}
+
+const NetworkProxy::Statistics& NetworkProxy::getStatistics() const {
+    return statistics_;
+}
+
+void NetworkProxy::waitForClients() {
+    socket_.async_wait(boost::asio::ip::udp::socket::wait_read, [this] (const boost::system::error_code& ec) {
+        if (ec) {
+            if (ec != boost::asio::error::operation_aborted) {
+                ERROR("Failed to receive from the clients: {0}", ec.message());
+            }
+            return;
+        }
+        const auto now = getSteadyTime();
+        receiveFromClients(now);
+        release(now);
+        waitForClients();
+    });
+}
+
+void NetworkProxy::waitForServer(Flow& flow) {
+    // The flow may be closed before the handler runs, so it is looked up again.
+    const auto key = getFlowKey(flow.client);
+    const auto id = flow.id;
+    flow.socket.async_wait(boost::asio::ip::udp::socket::wait_read, [this, key, id] (const boost::system::error_code& ec) {
+        const auto itr = flows_.find(key);
+        if (ec || itr == flows_.end() || itr->second->id != id) {
+            return;
+        }
+        const auto now = getSteadyTime();
+        receiveFromServer(*itr->second, now);
+        release(now);
+        waitForServer(*itr->second);
+    });
+}
+
+template<typename Fun>
+void NetworkProxy::drain(int socket, Fun&& fun) {
+    for (uint32_t round = 0; round < MAX_BATCHES_PER_WAKE; round++) {
+        while (batch_.size() < BATCH_SIZE) {
+            auto packet = packetPool_.pop();
+            if (!packet) {
+                break;
+            }
+            batch_.push_back(packet);
+        }
+
+        if (batch_.empty()) {
+            // Without packets to forward with, datagrams are still read so
+            // that they do not pile up in the socket buffer.
+            auto packet = &scratch_;
+            const auto received = receiveBatch(socket, &packet, 1);
+            statistics_.discardedPackets += received;
+            if (received == 0) {
+                return;
+            }
+            continue;
+        }
+
+        const auto requested = static_cast<uint32_t>(batch_.size());
+        const auto received = receiveBatch(socket, batch_.data(), requested);
+        for (uint32_t i = 0; i < received; i++) {
+            fun(batch_[i]);
+        }
+        batch_.erase(batch_.begin(), batch_.begin() + received);
+        if (received < requested) {
+            return;
+        }
+    }
+}
+
+void NetworkProxy::receiveFromClients(int64_t now) {
+    drain(socket_.native_handle(), [this, now] (Packet* packet) {
+        auto flow = getFlow(packet->getEndpoint(), now);
+        if (flow) {
+            flow->lastSeen = now;
+            impair(flow->upstream, upstream_, packet, now);
+        } else {
+            discard(packet);
+        }
+    });
+}
+
+void NetworkProxy::receiveFromServer(Flow& flow, int64_t now) {
+    drain(flow.socket.native_handle(), [this, &flow, now] (Packet* packet) {
+        packet->setEndpoint(flow.client);
+        impair(flow.downstream, downstream_, packet, now);
+    });
+}
+
+NetworkProxy::Flow* NetworkProxy::getFlow(const boost::asio::ip::udp::endpoint& client, int64_t now) {
+    const auto key = getFlowKey(client);
+    auto itr = flows_.find(key);
+    if (itr != flows_.end()) {
+        return itr->second.get();
+    }
+
+    // Each flow gets different random numbers, which a seed still repeats.
+    const auto id = statistics_.openedFlows;
+    auto upstream = upstreamImpairment_;
+    auto downstream = downstreamImpairment_;
+    if (upstream.seed != 0) {
+        upstream.seed += id;
+    }
+    if (downstream.seed != 0) {
+        downstream.seed += id;
+    }
+
+    try {
+        auto flow = std::make_unique<Flow>(io_service_, id, client, upstream, downstream, now);
+        flow->socket.connect(server_);
+        itr = flows_.emplace(key, std::move(flow)).first;
+    } catch (const boost::system::system_error& ex) {
+        WARN("Failed to open a flow for {0}: {1}", client, ex.what());
+        return nullptr;
+    }
+    statistics_.openedFlows++;
+    DEBUG("Opened flow {0} for {1}.", id, client);
+    waitForServer(*itr->second);
+    return itr->second.get();
+}
+
+void NetworkProxy::impair(ImpairmentModel& model, TimingWheel& timingWheel, Packet* packet, int64_t now) {
+    int64_t releaseTimes[ImpairmentModel::MaxCopies];
+    const auto count = model.apply(now, packet->getSize(), releaseTimes);
+    if (count == 0) {
+        discard(packet);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        auto copy = packet;
+        if (i > 0) {
+            copy = packetPool_.pop();
+            if (!copy) {
+                statistics_.discardedPackets++;
+                break;
+            }
+            copy->copyDataFrom(*packet);
+            copy->setEndpoint(packet->getEndpoint());
+        }
+        if (!timingWheel.schedule(copy, releaseTimes[i])) {
+            discard(copy);
+        }
+    }
+}
+
+void NetworkProxy::release(int64_t now) {
+    downstream_.advance(now, [this] (Packet* packet) { released_.push_back(packet); });
+    sendReleased(socket_.native_handle(), 0, released_.size(), false, statistics_.downstreamPackets);
+    released_.clear();
+
+    // Runs of packets of the same flow go out in one batch.
+    upstream_.advance(now, [this] (Packet* packet) { released_.push_back(packet); });
+    std::size_t begin = 0;
+    while (begin < released_.size()) {
+        const auto key = getFlowKey(released_[begin]->getEndpoint());
+        auto end = begin + 1;
+        while (end < released_.size() && end - begin < BATCH_SIZE && getFlowKey(released_[end]->getEndpoint()) == key) {
+            end++;
+        }
+        const auto itr = flows_.find(key);
+        if (itr != flows_.end()) {
+            sendReleased(itr->second->socket.native_handle(), begin, end, true, statistics_.upstreamPackets);
+        } else {
+            for (auto i = begin; i < end; i++) {
+                discard(released_[i]);
+            }
+        }
+        begin = end;
+    }
+    released_.clear();
+
+    scheduleRelease();
+}
+
+void NetworkProxy::sendReleased(int socket, std::size_t begin, std::size_t end, bool connected, uint64_t& sentCount) {
+    for (auto first = begin; first < end; first += BATCH_SIZE) {
+        const auto count = static_cast<uint32_t>(std::min<std::size_t>(end - first, BATCH_SIZE));
+        const auto sent = sendBatch(socket, released_.data() + first, count, connected);
+        // What the socket buffer does not take is lost like on a congested link.
+        sentCount += sent;
+        statistics_.discardedPackets += count - sent;
+        for (uint32_t i = 0; i < count; i++) {
+            packetPool_.push(released_[first + i]);
+        }
+    }
+}
+
+void NetworkProxy::scheduleRelease() {
+    const auto releaseTime = std::min(upstream_.getNextReleaseTime(), downstream_.getNextReleaseTime());
+    if (releaseTime == releaseTime_) {
+        return;
+    }
+    releaseTime_ = releaseTime;
+    if (releaseTime == TimingWheel::NoRelease) {
+        releaseTimer_.cancel();
+        return;
+    }
+    releaseTimer_.expires_at(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(releaseTime)));
+    releaseTimer_.async_wait([this] (const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        releaseTime_ = TimingWheel::NoRelease;
+        release(getSteadyTime());
+    });
+}
+
+void NetworkProxy::housekeeping(const std::atomic<bool>& running) {
+    if (!running) {
+        io_service_.stop();
+        return;
+    }
+
+    const auto now = getSteadyTime();
+    if (now - lastSweep_ >= SWEEP_INTERVAL) {
+        closeIdleFlows(now);
+        lastSweep_ = now;
+    }
+    if (now - lastStatus_ >= STATUS_INTERVAL) {
+        INFO("{0} flows, forwarded {1} packets to the server and {2} to the clients, discarded {3}, {4} packets in the pool.",
+             flows_.size(), statistics_.upstreamPackets, statistics_.downstreamPackets, statistics_.discardedPackets, packetPool_.getNumPooled());
+        lastStatus_ = now;
+    }
+
+    housekeepingTimer_.expires_from_now(HOUSEKEEPING_INTERVAL);
+    housekeepingTimer_.async_wait([this, &running] (const boost::system::error_code& ec) {
+        if (!ec) {
+            housekeeping(running);
+        }
+    });
+}
+
+void NetworkProxy::closeIdleFlows(int64_t now) {
+    for (auto itr = flows_.begin(); itr != flows_.end();) {
+        if (now - itr->second->lastSeen > FLOW_TIMEOUT) {
+            DEBUG("Closed flow {0} for {1}.", itr->second->id, itr->second->client);
+            statistics_.closedFlows++;
+            itr = flows_.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
+
+void NetworkProxy::discard(Packet* packet) {
+    statistics_.discardedPackets++;
+    packetPool_.push(packet);
+}
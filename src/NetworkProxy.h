@@ -0,0 +1,137 @@
+#ifndef _NetworkProxy_H
+#define _NetworkProxy_H
+
+#include "BufferedQueue.h"
+#include "Impairment.h"
+#include "TimingWheel.h"
+
+#include <boost/asio.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/** Forwards UDP packets between clients and a server over an emulated bad
+    network, without either side knowing.
+
+    Each client endpoint that sends to the proxy gets a flow with a socket of
+    its own towards the server, so that the server sees one endpoint per
+    client, and with its own impairment models for both directions. Delayed
+    packets of all flows wait in one timing wheel per direction. Sockets are
+    read and written in batches, and everything runs on the thread that calls
+    run(), so the packet path takes no lock.
+ */
+class NetworkProxy {
+public:
+    struct Statistics {
+        Statistics();
+
+        uint64_t upstreamPackets;
+        uint64_t downstreamPackets;
+        uint64_t discardedPackets;
+        uint64_t openedFlows;
+        uint64_t closedFlows;
+    };
+
+    /** Constructor
+
+        \param port the UDP port the clients send to, 0 for any free port.
+        \param server the endpoint of the server.
+        \param upstream the conditions of packets from the clients to the server.
+        \param downstream the conditions of packets from the server to the clients.
+     */
+    NetworkProxy(uint16_t port, const boost::asio::ip::udp::endpoint& server, const Impairment& upstream, const Impairment& downstream);
+
+    ~NetworkProxy();
+
+    NetworkProxy(const NetworkProxy&) = delete;
+
+    NetworkProxy& operator =(const NetworkProxy&) = delete;
+
+    /** Forwards packets until running becomes false. Must only be called once.
+
+        \param running the flag to stop the proxy with.
+     */
+    void run(const std::atomic<bool>& running);
+
+    /** Returns the port the clients send to.
+     */
+    uint16_t getPort() const;
+
+    /** Returns the number of open flows. Only valid while run() does not run.
+     */
+    std::size_t getFlowCount() const;
+
+    /** Returns the counters. Only valid while run() does not run.
+     */
+    const Statistics& getStatistics() const;
+
+private:
+    struct Flow {
+        Flow(boost::asio::io_service& ioService, uint64_t flowId, const boost::asio::ip::udp::endpoint& clientEndpoint,
+             const Impairment& upstreamImpairment, const Impairment& downstreamImpairment, int64_t now);
+
+        const uint64_t id;
+        boost::asio::ip::udp::endpoint client;
+        boost::asio::ip::udp::socket socket;
+        ImpairmentModel upstream;
+        ImpairmentModel downstream;
+        int64_t lastSeen;
+    };
+
+    void waitForClients();
+
+    void waitForServer(Flow& flow);
+
+    void receiveFromClients(int64_t now);
+
+    void receiveFromServer(Flow& flow, int64_t now);
+
+    template<typename Fun>
+    void drain(int socket, Fun&& fun);
+
+    Flow* getFlow(const boost::asio::ip::udp::endpoint& client, int64_t now);
+
+    void impair(ImpairmentModel& model, TimingWheel& timingWheel, Packet* packet, int64_t now);
+
+    void release(int64_t now);
+
+    void sendReleased(int socket, std::size_t begin, std::size_t end, bool connected, uint64_t& sentCount);
+
+    void scheduleRelease();
+
+    void housekeeping(const std::atomic<bool>& running);
+
+    void closeIdleFlows(int64_t now);
+
+    void discard(Packet* packet);
+
+    const boost::asio::ip::udp::endpoint server_;
+    const Impairment upstreamImpairment_;
+    const Impairment downstreamImpairment_;
+
+    BufferedQueue packetPool_;
+
+    boost::asio::io_service io_service_;
+    boost::asio::ip::udp::socket socket_;
+    boost::asio::steady_timer releaseTimer_;
+    boost::asio::steady_timer housekeepingTimer_;
+    int64_t releaseTime_;
+
+    TimingWheel upstream_;
+    TimingWheel downstream_;
+
+    std::unordered_map<uint64_t, std::unique_ptr<Flow>> flows_;
+
+    std::vector<Packet*> batch_;
+    std::vector<Packet*> released_;
+    Packet scratch_;
+
+    Statistics statistics_;
+    int64_t lastSweep_;
+    int64_t lastStatus_;
+};
+
+#endif  // _NetworkProxy_H
@@ -6,6 +6,7 @@
 #include <boost/asio.hpp>
 #include <boost/format.hpp>
 
+#include <chrono>
 #include <cstring>
 #include <stdexcept>
 #include <vector>
@@ -17,7 +18,8 @@ public:
     , size_(0)
     , head_(0)
     , data_(new char [capacity_])
-    , endpoint_() {
+    , endpoint_()
+    , receiveTime_() {
     }
 
     Packet(const Packet&) = delete;
@@ -46,6 +48,7 @@ public:
         reset();
         size_ = 0;
         endpoint_ = udp::endpoint(address::from_string("0.0.0.0"), 0);
+        receiveTime_ = std::chrono::steady_clock::time_point();
     }
 
     uint32_t getCapacity() const {
@@ -92,6 +95,19 @@ public:
         return endpoint_;
     }
 
+    /** Sets the time at which the packet arrived, preferably as stamped by the kernel.
+     */
+    void setReceiveTime(std::chrono::steady_clock::time_point receiveTime) {
+        receiveTime_ = receiveTime;
+    }
+
+    /** Returns the time at which the packet arrived, or the epoch of the steady
+        clock if the packet was not received.
+     */
+    std::chrono::steady_clock::time_point getReceiveTime() const {
+        return receiveTime_;
+    }
+
     template<typename T>
     void write(T data) {
         const auto size = sizeof(T);
@@ -162,6 +178,7 @@ private:
     char* data_;
 
     boost::asio::ip::udp::endpoint endpoint_;
+    std::chrono::steady_clock::time_point receiveTime_;
 };
 
 #endif  // _Packet_H
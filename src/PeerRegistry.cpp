@@ -1,7 +1,6 @@
 #include "PeerRegistry.h"
 
-#include <boost/lexical_cast.hpp>
-
+#include <algorithm>
 #include <stdexcept>
 
 PeerRegistry::PeerRegistry()
@@ -9,15 +8,13 @@ PeerRegistry::PeerRegistry()
 }
 
 bool PeerRegistry::isRegistered(const boost::asio::ip::udp::endpoint& endpoint) const {
-    const auto s = boost::lexical_cast<std::string>(endpoint);
-    return peers_.find(s) != peers_.end();
+    return find(endpoint) != peers_.end();
 }
 
 bool PeerRegistry::verifyPeer(uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint) const {
-    const auto s = boost::lexical_cast<std::string>(endpoint);
-    const auto itr = peers_.find(s);
+    const auto itr = find(endpoint);
     if (itr != peers_.end()) {
-        return itr->second.playerId == playerId;
+        return (*itr)->playerId == playerId;
     }
     return false;
 }
@@ -27,41 +24,68 @@ uint32_t PeerRegistry::getCount() const {
 }
 
 void PeerRegistry::add(const boost::asio::ip::udp::endpoint& endpoint, uint32_t playerId) {
-    const auto s = boost::lexical_cast<std::string>(endpoint);
-    if (peers_.find(s) != peers_.end()) {
+    if (find(endpoint) != peers_.end()) {
         throw std::logic_error("peer already registered");
-    }    
-    peers_.insert(std::make_pair(s, Peer(endpoint, playerId)));
+    }
+    peers_.push_back(std::make_unique<Peer>(endpoint, playerId));
 }
 
 void PeerRegistry::remove(const boost::asio::ip::udp::endpoint& endpoint) {
-    const auto s = boost::lexical_cast<std::string>(endpoint);
-    peers_.erase(s);
+    const auto itr = find(endpoint);
+    if (itr != peers_.end()) {
+        std::swap(*itr, peers_.back());
+        peers_.pop_back();
+    }
 }
 
 void PeerRegistry::reset() {
-    peers_.erase(peers_.begin(), peers_.end());
+    peers_.clear();
 }
 
-void PeerRegistry::forEachPeer(std::function<void (const Peer&)> fun) const {
-    for (const auto& p : peers_) {
-        fun(p.second);
+void PeerRegistry::addRoundTripTime(const boost::asio::ip::udp::endpoint& endpoint, float roundTripTime) {
+    const auto itr = find(endpoint);
+    if (itr != peers_.end()) {
+        (*itr)->latencyEstimator.addRTT(roundTripTime);
     }
 }
 
-void PeerRegistry::addRoundTripTime(const boost::asio::ip::udp::endpoint& endpoint, float roundTripTime) {
-    const auto s = boost::lexical_cast<std::string>(endpoint);
-    const auto itr = peers_.find(s);
+const LatencyEstimator& PeerRegistry::getLatencyEstimator(const boost::asio::ip::udp::endpoint& endpoint) const {
+    const auto itr = find(endpoint);
+    if (itr == peers_.end()) {
+        throw std::logic_error("Peer not registered");
+    }
+    return (*itr)->latencyEstimator;
+}
+
+void PeerRegistry::addSnapshot(const boost::asio::ip::udp::endpoint& endpoint, int64_t sourceTime, int64_t arrivalTime) {
+    const auto itr = find(endpoint);
     if (itr != peers_.end()) {
-        (*itr).second.latencyEstimator.addRTT(roundTripTime);
+        (*itr)->snapshotTimeline.addSnapshot(sourceTime, arrivalTime);
     }
 }
 
-const LatencyEstimator& PeerRegistry::getLatencyEstimator(const boost::asio::ip::udp::endpoint& endpoint) const {
-    const auto s = boost::lexical_cast<std::string>(endpoint);
-    const auto itr = peers_.find(s);
+void PeerRegistry::updateSnapshotTimelines(int64_t now) {
+    for (auto& peer : peers_) {
+        peer->snapshotTimeline.update(now);
+    }
+}
+
+const SnapshotTimeline& PeerRegistry::getSnapshotTimeline(const boost::asio::ip::udp::endpoint& endpoint) const {
+    const auto itr = find(endpoint);
     if (itr == peers_.end()) {
         throw std::logic_error("Peer not registered");
     }
-    return (*itr).second.latencyEstimator;
+    return (*itr)->snapshotTimeline;
+}
+
+PeerRegistry::Peers::iterator PeerRegistry::find(const boost::asio::ip::udp::endpoint& endpoint) {
+    return std::find_if(peers_.begin(), peers_.end(), [&endpoint] (const std::unique_ptr<Peer>& peer) {
+        return peer->endpoint == endpoint;
+    });
+}
+
+PeerRegistry::Peers::const_iterator PeerRegistry::find(const boost::asio::ip::udp::endpoint& endpoint) const {
+    return std::find_if(peers_.begin(), peers_.end(), [&endpoint] (const std::unique_ptr<Peer>& peer) {
+        return peer->endpoint == endpoint;
+    });
 }
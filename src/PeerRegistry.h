@@ -2,21 +2,25 @@
 #define _PeerRegistry_H
 
 #include "LatencyEstimator.h"
+#include "SnapshotTimeline.h"
 
 #include <boost/asio.hpp>
 
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 struct Peer {
     Peer(const boost::asio::ip::udp::endpoint& endpoint_, uint32_t playerId_)
     : endpoint(endpoint_)
     , playerId(playerId_)
-    , latencyEstimator(10) {
+    , latencyEstimator(10)
+    , snapshotTimeline() {
     }
 
     const boost::asio::ip::udp::endpoint endpoint;
     const uint32_t playerId;
     LatencyEstimator latencyEstimator;
+    SnapshotTimeline snapshotTimeline;
 };
 
 class PeerRegistry {
@@ -35,14 +39,36 @@ public:
 
     void reset();
 
-    void forEachPeer(std::function<void (const Peer&)> fun) const;
+    template<typename Fun>
+    void forEachPeer(Fun&& fun) const {
+        for (const auto& peer : peers_) {
+            fun(*peer);
+        }
+    }
 
     void addRoundTripTime(const boost::asio::ip::udp::endpoint& endpoint, float roundTripTime);
 
     const LatencyEstimator& getLatencyEstimator(const boost::asio::ip::udp::endpoint& endpoint) const;
 
+    void addSnapshot(const boost::asio::ip::udp::endpoint& endpoint, int64_t sourceTime, int64_t arrivalTime);
+
+    /** Advances the snapshot timelines of all peers. This method should be called once per frame.
+     */
+    void updateSnapshotTimelines(int64_t now);
+
+    const SnapshotTimeline& getSnapshotTimeline(const boost::asio::ip::udp::endpoint& endpoint) const;
+
 private:
-    std::unordered_map<std::string, Peer> peers_;
+    using Peers = std::vector<std::unique_ptr<Peer>>;
+
+    Peers::iterator find(const boost::asio::ip::udp::endpoint& endpoint);
+
+    Peers::const_iterator find(const boost::asio::ip::udp::endpoint& endpoint) const;
+
+    // A game has only a handful of peers, so a linear search beats hashing the
+    // endpoint. Peers are held by pointer because game objects keep references
+    // to their snapshot timelines.
+    Peers peers_;
 };
 
 #endif  // _PeerRegistry_H
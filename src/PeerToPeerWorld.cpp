@@ -4,28 +4,30 @@
 
 #include <unordered_set>
 #include <cassert>
+#include <utility>
 
 PeerToPeerWorld::PeerToPeerWorld(unsigned int width, unsigned int height, ConfirmCollisionFunc confirmCollisionFunc)
 : width_(width)
 , height_(height)
 , confirmCollisionFunc_(confirmCollisionFunc)
+, kinematics_()
 , localGameObjects_()
 , remoteGameObjects_()
 , remoteEndpoints_() {
 }
 
-void PeerToPeerWorld::addLocalGameObject(uint32_t objectId, GameObjectPtr& gameObject) {
+void PeerToPeerWorld::addLocalGameObject(uint32_t objectId, GameObjectPtr&& gameObject) {
     assert(localGameObjects_.find(objectId) == localGameObjects_.end());
-    localGameObjects_.insert(ObjectIdToGameObjectMap::value_type(objectId, gameObject));
+    localGameObjects_.insert(ObjectIdToGameObjectMap::value_type(objectId, std::move(gameObject)));
 }
 
 void PeerToPeerWorld::removeLocalGameObject(uint32_t objectId) {
     localGameObjects_.erase(localGameObjects_.find(objectId));
 }
 
-void PeerToPeerWorld::addRemoteGameObject(uint32_t objectId, GameObjectPtr& gameObject, const boost::asio::ip::udp::endpoint& endpoint) {
+void PeerToPeerWorld::addRemoteGameObject(uint32_t objectId, GameObjectPtr&& gameObject, const boost::asio::ip::udp::endpoint& endpoint) {
     assert(remoteGameObjects_.find(objectId) == remoteGameObjects_.end());
-    remoteGameObjects_.insert(ObjectIdToGameObjectMap::value_type(objectId, gameObject));
+    remoteGameObjects_.insert(ObjectIdToGameObjectMap::value_type(objectId, std::move(gameObject)));
     remoteEndpoints_.insert(ObjectIdToEndpointMap::value_type(objectId, endpoint));
 }
 
@@ -46,6 +48,10 @@ uint32_t PeerToPeerWorld::getLocalGameObjectCount() const {
     return static_cast<uint32_t>(localGameObjects_.size());
 }
 
+Kinematics& PeerToPeerWorld::getKinematics() {
+    return kinematics_;
+}
+
 void PeerToPeerWorld::update(float elapsed) {
     for (auto& gameObject : localGameObjects_) {
         gameObject.second->update(elapsed);
@@ -55,8 +61,10 @@ void PeerToPeerWorld::update(float elapsed) {
         gameObject.second->update(elapsed);
     }
 
+    kinematics_.integrate(elapsed);
+
     forEachLocalGameObject([this] (uint32_t objectId1, GameObject* gameObject1) {
-        const auto& pos = gameObject1->getPosition();
+        const auto pos = gameObject1->getPosition();
         if ((pos.getX() < 0 || pos.getY() < 0 || pos.getX() > width_ || pos.getY() > height_) && gameObject1->getClassId() != SpaceShip::ClassId) {
             gameObject1->kill();
         }
@@ -73,12 +81,12 @@ void PeerToPeerWorld::update(float elapsed) {
     });
 }
 
-void PeerToPeerWorld::draw(Renderer& renderer) {
+void PeerToPeerWorld::draw(Renderer& renderer, float alpha) {
     for (auto& gameObject : localGameObjects_) {
-        gameObject.second->draw(renderer);
+        gameObject.second->draw(renderer, alpha);
     }
     for (auto& gameObject : remoteGameObjects_) {
-        gameObject.second->draw(renderer);
+        gameObject.second->draw(renderer, alpha);
     }
 }
 
@@ -2,6 +2,7 @@
 #define _PeerToPeerWorld_H
 
 #include "GameObject.h"
+#include "Kinematics.h"
 
 #include <boost/asio.hpp>
 
@@ -16,11 +17,11 @@ class PeerToPeerWorld {
 public:
     PeerToPeerWorld(unsigned int width, unsigned int heigth, ConfirmCollisionFunc confirmCollisionFunc);
 
-    void addLocalGameObject(uint32_t objectId, GameObjectPtr& gameObject);
+    void addLocalGameObject(uint32_t objectId, GameObjectPtr&& gameObject);
 
     void removeLocalGameObject(uint32_t objectId);
 
-    void addRemoteGameObject(uint32_t objectId, GameObjectPtr& gameObject, const boost::asio::ip::udp::endpoint& endpoint);
+    void addRemoteGameObject(uint32_t objectId, GameObjectPtr&& gameObject, const boost::asio::ip::udp::endpoint& endpoint);
 
     void removeRemoteGameObject(uint32_t objectId);
 
@@ -28,9 +29,11 @@ public:
 
     uint32_t getLocalGameObjectCount() const;
 
+    Kinematics& getKinematics();
+
     void update(float elapsed);
 
-    void draw(Renderer& renderer);
+    void draw(Renderer& renderer, float alpha);
 
     void forEachLocalGameObject(std::function<void (uint32_t, GameObject*)> fun);
 
@@ -47,6 +50,8 @@ private:
 
     ConfirmCollisionFunc confirmCollisionFunc_;
 
+    Kinematics kinematics_;
+
     ObjectIdToGameObjectMap localGameObjects_;
 
     ObjectIdToGameObjectMap remoteGameObjects_;
@@ -0,0 +1,60 @@
+#include "PredictionHistory.h"
+
+#include <algorithm>
+
+PredictionHistory::PredictionHistory(uint32_t capacity)
+: checkpoints_(std::max(1u, capacity))
+, oldest_(0)
+, count_(0) {
+}
+
+void PredictionHistory::add(uint32_t tick, const BodyState& state) {
+    const auto capacity = static_cast<uint32_t>(checkpoints_.size());
+    if (count_ == capacity) {
+        oldest_ = (oldest_ + 1) % capacity;
+        count_--;
+    }
+    checkpoints_[(oldest_ + count_) % capacity] = Checkpoint{tick, state};
+    count_++;
+}
+
+const PredictionHistory::Checkpoint* PredictionHistory::findLatestBefore(uint32_t tick) const {
+    const auto count = countBefore(tick);
+    return count > 0 ? &get(count - 1) : nullptr;
+}
+
+const PredictionHistory::Checkpoint* PredictionHistory::getNewest() const {
+    return count_ > 0 ? &get(count_ - 1) : nullptr;
+}
+
+void PredictionHistory::removeBefore(uint32_t tick) {
+    const auto count = countBefore(tick);
+    oldest_ = static_cast<uint32_t>((oldest_ + count) % checkpoints_.size());
+    count_ -= count;
+}
+
+void PredictionHistory::clear() {
+    oldest_ = 0;
+    count_ = 0;
+}
+
+uint32_t PredictionHistory::getCount() const {
+    return count_;
+}
+
+const PredictionHistory::Checkpoint& PredictionHistory::get(uint32_t index) const {
+    return checkpoints_[(oldest_ + index) % checkpoints_.size()];
+}
+
+uint32_t PredictionHistory::countBefore(uint32_t tick) const {
+    uint32_t low = 0, high = count_;
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        if (get(middle).tick < tick) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
@@ -0,0 +1,66 @@
+#ifndef _PredictionHistory_H
+#define _PredictionHistory_H
+
+#include "BodyState.h"
+
+#include <vector>
+#include <cstdint>
+
+/** A fixed-capacity ring of the states predicted after each unacknowledged move,
+    ordered by the ticks of the moves. When the ring is full the oldest
+    checkpoint is overwritten.
+ */
+class PredictionHistory {
+public:
+    struct Checkpoint {
+        Checkpoint()
+        : tick(0)
+        , state() {
+        }
+
+        Checkpoint(uint32_t moveTick, const BodyState& predicted)
+        : tick(moveTick)
+        , state(predicted) {
+        }
+
+        uint32_t tick;
+        BodyState state;
+    };
+
+    /** Constructor
+
+        \param capacity the maximum number of checkpoints.
+     */
+    explicit PredictionHistory(uint32_t capacity);
+
+    /** Appends the state after a move. The tick must be larger than that of the newest checkpoint.
+     */
+    void add(uint32_t tick, const BodyState& state);
+
+    /** Returns the newest checkpoint whose tick is smaller than the given one, or nullptr if there is none.
+     */
+    const Checkpoint* findLatestBefore(uint32_t tick) const;
+
+    /** Returns the newest checkpoint, or nullptr if there are no checkpoints.
+     */
+    const Checkpoint* getNewest() const;
+
+    /** Removes all checkpoints whose tick is smaller than the given one.
+     */
+    void removeBefore(uint32_t tick);
+
+    void clear();
+
+    uint32_t getCount() const;
+
+private:
+    const Checkpoint& get(uint32_t index) const;
+
+    uint32_t countBefore(uint32_t tick) const;
+
+    std::vector<Checkpoint> checkpoints_;
+    uint32_t oldest_;
+    uint32_t count_;
+};
+
+#endif  // _PredictionHistory_H
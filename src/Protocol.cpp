@@ -5,6 +5,23 @@
 
 #include <boost/lexical_cast.hpp>
 
+// The resolution of time stamps on the wire.
+static const int64_t NANOSECONDS_PER_UNIT = 1000;
+
+static int64_t toUnits(int64_t time) {
+    // Rounds towards negative infinity, so that negative times wrap like positive ones.
+    return time >= 0 ? time / NANOSECONDS_PER_UNIT : -((-time + NANOSECONDS_PER_UNIT - 1) / NANOSECONDS_PER_UNIT);
+}
+
+uint32_t toProtocolTime(int64_t time) {
+    return static_cast<uint32_t>(static_cast<uint64_t>(toUnits(time)));
+}
+
+int64_t fromProtocolTime(uint32_t protocolTime, int64_t reference) {
+    const auto difference = static_cast<int32_t>(protocolTime - toProtocolTime(reference));
+    return (toUnits(reference) + difference) * NANOSECONDS_PER_UNIT;
+}
+
 static void createBasicPacket(Packet* packet, const boost::asio::ip::udp::endpoint& endpoint, uint8_t packetType) {
     packet->clear();
     packet->setEndpoint(endpoint);
@@ -41,10 +58,11 @@ void createIntroPacket(Packet* packet, uint32_t newPeerPlayerId, const boost::as
     packet->write(newPeerEndpoint.port());
 }
 
-void createInputPacket(Packet* packet, uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, const MoveList& moveList) {
+void createInputPacket(Packet* packet, uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, const MoveList& moveList, int64_t viewTime) {
     createBasicPacket(packet, endpoint, PROTOCOL_PACKET_TYPE_INPUT);
     packet->write(playerId);
-    packet->write(moveList.getLatestTimeStamp());
+    packet->write(moveList.getLatestTick());
+    packet->write(toProtocolTime(viewTime));
     moveList.write(packet);
 }
 
@@ -52,15 +70,18 @@ void createStatePacket(Packet* packet, const boost::asio::ip::udp::endpoint& end
     createBasicPacket(packet, endpoint, PROTOCOL_PACKET_TYPE_STATE);
 }
 
-void createTickPacket(Packet* packet, uint32_t playerId, float timeStamp, const boost::asio::ip::udp::endpoint& endpoint) {
+void createTickPacket(Packet* packet, uint32_t playerId, int64_t timeStamp, const boost::asio::ip::udp::endpoint& endpoint) {
     createBasicPacket(packet, endpoint, PROTOCOL_PACKET_TYPE_TICK);
     packet->write(playerId);
-    packet->write(timeStamp);
+    packet->write(toProtocolTime(timeStamp));
 }
 
-void createTockPacket(Packet* packet, float timeStamp, const boost::asio::ip::udp::endpoint& endpoint) {
+void createTockPacket(Packet* packet, uint32_t originateTime, int64_t receiveTime, int64_t transmitTime, const boost::asio::ip::udp::endpoint& endpoint) {
     createBasicPacket(packet, endpoint, PROTOCOL_PACKET_TYPE_TOCK);
-    packet->write(timeStamp);
+    // The originate time is echoed in the wire form it arrived in.
+    packet->write(originateTime);
+    packet->write(toProtocolTime(receiveTime));
+    packet->write(toProtocolTime(transmitTime));
 }
 
 void createStartPacket(Packet* packet, const boost::asio::ip::udp::endpoint& endpoint) {
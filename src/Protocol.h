@@ -9,7 +9,7 @@ class PeerRegistry;
 
 const uint32_t   PROTOCOL_MAGIC_NUMBER          = 0x01600CE8;
 
-const uint8_t    PROTOCOL_VERSION               = 0x01;
+const uint8_t    PROTOCOL_VERSION               = 0x08;
 
 const uint32_t   PROTOCOL_INVALID_PLAYER_ID     = 0;
 const uint32_t   PROTOCOL_INVALID_OBJECT_ID     = 0;
@@ -27,18 +27,37 @@ const uint8_t    PROTOCOL_PACKET_TYPE_INTRO     = 0x08;
 const uint8_t    PROTOCOL_PACKET_TYPE_START     = 0x09;
 
 const float      PROTOCOL_HELLO_INTERVAL        = 1.0f;
-const float      PROTOCOL_INPUT_INTERVAL        = 0.033f;
+const float      PROTOCOL_INPUT_COALESCE_WINDOW = 0.01f;
+const float      PROTOCOL_INPUT_HEARTBEAT       = 0.1f;
 
 const float      PROTOCOL_CLIENT_TIMEOUT        = 1.0f;
 
 const uint8_t    PROTOCOL_NUM_PEERS_FOR_GAME    = 3;
 
+// The largest packet sent, and the bytes of a STATE packet in front of its
+// objects. A STATE update with more objects than fit is split into at most
+// PROTOCOL_MAX_STATE_PARTS packets.
+const uint32_t   PROTOCOL_MAX_PACKET_SIZE       = 1500;
+const uint32_t   PROTOCOL_STATE_HEADER_SIZE     = 24;
+const uint8_t    PROTOCOL_MAX_STATE_PARTS       = 255;
+
+/** Returns the wire form of a time stamp in nanoseconds: the microseconds in 32
+    bits, which wrap about every 71 minutes.
+ */
+uint32_t toProtocolTime(int64_t time);
+
+/** Returns the time stamp in nanoseconds whose wire form is protocolTime and
+    that is closest to a reference time of the same clock. Times within 35
+    minutes of the reference are recovered to the microsecond.
+ */
+int64_t fromProtocolTime(uint32_t protocolTime, int64_t reference);
+
 void createHelloPacket(Packet* packet, const boost::asio::ip::udp::endpoint& endpoint);
 void createWelcomePacket(Packet* packet, uint32_t playerId, uint32_t objectId, const boost::asio::ip::udp::endpoint& endpoint);
-void createInputPacket(Packet* packet, uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, const MoveList& moveList);
+void createInputPacket(Packet* packet, uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, const MoveList& moveList, int64_t viewTime);
 void createStatePacket(Packet* packet, const boost::asio::ip::udp::endpoint& endpoint);
-void createTickPacket(Packet* packet, uint32_t playerId, float timeStamp, const boost::asio::ip::udp::endpoint& endpoint);
-void createTockPacket(Packet* packet, float timeStamp, const boost::asio::ip::udp::endpoint& endpoint);
+void createTickPacket(Packet* packet, uint32_t playerId, int64_t timeStamp, const boost::asio::ip::udp::endpoint& endpoint);
+void createTockPacket(Packet* packet, uint32_t originateTime, int64_t receiveTime, int64_t transmitTime, const boost::asio::ip::udp::endpoint& endpoint);
 void createInvitePacket(Packet* packet, uint32_t playerId, const boost::asio::ip::udp::endpoint& endpoint, const PeerRegistry& peerRegistry);
 void createIntroPacket(Packet* packet, uint32_t newPeerPlayerId, const boost::asio::ip::udp::endpoint& newPeerEndpoint, const boost::asio::ip::udp::endpoint& endpoint);
 void createStartPacket(Packet* packet, const boost::asio::ip::udp::endpoint& endpoint);
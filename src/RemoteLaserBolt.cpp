@@ -1,33 +1,34 @@
 #include "RemoteLaserBolt.h"
-#include "LatencyEstimator.h"
-#include "Utilities.h"
+#include "SnapshotTimeline.h"
 
-RemoteLaserBolt::RemoteLaserBolt(const Renderer& renderer, const LatencyEstimator& latencyEstimator, float frameDuration)
-: LaserBolt(renderer, Vector2d(0, 0), Vector2d(0, 0))
-, latencyEstimator_(latencyEstimator)
-, frameDuration_(frameDuration)
-, created_(true) {
+// Bolts fly straight, so a few snapshots are enough.
+static const uint32_t SNAPSHOT_BUFFER_SIZE = 8;
+
+// Without newer snapshots a bolt keeps flying for at most this long.
+static const float MAX_EXTRAPOLATION = 0.25f;
+
+RemoteLaserBolt::RemoteLaserBolt(const Renderer& renderer, Kinematics& kinematics, const SnapshotTimeline& timeline)
+: LaserBolt(renderer, kinematics, Vector2d(0, 0), Vector2d(0, 0))
+, timeline_(timeline)
+, snapshots_(SNAPSHOT_BUFFER_SIZE) {
+}
+
+void RemoteLaserBolt::update(float) {
+    BodyState state;
+    if (snapshots_.sample(timeline_.getRenderTime(), MAX_EXTRAPOLATION, state)) {
+        setBodyState(state);
+    }
 }
 
 void RemoteLaserBolt::read(Packet* packet) {
-    const auto oldPosition = position_;
+    // The snapshot only goes into the buffer; what is shown is decided in update().
+    const auto shown = getBodyState();
+    const auto created = snapshots_.getCount() == 0;
 
     LaserBolt::read(packet);
+    snapshots_.add(timeline_.getSnapshotTime(), getBodyState());
 
-    auto latency = latencyEstimator_.getMeanRTT() / 2.0f;
-    while (true) {
-        if (latency < frameDuration_) {
-            update(latency);
-            break;
-        } else {
-            update(frameDuration_);
-            latency -= frameDuration_;
-        }
-    }
-
-    if (created_) {
-        created_ = false;
-    } else {
-        position_ = lerp(position_, oldPosition, 0.5f);
+    if (!created) {
+        setBodyState(shown);
     }
 }
@@ -2,21 +2,22 @@
 #define _RemoteLaserBolt_H
 
 #include "LaserBolt.h"
+#include "InterpolationBuffer.h"
 
-class LatencyEstimator;
+class SnapshotTimeline;
 
 class RemoteLaserBolt : public LaserBolt {
 public:
-    RemoteLaserBolt(const Renderer& renderer, const LatencyEstimator& latencyEstimator, float frameDuration);
+    RemoteLaserBolt(const Renderer& renderer, Kinematics& kinematics, const SnapshotTimeline& timeline);
+
+    void update(float elapsed) override;
 
     void read(Packet* packet) override;
 
 private:
-    const LatencyEstimator& latencyEstimator_;
-
-    const float frameDuration_;
+    const SnapshotTimeline& timeline_;
 
-    bool created_;
+    InterpolationBuffer snapshots_;
 };
 
 #endif  // _RemoteLaserBolt_H
@@ -1,43 +1,34 @@
 #include "RemoteSpaceShip.h"
-#include "LatencyEstimator.h"
-#include "Utilities.h"
+#include "SnapshotTimeline.h"
 
-RemoteSpaceShip::RemoteSpaceShip(const Renderer& renderer, const LatencyEstimator& latencyEstimator, float frameDuration)
-: SpaceShip(renderer)
-, latencyEstimator_(latencyEstimator)
-, frameDuration_(frameDuration)
-, created_(true) {
+// Half a second of snapshots at 30 STATE updates per second.
+static const uint32_t SNAPSHOT_BUFFER_SIZE = 16;
+
+// Without newer snapshots a ship keeps moving for at most this long.
+static const float MAX_EXTRAPOLATION = 0.25f;
+
+RemoteSpaceShip::RemoteSpaceShip(const Renderer& renderer, Kinematics& kinematics, const SnapshotTimeline& timeline)
+: SpaceShip(renderer, kinematics)
+, timeline_(timeline)
+, snapshots_(SNAPSHOT_BUFFER_SIZE) {
 }
 
-void RemoteSpaceShip::update(float elapsed) {
-    SpaceShip::update(elapsed);
+void RemoteSpaceShip::update(float) {
+    BodyState state;
+    if (snapshots_.sample(timeline_.getRenderTime(), MAX_EXTRAPOLATION, state)) {
+        setBodyState(state);
+    }
 }
 
 void RemoteSpaceShip::read(Packet* packet) {
-    const auto oldPosition = position_;
-    const auto oldVelocity = velocity_;
-    const auto oldLookat = lookat_;
-    const auto oldAcceleration = acceleration_;
+    // The snapshot only goes into the buffer; what is shown is decided in update().
+    const auto shown = getBodyState();
+    const auto created = snapshots_.getCount() == 0;
 
     SpaceShip::read(packet);
+    snapshots_.add(timeline_.getSnapshotTime(), getBodyState());
 
-    auto latency = latencyEstimator_.getMeanRTT() / 2.0f;
-    while (true) {
-        if (latency < frameDuration_) {
-            update(latency);
-            break;
-        } else {
-            update(frameDuration_);
-            latency -= frameDuration_;
-        }
-    }
-
-    if (created_) {
-        created_ = false;
-    } else {
-        position_ = lerp(position_, oldPosition, 0.5f);
-        velocity_ = lerp(velocity_, oldVelocity, 0.5f);
-        lookat_ = lerp(lookat_, oldLookat, 0.5f);
-        acceleration_ = lerp(acceleration_, oldAcceleration, 0.5f);
+    if (!created) {
+        setBodyState(shown);
     }
 }
@@ -2,23 +2,22 @@
 #define _RemoteSpaceShip_H
 
 #include "SpaceShip.h"
+#include "InterpolationBuffer.h"
 
-class LatencyEstimator;
+class SnapshotTimeline;
 
 class RemoteSpaceShip : public SpaceShip {
 public:
-    RemoteSpaceShip(const Renderer& renderer, const LatencyEstimator& latencyEstimator, float frameDuration);
+    RemoteSpaceShip(const Renderer& renderer, Kinematics& kinematics, const SnapshotTimeline& timeline);
 
     void update(float elapsed) override;
 
     void read(Packet* packet) override;
 
 private:
-    const LatencyEstimator& latencyEstimator_;
+    const SnapshotTimeline& timeline_;
 
-    const float frameDuration_;
-
-    bool created_;
+    InterpolationBuffer snapshots_;
 };
 
 #endif  // _RemoteSpaceShip_H
@@ -2,21 +2,48 @@
 #include "Window.h"
 #include "Vector2d.h"
 
+#include <SDL2/SDL_image.h>
+
 #include <stdexcept>
 
 Renderer::Renderer(const Window &window)
-: renderer_(nullptr) {
+: surface_(nullptr)
+, renderer_(nullptr)
+, textures_() {
     renderer_ = SDL_CreateRenderer(window.getSDLWindow(), -1, SDL_RENDERER_ACCELERATED);
     if (renderer_ == nullptr) {
         throw std::runtime_error(SDL_GetError());
     }
 }
 
+Renderer::Renderer(unsigned int width, unsigned int height)
+: surface_(nullptr)
+, renderer_(nullptr)
+, textures_() {
+    surface_ = SDL_CreateRGBSurface(0, static_cast<int>(width), static_cast<int>(height), 32, 0, 0, 0, 0);
+    if (surface_ == nullptr) {
+        throw std::runtime_error(SDL_GetError());
+    }
+    renderer_ = SDL_CreateSoftwareRenderer(surface_);
+    if (renderer_ == nullptr) {
+        SDL_FreeSurface(surface_);
+        throw std::runtime_error(SDL_GetError());
+    }
+}
+
 Renderer::~Renderer() {
+    for (auto& texture : textures_) {
+        SDL_DestroyTexture(texture.second);
+    }
+    textures_.clear();
     if (renderer_) {
         SDL_DestroyRenderer(renderer_);
     }
     renderer_ = nullptr;
+    if (surface_) {
+        SDL_FreeSurface(surface_);
+    }
+    surface_ = nullptr;
 }
 
 void Renderer::clear(float r, float g, float b) {
@@ -47,3 +74,21 @@ void Renderer::drawRect(const Vector2d& pos, unsigned int width, unsigned int he
 void Renderer::present() {
     SDL_RenderPresent(renderer_);
 }
+
+SDL_Texture* Renderer::getTexture(const char* filename) const {
+    const auto itr = textures_.find(filename);
+    if (itr != textures_.end()) {
+        return itr->second;
+    }
+    SDL_Surface *surface = IMG_Load(filename);
+    if (surface == nullptr) {
+        throw std::runtime_error(IMG_GetError());
+    }
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer_, surface);
+    SDL_FreeSurface(surface);
+    if (texture == nullptr) {
+        throw std::runtime_error(SDL_GetError());
+    }
+    textures_.emplace(filename, texture);
+    return texture;
+}
@@ -3,6 +3,10 @@
 
 #include <SDL2/SDL.h>
 
+#include <functional>
+#include <map>
+#include <string>
+
 class Window;
 class Vector2d;
 
@@ -10,6 +14,15 @@ class Renderer {
 public:
     explicit Renderer(const Window &window);
 
+    /** Creates a software renderer that draws into an offscreen surface, for
+        servers that simulate worlds without a window. Textures still load, so
+        sprites report their real sizes.
+
+        \param width the width of the surface.
+        \param height the height of the surface.
+     */
+    Renderer(unsigned int width, unsigned int height);
+
     ~Renderer();
 
     Renderer(const Renderer&) = delete;
@@ -30,8 +43,21 @@ public:
         return renderer_;
     }
 
+    /** Returns the texture for an image file, loading it on first use.
+
+        The renderer owns the texture, so sprites of the same image share it
+        and creating a sprite does not touch the file system again.
+
+        \param filename the name of the image file.
+     */
+    SDL_Texture* getTexture(const char* filename) const;
+
 private:
+    SDL_Surface* surface_;
+
     SDL_Renderer* renderer_;
+
+    mutable std::map<std::string, SDL_Texture*, std::less<>> textures_;
 };
 
 #endif  // _Renderer_H
@@ -0,0 +1,283 @@
+#include "Room.h"
+#include "Renderer.h"
+#include "Clock.h"
+#include "Protocol.h"
+#include "ClientSession.h"
+#include "Packet.h"
+#include "PacketSink.h"
+#include "Transceiver.h"
+#include "Logging.h"
+
+#include <utility>
+#include <algorithm>
+
+// Shots are not rewound further than this, so that a client with a very high
+// latency cannot hit ships that have long left the spot.
+static const float MAX_REWIND_TIME = 0.5f;
+
+// A ship fires at most one laser bolt per this many seconds.
+static const double SHOT_INTERVAL = 0.25;
+
+Room::Room(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, std::size_t historyBudget, uint32_t seed, const Renderer& renderer, PacketSink& packetPool, Transceiver& transceiver)
+: width_(width)
+, height_(height)
+, renderer_(renderer)
+, packetPool_(packetPool)
+, transceiver_(transceiver)
+, spaceShipPool_()
+, laserBoltPool_()
+, explosionPool_()
+, history_(historyBudget)
+, world_(width, height, [this] (uint32_t objectId1, const GameObject* gameObject1, uint32_t objectId2, const GameObject* gameObject2) { return confirmCollision(objectId1, gameObject1, objectId2, gameObject2); }, [this] (uint32_t objectId) { removedObject(objectId); })
+, frameDuration_(1.0f/static_cast<float>(frameRate))
+, updateInterval_(Clock::toNanoseconds(1.0/updateRate))
+, playerIds_()
+, objectIds_()
+, playerToObjectMap_()
+, clientRegistry_()
+, snapshotEncoder_(nullptr)
+, recipients_()
+, encodedObject_(PROTOCOL_MAX_PACKET_SIZE)
+, random_(seed != 0 ? seed : std::random_device()())
+, lastStateUpdate_(0) {
+    if (historyBudget > 0) {
+        world_.setLagCompensation(&history_, [this] (const GameObject* gameObject) { return getRewindTime(gameObject); }, [] (const GameObject* gameObject) { return gameObject->getClassId() == SpaceShip::ClassId; });
+    }
+}
+
+void Room::setTaskScheduler(TaskScheduler* taskScheduler) {
+    world_.setTaskScheduler(taskScheduler);
+}
+
+void Room::setSnapshotEncoder(SnapshotEncoder* snapshotEncoder) {
+    snapshotEncoder_ = snapshotEncoder;
+}
+
+void Room::handlePacket(Packet* packet, const Clock& clock) {
+    uint32_t magicNumber = 0;
+    packet->read(magicNumber);
+    if (magicNumber != PROTOCOL_MAGIC_NUMBER) {
+        WARN("Received an invalid packet from {0}: wrong magic number.", packet->getEndpoint());
+        return;
+    }
+
+    unsigned char protocolVersion = 0;
+    packet->read(protocolVersion);
+    if (protocolVersion == PROTOCOL_VERSION) {
+        unsigned char packetType = PROTOCOL_PACKET_TYPE_INVALID;
+        packet->read(packetType);
+        switch (packetType) {
+        case PROTOCOL_PACKET_TYPE_HELLO:
+            handleHello(packet, clock);
+            break;
+        case PROTOCOL_PACKET_TYPE_INPUT:
+            handleInput(packet, clock);
+            break;
+        case PROTOCOL_PACKET_TYPE_TICK:
+            handleTick(packet, clock);
+            break;
+        default:
+            WARN("Received a packet with unexpected packet type {0} from {1}.", static_cast<unsigned int>(packetType), packet->getEndpoint());
+            break;
+        }
+    } else {
+        WARN("Received a packet with invalid protocol version {0} from {1}.", static_cast<unsigned int>(protocolVersion), packet->getEndpoint());
+    }
+}
+
+void Room::handleHello(Packet* packet, const Clock& clock) {
+    if (!clientRegistry_.hasClientSession(packet->getEndpoint())) {
+        INFO("HELLO received from new client at {0}", packet->getEndpoint());
+        auto welcomePacket = packetPool_.pop();
+        if (welcomePacket) {
+            const auto playerId = playerIds_.allocate();
+            const auto objectId = objectIds_.allocate();
+            if (playerId == HandleAllocator::InvalidHandle || objectId == HandleAllocator::InvalidHandle) {
+                // Releasing the invalid one of the two does nothing.
+                playerIds_.release(playerId);
+                objectIds_.release(objectId);
+                packetPool_.push(welcomePacket);
+                WARN("Failed to WELCOME client: no free player or object ID.");
+                return;
+            }
+
+            ClientSession* clientSession = clientRegistry_.addClientSession(playerId, packet->getEndpoint(), clock.getFrameStart());
+
+            std::uniform_real_distribution<float> x(0.0f, static_cast<float>(width_));
+            std::uniform_real_distribution<float> y(0.0f, static_cast<float>(height_));
+            auto newSpaceShip = spaceShipPool_.create(renderer_, world_.getKinematics(), Vector2d(x(random_), y(random_)), clientSession, [this, &clock, playerId] (SpaceShip* spaceShip, int64_t lastShot) -> int64_t {
+                const auto now = clock.getFrameStart();
+                if (now > lastShot + Clock::toNanoseconds(SHOT_INTERVAL)) {
+                    const auto boltObjectId = objectIds_.allocate();
+                    if (boltObjectId != HandleAllocator::InvalidHandle) {
+                        auto laserBolt = laserBoltPool_.create(renderer_, world_.getKinematics(), spaceShip->getPosition() + 5.0f * spaceShip->getLookAt(), 100.0f * spaceShip->getLookAt());
+                        laserBolt->setPlayerId(playerId);
+                        world_.add(boltObjectId, std::move(laserBolt));
+                    }
+                    return now;
+                }
+                return lastShot;
+            });
+            newSpaceShip->setPlayerId(playerId);
+            world_.add(objectId, std::move(newSpaceShip));
+
+            playerToObjectMap_[playerId] = objectId;
+
+            createWelcomePacket(welcomePacket, playerId, objectId, packet->getEndpoint());
+            transceiver_.sendTo(welcomePacket);
+
+            INFO("WELCOME client {0} from {1}.", playerId, packet->getEndpoint());
+        } else {
+            WARN("Failed to WELCOME client: empty packet pool.");
+        }
+    } else {
+        WARN("HELLO from known client {0}.", packet->getEndpoint());
+    }
+}
+
+void Room::handleInput(Packet* packet, const Clock& clock) {
+    uint32_t playerId = PROTOCOL_INVALID_PLAYER_ID;
+    packet->read(playerId);
+    if (clientRegistry_.verifyClientSession(playerId, packet->getEndpoint())) {
+        auto clientSession = clientRegistry_.getClientSession(playerId);
+        const auto now = clock.getFrameStart();
+        clientSession->setLastSeen(now);
+        InputBuffer& inputBuffer = clientSession->getInputBuffer();
+        uint32_t latestTick = 0;
+        packet->read(latestTick);
+        // The client renders the world at a time of the server clock.
+        uint32_t viewTime = 0;
+        packet->read(viewTime);
+        clientSession->setViewDelay(Clock::toSeconds(now - fromProtocolTime(viewTime, now)));
+        uint32_t count = 0;
+        packet->read(count);
+        for (uint32_t i = 0; i < count; i++) {
+            Move move;
+            move.read(packet);
+            inputBuffer.addMove(move);
+        }
+    } else {
+        WARN("Received INPUT from unknown client {0}.", packet->getEndpoint());
+    }
+}
+
+void Room::handleTick(Packet* packet, const Clock& clock) {
+    uint32_t playerId = PROTOCOL_INVALID_PLAYER_ID;
+    packet->read(playerId);
+    if (clientRegistry_.verifyClientSession(playerId, packet->getEndpoint())) {
+        auto clientSession = clientRegistry_.getClientSession(playerId);
+        const auto receiveTime = clock.toTime(packet->getReceiveTime());
+        clientSession->setLastSeen(clock.getFrameStart());
+        uint32_t timeStamp = 0;
+        packet->read(timeStamp);
+
+        auto replyPacket = packetPool_.pop();
+        if (replyPacket) {
+            createTockPacket(replyPacket, timeStamp, receiveTime, clock.now(), clientSession->getEndpoint());
+            transceiver_.sendTo(replyPacket);
+        } else {
+            WARN("Failed to send TOCK to a client: empty packet pool.");
+        }
+
+    } else {
+        WARN("Received INPUT from unknown client {0}.", packet->getEndpoint());
+    }
+}
+
+void Room::update(const Clock& clock) {
+    checkForDisconnects(clock);
+    world_.update(frameDuration_);
+    sendStateUpdate(clock);
+}
+
+void Room::draw(Renderer& renderer, float alpha) {
+    world_.draw(renderer, alpha);
+}
+
+uint32_t Room::getClientCount() const {
+    return clientRegistry_.getClientSessionCount();
+}
+
+void Room::checkForDisconnects(const Clock& clock) {
+    clientRegistry_.checkForDisconnects(clock.getFrameStart(), [this] (uint32_t playerId) {
+            DEBUG("Remove disconnected client {0}", playerId);
+            auto itr = playerToObjectMap_.find(playerId);
+            if (itr != playerToObjectMap_.end()) {
+                const uint32_t objectId = itr->second;
+                world_.remove(objectId);
+                removedObject(objectId);
+                playerToObjectMap_.erase(itr);
+            }
+            playerIds_.release(playerId);
+        });
+}
+
+void Room::sendStateUpdate(const Clock& clock) {
+    const auto now = clock.getFrameStart();
+    if (now > lastStateUpdate_ + updateInterval_) {
+        // All clients see the same objects, so they are encoded only once.
+        auto snapshot = std::make_shared<WorldSnapshot>();
+        snapshot->time = now;
+        uint32_t leftOut = 0;
+        world_.forEachGameObject([this, &snapshot, &leftOut] (uint32_t objectId, GameObject* gameObject) {
+            encodedObject_.clear();
+            encodedObject_.write(objectId);
+            encodedObject_.write(gameObject->getClassId());
+            gameObject->write(&encodedObject_);
+            if (!snapshot->addObject(encodedObject_)) {
+                leftOut++;
+            }
+        });
+        if (leftOut > 0) {
+            WARN("STATE update is full. Left out {0} objects.", leftOut);
+        }
+
+        recipients_.clear();
+        clientRegistry_.forEachClientSession([this] (ClientSession* clientSession) {
+            recipients_.push_back(StateRecipient{clientSession->getEndpoint(), clientSession->getLatestInputTick(), clientSession->getInputBuffer().getTimeScale()});
+        });
+
+        if (snapshotEncoder_) {
+            snapshotEncoder_->publish(snapshot, recipients_);
+        } else {
+            for (const auto& recipient : recipients_) {
+                SnapshotEncoder::send(*snapshot, recipient, packetPool_, transceiver_);
+            }
+        }
+
+        lastStateUpdate_ = now;
+    }
+}
+
+bool Room::confirmCollision(uint32_t, const GameObject* gameObject1, uint32_t, const GameObject* gameObject2) {
+    const auto result = gameObject1->getPlayerId() != gameObject2->getPlayerId();
+    if (result) {
+        if (gameObject1->getClassId() == SpaceShip::ClassId) {
+            addExplosion(gameObject1->getPosition());
+        }
+        if (gameObject2->getClassId() == SpaceShip::ClassId) {
+            addExplosion(gameObject2->getPosition());
+        }
+    }
+    return result;
+}
+
+void Room::addExplosion(const Vector2d& position) {
+    const auto objectId = objectIds_.allocate();
+    if (objectId != HandleAllocator::InvalidHandle) {
+        world_.add(objectId, explosionPool_.create(renderer_, position));
+    }
+}
+
+void Room::removedObject(uint32_t objectId) {
+    objectIds_.release(objectId);
+}
+
+float Room::getRewindTime(const GameObject* gameObject) {
+    // A laser bolt hits what its shooter saw when firing it.
+    if (gameObject->getClassId() != LaserBolt::ClassId) {
+        return 0.0f;
+    }
+    const auto clientSession = clientRegistry_.getClientSession(gameObject->getPlayerId());
+    return clientSession ? std::min(std::max(clientSession->getViewDelay(), 0.0f), MAX_REWIND_TIME) : 0.0f;
+}
@@ -0,0 +1,131 @@
+#ifndef _Room_H
+#define _Room_H
+
+#include "ServerWorld.h"
+#include "ServerSpaceShip.h"
+#include "LaserBolt.h"
+#include "Explosion.h"
+#include "GameObjectPool.h"
+#include "HandleAllocator.h"
+#include "ClientRegistry.h"
+#include "SnapshotEncoder.h"
+
+#include <random>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+class Renderer;
+class Clock;
+class Packet;
+class PacketSink;
+class Transceiver;
+class TaskScheduler;
+
+/** One match: a server world and the sessions of the clients playing in it.
+
+    A room owns all of its state, so rooms driven by different threads share
+    nothing but the packet pool and the socket. All methods must be called from
+    the thread that drives the room.
+ */
+class Room {
+public:
+    /** Constructor
+
+        \param width the width of the world.
+        \param height the height of the world.
+        \param frameRate the number of updates per second.
+        \param updateRate the number of STATE updates per second.
+        \param historyBudget the number of bytes of the history used for lag compensation, 0 to disable it.
+        \param seed the seed of the random spawn positions, 0 for a random seed.
+        \param renderer the renderer that provides the textures of the game objects.
+        \param packetPool the pool to take outgoing packets from.
+        \param transceiver the transceiver to send packets with.
+     */
+    Room(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, std::size_t historyBudget, uint32_t seed, const Renderer& renderer, PacketSink& packetPool, Transceiver& transceiver);
+
+    Room(const Room&) = delete;
+
+    Room& operator =(const Room&) = delete;
+
+    /** Sets the scheduler used to simulate the world of this room.
+     */
+    void setTaskScheduler(TaskScheduler* taskScheduler);
+
+    /** Sets the encoder that builds and sends the STATE packets of this room.
+        Without an encoder they are built on the calling thread.
+     */
+    void setSnapshotEncoder(SnapshotEncoder* snapshotEncoder);
+
+    /** Handles a packet received from a client. The caller keeps the ownership of the packet.
+
+        \param packet the received packet.
+        \param clock the clock of the thread that drives the room.
+     */
+    void handlePacket(Packet* packet, const Clock& clock);
+
+    /** Removes disconnected clients, simulates one frame and sends STATE updates when due.
+
+        \param clock the clock of the thread that drives the room.
+     */
+    void update(const Clock& clock);
+
+    /** Draws the world of this room.
+
+        \param renderer the renderer to draw with.
+        \param alpha how far the time has advanced from the last update towards the next one.
+     */
+    void draw(Renderer& renderer, float alpha);
+
+    /** Returns the number of connected clients.
+     */
+    uint32_t getClientCount() const;
+
+private:
+    void handleHello(Packet* packet, const Clock& clock);
+    void handleInput(Packet* packet, const Clock& clock);
+    void handleTick(Packet* packet, const Clock& clock);
+
+    void checkForDisconnects(const Clock& clock);
+    void sendStateUpdate(const Clock& clock);
+
+    bool confirmCollision(uint32_t objectId1, const GameObject* gameObject1, uint32_t objectId2, const GameObject* gameObject2);
+    void addExplosion(const Vector2d& position);
+    void removedObject(uint32_t objectId);
+
+    float getRewindTime(const GameObject* gameObject);
+
+    const unsigned int width_;
+    const unsigned int height_;
+
+    const Renderer& renderer_;
+
+    PacketSink& packetPool_;
+    Transceiver& transceiver_;
+
+    GameObjectPool<ServerSpaceShip> spaceShipPool_;
+    GameObjectPool<LaserBolt> laserBoltPool_;
+    GameObjectPool<Explosion> explosionPool_;
+
+    WorldHistory history_;
+    ServerWorld world_;
+
+    const float frameDuration_;
+    const int64_t updateInterval_;
+
+    HandleAllocator playerIds_;
+    HandleAllocator objectIds_;
+    std::unordered_map<uint32_t, uint32_t> playerToObjectMap_;
+
+    ClientRegistry clientRegistry_;
+
+    SnapshotEncoder* snapshotEncoder_;
+    std::vector<StateRecipient> recipients_;
+    Packet encodedObject_;
+
+    std::mt19937 random_;
+
+    int64_t lastStateUpdate_;
+};
+
+#endif  // _Room_H
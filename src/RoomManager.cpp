@@ -0,0 +1,202 @@
+#include "RoomManager.h"
+#include "Packet.h"
+#include "Protocol.h"
+#include "Utilities.h"
+#include "Logging.h"
+
+#include <algorithm>
+
+static const uint32_t PACKETS_PER_ROOM = 64;
+static const uint32_t WORKER_INBOX_SIZE = 1024;
+static const std::chrono::seconds STATUS_INTERVAL(10);
+
+// After a stall a worker runs at most this many ticks of its rooms at once.
+static const uint32_t MAX_CATCH_UP_TICKS = 5;
+
+static uint64_t getEndpointKey(const boost::asio::ip::udp::endpoint& endpoint) {
+    return (static_cast<uint64_t>(endpoint.address().to_v4().to_ulong()) << 16) | endpoint.port();
+}
+
+RoomManager::Worker::Worker(unsigned int width, unsigned int height, unsigned int tickRate, uint32_t inboxSize)
+: renderer(width, height)
+, clock()
+, timestep(tickRate, MAX_CATCH_UP_TICKS)
+, pacer()
+, rooms()
+, inbox(inboxSize)
+, clientCount(0)
+, thread() {
+    // A server tick need not start to the microsecond, so the workers sleep
+    // instead of spinning away the cores they share with the other rooms.
+    pacer.setSpinning(false);
+}
+
+RoomManager::RoomManager(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, std::size_t historyBudget, uint32_t seed,
+                         unsigned int roomCount, unsigned int playersPerRoom, unsigned int workerCount, bool pinWorkers,
+                         const Impairment& inbound, const Impairment& outbound, uint16_t port)
+: frameRate_(frameRate)
+, roomCount_(std::max(1u, roomCount))
+, playersPerRoom_(std::max(1u, playersPerRoom))
+, workerCount_(std::min(roomCount_, std::max(1u, workerCount != 0 ? workerCount : std::thread::hardware_concurrency())))
+, pinWorkers_(pinWorkers)
+, packetPool_(4000 + roomCount_ * PACKETS_PER_ROOM)
+, workers_(createWorkers(width, height, updateRate, historyBudget, seed))
+, assignments_()
+, roomLoad_(roomCount_, 0)
+, lastPrune_(std::chrono::steady_clock::now())
+, latencyEmulator_(*this, inbound, outbound)
+, transceiver_(port, latencyEmulator_) {
+    transceiver_.setSendEmulator(&latencyEmulator_);
+    INFO("Hosting {0} rooms on {1} workers.", roomCount_, workerCount_);
+}
+
+RoomManager::~RoomManager() {
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::vector<std::unique_ptr<RoomManager::Worker>> RoomManager::createWorkers(unsigned int width, unsigned int height, unsigned int updateRate, std::size_t historyBudget, uint32_t seed) {
+    // Room r lives on worker r % workerCount_ at index r / workerCount_. The
+    // transceiver is not running yet; rooms only keep a reference to it.
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (unsigned int w = 0; w < workerCount_; w++) {
+        workers.push_back(std::make_unique<Worker>(width, height, frameRate_, WORKER_INBOX_SIZE));
+    }
+    for (unsigned int r = 0; r < roomCount_; r++) {
+        auto& worker = *workers[r % workerCount_];
+        const auto roomSeed = seed != 0 ? seed + r : 0;
+        worker.rooms.push_back(std::make_unique<Room>(width, height, frameRate_, updateRate, historyBudget, roomSeed, worker.renderer, packetPool_, transceiver_));
+    }
+    return workers;
+}
+
+void RoomManager::run(const std::atomic<bool>& running) {
+    for (unsigned int w = 0; w < workerCount_; w++) {
+        auto& worker = *workers_[w];
+        worker.thread = std::thread([this, &worker, &running] { workerLoop(worker, running); });
+        if (pinWorkers_ && !pinThreadToCore(worker.thread.native_handle(), w % std::max(1u, std::thread::hardware_concurrency()))) {
+            WARN("Failed to pin worker {0} to a core.", w);
+        }
+    }
+
+    auto lastStatus = std::chrono::steady_clock::now();
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = std::chrono::steady_clock::now();
+        if (now - lastStatus >= STATUS_INTERVAL) {
+            uint32_t clientCount = 0;
+            for (const auto& worker : workers_) {
+                clientCount += worker->clientCount.load(std::memory_order_relaxed);
+            }
+            INFO("{0} clients in {1} rooms, {2} packets in the pool.", clientCount, roomCount_, packetPool_.getNumPooled());
+            lastStatus = now;
+        }
+    }
+
+    for (auto& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+unsigned int RoomManager::getRoomCount() const {
+    return roomCount_;
+}
+
+unsigned int RoomManager::getWorkerCount() const {
+    return workerCount_;
+}
+
+void RoomManager::push(Packet* packet) {
+    packetPool_.push(packet);
+}
+
+Packet* RoomManager::pop() {
+    return packetPool_.pop();
+}
+
+void RoomManager::enqueue(Packet* packet) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastPrune_ > std::chrono::seconds(1)) {
+        pruneAssignments(now);
+        lastPrune_ = now;
+    }
+
+    const auto key = getEndpointKey(packet->getEndpoint());
+    auto itr = assignments_.find(key);
+    if (itr == assignments_.end()) {
+        const auto room = assignRoom();
+        roomLoad_[room]++;
+        itr = assignments_.emplace(key, Assignment{room, now}).first;
+    }
+    itr->second.lastSeen = now;
+
+    const auto room = itr->second.room;
+    auto& worker = *workers_[room % workerCount_];
+    if (!worker.inbox.push(Delivery{packet, room / workerCount_})) {
+        WARN("Inbox of worker {0} is full. Discard a packet from {1}.", room % workerCount_, packet->getEndpoint());
+        packetPool_.push(packet);
+    }
+}
+
+Packet* RoomManager::dequeue() {
+    return nullptr;
+}
+
+void RoomManager::workerLoop(Worker& worker, const std::atomic<bool>& running) {
+    while (running) {
+        worker.clock.update();
+        worker.timestep.advance(worker.clock.getElapsedNanoseconds());
+
+        Delivery delivery{nullptr, 0};
+        while (worker.inbox.pop(delivery)) {
+            worker.rooms[delivery.room]->handlePacket(delivery.packet, worker.clock);
+            packetPool_.push(delivery.packet);
+        }
+
+        while (worker.timestep.takeTick()) {
+            for (auto& room : worker.rooms) {
+                room->update(worker.clock);
+            }
+        }
+
+        uint32_t clientCount = 0;
+        for (auto& room : worker.rooms) {
+            clientCount += room->getClientCount();
+        }
+        worker.clientCount.store(clientCount, std::memory_order_relaxed);
+
+        worker.pacer.waitUntil(worker.clock, worker.clock.getFrameStart() + worker.timestep.getTimeUntilNextTick());
+    }
+}
+
+uint32_t RoomManager::assignRoom() {
+    // Fill the rooms one after the other so that players meet each other, and
+    // spread the rest evenly once all rooms are full.
+    uint32_t leastLoaded = 0;
+    for (uint32_t room = 0; room < roomCount_; room++) {
+        if (roomLoad_[room] < playersPerRoom_) {
+            return room;
+        }
+        if (roomLoad_[room] < roomLoad_[leastLoaded]) {
+            leastLoaded = room;
+        }
+    }
+    return leastLoaded;
+}
+
+void RoomManager::pruneAssignments(std::chrono::steady_clock::time_point now) {
+    // Rooms drop silent clients after PROTOCOL_CLIENT_TIMEOUT, so an endpoint
+    // that has been silent for twice as long is no longer in its room.
+    const auto timeout = std::chrono::duration<float>(2.0f * PROTOCOL_CLIENT_TIMEOUT);
+    for (auto itr = assignments_.begin(); itr != assignments_.end();) {
+        if (now - itr->second.lastSeen > timeout) {
+            roomLoad_[itr->second.room]--;
+            itr = assignments_.erase(itr);
+        } else {
+            ++itr;
+        }
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef _RoomManager_H
+#define _RoomManager_H
+
+#include "PacketSink.h"
+#include "BufferedQueue.h"
+#include "LatencyEmulator.h"
+#include "Transceiver.h"
+#include "Renderer.h"
+#include "Clock.h"
+#include "FixedTimestep.h"
+#include "FramePacer.h"
+#include "Room.h"
+#include "SpscRing.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/** Hosts many independent rooms in one process without a window.
+
+    Rooms are dealt out to a fixed set of worker threads, one per core, and each
+    room is only ever touched by its worker. The receiving thread assigns each new
+    client endpoint to a room and forwards its packets to the owning worker through
+    a single-producer single-consumer ring, so rooms never share a lock. Workers
+    send directly through the shared socket and return packets to the shared
+    lock-free pool.
+ */
+class RoomManager : public PacketSink {
+public:
+    /** Constructor
+
+        \param width the width of the worlds.
+        \param height the height of the worlds.
+        \param frameRate the number of updates per second of each room.
+        \param updateRate the number of STATE updates per second of each room.
+        \param historyBudget the number of bytes of the lag compensation history of each room, 0 to disable it.
+        \param seed the seed of the random numbers of the first room, the next rooms count up from it. 0 for random seeds.
+        \param roomCount the number of rooms.
+        \param playersPerRoom the number of players a room is filled with before the next room is used.
+        \param workerCount the number of worker threads. 0 selects the number of hardware threads.
+        \param pinWorkers true to pin each worker to its own core.
+        \param inbound the emulated conditions of received packets.
+        \param outbound the emulated conditions of sent packets.
+        \param port the UDP port to listen on.
+     */
+    RoomManager(unsigned int width, unsigned int height, unsigned int frameRate, unsigned int updateRate, std::size_t historyBudget, uint32_t seed,
+                unsigned int roomCount, unsigned int playersPerRoom, unsigned int workerCount, bool pinWorkers,
+                const Impairment& inbound, const Impairment& outbound, uint16_t port);
+
+    ~RoomManager();
+
+    RoomManager(const RoomManager&) = delete;
+
+    RoomManager& operator =(const RoomManager&) = delete;
+
+    /** Runs the workers until running becomes false.
+
+        \param running the flag to stop the rooms with.
+     */
+    void run(const std::atomic<bool>& running);
+
+    /** Returns the number of rooms.
+     */
+    unsigned int getRoomCount() const;
+
+    /** Returns the number of worker threads.
+     */
+    unsigned int getWorkerCount() const;
+
+    void push(Packet* packet) override;
+
+    Packet* pop() override;
+
+    /** Routes a received packet to the worker that owns the room of its sender.
+        Must only be called from a single thread.
+     */
+    void enqueue(Packet* packet) override;
+
+    /** Received packets are routed to the workers, so this always returns nullptr.
+     */
+    Packet* dequeue() override;
+
+private:
+    struct Delivery {
+        Packet* packet;
+        uint32_t room;
+    };
+
+    struct Worker {
+        Worker(unsigned int width, unsigned int height, unsigned int tickRate, uint32_t inboxSize);
+
+        Renderer renderer;
+        Clock clock;
+        FixedTimestep timestep;
+        FramePacer pacer;
+        std::vector<std::unique_ptr<Room>> rooms;
+        SpscRing<Delivery> inbox;
+        std::atomic<uint32_t> clientCount;
+        std::thread thread;
+    };
+
+    struct Assignment {
+        uint32_t room;
+        std::chrono::steady_clock::time_point lastSeen;
+    };
+
+    std::vector<std::unique_ptr<Worker>> createWorkers(unsigned int width, unsigned int height, unsigned int updateRate, std::size_t historyBudget, uint32_t seed);
+
+    void workerLoop(Worker& worker, const std::atomic<bool>& running);
+
+    uint32_t assignRoom();
+
+    void pruneAssignments(std::chrono::steady_clock::time_point now);
+
+    const unsigned int frameRate_;
+    const unsigned int roomCount_;
+    const unsigned int playersPerRoom_;
+    const unsigned int workerCount_;
+    const bool pinWorkers_;
+
+    BufferedQueue packetPool_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    // Owned by the thread that calls enqueue().
+    // Keyed by the IPv4 address and the port of the client.
+    std::unordered_map<uint64_t, Assignment> assignments_;
+    std::vector<uint32_t> roomLoad_;
+    std::chrono::steady_clock::time_point lastPrune_;
+
+    LatencyEmulator latencyEmulator_;
+    Transceiver transceiver_;
+};
+
+#endif  // _RoomManager_H
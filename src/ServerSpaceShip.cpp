@@ -1,21 +1,20 @@
 #include "ServerSpaceShip.h"
 #include "Renderer.h"
 #include "ClientSession.h"
-#include "MoveList.h"
+#include "InputBuffer.h"
 #include "Move.h"
 
-ServerSpaceShip::ServerSpaceShip(const Renderer& renderer, const Vector2d& position, ClientSession* clientSession, ShootFunc shootFunc)
-: SpaceShip(renderer, position)
+ServerSpaceShip::ServerSpaceShip(const Renderer& renderer, Kinematics& kinematics, const Vector2d& position, ClientSession* clientSession, ShootFunc shootFunc)
+: SpaceShip(renderer, kinematics, position)
 , clientSession_(clientSession)
 , shootFunc_(shootFunc)
 , lastShot_(0) {
 }
 
 void ServerSpaceShip::update(float elapsed) {
-    SpaceShip::update(elapsed);
-
-    MoveList& moveList = clientSession_->getMoveList();
-    for (auto& move : moveList) {
+    // The moves are played back at the rate at which the client sampled them, so
+    // the STATE acknowledges the latest move that has actually been applied.
+    clientSession_->getInputBuffer().consume(elapsed, [this] (const Move& move) {
         const auto& inputState = move.getInputState();
         float deltaTime = move.getDeltaTime();
         rotate(inputState.desiredRightAmount * deltaTime);
@@ -24,6 +23,6 @@ void ServerSpaceShip::update(float elapsed) {
         if (inputState.shooting) {
             lastShot_ = shootFunc_(this, lastShot_);
         }
-    }
-    moveList.clear();
+        clientSession_->setLatestInputTick(move.getTick());
+    });
 }
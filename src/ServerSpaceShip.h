@@ -9,11 +9,11 @@ class Renderer;
 class ClientSession;
 class ServerSpaceShip;
 
-using ShootFunc = std::function<float (SpaceShip*, float)>;
+using ShootFunc = std::function<int64_t (SpaceShip*, int64_t)>;
 
 class ServerSpaceShip : public SpaceShip {
 public:
-    ServerSpaceShip(const Renderer& renderer, const Vector2d& position, ClientSession* clientSession, ShootFunc shootFunc);
+    ServerSpaceShip(const Renderer& renderer, Kinematics& kinematics, const Vector2d& position, ClientSession* clientSession, ShootFunc shootFunc);
 
     ServerSpaceShip(const ServerSpaceShip&) = delete;
 
@@ -26,7 +26,7 @@ private:
 
     ShootFunc shootFunc_;
 
-    float lastShot_;
+    int64_t lastShot_;
 };
 
 #endif  // _ServerSpaceShip_H
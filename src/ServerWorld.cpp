@@ -1,61 +1,224 @@
 #include "ServerWorld.h"
 #include "Vector2d.h"
 #include "SpaceShip.h"
+#include "Clock.h"
 #include "Logging.h"
 
-#include <boost/format.hpp>
+#include <algorithm>
+#include <numeric>
+#include <utility>
 
-#include <unordered_set>
-#include <string>
+static const uint32_t GATHER_GRAIN_SIZE = 1024;
+static const uint32_t SWEEP_GRAIN_SIZE = 256;
+
+ServerWorld::CollisionChunk::CollisionChunk()
+: hits()
+, contacts() {
+}
 
 ServerWorld::ServerWorld(unsigned int width, unsigned int height, ConfirmCollisionFunc confirmCollisionFunc, RemovedObjectFunc removedObjectFunc)
 : World()
 , width_(width)
 , height_(height)
 , confirmCollisionFunc_(confirmCollisionFunc)
-, removedObjectFunc_(removedObjectFunc) {
+, removedObjectFunc_(removedObjectFunc)
+, history_(nullptr)
+, rewindTimeFunc_()
+, isTargetFunc_()
+, time_(0)
+, colliders_()
+, boxes_()
+, rewindTimes_()
+, isTarget_()
+, targets_()
+, order_()
+, bounds_()
+, chunks_()
+, contacts_() {
+}
+
+void ServerWorld::setLagCompensation(WorldHistory* history, RewindTimeFunc rewindTimeFunc, IsTargetFunc isTargetFunc) {
+    history_ = history;
+    rewindTimeFunc_ = rewindTimeFunc;
+    isTargetFunc_ = isTargetFunc;
+}
+
+int64_t ServerWorld::getTime() const {
+    return time_;
 }
 
 void ServerWorld::update(float elapsed) {
     World::update(elapsed);
+    time_ += Clock::toNanoseconds(elapsed);
 
-    std::unordered_set<std::string> checked;
+    checkCollisions();
 
-    forEachGameObject([this, &checked] (uint32_t objectId1, GameObject* gameObject1) {
-        const auto& pos = gameObject1->getPosition();
-        if ((pos.getX() < 0 || pos.getY() < 0 || pos.getX() > width_ || pos.getY() > height_) && gameObject1->getClassId() != SpaceShip::ClassId) {
-            gameObject1->kill();
-        }
-        if (!gameObject1->doesCollide()) {
-            return;
+    removeGameObjectIf([this] (uint32_t objectId, GameObject* gameObject) {
+        if (gameObject->dead()) {
+            removedObjectFunc_(objectId);
+            return true;
         }
-        forEachGameObject([this, objectId1, gameObject1, &checked] (uint32_t objectId2, GameObject* gameObject2) {
-            if (!gameObject2->doesCollide()) {
-                return;
+        return false;
+    });
+}
+
+void ServerWorld::checkCollisions() {
+    // The broad and narrow phases only read the world and write into per-chunk
+    // buffers, so they can run on any number of threads. All decisions that
+    // change the world are taken afterwards on the calling thread, in object ID
+    // order, which makes the outcome independent of the thread count.
+    gatherColliders();
+    recordHistory();
+    sortColliders();
+    findContacts();
+    findRewoundContacts();
+    resolveContacts();
+}
+
+void ServerWorld::gatherColliders() {
+    colliders_.clear();
+    forEachGameObject([this] (uint32_t objectId, GameObject* gameObject) {
+        colliders_.push_back(Collider{objectId, gameObject});
+    });
+
+    boxes_.resize(colliders_.size());
+    rewindTimes_.assign(colliders_.size(), 0.0f);
+    isTarget_.assign(colliders_.size(), 0);
+    parallelFor(static_cast<uint32_t>(colliders_.size()), GATHER_GRAIN_SIZE, [this] (uint32_t begin, uint32_t end) {
+        for (auto i = begin; i < end; i++) {
+            auto gameObject = colliders_[i].gameObject;
+            const auto pos = gameObject->getPosition();
+            if ((pos.getX() < 0 || pos.getY() < 0 || pos.getX() > static_cast<float>(width_) || pos.getY() > static_cast<float>(height_)) && gameObject->getClassId() != SpaceShip::ClassId) {
+                gameObject->kill();
             }
-            auto oid1 = objectId1;
-            auto oid2 = objectId2;
-            if (oid1 != oid2) {
-                if (oid1 > oid2) {
-                    std::swap(oid1, oid2);
+            boxes_[i] = gameObject->doesCollide() ? gameObject->getBounds() : Aabb();
+            if (history_) {
+                rewindTimes_[i] = rewindTimeFunc_(gameObject);
+                isTarget_[i] = isTargetFunc_(gameObject) ? 1 : 0;
+            }
+        }
+    });
+
+    targets_.clear();
+    for (uint32_t i = 0; i < colliders_.size(); i++) {
+        if (isTarget_[i]) {
+            targets_.push_back(i);
+        }
+    }
+    std::sort(targets_.begin(), targets_.end(), [this] (uint32_t a, uint32_t b) {
+        return colliders_[a].objectId < colliders_[b].objectId;
+    });
+}
+
+void ServerWorld::recordHistory() {
+    if (history_) {
+        history_->addFrame(time_);
+        for (const auto i : targets_) {
+            history_->add(colliders_[i].objectId, boxes_[i]);
+        }
+    }
+}
+
+bool ServerWorld::isRewound(uint32_t first, uint32_t second) const {
+    return (rewindTimes_[first] > 0.0f && isTarget_[second]) || (rewindTimes_[second] > 0.0f && isTarget_[first]);
+}
+
+void ServerWorld::sortColliders() {
+    const auto count = static_cast<uint32_t>(colliders_.size());
+    order_.resize(count);
+    std::iota(order_.begin(), order_.end(), 0);
+    std::sort(order_.begin(), order_.end(), [this] (uint32_t a, uint32_t b) {
+        if (boxes_[a].minX != boxes_[b].minX) {
+            return boxes_[a].minX < boxes_[b].minX;
+        }
+        return colliders_[a].objectId < colliders_[b].objectId;
+    });
+
+    bounds_.resize(count);
+    parallelFor(count, GATHER_GRAIN_SIZE, [this] (uint32_t begin, uint32_t end) {
+        for (auto i = begin; i < end; i++) {
+            bounds_.set(i, boxes_[order_[i]]);
+        }
+    });
+}
+
+void ServerWorld::findContacts() {
+    // Sweep along x: with the boxes sorted by their left edge, the candidates
+    // for box i are the boxes after it whose left edge lies left of its right
+    // edge. The SIMD narrow phase then tests that range on both axes.
+    const auto count = bounds_.getCount();
+    const auto chunkCount = (count + SWEEP_GRAIN_SIZE - 1) / SWEEP_GRAIN_SIZE;
+    if (chunks_.size() < chunkCount) {
+        chunks_.resize(chunkCount);
+    }
+    for (auto& chunk : chunks_) {
+        chunk.contacts.clear();
+    }
+
+    parallelFor(count, SWEEP_GRAIN_SIZE, [this] (uint32_t begin, uint32_t end) {
+        auto& chunk = chunks_[begin / SWEEP_GRAIN_SIZE];
+        for (auto i = begin; i < end; i++) {
+            const auto box = bounds_.get(i);
+            const auto last = bounds_.findFirstMinX(box.maxX, i + 1);
+            bounds_.findOverlaps(box, i + 1, last, chunk.hits);
+            for (const auto j : chunk.hits) {
+                auto first = order_[i];
+                auto second = order_[j];
+                if (isRewound(first, second)) {
+                    continue;
                 }
-                const auto id = boost::str(boost::format("%1%,%2%") % oid1 % oid2);
-                if (checked.find(id) == checked.end()) {
-                    if (gameObject1->checkCollision(gameObject2) && confirmCollisionFunc_(oid1, gameObject1, oid2, gameObject2)) {
-                        gameObject1->kill();
-                        gameObject2->kill();
-                    }
-                    checked.insert(id);
+                if (colliders_[first].objectId > colliders_[second].objectId) {
+                    std::swap(first, second);
                 }
+                chunk.contacts.push_back(Contact{first, second});
             }
-        });
+        }
     });
 
-    removeGameObjectIf([this] (uint32_t objectId, GameObject* gameObject) {
-        if (gameObject->dead()) {
-            removedObjectFunc_(objectId);
-            return true;
+    contacts_.clear();
+    for (const auto& chunk : chunks_) {
+        contacts_.insert(contacts_.end(), chunk.contacts.begin(), chunk.contacts.end());
+    }
+}
+
+void ServerWorld::findRewoundContacts() {
+    // Projectiles are few, so testing each against all rewound targets is cheap.
+    if (history_ && !targets_.empty()) {
+        for (uint32_t i = 0; i < colliders_.size(); i++) {
+            if (rewindTimes_[i] <= 0.0f || isTarget_[i]) {
+                continue;
+            }
+            const auto time = time_ - Clock::toNanoseconds(rewindTimes_[i]);
+            for (const auto target : targets_) {
+                // Targets that do not collide any more cannot be hit in the past either.
+                Aabb box;
+                if (boxes_[target].minX <= boxes_[target].maxX && history_->find(colliders_[target].objectId, time, box) && intersects(boxes_[i], box)) {
+                    if (colliders_[i].objectId < colliders_[target].objectId) {
+                        contacts_.push_back(Contact{i, target});
+                    } else {
+                        contacts_.push_back(Contact{target, i});
+                    }
+                }
+            }
         }
-        return false;
+    }
+}
+
+void ServerWorld::resolveContacts() {
+    std::sort(contacts_.begin(), contacts_.end(), [this] (const Contact& a, const Contact& b) {
+        const auto a1 = colliders_[a.first].objectId, b1 = colliders_[b.first].objectId;
+        if (a1 != b1) {
+            return a1 < b1;
+        }
+        return colliders_[a.second].objectId < colliders_[b.second].objectId;
     });
+
+    for (const auto& contact : contacts_) {
+        const auto& collider1 = colliders_[contact.first];
+        const auto& collider2 = colliders_[contact.second];
+        if (confirmCollisionFunc_(collider1.objectId, collider1.gameObject, collider2.objectId, collider2.gameObject)) {
+            collider1.gameObject->kill();
+            collider2.gameObject->kill();
+        }
+    }
 }
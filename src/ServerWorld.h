@@ -2,24 +2,101 @@
 #define _ServerWorld_H
 
 #include "World.h"
+#include "AabbSet.h"
+#include "WorldHistory.h"
 
 #include <functional>
+#include <vector>
 
 using ConfirmCollisionFunc = std::function<bool(uint32_t, const GameObject*, uint32_t, const GameObject*)>;
 using RemovedObjectFunc = std::function<void(uint32_t)>;
+using RewindTimeFunc = std::function<float(const GameObject*)>;
+using IsTargetFunc = std::function<bool(const GameObject*)>;
 
 class ServerWorld : public World {
 public:
     ServerWorld(unsigned int width, unsigned int height, ConfirmCollisionFunc confirmCollisionFunc, RemovedObjectFunc removedObjectFunc);
 
+    ServerWorld(const ServerWorld&) = delete;
+
+    ServerWorld& operator =(const ServerWorld&) = delete;
+
     void update(float elapsed) override;
 
+    /** Enables lag compensation. The boxes of all targets are recorded into the
+        history every frame. A projectile, i.e. an object with a positive rewind
+        time, is tested against the targets as they were that long ago instead
+        of against their current boxes. The callbacks may be called from several
+        threads at once.
+
+        \param history the history to record into, or nullptr to disable lag compensation.
+        \param rewindTimeFunc returns the rewind time in seconds of an object, 0 for none.
+        \param isTargetFunc returns true for objects that projectiles are rewound against.
+     */
+    void setLagCompensation(WorldHistory* history, RewindTimeFunc rewindTimeFunc, IsTargetFunc isTargetFunc);
+
+    /** Returns the simulated time in nanoseconds, i.e. the sum of all elapsed
+        times. It is an integer, so that it keeps advancing by whole frames
+        however long the world runs.
+     */
+    int64_t getTime() const;
+
 private:
+    struct Collider {
+        uint32_t objectId;
+        GameObject* gameObject;
+    };
+
+    // A pair of overlapping colliders given as indices into colliders_, the
+    // one with the smaller object ID first.
+    struct Contact {
+        uint32_t first;
+        uint32_t second;
+    };
+
+    struct CollisionChunk {
+        CollisionChunk();
+
+        std::vector<uint32_t> hits;
+        std::vector<Contact> contacts;
+    };
+
+    void checkCollisions();
+
+    void gatherColliders();
+
+    void sortColliders();
+
+    void recordHistory();
+
+    bool isRewound(uint32_t first, uint32_t second) const;
+
+    void findContacts();
+
+    void findRewoundContacts();
+
+    void resolveContacts();
+
     const unsigned int width_;
     const unsigned int height_;
 
     ConfirmCollisionFunc confirmCollisionFunc_;
     RemovedObjectFunc removedObjectFunc_;
+
+    WorldHistory* history_;
+    RewindTimeFunc rewindTimeFunc_;
+    IsTargetFunc isTargetFunc_;
+    int64_t time_;
+
+    std::vector<Collider> colliders_;
+    std::vector<Aabb> boxes_;
+    std::vector<float> rewindTimes_;
+    std::vector<uint8_t> isTarget_;
+    std::vector<uint32_t> targets_;
+    std::vector<uint32_t> order_;
+    AabbSet bounds_;
+    std::vector<CollisionChunk> chunks_;
+    std::vector<Contact> contacts_;
 };
 
 #endif  // _ServerWorld_H
@@ -0,0 +1,189 @@
+#ifndef _SlotMap_H
+#define _SlotMap_H
+
+#include "HandleAllocator.h"
+
+#include <limits>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+/** A map from handles to values that keeps all values in one contiguous array.
+
+    Keys are handles as produced by HandleAllocator. The slot index of a key selects
+    an entry in a sparse array that points into the dense arrays of keys and values,
+    so lookup, insertion and removal are O(1) and iteration is a linear walk over the
+    values. Removal moves the last value into the hole, so the order of the values
+    changes when values are removed.
+
+    At most one value exists per slot index. Inserting a key whose slot index is held
+    by a key of another generation replaces that value, since the slot can only have
+    been reused after the old handle was released.
+ */
+template<typename T>
+class SlotMap {
+public:
+    /** Constructor
+     */
+    SlotMap()
+    : sparse_()
+    , keys_()
+    , values_() {
+    }
+
+    /** Inserts a value, replacing any value stored in the same slot.
+
+        \param key the key of the value.
+        \param value the value to be inserted.
+        \return a reference to the stored value, valid until the map is modified.
+     */
+    T& insert(uint32_t key, T value) {
+        const auto slot = HandleAllocator::getIndex(key);
+        if (slot >= sparse_.size()) {
+            sparse_.resize(slot + 1, Vacant);
+        }
+        const auto index = sparse_[slot];
+        if (index != Vacant) {
+            keys_[index] = key;
+            values_[index] = std::move(value);
+            return values_[index];
+        }
+        sparse_[slot] = size();
+        keys_.push_back(key);
+        values_.push_back(std::move(value));
+        return values_.back();
+    }
+
+    /** Removes a value.
+
+        \param key the key of the value.
+        \return true if a value was removed, otherwise false.
+     */
+    bool erase(uint32_t key) {
+        const auto index = findIndex(key);
+        if (index == Vacant) {
+            return false;
+        }
+        eraseAt(index);
+        return true;
+    }
+
+    /** Returns a pointer to the value for a given key, or nullptr if there is none.
+     */
+    T* find(uint32_t key) {
+        const auto index = findIndex(key);
+        return index != Vacant ? &values_[index] : nullptr;
+    }
+
+    const T* find(uint32_t key) const {
+        const auto index = findIndex(key);
+        return index != Vacant ? &values_[index] : nullptr;
+    }
+
+    bool contains(uint32_t key) const {
+        return findIndex(key) != Vacant;
+    }
+
+    uint32_t size() const {
+        return static_cast<uint32_t>(values_.size());
+    }
+
+    bool empty() const {
+        return values_.empty();
+    }
+
+    void clear() {
+        sparse_.clear();
+        keys_.clear();
+        values_.clear();
+    }
+
+    void reserve(uint32_t count) {
+        keys_.reserve(count);
+        values_.reserve(count);
+    }
+
+    /** Returns the key of the value at a given position of the dense array.
+     */
+    uint32_t keyAt(uint32_t index) const {
+        return keys_[index];
+    }
+
+    /** Returns the value at a given position of the dense array.
+     */
+    T& valueAt(uint32_t index) {
+        return values_[index];
+    }
+
+    const T& valueAt(uint32_t index) const {
+        return values_[index];
+    }
+
+    /** Calls fun(key, value) for all values. The map must not be modified meanwhile.
+     */
+    template<typename Fun>
+    void forEach(Fun&& fun) {
+        const auto count = size();
+        for (uint32_t i = 0; i < count; i++) {
+            fun(keys_[i], values_[i]);
+        }
+    }
+
+    template<typename Fun>
+    void forEach(Fun&& fun) const {
+        const auto count = size();
+        for (uint32_t i = 0; i < count; i++) {
+            fun(keys_[i], values_[i]);
+        }
+    }
+
+    /** Removes all values for which predicate(key, value) returns true.
+     */
+    template<typename Predicate>
+    void eraseIf(Predicate&& predicate) {
+        for (uint32_t i = 0; i < size();) {
+            if (predicate(keys_[i], values_[i])) {
+                eraseAt(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+private:
+    static const uint32_t Vacant = std::numeric_limits<uint32_t>::max();
+
+    uint32_t findIndex(uint32_t key) const {
+        const auto slot = HandleAllocator::getIndex(key);
+        if (slot < sparse_.size()) {
+            const auto index = sparse_[slot];
+            if (index != Vacant && keys_[index] == key) {
+                return index;
+            }
+        }
+        return Vacant;
+    }
+
+    void eraseAt(uint32_t index) {
+        sparse_[HandleAllocator::getIndex(keys_[index])] = Vacant;
+        const auto last = size() - 1;
+        if (index != last) {
+            keys_[index] = keys_[last];
+            values_[index] = std::move(values_[last]);
+            sparse_[HandleAllocator::getIndex(keys_[index])] = index;
+        }
+        keys_.pop_back();
+        values_.pop_back();
+    }
+
+    std::vector<uint32_t> sparse_;
+
+    std::vector<uint32_t> keys_;
+
+    std::vector<T> values_;
+};
+
+template<typename T>
+const uint32_t SlotMap<T>::Vacant;
+
+#endif  // _SlotMap_H
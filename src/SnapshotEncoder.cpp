@@ -0,0 +1,141 @@
+#include "SnapshotEncoder.h"
+#include "PacketSink.h"
+#include "Protocol.h"
+#include "Transceiver.h"
+#include "Logging.h"
+
+const uint32_t WorldSnapshot::PartCapacity = PROTOCOL_MAX_PACKET_SIZE - PROTOCOL_STATE_HEADER_SIZE;
+
+WorldSnapshot::Part::Part()
+: objectCount(0)
+, objects(PartCapacity) {
+}
+
+WorldSnapshot::WorldSnapshot()
+: time(0)
+, parts() {
+    parts.push_back(std::make_unique<Part>());
+}
+
+bool WorldSnapshot::addObject(const Packet& object) {
+    if (object.getSize() > PartCapacity) {
+        return false;
+    }
+    if (parts.back()->objects.getSize() + object.getSize() > PartCapacity) {
+        if (parts.size() >= PROTOCOL_MAX_STATE_PARTS) {
+            return false;
+        }
+        parts.push_back(std::make_unique<Part>());
+    }
+    auto& part = *parts.back();
+    part.objects.write(object.getData(), object.getSize());
+    part.objectCount++;
+    return true;
+}
+
+uint32_t WorldSnapshot::getObjectCount() const {
+    uint32_t count = 0;
+    for (const auto& part : parts) {
+        count += part->objectCount;
+    }
+    return count;
+}
+
+SnapshotEncoder::SnapshotEncoder(unsigned int threadCount, PacketSink& packetPool, Transceiver& transceiver)
+: packetPool_(packetPool)
+, transceiver_(transceiver)
+, mutex_()
+, wakeCondition_()
+, idleCondition_()
+, jobs_()
+, busyCount_(0)
+, stopping_(false)
+, threads_() {
+    for (unsigned int i = 0; i < threadCount; i++) {
+        threads_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+SnapshotEncoder::~SnapshotEncoder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void SnapshotEncoder::publish(const std::shared_ptr<const WorldSnapshot>& snapshot, const std::vector<StateRecipient>& recipients) {
+    if (threads_.empty()) {
+        for (const auto& recipient : recipients) {
+            send(*snapshot, recipient, packetPool_, transceiver_);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& recipient : recipients) {
+            jobs_.push_back(Job{snapshot, recipient});
+        }
+    }
+    wakeCondition_.notify_all();
+}
+
+void SnapshotEncoder::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCondition_.wait(lock, [this] { return jobs_.empty() && busyCount_ == 0; });
+}
+
+unsigned int SnapshotEncoder::getThreadCount() const {
+    return static_cast<unsigned int>(threads_.size());
+}
+
+void SnapshotEncoder::encode(const WorldSnapshot& snapshot, uint32_t part, const StateRecipient& recipient, Packet* packet) {
+    const auto& objects = *snapshot.parts[part];
+    createStatePacket(packet, recipient.endpoint);
+    packet->write(recipient.latestInputTick);
+    packet->write(recipient.timeScale);
+    packet->write(toProtocolTime(snapshot.time));
+    packet->write(static_cast<uint8_t>(part));
+    packet->write(static_cast<uint8_t>(snapshot.parts.size()));
+    packet->write(objects.objectCount);
+    packet->write(objects.objects.getData(), objects.objects.getSize());
+}
+
+void SnapshotEncoder::send(const WorldSnapshot& snapshot, const StateRecipient& recipient, PacketSink& packetPool, Transceiver& transceiver) {
+    for (uint32_t part = 0; part < snapshot.parts.size(); part++) {
+        auto packet = packetPool.pop();
+        if (packet) {
+            encode(snapshot, part, recipient, packet);
+            transceiver.sendTo(packet);
+        } else {
+            WARN("Failed send STATE update to a client: empty packet pool.");
+            return;
+        }
+    }
+}
+
+void SnapshotEncoder::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wakeCondition_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+            return;
+        }
+        const auto job = std::move(jobs_.front());
+        jobs_.pop_front();
+        busyCount_++;
+
+        lock.unlock();
+        send(*job.snapshot, job.recipient, packetPool_, transceiver_);
+        lock.lock();
+
+        busyCount_--;
+        if (jobs_.empty() && busyCount_ == 0) {
+            idleCondition_.notify_all();
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#ifndef _SnapshotEncoder_H
+#define _SnapshotEncoder_H
+
+#include "Packet.h"
+
+#include <boost/asio.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PacketSink;
+class Transceiver;
+
+/** The encoded game objects of one STATE update. It is written once by the
+    simulation thread and only read afterwards, so any number of threads may
+    build STATE packets from it at the same time.
+
+    The objects are split into parts that each fit into one STATE packet, so
+    a world of any size goes out as several packets instead of overflowing
+    one. A snapshot always has at least one part, even without objects.
+ */
+struct WorldSnapshot {
+    /** The number of bytes of objects that fit into a STATE packet behind its header.
+     */
+    static const uint32_t PartCapacity;
+
+    /** The objects that go out in one STATE packet.
+     */
+    struct Part {
+        Part();
+
+        uint32_t objectCount;
+        Packet objects;
+    };
+
+    WorldSnapshot();
+
+    WorldSnapshot(const WorldSnapshot&) = delete;
+
+    WorldSnapshot& operator =(const WorldSnapshot&) = delete;
+
+    /** Appends an encoded object, and starts a new part if the last one is full.
+
+        \param object the object ID, the class ID and the state of the object.
+        \return false if the object is left out, because the snapshot has
+                PROTOCOL_MAX_STATE_PARTS full parts or the object alone does
+                not fit into a part.
+     */
+    bool addObject(const Packet& object);
+
+    /** Returns the number of objects in all parts.
+     */
+    uint32_t getObjectCount() const;
+
+    int64_t time;
+
+    std::vector<std::unique_ptr<Part>> parts;
+};
+
+/** The client specific part of a STATE packet.
+ */
+struct StateRecipient {
+    boost::asio::ip::udp::endpoint endpoint;
+
+    uint32_t latestInputTick;
+    float timeScale;
+};
+
+/** Builds and sends the STATE packets of published snapshots on a pool of threads.
+
+    publish() only queues one job per client and returns, so the simulation can
+    go on with the next tick while the packets are assembled and handed to the
+    transceiver. Without threads, publish() encodes and sends inline.
+ */
+class SnapshotEncoder {
+public:
+    /** Constructor
+
+        \param threadCount the number of encoder threads. 0 encodes on the publishing thread.
+        \param packetPool the pool to take the STATE packets from.
+        \param transceiver the transceiver to send the STATE packets with.
+     */
+    SnapshotEncoder(unsigned int threadCount, PacketSink& packetPool, Transceiver& transceiver);
+
+    /** Destructor. Sends all queued packets before it returns.
+     */
+    ~SnapshotEncoder();
+
+    SnapshotEncoder(const SnapshotEncoder&) = delete;
+
+    SnapshotEncoder& operator =(const SnapshotEncoder&) = delete;
+
+    /** Queues a STATE packet of a snapshot for each recipient.
+
+        \param snapshot the snapshot.
+        \param recipients the clients to send the snapshot to.
+     */
+    void publish(const std::shared_ptr<const WorldSnapshot>& snapshot, const std::vector<StateRecipient>& recipients);
+
+    /** Blocks until all published packets have been handed to the transceiver.
+     */
+    void flush();
+
+    /** Returns the number of encoder threads.
+     */
+    unsigned int getThreadCount() const;
+
+    /** Writes the STATE packet of a part of a snapshot for a recipient.
+
+        \param snapshot the snapshot.
+        \param part the index of the part.
+        \param recipient the recipient.
+        \param packet the packet to write to.
+     */
+    static void encode(const WorldSnapshot& snapshot, uint32_t part, const StateRecipient& recipient, Packet* packet);
+
+    /** Encodes all parts of a snapshot for a recipient and sends them.
+
+        \param snapshot the snapshot.
+        \param recipient the recipient.
+        \param packetPool the pool to take the STATE packets from.
+        \param transceiver the transceiver to send the STATE packets with.
+     */
+    static void send(const WorldSnapshot& snapshot, const StateRecipient& recipient, PacketSink& packetPool, Transceiver& transceiver);
+
+private:
+    struct Job {
+        std::shared_ptr<const WorldSnapshot> snapshot;
+        StateRecipient recipient;
+    };
+
+    void workerLoop();
+
+    PacketSink& packetPool_;
+    Transceiver& transceiver_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable idleCondition_;
+    std::deque<Job> jobs_;
+    unsigned int busyCount_;
+    bool stopping_;
+
+    std::vector<std::thread> threads_;
+};
+
+#endif  // _SnapshotEncoder_H
@@ -0,0 +1,114 @@
+#include "SnapshotTimeline.h"
+#include "Clock.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Weight of a new sample in the smoothed jitter, as in RFC 3550.
+static const float JITTER_GAIN = 1.0f / 16.0f;
+
+// Weight of a new sample in the smoothed update interval.
+static const float INTERVAL_GAIN = 1.0f / 8.0f;
+
+// The offset is the smallest transit time of this many recent snapshots, so
+// that it follows clock adjustments and route changes within a few seconds.
+static const uint32_t TRANSIT_WINDOW = 64;
+
+// The number of jitter deviations covered by the interpolation delay.
+static const float JITTER_MARGIN = 3.0f;
+
+static const float MAX_DELAY = 0.5f;
+
+// The delay changes at most this much per second, i.e. remote objects run at
+// most 10% faster or slower while it adapts.
+static const float DELAY_ADAPTION_RATE = 0.1f;
+
+SnapshotTimeline::SnapshotTimeline()
+: started_(false)
+, snapshotTime_(0)
+, lastTransit_(0)
+, transits_()
+, nextTransit_(0)
+, offset_(0)
+, interval_(0)
+, jitter_(0)
+, delay_(0)
+, lastUpdate_(0)
+, renderTime_(0) {
+}
+
+void SnapshotTimeline::addSnapshot(int64_t sourceTime, int64_t arrivalTime) {
+    const auto transit = arrivalTime - sourceTime;
+    if (transits_.size() < TRANSIT_WINDOW) {
+        transits_.push_back(transit);
+    } else {
+        transits_[nextTransit_] = transit;
+    }
+    nextTransit_ = (nextTransit_ + 1) % TRANSIT_WINDOW;
+    offset_ = *std::min_element(transits_.begin(), transits_.end());
+
+    if (!started_) {
+        started_ = true;
+        snapshotTime_ = sourceTime;
+        lastTransit_ = transit;
+        lastUpdate_ = arrivalTime;
+        renderTime_ = sourceTime;
+        return;
+    }
+
+    if (sourceTime > snapshotTime_) {
+        const auto interval = Clock::toSeconds(sourceTime - snapshotTime_);
+        if (interval_ > 0.0f) {
+            interval_ += (interval - interval_) * INTERVAL_GAIN;
+        } else {
+            interval_ = interval;
+            delay_ = std::min(interval_, MAX_DELAY);
+        }
+        snapshotTime_ = sourceTime;
+    }
+    jitter_ += (std::abs(Clock::toSeconds(transit - lastTransit_)) - jitter_) * JITTER_GAIN;
+    lastTransit_ = transit;
+}
+
+void SnapshotTimeline::shiftArrivalClock(int64_t shift) {
+    for (auto& transit : transits_) {
+        transit += shift;
+    }
+    lastTransit_ += shift;
+    offset_ += shift;
+    lastUpdate_ += shift;
+}
+
+void SnapshotTimeline::update(int64_t now) {
+    if (!started_) {
+        return;
+    }
+
+    const auto target = std::min(interval_ + JITTER_MARGIN * jitter_, MAX_DELAY);
+    const auto step = DELAY_ADAPTION_RATE * std::max(Clock::toSeconds(now - lastUpdate_), 0.0f);
+    delay_ += std::max(-step, std::min(target - delay_, step));
+    lastUpdate_ = now;
+
+    // The render time never goes backwards, even if the offset estimate jumps.
+    renderTime_ = std::max(renderTime_, now - offset_ - Clock::toNanoseconds(delay_));
+}
+
+int64_t SnapshotTimeline::getSnapshotTime() const {
+    return snapshotTime_;
+}
+
+int64_t SnapshotTimeline::getRenderTime() const {
+    return renderTime_;
+}
+
+float SnapshotTimeline::getDelay() const {
+    return delay_;
+}
+
+float SnapshotTimeline::getJitter() const {
+    return jitter_;
+}
+
+int64_t SnapshotTimeline::getTransitTime() const {
+    return offset_;
+}
@@ -0,0 +1,80 @@
+#ifndef _SnapshotTimeline_H
+#define _SnapshotTimeline_H
+
+#include <vector>
+#include <cstdint>
+
+/** Maps the time stamps of the STATE updates from one source to the local clock
+    and decides at which source time remote objects are rendered.
+
+    Arrival times may be given in the local clock or, once the clocks are
+    synchronized, already converted into the clock of the source. The smallest
+    transit time of recent snapshots absorbs the remaining clock difference, so
+    both work and the render time does not depend on it.
+
+    Remote objects are shown a little in the past, so that there is almost always
+    a newer snapshot to interpolate towards. The interpolation delay is one update
+    interval plus a margin for the measured arrival jitter. It adapts slowly, so
+    the render time never jumps.
+
+    Time stamps are in nanoseconds, delays and jitter in seconds.
+ */
+class SnapshotTimeline {
+public:
+    SnapshotTimeline();
+
+    /** Adds a received snapshot.
+
+        \param sourceTime the time stamp of the snapshot in the clock of its source.
+        \param arrivalTime the local time when the snapshot was received.
+     */
+    void addSnapshot(int64_t sourceTime, int64_t arrivalTime);
+
+    /** Moves the clock of the arrival times, e.g. after a new clock offset has
+        been estimated. Past arrival times are shifted along, so the render time
+        does not jump.
+     */
+    void shiftArrivalClock(int64_t shift);
+
+    /** Advances the render time. This method should be called once per frame.
+
+        \param now the current local time.
+     */
+    void update(int64_t now);
+
+    /** Returns the source time of the latest snapshot.
+     */
+    int64_t getSnapshotTime() const;
+
+    /** Returns the source time at which remote objects are rendered in this frame.
+     */
+    int64_t getRenderTime() const;
+
+    /** Returns the current interpolation delay in seconds.
+     */
+    float getDelay() const;
+
+    /** Returns the smoothed arrival jitter in seconds.
+     */
+    float getJitter() const;
+
+    /** Returns the smallest transit time of the recent snapshots. This is the
+        one-way delay if the arrival times are given in the clock of the source.
+     */
+    int64_t getTransitTime() const;
+
+private:
+    bool started_;
+    int64_t snapshotTime_;
+    int64_t lastTransit_;
+    std::vector<int64_t> transits_;
+    uint32_t nextTransit_;
+    int64_t offset_;
+    float interval_;
+    float jitter_;
+    float delay_;
+    int64_t lastUpdate_;
+    int64_t renderTime_;
+};
+
+#endif  // _SnapshotTimeline_H
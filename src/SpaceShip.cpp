@@ -4,87 +4,81 @@
 #include "Packet.h"
 #include "Protocol.h"
 
-SpaceShip::SpaceShip(const Renderer &renderer, const Vector2d& position)
-: playerId_(PROTOCOL_INVALID_PLAYER_ID)
-, sprite_("data/ship.png", renderer)
-, thrustOn_(false)
-, angle_(0)
-, position_(position)
-, velocity_(0, 0)
-, lookat_(0, -1)
-, acceleration_(0) {
-}
-
-SpaceShip::SpaceShip(const Renderer &renderer)
-: SpaceShip(renderer, Vector2d(0, 0)) {
-}
-
-void SpaceShip::update(float elapsed) {
-    angle_ *= 0.99f;
-    lookat_.rotate(angle_ * elapsed);
-    acceleration_ = thrustOn_ ? 50.0f : 0.0f;
-    velocity_ *= 0.99f;
-    if (velocity_.length() < 0.8f) {
-        velocity_.reset();
-    }
-    velocity_ += (elapsed * (acceleration_ * lookat_));
-    position_ += (elapsed * velocity_);
-}
-
-void SpaceShip::draw(Renderer &renderer) {
+SpaceShip::SpaceShip(const Renderer &renderer, Kinematics& kinematics, const Vector2d& position)
+: sprite_("data/ship.png", renderer)
+, kinematics_(kinematics)
+, body_(kinematics_.create(Kinematics::Kind::Ship, position)) {
+}
+
+SpaceShip::SpaceShip(const Renderer &renderer, Kinematics& kinematics)
+: SpaceShip(renderer, kinematics, Vector2d(0, 0)) {
+}
+
+SpaceShip::~SpaceShip() {
+    kinematics_.destroy(body_);
+}
+
+void SpaceShip::update(float) {
+}
+
+void SpaceShip::draw(Renderer &renderer, float alpha) {
+    const auto position = kinematics_.getPosition(body_, alpha);
+    const auto lookat = getLookAt();
     renderer.setDrawColor(1, 1, 1, 1);
-    renderer.drawLine(position_, position_ + (30 * lookat_));
+    renderer.drawLine(position, position + (30 * lookat));
 
     renderer.setDrawColor(1, 0, 0, 1);
-    renderer.drawLine(position_, position_ + velocity_);
+    renderer.drawLine(position, position + getVelocity());
 
     sprite_.draw(
-        static_cast<int>(position_.getX() - static_cast<float>(sprite_.getWidth()) / 2.0f),
-        static_cast<int>(position_.getY() - static_cast<float>(sprite_.getHeight()) / 2.0f),
-        -angle(Vector2d{0, -1}, lookat_),
+        static_cast<int>(position.getX() - static_cast<float>(sprite_.getWidth()) / 2.0f),
+        static_cast<int>(position.getY() - static_cast<float>(sprite_.getHeight()) / 2.0f),
+        -angle(Vector2d{0, -1}, lookat),
         renderer);
 }
 
 void SpaceShip::write(Packet* packet) {
-    packet->write(playerId_);
-    position_.write(packet);
-    velocity_.write(packet);
-    lookat_.write(packet);
-    packet->write(angle_);
-    packet->write(thrustOn_);
+    packet->write(getPlayerId());
+    getPosition().write(packet);
+    getVelocity().write(packet);
+    getLookAt().write(packet);
+    packet->write(kinematics_.getAngle(body_));
+    packet->write(kinematics_.getThrust(body_));
 }
 
 void SpaceShip::read(Packet* packet) {
-    packet->read(playerId_);
-    position_.read(packet);
-    velocity_.read(packet);
-    lookat_.read(packet);
-    packet->read(angle_);
-    packet->read(thrustOn_);
+    Vector2d position, velocity, lookat;
+    uint32_t playerId = PROTOCOL_INVALID_PLAYER_ID;
+    float rotation = 0.0f;
+    bool thrustOn = false;
+    packet->read(playerId);
+    position.read(packet);
+    velocity.read(packet);
+    lookat.read(packet);
+    packet->read(rotation);
+    packet->read(thrustOn);
+    setPlayerId(playerId);
+    setPosition(position);
+    setVelocity(velocity);
+    setLookAt(lookat);
+    kinematics_.setAngle(body_, rotation);
+    kinematics_.setThrust(body_, thrustOn);
 }
 
 uint32_t SpaceShip::getClassId() const {
     return ClassId;
 }
 
-void SpaceShip::setPlayerId(uint32_t playerId) {
-    playerId_ = playerId;
-}
-
-uint32_t SpaceShip::getPlayerId() const {
-    return playerId_;
-}
-
 void SpaceShip::rotate(float angle) {
-    angle_ += angle;
+    kinematics_.setAngle(body_, kinematics_.getAngle(body_) + angle);
 }
 
 void SpaceShip::thrust(bool onOff) {
-    thrustOn_ = onOff;
+    kinematics_.setThrust(body_, onOff);
 }
 
-const Vector2d& SpaceShip::getPosition() const {
-    return position_;
+Vector2d SpaceShip::getPosition() const {
+    return kinematics_.getPosition(body_);
 }
 
 unsigned int SpaceShip::getWidth() const {
@@ -95,10 +89,42 @@ unsigned int SpaceShip::getHeight() const {
     return sprite_.getHeight();
 }
 
-const Vector2d& SpaceShip::getLookAt() const {
-    return lookat_;
+Vector2d SpaceShip::getLookAt() const {
+    return kinematics_.getLookAt(body_);
+}
+
+GameObjectPtr SpaceShip::createInstance(const Renderer& renderer, Kinematics& kinematics) {
+    return GameObjectPtr(new SpaceShip(renderer, kinematics));
+}
+
+void SpaceShip::integrate(float elapsed) {
+    kinematics_.integrate(body_, elapsed);
+}
+
+Vector2d SpaceShip::getVelocity() const {
+    return kinematics_.getVelocity(body_);
+}
+
+void SpaceShip::setPosition(const Vector2d& position) {
+    kinematics_.setPosition(body_, position);
+}
+
+void SpaceShip::setVelocity(const Vector2d& velocity) {
+    kinematics_.setVelocity(body_, velocity);
+}
+
+void SpaceShip::setLookAt(const Vector2d& lookat) {
+    kinematics_.setLookAt(body_, lookat);
+}
+
+BodyState SpaceShip::getBodyState() const {
+    return BodyState(getPosition(), getVelocity(), getLookAt(), kinematics_.getAngle(body_), kinematics_.getThrust(body_));
 }
 
-GameObjectPtr SpaceShip::createInstance(const Renderer& renderer) {
-    return GameObjectPtr(new SpaceShip(renderer));
+void SpaceShip::setBodyState(const BodyState& state) {
+    setPosition(state.position);
+    setVelocity(state.velocity);
+    setLookAt(state.lookAt);
+    kinematics_.setAngle(body_, state.angle);
+    kinematics_.setThrust(body_, state.thrust);
 }
@@ -4,21 +4,27 @@
 #include "GameObject.h"
 #include "Sprite.h"
 #include "Vector2d.h"
+#include "Kinematics.h"
+#include "BodyState.h"
 
 class Renderer;
 class Packet;
 
 class SpaceShip : public GameObject {
 public:
-    SpaceShip(const Renderer& renderer, const Vector2d& position);
+    SpaceShip(const Renderer& renderer, Kinematics& kinematics, const Vector2d& position);
 
-    explicit SpaceShip(const Renderer& renderer);
+    SpaceShip(const Renderer& renderer, Kinematics& kinematics);
 
-    virtual ~SpaceShip() = default;
+    SpaceShip(const SpaceShip&) = delete;
+
+    SpaceShip& operator =(const SpaceShip&) = delete;
+
+    virtual ~SpaceShip();
 
     virtual void update(float elapsed) override;
 
-    virtual void draw(Renderer& renderer) override;
+    virtual void draw(Renderer& renderer, float alpha) override;
 
     void write(Packet* packet) override;
 
@@ -26,41 +32,42 @@ public:
 
     uint32_t getClassId() const override;
 
-    void setPlayerId(uint32_t playerId);
-
-    uint32_t getPlayerId() const;
-
     void rotate(float angle);
 
     void thrust(bool onOff);
 
-    const Vector2d& getPosition() const override;
+    Vector2d getPosition() const override;
 
     unsigned int getWidth() const override;
 
     unsigned int getHeight() const override;
 
-    const Vector2d& getLookAt() const;
+    Vector2d getLookAt() const;
 
-    static GameObjectPtr createInstance(const Renderer& renderer);
+    static GameObjectPtr createInstance(const Renderer& renderer, Kinematics& kinematics);
 
     enum { ClassId = 1 };
 
 protected:
-    uint32_t playerId_;
+    void integrate(float elapsed);
 
-    Sprite sprite_;
+    Vector2d getVelocity() const;
 
-    bool thrustOn_;
+    void setPosition(const Vector2d& position);
 
-    float angle_;
+    void setVelocity(const Vector2d& velocity);
 
-    Vector2d position_;
-    Vector2d velocity_;
-    Vector2d lookat_;
-    float acceleration_;
-};
+    void setLookAt(const Vector2d& lookat);
 
-using SpaceShipPtr = std::shared_ptr<SpaceShip>;
+    BodyState getBodyState() const;
+
+    void setBodyState(const BodyState& state);
+
+    Sprite sprite_;
+
+    Kinematics& kinematics_;
+
+    const uint32_t body_;
+};
 
 #endif  // _SpaceShip_H
@@ -9,8 +9,6 @@ class Sprite {
 public:
     Sprite(const char *filename, const Renderer &renderer);
 
-    ~Sprite();
-
     Sprite(const Sprite&) = delete;
 
     Sprite& operator =(const Sprite&) = delete;
@@ -27,8 +25,6 @@ public:
     void draw(int x, int y, unsigned int width, unsigned int height, const double &angle, const Renderer &renderer) const;
 
 private:
-    void tidyup();
-
     SDL_Texture *texture_;
     unsigned int width_;
     unsigned int height_;
@@ -0,0 +1,91 @@
+#ifndef _SpscRing_H
+#define _SpscRing_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+/** A bounded lock-free ring buffer for exactly one producer and one consumer thread.
+
+    Unlike Queue, which is safe for any number of threads, the ring only needs one
+    release store per push and pop and never contends on a shared counter. The
+    producer and consumer indices live on separate cache lines.
+ */
+template <typename T>
+class SpscRing {
+public:
+    /** Constructor
+
+        \param capacity the minimum number of elements. It is rounded up to a power of two.
+     */
+    explicit SpscRing(uint32_t capacity)
+    : mask_(roundUp(capacity) - 1)
+    , elements_(new T [mask_ + 1])
+    , head_(0)
+    , tail_(0) {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+
+    SpscRing& operator =(const SpscRing&) = delete;
+
+    /** Appends an element. Must only be called by the producer thread.
+
+        \param element the element to append.
+        \return true on success, false if the ring is full.
+     */
+    bool push(const T& element) {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) > mask_) {
+            return false;
+        }
+        elements_[tail & mask_] = element;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Removes the oldest element. Must only be called by the consumer thread.
+
+        \param element receives the element.
+        \return true on success, false if the ring is empty.
+     */
+    bool pop(T& element) {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        element = elements_[head & mask_];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Returns the capacity of the ring.
+     */
+    uint32_t getCapacity() const {
+        return mask_ + 1;
+    }
+
+    /** Returns the number of elements. The result is only a snapshot when called
+        while the other thread is active.
+     */
+    uint32_t getCount() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    static uint32_t roundUp(uint32_t capacity) {
+        uint32_t result = 1;
+        while (result < capacity) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const uint32_t mask_;
+    std::unique_ptr<T[]> elements_;
+
+    alignas(64) std::atomic<uint32_t> head_;
+    alignas(64) std::atomic<uint32_t> tail_;
+};
+
+#endif  // _SpscRing_H
@@ -0,0 +1,134 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+
+TaskScheduler::WorkQueue::WorkQueue()
+: mutex()
+, tasks() {
+}
+
+TaskScheduler::TaskScheduler(unsigned int threadCount)
+: threadCount_(std::max(1u, threadCount != 0 ? threadCount : std::thread::hardware_concurrency()))
+, queues_()
+, workers_()
+, queuedTasks_(0)
+, wakeMutex_()
+, wakeCondition_()
+, stopping_(false) {
+    for (unsigned int i = 0; i < threadCount_; i++) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    // Queue 0 belongs to the calling threads, the workers own the others.
+    for (unsigned int i = 1; i < threadCount_; i++) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+unsigned int TaskScheduler::getThreadCount() const {
+    return threadCount_;
+}
+
+void TaskScheduler::run(uint32_t count, uint32_t grainSize, RangeFunction function, const void* context) {
+    if (count == 0) {
+        return;
+    }
+    grainSize = std::max(1u, grainSize);
+    const auto taskCount = (count + grainSize - 1) / grainSize;
+    if (threadCount_ == 1 || taskCount == 1) {
+        for (uint32_t begin = 0; begin < count; begin += grainSize) {
+            function(context, begin, std::min(count, begin + grainSize));
+        }
+        return;
+    }
+
+    Job job;
+    job.function = function;
+    job.context = context;
+    job.remaining = taskCount;
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        queuedTasks_ += taskCount;
+    }
+
+    // Deal out contiguous runs of chunks so that each thread starts on its own
+    // part of the range.
+    for (unsigned int q = 0; q < threadCount_; q++) {
+        const auto first = static_cast<uint32_t>(static_cast<uint64_t>(taskCount) * q / threadCount_);
+        const auto last = static_cast<uint32_t>(static_cast<uint64_t>(taskCount) * (q + 1) / threadCount_);
+        if (first == last) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        for (auto t = last; t > first; t--) {
+            const auto begin = (t - 1) * grainSize;
+            queues_[q]->tasks.push_back(Task{&job, begin, std::min(count, begin + grainSize)});
+        }
+    }
+    wakeCondition_.notify_all();
+
+    while (job.remaining.load(std::memory_order_acquire) != 0) {
+        if (!runOneTask(0)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::workerLoop(unsigned int index) {
+    while (true) {
+        if (runOneTask(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCondition_.wait(lock, [this] { return stopping_ || queuedTasks_.load() != 0; });
+        if (stopping_) {
+            return;
+        }
+    }
+}
+
+bool TaskScheduler::runOneTask(unsigned int index) {
+    Task task{nullptr, 0, 0};
+    if (!popTask(index, task) && !stealTask(index, task)) {
+        return false;
+    }
+    queuedTasks_--;
+    task.job->function(task.job->context, task.begin, task.end);
+    task.job->remaining.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+bool TaskScheduler::popTask(unsigned int index, Task& task) {
+    auto& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool TaskScheduler::stealTask(unsigned int index, Task& task) {
+    for (unsigned int i = 1; i < threadCount_; i++) {
+        auto& queue = *queues_[(index + i) % threadCount_];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
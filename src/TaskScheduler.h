@@ -0,0 +1,106 @@
+#ifndef _TaskScheduler_H
+#define _TaskScheduler_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+/** A small work-stealing scheduler for data-parallel loops.
+
+    parallelFor() splits an index range into chunks and deals them out to one
+    queue per thread. Each thread works through its own queue from the back and
+    steals from the front of the other queues when it runs dry. The calling
+    thread takes part in the work and returns once all chunks of its loop are
+    done, so a scheduler with a single thread runs all chunks inline.
+
+    Loop bodies must not throw. Several threads may call parallelFor() at once;
+    a waiting caller helps with whatever work is queued.
+ */
+class TaskScheduler {
+public:
+    /** Constructor
+
+        \param threadCount the total number of threads including the calling
+               thread. 0 selects the number of hardware threads.
+     */
+    explicit TaskScheduler(unsigned int threadCount);
+
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+
+    TaskScheduler& operator =(const TaskScheduler&) = delete;
+
+    /** Returns the total number of threads including the calling thread.
+     */
+    unsigned int getThreadCount() const;
+
+    /** Calls fun(begin, end) for consecutive sub-ranges of [0, count) in parallel.
+
+        \param count the size of the index range.
+        \param grainSize the maximum size of a sub-range.
+        \param fun the loop body.
+     */
+    template<typename Fun>
+    void parallelFor(uint32_t count, uint32_t grainSize, const Fun& fun) {
+        run(count, grainSize, &invoke<Fun>, &fun);
+    }
+
+private:
+    using RangeFunction = void (*)(const void* context, uint32_t begin, uint32_t end);
+
+    struct Job {
+        RangeFunction function;
+        const void* context;
+        std::atomic<uint32_t> remaining;
+    };
+
+    struct Task {
+        Job* job;
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    struct WorkQueue {
+        WorkQueue();
+
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    template<typename Fun>
+    static void invoke(const void* context, uint32_t begin, uint32_t end) {
+        (*static_cast<const Fun*>(context))(begin, end);
+    }
+
+    void run(uint32_t count, uint32_t grainSize, RangeFunction function, const void* context);
+
+    void workerLoop(unsigned int index);
+
+    bool runOneTask(unsigned int index);
+
+    bool popTask(unsigned int index, Task& task);
+
+    bool stealTask(unsigned int index, Task& task);
+
+    const unsigned int threadCount_;
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+
+    std::vector<std::thread> workers_;
+
+    std::atomic<uint32_t> queuedTasks_;
+
+    std::mutex wakeMutex_;
+
+    std::condition_variable wakeCondition_;
+
+    bool stopping_;
+};
+
+#endif  // _TaskScheduler_H
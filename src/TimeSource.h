@@ -0,0 +1,18 @@
+#ifndef _TimeSource_H
+#define _TimeSource_H
+
+#include <chrono>
+
+/** A source of time for a Clock. Tests hand a Clock a VirtualClock to run
+    the game faster than real time.
+ */
+class TimeSource {
+public:
+    virtual ~TimeSource() = default;
+
+    /** Returns the current time as a time point of the steady clock.
+     */
+    virtual std::chrono::steady_clock::time_point now() const = 0;
+};
+
+#endif  // _TimeSource_H
@@ -0,0 +1,87 @@
+#include "TimingWheel.h"
+
+#include <algorithm>
+
+const int64_t TimingWheel::NoRelease;
+const uint32_t TimingWheel::InvalidIndex;
+
+TimingWheel::TimingWheel(int64_t resolution, uint32_t slotCount, uint32_t capacity, int64_t startTime)
+: resolution_(std::max(resolution, int64_t(1)))
+, nodes_(std::max(capacity, 1u))
+, slots_(std::max(slotCount, 1u))
+, freeNode_(0)
+, count_(0)
+, currentTick_(startTime / resolution_) {
+    for (uint32_t i = 0; i + 1 < nodes_.size(); i++) {
+        nodes_[i].next = i + 1;
+    }
+}
+
+bool TimingWheel::schedule(Packet* packet, int64_t releaseTime) {
+    if (freeNode_ == InvalidIndex) {
+        return false;
+    }
+    const auto index = freeNode_;
+    auto& node = nodes_[index];
+    freeNode_ = node.next;
+    node.packet = packet;
+    node.releaseTime = releaseTime;
+    node.next = InvalidIndex;
+
+    // A late packet goes into the current slot, which the next advance visits.
+    auto& slot = getSlot(std::max(releaseTime / resolution_, currentTick_));
+    if (slot.tail == InvalidIndex) {
+        slot.head = index;
+    } else {
+        nodes_[slot.tail].next = index;
+    }
+    slot.tail = index;
+    count_++;
+    return true;
+}
+
+int64_t TimingWheel::getNextReleaseTime() const {
+    if (count_ == 0) {
+        return NoRelease;
+    }
+    const auto slotCount = static_cast<int64_t>(slots_.size());
+    for (auto t = currentTick_; t < currentTick_ + slotCount; t++) {
+        // Only the packets of this turn count; the others come round again.
+        const auto turnEnd = (t + 1) * resolution_;
+        auto earliest = NoRelease;
+        const auto& slot = slots_[static_cast<std::size_t>(t % slotCount)];
+        for (auto index = slot.head; index != InvalidIndex; index = nodes_[index].next) {
+            if (nodes_[index].releaseTime < turnEnd) {
+                earliest = std::min(earliest, nodes_[index].releaseTime);
+            }
+        }
+        if (earliest != NoRelease) {
+            return earliest;
+        }
+    }
+    return (currentTick_ + slotCount) * resolution_;
+}
+
+uint32_t TimingWheel::getCount() const {
+    return count_;
+}
+
+TimingWheel::Slot& TimingWheel::getSlot(int64_t tick) {
+    return slots_[static_cast<std::size_t>(tick % static_cast<int64_t>(slots_.size()))];
+}
+
+void TimingWheel::unlink(Slot& slot, uint32_t previous, uint32_t index) {
+    auto& node = nodes_[index];
+    if (previous == InvalidIndex) {
+        slot.head = node.next;
+    } else {
+        nodes_[previous].next = node.next;
+    }
+    if (slot.tail == index) {
+        slot.tail = previous;
+    }
+    node.packet = nullptr;
+    node.next = freeNode_;
+    freeNode_ = index;
+    count_--;
+}
@@ -0,0 +1,122 @@
+#ifndef _TimingWheel_H
+#define _TimingWheel_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class Packet;
+
+/** Holds packets until their release time, with constant cost per packet.
+
+    The wheel is a ring of slots of a fixed time resolution. A packet goes into
+    the slot of its release time, and advancing the wheel visits only the slots
+    that have passed since the last call. A packet further away than one turn of
+    the wheel stays in its slot for the turns in between. All nodes are
+    allocated up front, so scheduling never allocates. The wheel is not thread
+    safe.
+ */
+class TimingWheel {
+public:
+    static const int64_t NoRelease = std::numeric_limits<int64_t>::max();
+
+    /** Constructor
+
+        \param resolution the duration of a slot in nanoseconds.
+        \param slotCount the number of slots.
+        \param capacity the maximum number of packets held at the same time.
+        \param startTime the current time in nanoseconds.
+     */
+    TimingWheel(int64_t resolution, uint32_t slotCount, uint32_t capacity, int64_t startTime);
+
+    /** Schedules a packet for release. A release time in the past releases it
+        with the next call to advance.
+
+        \return false if the wheel is full.
+     */
+    bool schedule(Packet* packet, int64_t releaseTime);
+
+    /** Releases the packets that are due, slot by slot, and in the order in
+        which they were scheduled within a slot.
+
+        \param now the current time in nanoseconds.
+        \param fun is called with each released packet.
+     */
+    template<typename Fun>
+    void advance(int64_t now, Fun&& fun) {
+        const auto tick = now / resolution_;
+        // Beyond one turn every slot has passed, and each is visited once.
+        const auto last = std::min(tick, currentTick_ + static_cast<int64_t>(slots_.size()) - 1);
+        for (auto t = currentTick_; t <= last && count_ > 0; t++) {
+            releaseSlot(getSlot(t), now, fun);
+        }
+        currentTick_ = std::max(tick, currentTick_);
+    }
+
+    /** Returns the earliest release time, an earlier time at which to look
+        again if it is more than a turn of the wheel away, or NoRelease if the
+        wheel is empty.
+     */
+    int64_t getNextReleaseTime() const;
+
+    uint32_t getCount() const;
+
+private:
+    static const uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        Node()
+        : packet(nullptr)
+        , releaseTime(0)
+        , next(InvalidIndex) {
+        }
+
+        Packet* packet;
+        int64_t releaseTime;
+        uint32_t next;
+    };
+
+    struct Slot {
+        Slot()
+        : head(InvalidIndex)
+        , tail(InvalidIndex) {
+        }
+
+        uint32_t head;
+        uint32_t tail;
+    };
+
+    Slot& getSlot(int64_t tick);
+
+    template<typename Fun>
+    void releaseSlot(Slot& slot, int64_t now, Fun& fun) {
+        auto previous = InvalidIndex;
+        auto index = slot.head;
+        while (index != InvalidIndex) {
+            auto& node = nodes_[index];
+            const auto next = node.next;
+            if (node.releaseTime <= now) {
+                auto packet = node.packet;
+                unlink(slot, previous, index);
+                fun(packet);
+            } else {
+                previous = index;
+            }
+            index = next;
+        }
+    }
+
+    void unlink(Slot& slot, uint32_t previous, uint32_t index);
+
+    const int64_t resolution_;
+
+    std::vector<Node> nodes_;
+    std::vector<Slot> slots_;
+
+    uint32_t freeNode_;
+    uint32_t count_;
+    int64_t currentTick_;
+};
+
+#endif  // _TimingWheel_H
@@ -1,48 +1,121 @@
 #include "Transceiver.h"
 #include "Packet.h"
 #include "PacketSink.h"
+#include "LatencyEmulator.h"
+#include "VirtualNetwork.h"
 #include "Logging.h"
 
+#include <sys/socket.h>
+#include <cerrno>
+#include <ctime>
+
+// The number of sent packets that can wait for the thread of the transceiver
+// without an allocation.
+static const uint32_t OUTGOING_QUEUE_SIZE = 4096;
+
 Transceiver::Transceiver(uint16_t port, PacketSink& packetSink)
+: Transceiver(port, packetSink, nullptr) {
+}
+
+Transceiver::Transceiver(PacketSink& packetSink)
+: Transceiver(0, packetSink, nullptr) {
+}
+
+Transceiver::Transceiver(uint16_t port, PacketSink& packetSink, VirtualNetwork* network)
 : packetSink_(packetSink)
+, sendEmulator_(nullptr)
+, network_(network)
+, virtualEndpoint_()
 , io_service_()
 , work_(io_service_)
-, socket_(io_service_, boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), port))
-, thread_([this] () { io_service_.run(); }) {
+, socket_(io_service_)
+, outgoing_(OUTGOING_QUEUE_SIZE)
+, sendPosted_(false)
+, thread_() {
+    if (network_) {
+        virtualEndpoint_ = network_->attach(port, packetSink_);
+        return;
+    }
+
+    socket_.open(boost::asio::ip::udp::v4());
+    socket_.bind(boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), port));
+#ifdef SO_TIMESTAMPNS
+    const int enable = 1;
+    if (setsockopt(socket_.native_handle(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) != 0) {
+        WARN("Failed to enable kernel receive time stamps, errno {0}.", errno);
+    }
+#endif
     auto packet = packetSink_.pop();
     assert(packet != nullptr);
     if (packet) {
         packet->clear();
         receiveFrom(packet);
     }
+    thread_ = std::thread([this] () { io_service_.run(); });
 }
 
-Transceiver::Transceiver(PacketSink& packetSink)
-: Transceiver(0, packetSink) {
+void Transceiver::sendTo(Packet* packet) {
+    if (sendEmulator_) {
+        sendEmulator_->send(packet);
+    } else {
+        transmit(packet);
+    }
 }
 
-void Transceiver::sendTo(Packet* packet) {
-    socket_.async_send_to(boost::asio::buffer(packet->getData(), packet->getSize()), packet->getEndpoint(),
-        [this, packet] (const boost::system::error_code &ec, std::size_t bytesTransferred) {
-            if (ec) {
-                ERROR("Failed to send a packet: {0}", ec.message());
-            } else {
-                assert(bytesTransferred == packet->getSize());
-            }
-            packetSink_.push(packet);
-        });
+void Transceiver::setSendEmulator(LatencyEmulator* emulator) {
+    if (sendEmulator_) {
+        sendEmulator_->setSender(nullptr);
+    }
+    sendEmulator_ = emulator && emulator->impairsOutbound() ? emulator : nullptr;
+    if (sendEmulator_) {
+        sendEmulator_->setSender([this] (Packet* packet) { transmit(packet); });
+    }
+}
+
+void Transceiver::transmit(Packet* packet) {
+    if (network_) {
+        network_->send(virtualEndpoint_, *packet);
+        packetSink_.push(packet);
+        return;
+    }
+    outgoing_.push(packet);
+    // One posted handler sends everything queued until it runs.
+    if (!sendPosted_.exchange(true)) {
+        io_service_.post([this] () { sendQueued(); });
+    }
+}
+
+void Transceiver::sendQueued() {
+    sendPosted_ = false;
+    while (auto packet = outgoing_.pop()) {
+        socket_.async_send_to(boost::asio::buffer(packet->getData(), packet->getSize()), packet->getEndpoint(),
+            [this, packet] (const boost::system::error_code &ec, std::size_t bytesTransferred) {
+                if (ec) {
+                    ERROR("Failed to send a packet: {0}", ec.message());
+                } else {
+                    assert(bytesTransferred == packet->getSize());
+                }
+                packetSink_.push(packet);
+            });
+    }
 }
 
 void Transceiver::receiveFrom(Packet* packet) {
-    socket_.async_receive_from(boost::asio::buffer(packet->getData(), packet->getCapacity()), packet->getEndpoint(),
-        [this, packet] (const boost::system::error_code &ec, std::size_t bytesReceived) {
+    // The socket is read with recvmsg once it is readable, because the receive
+    // time stamp comes as ancillary data that asio does not hand out.
+    socket_.async_wait(boost::asio::ip::udp::socket::wait_read,
+        [this, packet] (boost::system::error_code ec) {
+            if (!ec && !receiveNow(packet, ec)) {
+                // Somebody else has read the datagram.
+                receiveFrom(packet);
+                return;
+            }
             if (ec) {
                 ERROR("Failed to receive a packet: {0}", ec.message());
                 packetSink_.push(packet);
             } else {
                 auto newBuffer = packetSink_.pop();
                 if (newBuffer) {
-                    packet->setSize(static_cast<uint32_t>(bytesReceived));
                     packetSink_.enqueue(packet);
                     newBuffer->clear();
                     receiveFrom(newBuffer);
@@ -55,7 +128,59 @@ void Transceiver::receiveFrom(Packet* packet) {
         });
 }
 
+bool Transceiver::receiveNow(Packet* packet, boost::system::error_code& ec) {
+    auto& endpoint = packet->getEndpoint();
+    iovec data{packet->getData(), packet->getCapacity()};
+    char control[CMSG_SPACE(sizeof(timespec))];
+    msghdr message{};
+    message.msg_name = endpoint.data();
+    message.msg_namelen = static_cast<socklen_t>(endpoint.capacity());
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    const auto bytesReceived = recvmsg(socket_.native_handle(), &message, MSG_DONTWAIT);
+    const auto now = std::chrono::steady_clock::now();
+    if (bytesReceived < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+        }
+        ec = boost::system::error_code(errno, boost::system::system_category());
+        return true;
+    }
+    endpoint.resize(message.msg_namelen);
+    packet->setSize(static_cast<uint32_t>(bytesReceived));
+    packet->setReceiveTime(now);
+
+#ifdef SO_TIMESTAMPNS
+    for (auto header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_TIMESTAMPNS) {
+            // The kernel stamps with the real time clock, so the age of the
+            // packet is carried over to the steady clock.
+            timespec stamp{};
+            memcpy(&stamp, CMSG_DATA(header), sizeof(stamp));
+            const auto age = std::chrono::system_clock::now().time_since_epoch() - (std::chrono::seconds(stamp.tv_sec) + std::chrono::nanoseconds(stamp.tv_nsec));
+            if (age > std::chrono::system_clock::duration::zero()) {
+                packet->setReceiveTime(now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(age));
+            }
+        }
+    }
+#endif
+    return true;
+}
+
 Transceiver::~Transceiver() {
+    setSendEmulator(nullptr);
+    if (network_) {
+        network_->detach(virtualEndpoint_);
+    }
     io_service_.stop();
-    thread_.join();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    // The queue would delete the packets it still holds, but they belong to the pool.
+    while (auto packet = outgoing_.pop()) {
+        packetSink_.push(packet);
+    }
 }
@@ -1,30 +1,79 @@
 #ifndef _Transceiver_H
 #define _Transceiver_H
 
+#include "Queue.h"
+
 #include <boost/asio.hpp>
+
+#include <atomic>
 #include <thread>
 
 class Packet;
 class PacketSink;
+class LatencyEmulator;
+class VirtualNetwork;
+
+/** Sends and receives UDP packets on a thread of its own.
+
+    Received packets carry the time at which they arrived. Where the platform
+    supports it, this is the time stamp of the kernel, so that it excludes the
+    time the packet waited in the socket buffer and in the queues of the game.
 
+    Any number of threads may send at the same time. Their packets go through
+    a lock-free queue to the thread of the transceiver, which alone uses the
+    socket, because asio does not allow concurrent use of one socket object.
+
+    Attached to a VirtualNetwork instead, it opens no socket and starts no
+    thread; the network hands it the packets sent to its port.
+ */
 class Transceiver {
 public:
     Transceiver(uint16_t port, PacketSink& packetSink);
 
     explicit Transceiver(PacketSink& packetSink);
 
+    /** Constructor
+
+        \param port the port to receive on, 0 for any free port.
+        \param packetSink the sink of the received packets, which owns the pool.
+        \param network the virtual network to attach to, or nullptr for a UDP
+               socket. The network must outlive the transceiver.
+     */
+    Transceiver(uint16_t port, PacketSink& packetSink, VirtualNetwork* network);
+
     ~Transceiver();
 
+    Transceiver(const Transceiver&) = delete;
+
+    Transceiver& operator =(const Transceiver&) = delete;
+
     void sendTo(Packet* packet);
 
+    /** Routes sent packets through the outbound path of a latency emulator.
+        An emulator that does not impair outbound packets is left out, so that
+        sending takes no lock. The emulator must outlive the transceiver.
+     */
+    void setSendEmulator(LatencyEmulator* emulator);
+
 private:
+    void transmit(Packet* packet);
+
+    void sendQueued();
+
     void receiveFrom(Packet* packet);
 
+    bool receiveNow(Packet* packet, boost::system::error_code& ec);
+
     PacketSink& packetSink_;
+    LatencyEmulator* sendEmulator_;
+    VirtualNetwork* network_;
+    boost::asio::ip::udp::endpoint virtualEndpoint_;
 
     boost::asio::io_service io_service_;
     boost::asio::io_service::work work_;
     boost::asio::ip::udp::socket socket_;
+    Queue<Packet> outgoing_;
+    std::atomic<bool> sendPosted_;
     std::thread thread_;
 };
 
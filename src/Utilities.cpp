@@ -2,6 +2,11 @@
 
 #include <cstdlib>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 float randomValue(unsigned int max) {
     return static_cast<float>(std::rand() % static_cast<int>(max));
 }
@@ -9,3 +14,25 @@ float randomValue(unsigned int max) {
 float lerp(float a, float b, float t) {
     return a + t * (b - a);
 }
+
+bool pinThreadToCore(std::thread::native_handle_type thread, unsigned int core) {
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(core, &cpuSet);
+    return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuSet) == 0;
+#else
+    static_cast<void>(thread);
+    static_cast<void>(core);
+    return false;
+#endif
+}
+
+bool pinCurrentThreadToCore(unsigned int core) {
+#ifdef __linux__
+    return pinThreadToCore(pthread_self(), core);
+#else
+    static_cast<void>(core);
+    return false;
+#endif
+}
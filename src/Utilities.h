@@ -1,8 +1,25 @@
 #ifndef _Utilities_H
 #define _Utilities_H
 
+#include <thread>
+
 float randomValue(unsigned int max);
 
 float lerp(float a, float b, float t);
 
+/** Restricts a thread to a single CPU core. Only supported on Linux.
+
+    \param thread the native handle of the thread.
+    \param core the index of the core.
+    \return true on success, otherwise false.
+ */
+bool pinThreadToCore(std::thread::native_handle_type thread, unsigned int core);
+
+/** Restricts the calling thread to a single CPU core. Only supported on Linux.
+
+    \param core the index of the core.
+    \return true on success, otherwise false.
+ */
+bool pinCurrentThreadToCore(unsigned int core);
+
 #endif  // _Utilities_H
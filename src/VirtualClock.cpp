@@ -0,0 +1,23 @@
+#include "VirtualClock.h"
+
+#include <cassert>
+
+// The time of a new clock in nanoseconds.
+static const int64_t START_TIME = 1000000000;
+
+VirtualClock::VirtualClock()
+: time_(START_TIME) {
+}
+
+std::chrono::steady_clock::time_point VirtualClock::now() const {
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(time_.load())));
+}
+
+int64_t VirtualClock::getTime() const {
+    return time_.load();
+}
+
+void VirtualClock::advance(int64_t nanoseconds) {
+    assert(nanoseconds >= 0);
+    time_ += nanoseconds;
+}
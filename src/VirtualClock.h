@@ -0,0 +1,41 @@
+#ifndef _VirtualClock_H
+#define _VirtualClock_H
+
+#include "TimeSource.h"
+
+#include <atomic>
+#include <cstdint>
+
+/** A time source that only moves when it is told to.
+
+    Its time points start one second after the epoch of the steady clock,
+    because the epoch stands for an unknown time, e.g. in the receive time of
+    a packet.
+ */
+class VirtualClock : public TimeSource {
+public:
+    /** Constructor
+     */
+    VirtualClock();
+
+    VirtualClock(const VirtualClock&) = delete;
+
+    VirtualClock& operator =(const VirtualClock&) = delete;
+
+    std::chrono::steady_clock::time_point now() const override;
+
+    /** Returns the current time in nanoseconds since the epoch of the steady clock.
+     */
+    int64_t getTime() const;
+
+    /** Moves the time forward.
+
+        \param nanoseconds the duration to advance by, not negative.
+     */
+    void advance(int64_t nanoseconds);
+
+private:
+    std::atomic<int64_t> time_;
+};
+
+#endif  // _VirtualClock_H
@@ -0,0 +1,168 @@
+#include "VirtualNetwork.h"
+#include "VirtualClock.h"
+#include "PacketSink.h"
+#include "Packet.h"
+
+#include <boost/format.hpp>
+
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+
+using namespace boost::asio::ip;
+
+// The range of ports handed out to receivers that take any port.
+static const uint16_t FIRST_DYNAMIC_PORT = 49152;
+static const uint16_t LAST_DYNAMIC_PORT = 65535;
+
+// The capacity of the packets on their way, as that of the BufferedQueue.
+static const uint32_t PACKET_CAPACITY = 1500;
+
+VirtualNetwork::Statistics::Statistics()
+: sentPackets(0)
+, deliveredPackets(0)
+, lostPackets(0)
+, discardedPackets(0) {
+}
+
+VirtualNetwork::InFlight::InFlight(int64_t deliveryTime, uint64_t inFlightSequence, uint16_t destination, Packet* inFlightPacket)
+: time(deliveryTime)
+, sequence(inFlightSequence)
+, to(destination)
+, packet(inFlightPacket) {
+}
+
+bool VirtualNetwork::InFlight::operator >(const InFlight& other) const {
+    // Packets that arrive at the same time keep the order in which they were sent.
+    return time > other.time || (time == other.time && sequence > other.sequence);
+}
+
+VirtualNetwork::VirtualNetwork(const VirtualClock& clock, uint64_t seed)
+: clock_(clock)
+, seed_(seed)
+, mutex_()
+, receivers_()
+, nextPort_(FIRST_DYNAMIC_PORT)
+, defaultLink_()
+, linkImpairments_()
+, links_()
+, inFlight_()
+, sequence_(0)
+, packets_()
+, freePackets_()
+, statistics_() {
+}
+
+udp::endpoint VirtualNetwork::attach(uint16_t port, PacketSink& packetSink) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (port == 0) {
+        for (uint32_t i = FIRST_DYNAMIC_PORT; i <= LAST_DYNAMIC_PORT && port == 0; i++) {
+            if (receivers_.find(nextPort_) == receivers_.end()) {
+                port = nextPort_;
+            }
+            nextPort_ = nextPort_ == LAST_DYNAMIC_PORT ? FIRST_DYNAMIC_PORT : static_cast<uint16_t>(nextPort_ + 1);
+        }
+        if (port == 0) {
+            throw std::runtime_error("No virtual port is free.");
+        }
+    } else if (receivers_.find(port) != receivers_.end()) {
+        throw std::runtime_error(boost::str(boost::format("Virtual port %1% is taken.") % port));
+    }
+    receivers_[port] = &packetSink;
+    return udp::endpoint(address_v4::loopback(), port);
+}
+
+void VirtualNetwork::detach(const udp::endpoint& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    receivers_.erase(endpoint.port());
+}
+
+void VirtualNetwork::setDefaultLink(const Impairment& impairment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    defaultLink_ = impairment;
+}
+
+void VirtualNetwork::setLink(const udp::endpoint& from, const udp::endpoint& to, const Impairment& impairment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Link link(from.port(), to.port());
+    linkImpairments_[link] = impairment;
+    links_.erase(link);
+}
+
+void VirtualNetwork::send(const udp::endpoint& from, const Packet& packet) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    statistics_.sentPackets++;
+    const auto to = packet.getEndpoint().port();
+    int64_t deliveryTimes[ImpairmentModel::MaxCopies];
+    const auto count = getLink(from.port(), to).apply(clock_.getTime(), packet.getSize(), deliveryTimes);
+    if (count == 0) {
+        statistics_.lostPackets++;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        auto copy = allocate();
+        copy->copyDataFrom(packet);
+        copy->setEndpoint(udp::endpoint(address_v4::loopback(), from.port()));
+        inFlight_.emplace(deliveryTimes[i], sequence_++, to, copy);
+    }
+}
+
+uint32_t VirtualNetwork::deliver() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto now = clock_.getTime();
+    uint32_t count = 0;
+    while (!inFlight_.empty() && inFlight_.top().time <= now) {
+        const auto inFlight = inFlight_.top();
+        inFlight_.pop();
+        const auto receiver = receivers_.find(inFlight.to);
+        auto packet = receiver != receivers_.end() ? receiver->second->pop() : nullptr;
+        if (packet) {
+            packet->clear();
+            packet->copyDataFrom(*inFlight.packet);
+            packet->setEndpoint(inFlight.packet->getEndpoint());
+            packet->setReceiveTime(std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(inFlight.time))));
+            receiver->second->enqueue(packet);
+            statistics_.deliveredPackets++;
+            count++;
+        } else {
+            statistics_.discardedPackets++;
+        }
+        freePackets_.push_back(inFlight.packet);
+    }
+    return count;
+}
+
+int64_t VirtualNetwork::getNextDeliveryTime() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inFlight_.empty() ? std::numeric_limits<int64_t>::max() : inFlight_.top().time;
+}
+
+VirtualNetwork::Statistics VirtualNetwork::getStatistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return statistics_;
+}
+
+ImpairmentModel& VirtualNetwork::getLink(uint16_t from, uint16_t to) {
+    const Link link(from, to);
+    auto& model = links_[link];
+    if (!model) {
+        const auto itr = linkImpairments_.find(link);
+        auto impairment = itr != linkImpairments_.end() ? itr->second : defaultLink_;
+        if (impairment.seed == 0) {
+            // Every link draws other random numbers, which the seed of the network repeats.
+            impairment.seed = seed_ + ((static_cast<uint64_t>(from) << 16) | to);
+        }
+        model = std::make_unique<ImpairmentModel>(impairment);
+    }
+    return *model;
+}
+
+Packet* VirtualNetwork::allocate() {
+    if (freePackets_.empty()) {
+        packets_.push_back(std::make_unique<Packet>(PACKET_CAPACITY));
+        return packets_.back().get();
+    }
+    auto packet = freePackets_.back();
+    freePackets_.pop_back();
+    return packet;
+}
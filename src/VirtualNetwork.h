@@ -0,0 +1,134 @@
+#ifndef _VirtualNetwork_H
+#define _VirtualNetwork_H
+
+#include "Impairment.h"
+
+#include <boost/asio.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Packet;
+class PacketSink;
+class VirtualClock;
+
+/** Carries packets between transceivers in one process, on the time of a
+    virtual clock instead of over sockets.
+
+    Each attached transceiver gets a port on 127.0.0.1. Every directed link
+    between two ports has an impairment model of its own, so latency, loss
+    and the rest are emulated like by the LatencyEmulator. Packets are only
+    handed to their receivers by deliver(), which makes a test that advances
+    the clock, delivers and then updates its games fully deterministic, and
+    as fast as the games can simulate.
+ */
+class VirtualNetwork {
+public:
+    struct Statistics {
+        Statistics();
+
+        uint64_t sentPackets;
+        uint64_t deliveredPackets;
+        uint64_t lostPackets;
+        // Packets to a port without a receiver, or to one without a free packet.
+        uint64_t discardedPackets;
+    };
+
+    /** Constructor
+
+        \param clock the clock whose time the packets travel on. It must
+               outlive the network.
+        \param seed the seed of the random numbers of links whose impairment
+               does not bring its own.
+     */
+    VirtualNetwork(const VirtualClock& clock, uint64_t seed);
+
+    VirtualNetwork(const VirtualNetwork&) = delete;
+
+    VirtualNetwork& operator =(const VirtualNetwork&) = delete;
+
+    /** Attaches a receiver to a port.
+
+        \param port the port, or 0 for any free port.
+        \param packetSink the sink that the packets to the port are enqueued
+               to, taking them from its pool.
+        \return the endpoint of the receiver.
+        \throws std::runtime_error if the port is taken.
+     */
+    boost::asio::ip::udp::endpoint attach(uint16_t port, PacketSink& packetSink);
+
+    /** Detaches the receiver of an endpoint. Packets on their way to it are
+        discarded.
+     */
+    void detach(const boost::asio::ip::udp::endpoint& endpoint);
+
+    /** Sets the conditions of the links that have none of their own. Applies
+        to links that carry their first packet afterwards.
+     */
+    void setDefaultLink(const Impairment& impairment);
+
+    /** Sets the conditions of the link from one endpoint to another.
+     */
+    void setLink(const boost::asio::ip::udp::endpoint& from, const boost::asio::ip::udp::endpoint& to, const Impairment& impairment);
+
+    /** Sends a copy of a packet to its endpoint. The caller keeps the packet.
+
+        \param from the endpoint of the sender.
+        \param packet the packet.
+     */
+    void send(const boost::asio::ip::udp::endpoint& from, const Packet& packet);
+
+    /** Hands every packet that has arrived by the time of the clock to its receiver.
+
+        \return the number of delivered packets.
+     */
+    uint32_t deliver();
+
+    /** Returns the time at which the next packet arrives, in nanoseconds of
+        the clock, or INT64_MAX if none is on its way.
+     */
+    int64_t getNextDeliveryTime() const;
+
+    Statistics getStatistics() const;
+
+private:
+    typedef std::pair<uint16_t, uint16_t> Link;
+
+    struct InFlight {
+        InFlight(int64_t deliveryTime, uint64_t inFlightSequence, uint16_t destination, Packet* inFlightPacket);
+
+        bool operator >(const InFlight& other) const;
+
+        int64_t time;
+        uint64_t sequence;
+        uint16_t to;
+        Packet* packet;
+    };
+
+    ImpairmentModel& getLink(uint16_t from, uint16_t to);
+
+    Packet* allocate();
+
+    const VirtualClock& clock_;
+    const uint64_t seed_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint16_t, PacketSink*> receivers_;
+    uint16_t nextPort_;
+    Impairment defaultLink_;
+    std::map<Link, Impairment> linkImpairments_;
+    std::map<Link, std::unique_ptr<ImpairmentModel>> links_;
+    std::priority_queue<InFlight, std::vector<InFlight>, std::greater<InFlight>> inFlight_;
+    uint64_t sequence_;
+    std::vector<std::unique_ptr<Packet>> packets_;
+    std::vector<Packet*> freePackets_;
+    Statistics statistics_;
+};
+
+#endif  // _VirtualNetwork_H
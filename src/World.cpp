@@ -1,59 +1,59 @@
 #include "World.h"
 
 #include <cassert>
+#include <utility>
+
+static const uint32_t INTEGRATION_GRAIN_SIZE = 4096;
 
 World::World()
-: gameObjects_() {
+: taskScheduler_(nullptr)
+, kinematics_()
+, gameObjects_() {
 }
 
-void World::add(uint32_t objectId, GameObjectPtr& gameObject) {
-    assert(gameObjects_.find(objectId) == gameObjects_.end());
-    gameObjects_.insert(ObjectIdToGameObjectMap::value_type(objectId, gameObject));
+void World::add(uint32_t objectId, GameObjectPtr&& gameObject) {
+    assert(!gameObjects_.contains(objectId));
+    gameObjects_.insert(objectId, std::move(gameObject));
 }
 
 void World::remove(uint32_t objectId) {
-    const auto itr = gameObjects_.find(objectId);
-    if (itr != gameObjects_.end()) {
-        gameObjects_.erase(itr);
-    }
+    gameObjects_.erase(objectId);
 }
 
 GameObject* World::getGameObject(uint32_t objectId) {
-    auto itr = gameObjects_.find(objectId);
-    if (itr != gameObjects_.end()) {
-        return itr->second.get();
-    }
-    return nullptr;
+    const auto gameObject = gameObjects_.find(objectId);
+    return gameObject != nullptr ? gameObject->get() : nullptr;
 }
 
 uint32_t World::getGameObjectCount() const {
-    return static_cast<uint32_t>(gameObjects_.size());
+    return gameObjects_.size();
 }
 
-void World::update(float elapsed) {
-    for (auto& gameObject : gameObjects_) {
-        gameObject.second->update(elapsed);
-    }
+Kinematics& World::getKinematics() {
+    return kinematics_;
 }
 
-void World::draw(Renderer& renderer) {
-    for (auto& gameObject : gameObjects_) {
-        gameObject.second->draw(renderer);
-    }
+void World::setTaskScheduler(TaskScheduler* taskScheduler) {
+    taskScheduler_ = taskScheduler;
 }
 
-void World::forEachGameObject(std::function<void (uint32_t, GameObject*)> fun) {
-    for (auto& gameObject : gameObjects_) {
-        fun(gameObject.first, gameObject.second.get());
+void World::update(float elapsed) {
+    // Objects may spawn new objects while they are updated, so the count is
+    // re-read on every iteration and no reference into the map is held. This
+    // pass stays on the calling thread; the physics below runs in parallel.
+    for (uint32_t i = 0; i < gameObjects_.size(); i++) {
+        gameObjects_.valueAt(i)->update(elapsed);
+    }
+
+    for (const auto kind : { Kinematics::Kind::Ship, Kinematics::Kind::Bolt }) {
+        parallelFor(kinematics_.getCount(kind), INTEGRATION_GRAIN_SIZE, [this, kind, elapsed] (uint32_t begin, uint32_t end) {
+            kinematics_.integrate(kind, begin, end, elapsed);
+        });
     }
 }
 
-void World::removeGameObjectIf(std::function<bool (uint32_t, GameObject*)> predicate) {
-    for(auto itr = begin(gameObjects_); itr != end(gameObjects_);) {
-        if (predicate(itr->first, itr->second.get())) {
-            itr = gameObjects_.erase(itr);
-        } else {
-            ++itr;
-        }
+void World::draw(Renderer& renderer, float alpha) {
+    for (uint32_t i = 0; i < gameObjects_.size(); i++) {
+        gameObjects_.valueAt(i)->draw(renderer, alpha);
     }
 }
@@ -2,11 +2,9 @@
 #define _World_H
 
 #include "GameObject.h"
-
-#include <unordered_map>
-#include <functional>
-
-using ObjectIdToGameObjectMap = std::unordered_map<uint32_t, GameObjectPtr>;
+#include "Kinematics.h"
+#include "SlotMap.h"
+#include "TaskScheduler.h"
 
 class World {
 public:
@@ -14,7 +12,11 @@ public:
 
     virtual ~World() = default;
 
-    void add(uint32_t objectId, GameObjectPtr& gameObject);
+    World(const World&) = delete;
+
+    World& operator =(const World&) = delete;
+
+    void add(uint32_t objectId, GameObjectPtr&& gameObject);
 
     void remove(uint32_t objectId);
 
@@ -22,16 +24,58 @@ public:
 
     uint32_t getGameObjectCount() const;
 
+    Kinematics& getKinematics();
+
+    /** Sets the scheduler used to spread the simulation across threads. Without
+        a scheduler the world is simulated on the calling thread.
+     */
+    void setTaskScheduler(TaskScheduler* taskScheduler);
+
     virtual void update(float elapsed);
 
-    void draw(Renderer& renderer);
+    /** Draws all game objects.
+
+        \param renderer the renderer to draw with.
+        \param alpha how far the time has advanced from the last update towards the next one.
+     */
+    void draw(Renderer& renderer, float alpha);
 
-    void forEachGameObject(std::function<void (uint32_t, GameObject*)> fun);
+    /** Calls fun(objectId, gameObject) for each game object. Objects must not be added
+        or removed meanwhile.
+     */
+    template<typename Fun>
+    void forEachGameObject(Fun&& fun) {
+        gameObjects_.forEach([&fun] (uint32_t objectId, GameObjectPtr& gameObject) {
+            fun(objectId, gameObject.get());
+        });
+    }
 
-    void removeGameObjectIf(std::function<bool (uint32_t, GameObject*)> predicate);
+    /** Removes all game objects for which predicate(objectId, gameObject) returns true.
+     */
+    template<typename Predicate>
+    void removeGameObjectIf(Predicate&& predicate) {
+        gameObjects_.eraseIf([&predicate] (uint32_t objectId, GameObjectPtr& gameObject) {
+            return predicate(objectId, gameObject.get());
+        });
+    }
 
 protected:
-    ObjectIdToGameObjectMap gameObjects_;
+    /** Calls fun(begin, end) for sub-ranges of [0, count), in parallel if there is a scheduler.
+     */
+    template<typename Fun>
+    void parallelFor(uint32_t count, uint32_t grainSize, const Fun& fun) {
+        if (taskScheduler_ != nullptr) {
+            taskScheduler_->parallelFor(count, grainSize, fun);
+        } else if (count > 0) {
+            fun(0, count);
+        }
+    }
+
+    TaskScheduler* taskScheduler_;
+
+    Kinematics kinematics_;
+
+    SlotMap<GameObjectPtr> gameObjects_;
 };
 
 #endif  // _World_H
@@ -0,0 +1,128 @@
+#include "WorldHistory.h"
+#include "Utilities.h"
+
+#include <algorithm>
+
+// A fifth of the budget goes to the frame ring, the rest to the boxes.
+static const std::size_t FRAME_SHARE = 5;
+
+WorldHistory::WorldHistory(std::size_t memoryBudget)
+: frames_(std::max<std::size_t>(2, memoryBudget / FRAME_SHARE / sizeof(Frame)))
+, oldestFrame_(0)
+, frameCount_(0)
+, entries_(std::max<std::size_t>(1, (memoryBudget - memoryBudget / FRAME_SHARE) / sizeof(Entry)))
+, firstEntry_(0)
+, endEntry_(0) {
+}
+
+void WorldHistory::clear() {
+    oldestFrame_ = 0;
+    frameCount_ = 0;
+    firstEntry_ = endEntry_;
+}
+
+void WorldHistory::addFrame(int64_t time) {
+    if (frameCount_ == frames_.size()) {
+        dropOldestFrame();
+    }
+    const auto index = static_cast<uint32_t>((oldestFrame_ + frameCount_) % frames_.size());
+    frames_[index] = Frame{time, 0, endEntry_};
+    frameCount_++;
+}
+
+bool WorldHistory::add(uint32_t objectId, const Aabb& box) {
+    if (frameCount_ == 0) {
+        return false;
+    }
+    while (endEntry_ - firstEntry_ == entries_.size()) {
+        if (frameCount_ == 1) {
+            return false;
+        }
+        dropOldestFrame();
+    }
+    entries_[endEntry_ % entries_.size()] = Entry{objectId, box};
+    endEntry_++;
+    frames_[(oldestFrame_ + frameCount_ - 1) % frames_.size()].count++;
+    return true;
+}
+
+bool WorldHistory::find(uint32_t objectId, int64_t time, Aabb& box) const {
+    if (frameCount_ == 0) {
+        return false;
+    }
+
+    // The index of the first frame that is newer than time.
+    uint32_t low = 0, high = frameCount_;
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        if (getFrame(middle).time <= time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    if (low == 0) {
+        return findInFrame(getFrame(0), objectId, box);
+    }
+    const auto& before = getFrame(low - 1);
+    if (low == frameCount_) {
+        return findInFrame(before, objectId, box);
+    }
+    const auto& after = getFrame(low);
+
+    Aabb box0, box1;
+    const auto found0 = findInFrame(before, objectId, box0);
+    const auto found1 = findInFrame(after, objectId, box1);
+    if (found0 && found1) {
+        // Only the differences of the times become floats, so they keep their precision.
+        const auto t = static_cast<float>(time - before.time) / static_cast<float>(after.time - before.time);
+        box.minX = lerp(box0.minX, box1.minX, t);
+        box.minY = lerp(box0.minY, box1.minY, t);
+        box.maxX = lerp(box0.maxX, box1.maxX, t);
+        box.maxY = lerp(box0.maxY, box1.maxY, t);
+        return true;
+    }
+    box = found0 ? box0 : box1;
+    return found0 || found1;
+}
+
+uint32_t WorldHistory::getFrameCount() const {
+    return frameCount_;
+}
+
+int64_t WorldHistory::getOldestTime() const {
+    return frameCount_ > 0 ? getFrame(0).time : 0;
+}
+
+uint32_t WorldHistory::getBoxCapacity() const {
+    return static_cast<uint32_t>(entries_.size());
+}
+
+const WorldHistory::Frame& WorldHistory::getFrame(uint32_t index) const {
+    return frames_[(oldestFrame_ + index) % frames_.size()];
+}
+
+bool WorldHistory::findInFrame(const Frame& frame, uint32_t objectId, Aabb& box) const {
+    uint32_t low = 0, high = frame.count;
+    while (low < high) {
+        const auto middle = low + (high - low) / 2;
+        const auto& entry = entries_[(frame.first + middle) % entries_.size()];
+        if (entry.objectId < objectId) {
+            low = middle + 1;
+        } else if (entry.objectId > objectId) {
+            high = middle;
+        } else {
+            box = entry.box;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorldHistory::dropOldestFrame() {
+    const auto& oldest = frames_[oldestFrame_];
+    firstEntry_ = oldest.first + oldest.count;
+    oldestFrame_ = static_cast<uint32_t>((oldestFrame_ + 1) % frames_.size());
+    frameCount_--;
+}
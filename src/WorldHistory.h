@@ -0,0 +1,104 @@
+#ifndef _WorldHistory_H
+#define _WorldHistory_H
+
+#include "Aabb.h"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/** A ring buffer of the bounding boxes that game objects had in past frames.
+
+    Each frame stores the boxes of the recorded objects sorted by object ID. Frames
+    and boxes live in two fixed rings sized from a memory budget; when either ring
+    is full the oldest frames are dropped, so the history reaches back as far as
+    the budget allows.
+ */
+class WorldHistory {
+public:
+    /** Constructor
+
+        \param memoryBudget the number of bytes to use for frames and boxes.
+     */
+    explicit WorldHistory(std::size_t memoryBudget);
+
+    /** Removes all frames.
+     */
+    void clear();
+
+    /** Starts a new frame. Boxes added afterwards belong to it.
+
+        \param time the time of the frame in nanoseconds. It must not be smaller than the time of the previous frame.
+     */
+    void addFrame(int64_t time);
+
+    /** Adds the box of an object to the current frame. Objects must be added in
+        ascending order of their IDs.
+
+        \param objectId the ID of the object.
+        \param box the bounding box of the object.
+        \return false if the box did not fit into the budget, otherwise true.
+     */
+    bool add(uint32_t objectId, const Aabb& box);
+
+    /** Looks up the box of an object at a given time, interpolated between the two
+        frames around that time. Times outside the history are clamped to the
+        oldest or newest frame.
+
+        \param objectId the ID of the object.
+        \param time the time to rewind to in nanoseconds.
+        \param box receives the box.
+        \return true if the object was found, otherwise false.
+     */
+    bool find(uint32_t objectId, int64_t time, Aabb& box) const;
+
+    /** Returns the number of frames.
+     */
+    uint32_t getFrameCount() const;
+
+    /** Returns the time of the oldest frame in nanoseconds, or 0 if there are no frames.
+     */
+    int64_t getOldestTime() const;
+
+    /** Returns the maximum number of boxes.
+     */
+    uint32_t getBoxCapacity() const;
+
+private:
+    struct Frame {
+        int64_t time;
+        uint32_t count;
+        uint64_t first;
+    };
+
+    struct Entry {
+        Entry()
+        : objectId(0)
+        , box() {
+        }
+
+        Entry(uint32_t id, const Aabb& bounds)
+        : objectId(id)
+        , box(bounds) {
+        }
+
+        uint32_t objectId;
+        Aabb box;
+    };
+
+    const Frame& getFrame(uint32_t index) const;
+
+    bool findInFrame(const Frame& frame, uint32_t objectId, Aabb& box) const;
+
+    void dropOldestFrame();
+
+    std::vector<Frame> frames_;
+    uint32_t oldestFrame_;
+    uint32_t frameCount_;
+
+    std::vector<Entry> entries_;
+    uint64_t firstEntry_;
+    uint64_t endEntry_;
+};
+
+#endif  // _WorldHistory_H
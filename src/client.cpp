@@ -4,6 +4,7 @@
 #include "GameObjectRegistry.h"
 #include "Logging.h"
 #include "Sound.h"
+#include "Impairment.h"
 
 #include <boost/lexical_cast.hpp>
 
@@ -16,9 +17,11 @@ int main(int argc, char** argv) {
     unsigned short serverPort = 12345;
     unsigned int emulatedLatency = 0;
     unsigned int stdDevLatencyMean = 0;
+    Impairment inbound, outbound;
+    int core = -1;
 
     int c = 0;
-    while ((c = getopt(argc, argv, "s:p:l:d:h")) != -1) {
+    while ((c = getopt(argc, argv, "s:p:l:d:a:i:o:h")) != -1) {
         switch (c) {
         case 's':
             serverAddress = optarg;
@@ -32,6 +35,18 @@ int main(int argc, char** argv) {
         case 'd':
             stdDevLatencyMean = boost::lexical_cast<unsigned int>(optarg);
             break;
+        case 'i':
+        case 'o':
+            try {
+                (c == 'i' ? inbound : outbound) = parseImpairment(optarg);
+            } catch (const std::invalid_argument& ex) {
+                std::cerr << "Error: " << ex.what() << "\n";
+                return 1;
+            }
+            break;
+        case 'a':
+            core = boost::lexical_cast<int>(optarg);
+            break;
         case 'h':
             printHelp();
             return 0;
@@ -47,6 +62,11 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    if (emulatedLatency > 0 || stdDevLatencyMean > 0) {
+        inbound.latency = static_cast<float>(emulatedLatency) / 1000.0f;
+        inbound.jitter = static_cast<float>(stdDevLatencyMean) / 1000.0f;
+    }
+
     try {
         INIT_LOGGING(LOG_LEVEL_DEBUG);
 
@@ -66,7 +86,11 @@ int main(int argc, char** argv) {
         
         registerGameObjects();
 
-        GameClient gameClient(60, emulatedLatency, stdDevLatencyMean, serverAddress, serverPort, renderer);
+        GameClient gameClient(60, inbound, outbound, serverAddress, serverPort, renderer, nullptr);
+
+        if (core >= 0) {
+            gameClient.pinToCore(static_cast<unsigned int>(core));
+        }
 
         gameClient.run();
         
@@ -87,6 +111,12 @@ void printHelp() {
               << "  -p <port>     Pass the UDP <port> of the server. This parameter is optional. Default is port 12345.\n"
               << "  -l <latency>  Pass the emulated latency in milliseconds. This parameter is optional. Default is 0 ms.\n"
               << "  -d <stddev>   Pass the standard deviation of the latency in milliseconds. This parameter is optional. Default is 0 ms.\n"
+              << "  -i <settings> Pass the emulated conditions of received packets, e.g. latency=50,jitter=5,loss=0.01. -l and -d take precedence. This parameter is optional.\n"
+              << "                The settings are latency, jitter and reorder-delay in milliseconds, loss, burst-enter, burst-exit, burst-loss,\n"
+              << "                duplicate and reorder as probabilities, bandwidth in kbit/s, queue in bytes and the seed of the random numbers.\n"
+              << "                trace replays the delays and losses of a CSV or binary trace file, trace-speed=<factor> speeds it up and trace-loop=1 repeats it.\n"
+              << "  -o <settings> Pass the emulated conditions of sent packets, like -i. This parameter is optional.\n"
+              << "  -a <core>     Pin the game loop to <core>. This parameter is optional.\n"
               << "  -h            Display this information.\n"
               ;
 }
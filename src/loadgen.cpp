@@ -0,0 +1,107 @@
+#include "LoadGenerator.h"
+#include "Logging.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <atomic>
+#include <csignal>
+#include <iostream>
+
+void printHelp();
+
+static std::atomic<bool> running(true);
+
+static void stopRunning(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    std::string serverAddress = "127.0.0.1";
+    unsigned short serverPort = 12345;
+    unsigned int clientCount = 100;
+    std::vector<LoadGenerator::InputStep> inputScript;
+    float sessionTime = 0.0f;
+    float rampUpTime = 5.0f;
+    float duration = 0.0f;
+    unsigned int tickRate = 60;
+
+    int c = 0;
+    while ((c = getopt(argc, argv, "s:p:n:m:c:r:t:f:h")) != -1) {
+        switch (c) {
+        case 's':
+            serverAddress = optarg;
+            break;
+        case 'p':
+            serverPort = boost::lexical_cast<unsigned short>(optarg);
+            break;
+        case 'n':
+            clientCount = boost::lexical_cast<unsigned int>(optarg);
+            break;
+        case 'm':
+            try {
+                inputScript = LoadGenerator::parseInputPattern(optarg);
+            } catch (const std::invalid_argument& ex) {
+                std::cerr << "Error: " << ex.what() << "\n";
+                return 1;
+            }
+            break;
+        case 'c':
+            sessionTime = boost::lexical_cast<float>(optarg);
+            break;
+        case 'r':
+            rampUpTime = boost::lexical_cast<float>(optarg);
+            break;
+        case 't':
+            duration = boost::lexical_cast<float>(optarg);
+            break;
+        case 'f':
+            tickRate = std::max(1u, boost::lexical_cast<unsigned int>(optarg));
+            break;
+        case 'h':
+            printHelp();
+            return 0;
+        case '?':
+            return 1;
+        default:
+            abort ();
+        }
+    }
+
+    try {
+        INIT_LOGGING(LOG_LEVEL_INFO);
+
+        signal(SIGINT, stopRunning);
+        signal(SIGTERM, stopRunning);
+
+        using namespace boost::asio::ip;
+        LoadGenerator loadGenerator(udp::endpoint(address::from_string(serverAddress), serverPort), clientCount, inputScript, sessionTime, rampUpTime, tickRate);
+        loadGenerator.run(running, duration);
+
+        return 0;
+    } catch (const spdlog::spdlog_ex& ex) {
+        std::cerr << "spdlog exception: " << ex.what();
+    } catch (const std::exception &ex) {
+        ERROR("Exception: {0}", ex.what());
+    }
+
+    return 1;
+}
+
+void printHelp() {
+    std::cout << "Usage: loadgen [options]\n"
+              << "Simulates many clients without a window and reports what they observe of the server.\n"
+              << "Each client needs a file descriptor, so raise the limit with ulimit -n for thousands of clients.\n"
+              << "Options:\n"
+              << "  -s <address>  Pass the IP <address> of the server. This parameter is optional. Default is 127.0.0.1.\n"
+              << "  -p <port>     Pass the UDP <port> of the server. This parameter is optional. Default is port 12345.\n"
+              << "  -n <clients>  Pass the number of clients. This parameter is optional. Default is 100.\n"
+              << "  -m <pattern>  Pass the input of the clients: idle, steady, random or a script like ul:1,s:0.2,-:0.5 of keys\n"
+              << "                u, l, r and s for up, left, right and space, or - for none, and the seconds to hold them.\n"
+              << "                This parameter is optional. Default is random.\n"
+              << "  -c <seconds>  Pass the mean time a client stays before a new one replaces it. This parameter is optional. Default is 0 for clients that stay.\n"
+              << "  -r <seconds>  Pass the time over which the clients connect. This parameter is optional. Default is 5 s.\n"
+              << "  -t <seconds>  Pass the duration of the run. This parameter is optional. Default is 0 to run until interrupted.\n"
+              << "  -f <rate>     Pass the number of ticks per second of each client. This parameter is optional. Default is 60.\n"
+              << "  -h            Display this information.\n"
+              ;
+}
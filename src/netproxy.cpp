@@ -0,0 +1,90 @@
+#include "NetworkProxy.h"
+#include "Logging.h"
+#include "Impairment.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <atomic>
+#include <csignal>
+#include <iostream>
+
+void printHelp();
+
+static std::atomic<bool> running(true);
+
+static void stopRunning(int) {
+    running = false;
+}
+
+int main(int argc, char** argv) {
+    std::string serverAddress = "127.0.0.1";
+    unsigned short serverPort = 12345;
+    unsigned short proxyPort = 12346;
+    Impairment upstream, downstream;
+
+    int c = 0;
+    while ((c = getopt(argc, argv, "s:p:l:u:d:h")) != -1) {
+        switch (c) {
+        case 's':
+            serverAddress = optarg;
+            break;
+        case 'p':
+            serverPort = boost::lexical_cast<unsigned short>(optarg);
+            break;
+        case 'l':
+            proxyPort = boost::lexical_cast<unsigned short>(optarg);
+            break;
+        case 'u':
+        case 'd':
+            try {
+                (c == 'u' ? upstream : downstream) = parseImpairment(optarg);
+            } catch (const std::invalid_argument& ex) {
+                std::cerr << "Error: " << ex.what() << "\n";
+                return 1;
+            }
+            break;
+        case 'h':
+            printHelp();
+            return 0;
+        case '?':
+            return 1;
+        default:
+            abort ();
+        }
+    }
+
+    try {
+        INIT_LOGGING(LOG_LEVEL_INFO);
+
+        signal(SIGINT, stopRunning);
+        signal(SIGTERM, stopRunning);
+
+        using namespace boost::asio::ip;
+        NetworkProxy proxy(proxyPort, udp::endpoint(address::from_string(serverAddress), serverPort), upstream, downstream);
+        proxy.run(running);
+
+        return 0;
+    } catch (const spdlog::spdlog_ex& ex) {
+        std::cerr << "spdlog exception: " << ex.what();
+    } catch (const std::exception &ex) {
+        ERROR("Exception: {0}", ex.what());
+    }
+
+    return 1;
+}
+
+void printHelp() {
+    std::cout << "Usage: netproxy [options]\n"
+              << "Forwards the UDP packets of clients to a server and back over an emulated network. Each client gets a flow of its own.\n"
+              << "Options:\n"
+              << "  -s <address>  Pass the IP <address> of the server. This parameter is optional. Default is 127.0.0.1.\n"
+              << "  -p <port>     Pass the UDP <port> of the server. This parameter is optional. Default is port 12345.\n"
+              << "  -l <port>     Pass the UDP <port> the clients connect to. This parameter is optional. Default is port 12346.\n"
+              << "  -u <settings> Pass the emulated conditions of packets to the server, e.g. latency=50,jitter=5,loss=0.01. This parameter is optional.\n"
+              << "                The settings are latency, jitter and reorder-delay in milliseconds, loss, burst-enter, burst-exit, burst-loss,\n"
+              << "                duplicate and reorder as probabilities, bandwidth in kbit/s, queue in bytes and the seed of the random numbers.\n"
+              << "                trace replays the delays and losses of a CSV or binary trace file, trace-speed=<factor> speeds it up and trace-loop=1 repeats it.\n"
+              << "  -d <settings> Pass the emulated conditions of packets to the clients, like -u. This parameter is optional.\n"
+              << "  -h            Display this information.\n"
+              ;
+}
@@ -1,22 +1,41 @@
 #include "Window.h"
 #include "Renderer.h"
 #include "GameServer.h"
+#include "RoomManager.h"
 #include "Logging.h"
 #include "Sound.h"
+#include "Impairment.h"
 
 #include <boost/lexical_cast.hpp>
 
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
 
 void printHelp();
 
+static std::atomic<bool> running(true);
+
+static void stopRunning(int) {
+    running = false;
+}
+
 int main(int argc, char** argv) {
     unsigned short serverPort = 12345;
     unsigned int emulatedLatency = 0;
     unsigned int stdDevLatencyMean = 0;
+    Impairment inbound, outbound;
+    unsigned int threadCount = 0;
+    unsigned int encoderCount = 2;
+    unsigned int roomCount = 0;
+    unsigned int playersPerRoom = 8;
+    bool pinWorkers = false;
+    std::size_t historyBudget = 64 * 1024;
+    uint32_t seed = 0;
 
     int c = 0;
-    while ((c = getopt(argc, argv, "p:l:d:h")) != -1) {
+    while ((c = getopt(argc, argv, "p:l:d:t:e:k:r:n:ai:o:s:h")) != -1) {
         switch (c) {
         case 'p':
             serverPort = boost::lexical_cast<unsigned short>(optarg);
@@ -27,6 +46,36 @@ int main(int argc, char** argv) {
         case 'd':
             stdDevLatencyMean = boost::lexical_cast<unsigned int>(optarg);
             break;
+        case 'i':
+        case 'o':
+            try {
+                (c == 'i' ? inbound : outbound) = parseImpairment(optarg);
+            } catch (const std::invalid_argument& ex) {
+                std::cerr << "Error: " << ex.what() << "\n";
+                return 1;
+            }
+            break;
+        case 't':
+            threadCount = boost::lexical_cast<unsigned int>(optarg);
+            break;
+        case 'e':
+            encoderCount = boost::lexical_cast<unsigned int>(optarg);
+            break;
+        case 'k':
+            historyBudget = boost::lexical_cast<std::size_t>(optarg) * 1024;
+            break;
+        case 'r':
+            roomCount = boost::lexical_cast<unsigned int>(optarg);
+            break;
+        case 'n':
+            playersPerRoom = boost::lexical_cast<unsigned int>(optarg);
+            break;
+        case 's':
+            seed = boost::lexical_cast<uint32_t>(optarg);
+            break;
+        case 'a':
+            pinWorkers = true;
+            break;
         case 'h':
             printHelp();
             return 0;
@@ -37,9 +86,35 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (emulatedLatency > 0 || stdDevLatencyMean > 0) {
+        inbound.latency = static_cast<float>(emulatedLatency) / 1000.0f;
+        inbound.jitter = static_cast<float>(stdDevLatencyMean) / 1000.0f;
+    }
+
     try {
         INIT_LOGGING(LOG_LEVEL_DEBUG);
 
+        if (roomCount > 0) {
+            // Without a window there is nothing to play sounds on either.
+            setenv("SDL_AUDIODRIVER", "dummy", 0);
+            if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+                throw std::runtime_error(SDL_GetError());
+            }
+            atexit(SDL_Quit);
+
+            Sound::getInstance()->loadSound(0, "data/silence.wav");
+            Sound::getInstance()->loadSound(1, "data/silence.wav");
+
+            SET_LOG_LEVEL(LOG_LEVEL_INFO);
+            signal(SIGINT, stopRunning);
+            signal(SIGTERM, stopRunning);
+
+            RoomManager roomManager(640, 480, 60, 30, historyBudget, seed, roomCount, playersPerRoom, threadCount, pinWorkers, inbound, outbound, serverPort);
+            roomManager.run(running);
+
+            return 0;
+        }
+
         if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
             throw std::runtime_error(SDL_GetError());
         }
@@ -54,7 +129,10 @@ int main(int argc, char** argv) {
         
         Renderer renderer(window);
         
-        GameServer gameServer(window.getWidth(), window.getHeight(), 60, 30, emulatedLatency, stdDevLatencyMean, serverPort, renderer);
+        GameServer gameServer(window.getWidth(), window.getHeight(), 60, 30, inbound, outbound, serverPort, threadCount, encoderCount, historyBudget, seed, renderer, nullptr);
+        if (pinWorkers) {
+            gameServer.pinToCore(0);
+        }
 
         gameServer.run();
         
@@ -74,6 +152,18 @@ void printHelp() {
               << "  -p <port>     Pass the UDP <port> of the server. This parameter is optional. Default is port 12345.\n"
               << "  -l <latency>  Pass the emulated latency in milliseconds. This parameter is optional. Default is 0 ms.\n"
               << "  -d <stddev>   Pass the standard deviation of the latency in milliseconds. This parameter is optional. Default is 0 ms.\n"
+              << "  -i <settings> Pass the emulated conditions of received packets, e.g. latency=50,jitter=5,loss=0.01. -l and -d take precedence. This parameter is optional.\n"
+              << "                The settings are latency, jitter and reorder-delay in milliseconds, loss, burst-enter, burst-exit, burst-loss,\n"
+              << "                duplicate and reorder as probabilities, bandwidth in kbit/s, queue in bytes and the seed of the random numbers.\n"
+              << "                trace replays the delays and losses of a CSV or binary trace file, trace-speed=<factor> speeds it up and trace-loop=1 repeats it.\n"
+              << "  -o <settings> Pass the emulated conditions of sent packets, like -i. This parameter is optional.\n"
+              << "  -t <threads>  Pass the number of threads that simulate the world, or the number of worker threads with -r. This parameter is optional. Default is the number of hardware threads.\n"
+              << "  -e <threads>  Pass the number of threads that build STATE updates. This parameter is optional. Default is 2.\n"
+              << "  -k <KiB>      Pass the memory of the lag compensation history of each room in KiB, 0 to disable lag compensation. This parameter is optional. Default is 64 KiB.\n"
+              << "  -r <rooms>    Host <rooms> independent matches without a window. This parameter is optional.\n"
+              << "  -n <players>  Pass the number of players per room with -r. This parameter is optional. Default is 8.\n"
+              << "  -s <seed>     Pass the seed of the spawn positions, 0 for a random seed. With -r each room counts up from it. This parameter is optional. Default is 0.\n"
+              << "  -a            Pin each worker thread to its own core with -r, or the game loop to the first core without.\n"
               << "  -h            Display this information.\n"
               ;
 }
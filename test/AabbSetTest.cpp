@@ -0,0 +1,66 @@
+#include "AabbSet.h"
+
+#include <catch.hpp>
+
+#include <random>
+
+TEST_CASE("boxes without area never intersect", "[AabbSet]") {
+    const Aabb empty(10, 10, 0, 5);
+    const Aabb box(0, 0, 20, 20);
+    REQUIRE_FALSE(intersects(empty, box));
+    REQUIRE_FALSE(intersects(box, empty));
+    REQUIRE_FALSE(intersects(Aabb{}, Aabb{}));
+}
+
+TEST_CASE("touching boxes do not intersect", "[AabbSet]") {
+    const Aabb a(0, 0, 10, 10);
+    REQUIRE_FALSE(intersects(a, Aabb(10, 0, 10, 10)));
+    REQUIRE_FALSE(intersects(a, Aabb(0, 10, 10, 10)));
+    REQUIRE(intersects(a, Aabb(9, 9, 10, 10)));
+}
+
+TEST_CASE("an empty set has no overlaps", "[AabbSet]") {
+    AabbSet aabbSet;
+    std::vector<uint32_t> hits{1, 2, 3};
+    REQUIRE(aabbSet.getCount() == 0);
+    REQUIRE(aabbSet.findOverlaps(Aabb(0, 0, 10, 10), 0, hits) == 0);
+    REQUIRE(hits.empty());
+}
+
+TEST_CASE("findOverlaps only tests boxes starting at the given index", "[AabbSet]") {
+    AabbSet aabbSet;
+    for (int i = 0; i < 5; ++i) {
+        aabbSet.add(Aabb(0, 0, 10, 10));
+    }
+    std::vector<uint32_t> hits;
+    REQUIRE(aabbSet.findOverlaps(Aabb(5, 5, 10, 10), 3, hits) == 2);
+    REQUIRE(hits == std::vector<uint32_t>({3, 4}));
+}
+
+TEST_CASE("findOverlaps matches the scalar test for random boxes", "[AabbSet]") {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> position(0, 640);
+    std::uniform_int_distribution<int> size(0, 40);
+
+    for (uint32_t count : {1u, 3u, 7u, 8u, 15u, 16u, 17u, 33u, 257u}) {
+        AabbSet aabbSet;
+        std::vector<Aabb> boxes;
+        for (uint32_t i = 0; i < count; ++i) {
+            const Aabb box(position(generator), position(generator), size(generator), size(generator));
+            boxes.push_back(box);
+            aabbSet.add(box);
+        }
+
+        std::vector<uint32_t> hits;
+        for (uint32_t i = 0; i < count; ++i) {
+            std::vector<uint32_t> expected;
+            for (uint32_t j = i + 1; j < count; ++j) {
+                if (intersects(boxes[i], boxes[j])) {
+                    expected.push_back(j);
+                }
+            }
+            aabbSet.findOverlaps(aabbSet.get(i), i + 1, hits);
+            REQUIRE(hits == expected);
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include "ClientRegistry.h"
 #include "Protocol.h"
+#include "Clock.h"
 
 #include <catch.hpp>
 
@@ -21,7 +22,7 @@ TEST_CASE("registry is not empty after adding a session") {
 
     const uint32_t playerId = 123;
     const udp::endpoint endpoint(address::from_string("127.0.0.2"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     clientRegistry.addClientSession(playerId, endpoint, timeStamp);
 
@@ -41,13 +42,13 @@ TEST_CASE("loop over all session") {
 
     const uint32_t playerId = 123;
     const udp::endpoint endpoint(address::from_string("127.0.0.2"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
-    clientRegistry.addClientSession(123, udp::endpoint(address::from_string("127.0.0.1"), 32132), 1.0f);
-    clientRegistry.addClientSession(124, udp::endpoint(address::from_string("127.0.0.2"), 32132), 2.0f);
-    clientRegistry.addClientSession(125, udp::endpoint(address::from_string("127.0.0.3"), 32132), 3.0f);
-    clientRegistry.addClientSession(126, udp::endpoint(address::from_string("127.0.0.4"), 32132), 4.0f);
-    clientRegistry.addClientSession(127, udp::endpoint(address::from_string("127.0.0.5"), 32132), 5.0f);
+    clientRegistry.addClientSession(123, udp::endpoint(address::from_string("127.0.0.1"), 32132), 1000000000);
+    clientRegistry.addClientSession(124, udp::endpoint(address::from_string("127.0.0.2"), 32132), 2000000000);
+    clientRegistry.addClientSession(125, udp::endpoint(address::from_string("127.0.0.3"), 32132), 3000000000);
+    clientRegistry.addClientSession(126, udp::endpoint(address::from_string("127.0.0.4"), 32132), 4000000000);
+    clientRegistry.addClientSession(127, udp::endpoint(address::from_string("127.0.0.5"), 32132), 5000000000);
 
     unsigned int count = 0;
     clientRegistry.forEachClientSession([&count] (ClientSession*) {
@@ -62,7 +63,7 @@ TEST_CASE("add sessions to the registry") {
 
     const uint32_t playerId = 123;
     const udp::endpoint endpoint(address::from_string("127.0.0.2"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     const auto session = clientRegistry.addClientSession(playerId, endpoint, timeStamp);
 
@@ -82,7 +83,7 @@ TEST_CASE("get an existing sessions from the registry") {
 
     const uint32_t playerId = 123;
     const udp::endpoint endpoint(address::from_string("127.0.0.2"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     clientRegistry.addClientSession(playerId, endpoint, timeStamp);
 
@@ -98,7 +99,7 @@ TEST_CASE("remove an existing sessions from the registry") {
 
     const uint32_t playerId = 123;
     const udp::endpoint endpoint(address::from_string("127.0.0.2"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     clientRegistry.addClientSession(playerId, endpoint, timeStamp);
 
@@ -118,7 +119,7 @@ TEST_CASE("verify a session (match)") {
     const uint32_t playerId2 = 124;
     const udp::endpoint endpoint1(address::from_string("127.0.0.2"), 32132);
     const udp::endpoint endpoint2(address::from_string("127.0.0.3"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     clientRegistry.addClientSession(playerId1, endpoint1, timeStamp);
     clientRegistry.addClientSession(playerId2, endpoint2, timeStamp);
@@ -134,7 +135,7 @@ TEST_CASE("verify a session (non-match)") {
     const uint32_t playerId2 = 124;
     const udp::endpoint endpoint1(address::from_string("127.0.0.2"), 32132);
     const udp::endpoint endpoint2(address::from_string("127.0.0.3"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     clientRegistry.addClientSession(playerId1, endpoint1, timeStamp);
     clientRegistry.addClientSession(playerId2, endpoint2, timeStamp);
@@ -150,7 +151,7 @@ TEST_CASE("check for an existing session") {
     const uint32_t playerId2 = 124;
     const udp::endpoint endpoint1(address::from_string("127.0.0.2"), 32132);
     const udp::endpoint endpoint2(address::from_string("127.0.0.3"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     clientRegistry.addClientSession(playerId1, endpoint1, timeStamp);
     clientRegistry.addClientSession(playerId2, endpoint2, timeStamp);
@@ -168,7 +169,7 @@ TEST_CASE("check for an non-existing session") {
     const udp::endpoint endpoint2(address::from_string("127.0.0.3"), 32132);
     const udp::endpoint endpoint3(address::from_string("127.0.0.2"), 32133);
     const udp::endpoint endpoint4(address::from_string("127.0.0.4"), 32132);
-    const float timeStamp = 987.65f;
+    const int64_t timeStamp = 987650000000;
 
     clientRegistry.addClientSession(playerId1, endpoint1, timeStamp);
     clientRegistry.addClientSession(playerId2, endpoint2, timeStamp);
@@ -182,12 +183,12 @@ TEST_CASE("check for disconnects: in time") {
 
     const uint32_t playerId = 123;
     const udp::endpoint endpoint(address::from_string("127.0.0.2"), 32132);
-    const float timeStamp = 123.46f;
+    const int64_t timeStamp = 123460000000;
 
     clientRegistry.addClientSession(playerId, endpoint, timeStamp);
 
     bool noDisconnects = true;
-    clientRegistry.checkForDisconnects(timeStamp + PROTOCOL_CLIENT_TIMEOUT, [&noDisconnects] (uint32_t) {
+    clientRegistry.checkForDisconnects(timeStamp + Clock::toNanoseconds(PROTOCOL_CLIENT_TIMEOUT), [&noDisconnects] (uint32_t) {
         noDisconnects = false;
     });
 
@@ -199,14 +200,26 @@ TEST_CASE("check for disconnects: out of time") {
 
     const uint32_t playerId = 123;
     const udp::endpoint endpoint(address::from_string("127.0.0.2"), 32132);
-    const float timeStamp = 123.46f;
+    const int64_t timeStamp = 123460000000;
 
     clientRegistry.addClientSession(playerId, endpoint, timeStamp);
 
     uint32_t disconnectedClient = 0;
-    clientRegistry.checkForDisconnects(timeStamp + PROTOCOL_CLIENT_TIMEOUT + 1, [&disconnectedClient] (uint32_t pid) {
+    clientRegistry.checkForDisconnects(timeStamp + Clock::toNanoseconds(PROTOCOL_CLIENT_TIMEOUT) + 1, [&disconnectedClient] (uint32_t pid) {
         disconnectedClient = pid;
     });
 
     REQUIRE(disconnectedClient == playerId);
 }
+
+TEST_CASE("the session count follows adds and removals") {
+    ClientRegistry clientRegistry;
+    REQUIRE(clientRegistry.getClientSessionCount() == 0);
+
+    clientRegistry.addClientSession(1, udp::endpoint(address::from_string("127.0.0.2"), 32132), 0);
+    clientRegistry.addClientSession(2, udp::endpoint(address::from_string("127.0.0.3"), 32132), 0);
+    REQUIRE(clientRegistry.getClientSessionCount() == 2);
+
+    clientRegistry.removeClientSession(1);
+    REQUIRE(clientRegistry.getClientSessionCount() == 1);
+}
@@ -5,7 +5,7 @@
 TEST_CASE("ClientSession construction") {
     const boost::asio::ip::udp::endpoint endpoint;
     const uint32_t playerId = 12;
-    const float timeStamp = 34.56f;
+    const int64_t timeStamp = 34560000000;
 
     ClientSession clientSession(endpoint, playerId, timeStamp);
 
@@ -17,13 +17,13 @@ TEST_CASE("ClientSession construction") {
 TEST_CASE("update last seen") {
     const boost::asio::ip::udp::endpoint endpoint;
     const uint32_t playerId = 12;
-    const float timeStamp = 34.56f;
+    const int64_t timeStamp = 34560000000;
 
     ClientSession clientSession(endpoint, playerId, timeStamp);
 
     REQUIRE(clientSession.getLastSeen() == timeStamp);
 
-    const float lastSeen = 234.42f;
+    const int64_t lastSeen = 234420000000;
     clientSession.setLastSeen(lastSeen);
 
     REQUIRE(clientSession.getLastSeen() == lastSeen);
@@ -0,0 +1,62 @@
+#include "ClockSync.h"
+#include "Clock.h"
+
+#include <catch.hpp>
+
+namespace {
+
+int64_t seconds(double value) {
+    return Clock::toNanoseconds(value);
+}
+
+}
+
+TEST_CASE("an exchange over a symmetric path yields the exact offset", "[ClockSync]") {
+    ClockSync clockSync;
+    REQUIRE(!clockSync.isSynchronized());
+    REQUIRE(clockSync.toRemoteTime(seconds(5.0)) == seconds(5.0));
+
+    // The remote clock is 10 s ahead, each direction takes 50 ms and the remote
+    // end needs 5 ms to answer.
+    clockSync.addSample(seconds(1.0), seconds(11.05), seconds(11.055), seconds(1.105));
+    REQUIRE(clockSync.isSynchronized());
+    REQUIRE(clockSync.getOffset(seconds(1.105)) == seconds(10.0));
+    REQUIRE(clockSync.getRoundTripTime() == Approx(0.1f));
+    REQUIRE(clockSync.getSyncError() == Approx(0.05f));
+    REQUIRE(clockSync.toRemoteTime(seconds(2.0)) == seconds(12.0));
+    REQUIRE(clockSync.toLocalTime(seconds(12.0)) == seconds(2.0));
+}
+
+TEST_CASE("the sample with the smallest delay is trusted", "[ClockSync]") {
+    ClockSync clockSync;
+    clockSync.addSample(seconds(1.0), seconds(11.05), seconds(11.05), seconds(1.1));
+    // Queueing on the way back delays the answer by 200 ms.
+    clockSync.addSample(seconds(2.0), seconds(12.05), seconds(12.05), seconds(2.3));
+    REQUIRE(clockSync.getOffset(seconds(2.3)) == seconds(10.0));
+    REQUIRE(clockSync.getRoundTripTime() == Approx(0.1f));
+
+    // Impossible time stamps are ignored.
+    clockSync.addSample(seconds(3.0), seconds(13.05), seconds(13.2), seconds(3.1));
+    REQUIRE(clockSync.getRoundTripTime() == Approx(0.1f));
+}
+
+TEST_CASE("the drift of the remote clock is tracked", "[ClockSync]") {
+    ClockSync clockSync;
+    // The remote clock runs 100 ppm fast.
+    for (int i = 0; i < 40; i++) {
+        const auto local = static_cast<double>(i) * 3.0;
+        const auto remote = local * 1.0001;
+        clockSync.addSample(seconds(local), seconds(remote + 0.05), seconds(remote + 0.05), seconds(local + 0.1));
+    }
+    REQUIRE(clockSync.getDrift() == Approx(0.0001f).epsilon(0.05f));
+    REQUIRE(Clock::toSeconds(clockSync.getOffset(seconds(200.0))) == Approx(0.02f).epsilon(0.05f));
+}
+
+TEST_CASE("clocks that have run for weeks are synchronized to the microsecond", "[ClockSync]") {
+    ClockSync clockSync;
+    const auto local = seconds(40.0 * 24.0 * 3600.0);
+    const auto remote = seconds(90.0 * 24.0 * 3600.0) + 1234;
+    clockSync.addSample(local, remote + seconds(0.02), remote + seconds(0.021), local + seconds(0.041));
+    REQUIRE(clockSync.toRemoteTime(local) == remote);
+    REQUIRE(clockSync.getRoundTripTime() == Approx(0.04f));
+}
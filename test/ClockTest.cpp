@@ -1,4 +1,5 @@
 #include "Clock.h"
+#include "VirtualClock.h"
 
 #include <catch.hpp>
 
@@ -62,42 +63,107 @@ TEST_CASE("Game time is not implicitly updated") {
 
 TEST_CASE("Frame time is approximately zero after construction") {
     Clock clock;
-    REQUIRE(clock.getFrameTime() == Approx(0.0f).epsilon(0.000001f));
+    REQUIRE(clock.getFrameTime() < 0.01f);
 }
 
 TEST_CASE("Frame time is properly updated") {
     Clock clock;
- 
+
     std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    REQUIRE(clock.getFrameTime() == Approx(0.5f).epsilon(0.000001f));
+    REQUIRE(clock.getFrameTime() >= 0.5f);
+    REQUIRE(clock.getFrameTime() < 0.6f);
 
     clock.update();
-    REQUIRE(clock.getFrameTime() == Approx(0.0f).epsilon(0.000001f));
+    REQUIRE(clock.getFrameTime() < 0.01f);
 }
 
 TEST_CASE("Current time is zero after construction") {
     Clock clock;
-    REQUIRE(clock.getTime() == Approx(0.0f).epsilon(0.000001f));
+    REQUIRE(clock.getTime() < 0.01f);
 }
 
 TEST_CASE("Current time is updated implicitly") {
     Clock clock;
 
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    REQUIRE(clock.getTime() == Approx(0.1f).epsilon(0.000001f));
+    REQUIRE(clock.getTime() >= 0.1f);
+    REQUIRE(clock.getTime() < 0.2f);
 
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    REQUIRE(clock.getTime() == Approx(0.3f).epsilon(0.000001f));
+    REQUIRE(clock.getTime() >= 0.3f);
+    REQUIRE(clock.getTime() < 0.4f);
 }
 
 TEST_CASE("Current time is not affected by updates") {
     Clock clock;
 
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    REQUIRE(clock.getTime() == Approx(0.1f).epsilon(0.000001f));
+    REQUIRE(clock.getTime() >= 0.1f);
 
     clock.update();
 
     std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    REQUIRE(clock.getTime() == Approx(0.3f).epsilon(0.000001f));
+    REQUIRE(clock.getTime() >= 0.3f);
+    REQUIRE(clock.getTime() < 0.4f);
+}
+
+TEST_CASE("Frame start is cached until the next update") {
+    Clock clock;
+    REQUIRE(clock.getFrameStart() == 0);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    REQUIRE(clock.getFrameStart() == 0);
+    REQUIRE(clock.now() >= 10000000);
+
+    clock.update();
+    const auto frameStart = clock.getFrameStart();
+    REQUIRE(frameStart >= 10000000);
+    REQUIRE(clock.getElapsedNanoseconds() == frameStart);
+    REQUIRE(clock.now() >= frameStart);
+}
+
+TEST_CASE("Elapsed time has a sub-millisecond resolution") {
+    Clock clock;
+
+    std::this_thread::sleep_for(std::chrono::microseconds(1500));
+    clock.update();
+    REQUIRE(clock.getElapsed() >= 0.0015f);
+}
+
+TEST_CASE("Nanoseconds convert to seconds and back") {
+    REQUIRE(Clock::toNanoseconds(0.25) == 250000000);
+    REQUIRE(Clock::toNanoseconds(-1.5) == -1500000000);
+    REQUIRE(Clock::toSeconds(250000000) == 0.25f);
+
+    // A duration keeps its precision however late it is measured.
+    const int64_t late = Clock::toNanoseconds(30.0 * 24.0 * 3600.0);
+    REQUIRE(Clock::toSeconds((late + 1000) - late) == Approx(0.000001f));
+}
+
+TEST_CASE("Steady clock time points convert to nanoseconds of the clock") {
+    const auto before = std::chrono::steady_clock::now();
+    Clock clock;
+    const auto time = clock.toTime(before + std::chrono::milliseconds(20));
+    REQUIRE(time <= 20000000);
+    REQUIRE(time > 19000000);
+
+    // An unset time point is taken as the current time.
+    const auto now = clock.toTime(std::chrono::steady_clock::time_point());
+    REQUIRE(now >= 0);
+    REQUIRE(now <= clock.now());
+}
+
+TEST_CASE("A clock on a virtual clock only moves with it") {
+    VirtualClock virtualClock;
+    Clock clock(virtualClock);
+    REQUIRE(clock.now() == 0);
+
+    virtualClock.advance(Clock::toNanoseconds(3600.0));
+    REQUIRE(clock.now() == Clock::toNanoseconds(3600.0));
+    clock.update();
+    REQUIRE(clock.getElapsedNanoseconds() == Clock::toNanoseconds(3600.0));
+
+    // Time points of the virtual clock are never the unknown time.
+    REQUIRE(virtualClock.now() != std::chrono::steady_clock::time_point());
+    REQUIRE(clock.toTime(virtualClock.now()) == clock.now());
 }
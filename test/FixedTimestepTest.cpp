@@ -0,0 +1,59 @@
+#include "FixedTimestep.h"
+#include "Clock.h"
+
+#include <catch.hpp>
+
+namespace {
+
+// 100 ticks per second, i.e. 10 ms per tick.
+const int64_t TickDuration = 10000000;
+
+uint32_t takeTicks(FixedTimestep& timestep) {
+    uint32_t count = 0;
+    while (timestep.takeTick()) {
+        count++;
+    }
+    return count;
+}
+
+}
+
+TEST_CASE("the accumulated time is cut into whole ticks", "[FixedTimestep]") {
+    FixedTimestep timestep(100, 5);
+    REQUIRE(timestep.getTickDuration() == TickDuration);
+    REQUIRE(timestep.getTickSeconds() == Approx(0.01f));
+
+    timestep.advance(TickDuration / 2);
+    REQUIRE(takeTicks(timestep) == 0);
+    REQUIRE(timestep.getAlpha() == Approx(0.5f));
+    REQUIRE(timestep.getTimeUntilNextTick() == TickDuration / 2);
+
+    timestep.advance(TickDuration * 2);
+    REQUIRE(takeTicks(timestep) == 2);
+    REQUIRE(timestep.getTick() == 2);
+    REQUIRE(timestep.getAlpha() == Approx(0.5f));
+}
+
+TEST_CASE("irregular frames yield one tick per tick duration", "[FixedTimestep]") {
+    FixedTimestep timestep(100, 5);
+    const int64_t frames[] = {3000000, 17000000, 9000000, 1000000, 12000000, 8000000};
+    uint32_t ticks = 0;
+    for (int i = 0; i < 50; i++) {
+        for (auto frame : frames) {
+            timestep.advance(frame);
+            ticks += takeTicks(timestep);
+        }
+    }
+    // 50 rounds of 50 ms.
+    REQUIRE(ticks == 250);
+    REQUIRE(timestep.getTick() == 250);
+    REQUIRE(timestep.getDroppedTicks() == 0);
+}
+
+TEST_CASE("a long stall is not caught up beyond the limit", "[FixedTimestep]") {
+    FixedTimestep timestep(100, 4);
+    timestep.advance(Clock::toNanoseconds(2.0) + TickDuration / 4);
+    REQUIRE(takeTicks(timestep) == 4);
+    REQUIRE(timestep.getDroppedTicks() == 196);
+    REQUIRE(timestep.getAlpha() == Approx(0.25f));
+}
@@ -0,0 +1,46 @@
+#include "FramePacer.h"
+#include "Clock.h"
+
+#include <catch.hpp>
+
+TEST_CASE("a wait never returns before its deadline", "[FramePacer]") {
+    Clock clock;
+    FramePacer pacer;
+    auto deadline = clock.now();
+    for (int i = 0; i < 20; i++) {
+        deadline += 2000000;
+        const auto overshoot = pacer.waitUntil(clock, deadline);
+        REQUIRE(overshoot >= 0);
+        REQUIRE(clock.now() >= deadline);
+    }
+    REQUIRE(pacer.getWaitCount() == 20);
+    REQUIRE(pacer.getMaxOvershoot() >= pacer.getMeanOvershoot());
+    REQUIRE(pacer.getSpinThreshold() >= 100000);
+    REQUIRE(pacer.getSpinThreshold() <= 4000000);
+
+    pacer.resetStatistics();
+    REQUIRE(pacer.getWaitCount() == 0);
+    REQUIRE(pacer.getMeanOvershoot() == 0);
+}
+
+TEST_CASE("a passed deadline is reported as overshoot", "[FramePacer]") {
+    Clock clock;
+    FramePacer pacer;
+    const auto start = clock.now();
+    const auto overshoot = pacer.waitUntil(clock, start - 3000000);
+    REQUIRE(overshoot >= 3000000);
+    REQUIRE(pacer.getMaxOvershoot() == overshoot);
+}
+
+TEST_CASE("a pacer without spinning sleeps until the deadline", "[FramePacer]") {
+    Clock clock;
+    FramePacer pacer;
+    pacer.setSpinning(false);
+    auto deadline = clock.now();
+    for (int i = 0; i < 5; i++) {
+        deadline += 2000000;
+        REQUIRE(pacer.waitUntil(clock, deadline) >= 0);
+        REQUIRE(clock.now() >= deadline);
+    }
+    REQUIRE(pacer.getWaitCount() == 5);
+}
@@ -0,0 +1,94 @@
+#include "GameObjectPool.h"
+#include "Vector2d.h"
+
+#include <catch.hpp>
+
+#include <set>
+#include <vector>
+
+namespace {
+
+class DummyObject : public GameObject {
+public:
+    DummyObject(int value, int& instances)
+    : value_(value)
+    , instances_(instances) {
+        instances_++;
+    }
+
+    ~DummyObject() {
+        instances_--;
+    }
+
+    DummyObject(const DummyObject&) = delete;
+
+    DummyObject& operator =(const DummyObject&) = delete;
+
+    void update(float) override {}
+    void draw(Renderer&, float) override {}
+    void write(Packet*) override {}
+    void read(Packet*) override {}
+    Vector2d getPosition() const override { return Vector2d(0, 0); }
+    unsigned int getWidth() const override { return 1; }
+    unsigned int getHeight() const override { return 1; }
+    uint32_t getClassId() const override { return 42; }
+
+    int getValue() const {
+        return value_;
+    }
+
+private:
+    int value_;
+    int& instances_;
+};
+
+}
+
+TEST_CASE("objects are constructed in and returned to the pool", "[GameObjectPool]") {
+    int instances = 0;
+    GameObjectPool<DummyObject> pool(4);
+    {
+        auto object = pool.create(7, instances);
+        REQUIRE(object->getValue() == 7);
+        REQUIRE(instances == 1);
+        REQUIRE(pool.getCount() == 1);
+        REQUIRE(pool.getCapacity() == 4);
+    }
+    REQUIRE(instances == 0);
+    REQUIRE(pool.getCount() == 0);
+}
+
+TEST_CASE("released storage is reused without growing the pool", "[GameObjectPool]") {
+    int instances = 0;
+    GameObjectPool<DummyObject> pool(4);
+    pool.reserve(8);
+    REQUIRE(pool.getCapacity() == 8);
+
+    std::set<GameObject*> addresses;
+    for (int round = 0; round < 100; round++) {
+        std::vector<GameObjectPtr> objects;
+        for (int i = 0; i < 8; i++) {
+            objects.push_back(pool.create(i, instances));
+            addresses.insert(objects.back().get());
+        }
+        REQUIRE(pool.getCount() == 8);
+    }
+    REQUIRE(addresses.size() == 8);
+    REQUIRE(pool.getCapacity() == 8);
+    REQUIRE(instances == 0);
+}
+
+TEST_CASE("a pooled object can be owned as a GameObjectPtr", "[GameObjectPool]") {
+    int instances = 0;
+    GameObjectPool<DummyObject> pool;
+    GameObjectPtr gameObject = pool.create(3, instances);
+    REQUIRE(gameObject->getClassId() == 42);
+    gameObject.reset();
+    REQUIRE(instances == 0);
+    REQUIRE(pool.getCount() == 0);
+
+    GameObjectPtr heapObject(new DummyObject(4, instances));
+    REQUIRE(instances == 1);
+    heapObject.reset();
+    REQUIRE(instances == 0);
+}
@@ -0,0 +1,61 @@
+#include "Game.h"
+#include "Clock.h"
+#include "VirtualClock.h"
+#include "Renderer.h"
+
+#include <catch.hpp>
+
+namespace {
+
+// 100 ticks per second, i.e. 10 ms per tick.
+const int64_t TickDuration = 10000000;
+
+// Counts the ticks and remembers the alpha of the last frame.
+class RecordingGame : public Game {
+public:
+    explicit RecordingGame(Renderer& renderer)
+    : Game(100, renderer)
+    , ticks(0)
+    , alpha(-1.0f) {
+    }
+
+    uint32_t ticks;
+    float alpha;
+
+private:
+    void update(const Clock&) override {
+        ticks++;
+    }
+
+    void render(float frameAlpha) override {
+        alpha = frameAlpha;
+    }
+
+    void handleEvent(SDL_Event&, int64_t, bool&) override {
+    }
+};
+
+}
+
+TEST_CASE("a paced frame draws the tick it just simulated", "[Game]") {
+    VirtualClock virtualClock;
+    Clock clock(virtualClock);
+    Renderer renderer(64, 64);
+    RecordingGame game(renderer);
+
+    // As in run(), every frame ends a little after the next tick is due.
+    for (uint32_t i = 1; i <= 3; i++) {
+        virtualClock.advance(TickDuration + TickDuration / 100);
+        clock.update();
+        game.stepPaced(clock);
+        REQUIRE(game.ticks == i);
+        REQUIRE(game.alpha == 1.0f);
+    }
+
+    // A frame of its own length draws between the last two ticks.
+    virtualClock.advance(TickDuration / 2);
+    clock.update();
+    game.step(clock);
+    REQUIRE(game.ticks == 3);
+    REQUIRE(game.alpha == Approx(0.53f));
+}
@@ -0,0 +1,61 @@
+#include "HandleAllocator.h"
+
+#include <catch.hpp>
+
+#include <set>
+
+TEST_CASE("handles are unique and never invalid", "[HandleAllocator]") {
+    HandleAllocator allocator;
+    std::set<uint32_t> handles;
+    for (int i = 0; i < 100; i++) {
+        const auto handle = allocator.allocate();
+        REQUIRE(handle != HandleAllocator::InvalidHandle);
+        REQUIRE(allocator.isValid(handle));
+        handles.insert(handle);
+    }
+    REQUIRE(handles.size() == 100);
+    REQUIRE(allocator.getCount() == 100);
+}
+
+TEST_CASE("a released slot is reused with a new generation", "[HandleAllocator]") {
+    HandleAllocator allocator;
+    const auto a = allocator.allocate();
+    const auto b = allocator.allocate();
+
+    allocator.release(a);
+    REQUIRE_FALSE(allocator.isValid(a));
+    REQUIRE(allocator.isValid(b));
+    REQUIRE(allocator.getCount() == 1);
+
+    const auto c = allocator.allocate();
+    REQUIRE(c != a);
+    REQUIRE(HandleAllocator::getIndex(c) == HandleAllocator::getIndex(a));
+    REQUIRE(HandleAllocator::getGeneration(c) == HandleAllocator::getGeneration(a) + 1);
+    REQUIRE(allocator.isValid(c));
+    REQUIRE_FALSE(allocator.isValid(a));
+}
+
+TEST_CASE("releasing a stale handle has no effect", "[HandleAllocator]") {
+    HandleAllocator allocator;
+    const auto a = allocator.allocate();
+    allocator.release(a);
+    const auto b = allocator.allocate();
+
+    allocator.release(a);
+    REQUIRE(allocator.isValid(b));
+    REQUIRE(allocator.getCount() == 1);
+}
+
+TEST_CASE("the handle space stays bounded by the peak number of live handles", "[HandleAllocator]") {
+    HandleAllocator allocator;
+    for (int i = 0; i < 10000; i++) {
+        const auto a = allocator.allocate();
+        const auto b = allocator.allocate();
+        REQUIRE(HandleAllocator::getIndex(a) < 2);
+        REQUIRE(HandleAllocator::getIndex(b) < 2);
+        REQUIRE(a != HandleAllocator::InvalidHandle);
+        allocator.release(b);
+        allocator.release(a);
+    }
+    REQUIRE(allocator.getCount() == 0);
+}
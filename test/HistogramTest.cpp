@@ -0,0 +1,68 @@
+#include "Histogram.h"
+
+#include <catch.hpp>
+
+TEST_CASE("percentiles are the upper edges of the buckets", "[Histogram]") {
+    Histogram histogram(10, 10);
+    REQUIRE(histogram.getPercentile(0.5) == 0);
+
+    for (int64_t value = 0; value < 100; value++) {
+        histogram.add(value);
+    }
+    REQUIRE(histogram.getCount() == 100);
+    REQUIRE(histogram.getMean() == 49);
+    REQUIRE(histogram.getMax() == 99);
+    REQUIRE(histogram.getPercentile(0.5) == 50);
+    REQUIRE(histogram.getPercentile(0.95) == 99);
+    REQUIRE(histogram.getPercentile(0.05) == 10);
+}
+
+TEST_CASE("values beyond the range end up in the last bucket", "[Histogram]") {
+    Histogram histogram(10, 4);
+    histogram.add(5);
+    histogram.add(-3);
+    histogram.add(1000);
+    REQUIRE(histogram.getMax() == 1000);
+    REQUIRE(histogram.getPercentile(0.5) == 10);
+    REQUIRE(histogram.getPercentile(1.0) == 40);
+
+    histogram.clear();
+    REQUIRE(histogram.getCount() == 0);
+    REQUIRE(histogram.getMax() == 0);
+}
+
+TEST_CASE("decaying halves the weight of the old values", "[Histogram]") {
+    Histogram histogram(10, 10);
+    for (int i = 0; i < 4; i++) {
+        histogram.add(15);
+    }
+    histogram.decay();
+    REQUIRE(histogram.getCount() == 2);
+    REQUIRE(histogram.getMean() == 15);
+
+    for (int i = 0; i < 4; i++) {
+        histogram.add(75);
+    }
+    REQUIRE(histogram.getPercentile(0.5) == 75);
+    REQUIRE(histogram.getPercentile(0.3) == 20);
+
+    histogram.decay();
+    histogram.decay();
+    histogram.decay();
+    REQUIRE(histogram.getCount() == 0);
+}
+
+TEST_CASE("a single outlier fades instead of vanishing", "[Histogram]") {
+    Histogram histogram(10, 10);
+    for (int i = 0; i < 99; i++) {
+        histogram.add(15);
+    }
+    histogram.add(95);
+    histogram.decay();
+    REQUIRE(histogram.getCount() == 50);
+    REQUIRE(histogram.getPercentile(1.0) == 95);
+
+    // Afterwards it weighs half as much as a new one.
+    histogram.add(15);
+    REQUIRE(histogram.getPercentile(0.99) == 20);
+}
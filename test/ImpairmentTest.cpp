@@ -0,0 +1,110 @@
+#include "Impairment.h"
+#include "Clock.h"
+
+#include <catch.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const int64_t Millisecond = 1000000;
+
+std::vector<int64_t> sendPackets(ImpairmentModel& model, int count, int64_t interval, uint32_t size) {
+    std::vector<int64_t> releaseTimes;
+    int64_t times[ImpairmentModel::MaxCopies];
+    for (int i = 0; i < count; i++) {
+        const auto copies = model.apply(i * interval, size, times);
+        releaseTimes.insert(releaseTimes.end(), times, times + copies);
+    }
+    return releaseTimes;
+}
+
+}
+
+TEST_CASE("the settings are parsed from a list", "[Impairment]") {
+    const auto impairment = parseImpairment("latency=50,jitter=5,loss=0.01,burst-enter=0.02,burst-exit=0.25,burst-loss=0.5,duplicate=0.001,reorder=0.1,reorder-delay=20,bandwidth=800,queue=30000,seed=7");
+    REQUIRE(impairment.latency == Approx(0.05f));
+    REQUIRE(impairment.jitter == Approx(0.005f));
+    REQUIRE(impairment.loss == Approx(0.01f));
+    REQUIRE(impairment.burstEnter == Approx(0.02f));
+    REQUIRE(impairment.burstExit == Approx(0.25f));
+    REQUIRE(impairment.burstLoss == Approx(0.5f));
+    REQUIRE(impairment.duplication == Approx(0.001f));
+    REQUIRE(impairment.reordering == Approx(0.1f));
+    REQUIRE(impairment.reorderDelay == Approx(0.02f));
+    REQUIRE(impairment.bandwidth == 100000);
+    REQUIRE(impairment.queueSize == 30000);
+    REQUIRE(impairment.seed == 7);
+    REQUIRE(!impairment.isNone());
+
+    REQUIRE(parseImpairment("").isNone());
+    REQUIRE_THROWS_AS(parseImpairment("latency"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseImpairment("loss=2"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseImpairment("speed=1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(parseImpairment("jitter=abc"), std::invalid_argument);
+}
+
+TEST_CASE("the same seed yields the same fate for each packet", "[Impairment]") {
+    const auto impairment = parseImpairment("latency=30,jitter=10,loss=0.1,duplicate=0.05,seed=42");
+    ImpairmentModel first(impairment), second(impairment);
+    const auto releaseTimes = sendPackets(first, 1000, Millisecond, 100);
+    REQUIRE(releaseTimes == sendPackets(second, 1000, Millisecond, 100));
+    REQUIRE(first.getLostCount() > 50);
+    REQUIRE(first.getLostCount() < 150);
+    REQUIRE(first.getDuplicatedCount() > 20);
+    REQUIRE(releaseTimes.size() == 1000 - first.getLostCount() + first.getDuplicatedCount());
+}
+
+TEST_CASE("losses come in bursts in the bad state", "[Impairment]") {
+    Impairment impairment;
+    impairment.burstEnter = 0.01f;
+    impairment.burstExit = 0.2f;
+    impairment.burstLoss = 1.0f;
+    impairment.seed = 3;
+    ImpairmentModel model(impairment);
+
+    int64_t times[ImpairmentModel::MaxCopies];
+    int bursts = 0, lost = 0;
+    bool previousLost = false;
+    for (int i = 0; i < 100000; i++) {
+        const auto isLost = model.apply(0, 100, times) == 0;
+        if (isLost) {
+            lost++;
+            bursts += previousLost ? 0 : 1;
+        }
+        previousLost = isLost;
+    }
+    // The bad state lasts 1 / 0.2 = 5 packets on average, and is entered
+    // 1 / (1 / 0.01 + 5) of the time.
+    REQUIRE(static_cast<double>(lost) / bursts == Approx(5.0).epsilon(0.1));
+    REQUIRE(lost / 100000.0 == Approx(5.0 / 105.0).epsilon(0.1));
+}
+
+TEST_CASE("a bandwidth limit spaces packets and drops them when the queue is full", "[Impairment]") {
+    Impairment impairment;
+    impairment.latency = 0.01f;
+    impairment.bandwidth = 100000;
+    impairment.queueSize = 3000;
+    ImpairmentModel model(impairment);
+
+    // 1000 bytes take 10 ms on the link.
+    const auto releaseTimes = sendPackets(model, 10, 0, 1000);
+    REQUIRE(releaseTimes.size() == 3);
+    REQUIRE(releaseTimes[0] == 20 * Millisecond);
+    REQUIRE(releaseTimes[1] == 30 * Millisecond);
+    REQUIRE(releaseTimes[2] == 40 * Millisecond);
+    REQUIRE(model.getDroppedCount() == 7);
+}
+
+TEST_CASE("reordered packets are held back", "[Impairment]") {
+    Impairment impairment;
+    impairment.latency = 0.01f;
+    impairment.reordering = 1.0f;
+    impairment.reorderDelay = 0.02f;
+    ImpairmentModel model(impairment);
+    int64_t times[ImpairmentModel::MaxCopies];
+    REQUIRE(model.apply(Millisecond, 100, times) == 1);
+    REQUIRE(times[0] == 31 * Millisecond);
+    REQUIRE(model.getReorderedCount() == 1);
+}
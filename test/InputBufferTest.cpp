@@ -0,0 +1,116 @@
+#include "InputBuffer.h"
+#include "Move.h"
+
+#include <catch.hpp>
+
+#include <vector>
+
+namespace {
+
+const float MoveInterval = 1.0f / 30.0f;
+const float FrameDuration = 1.0f / 60.0f;
+
+Move makeMove(int index) {
+    return Move(InputState{}, static_cast<uint32_t>(index), MoveInterval);
+}
+
+}
+
+TEST_CASE("moves that arrive in a clump are played back one at a time", "[InputBuffer]") {
+    InputBuffer buffer;
+    for (int i = 1; i <= 4; i++) {
+        buffer.addMove(makeMove(i));
+    }
+    REQUIRE(buffer.getDepth() == Approx(4 * MoveInterval));
+
+    std::vector<uint32_t> consumed;
+    for (int frame = 0; frame < 4; frame++) {
+        buffer.consume(FrameDuration, [&consumed] (const Move& move) {
+            consumed.push_back(move.getTick());
+        });
+    }
+    REQUIRE(consumed.size() == 2);
+    REQUIRE(consumed[0] == makeMove(1).getTick());
+    REQUIRE(consumed[1] == makeMove(2).getTick());
+    REQUIRE(buffer.getDepth() == Approx(2 * MoveInterval));
+}
+
+TEST_CASE("duplicate moves are ignored", "[InputBuffer]") {
+    InputBuffer buffer;
+    buffer.addMove(makeMove(1));
+    buffer.addMove(makeMove(2));
+    buffer.addMove(makeMove(1));
+    buffer.addMove(makeMove(2));
+    REQUIRE(buffer.getDepth() == Approx(2 * MoveInterval));
+}
+
+TEST_CASE("a deep buffer is drained to bound the latency", "[InputBuffer]") {
+    InputBuffer buffer;
+    for (int i = 1; i <= 30; i++) {
+        buffer.addMove(makeMove(i));
+    }
+    int count = 0;
+    buffer.consume(FrameDuration, [&count] (const Move&) { count++; });
+    REQUIRE(count > 20);
+    REQUIRE(buffer.getDepth() <= 0.2f);
+}
+
+TEST_CASE("a starving client is asked to speed up, a flooding one to slow down", "[InputBuffer]") {
+    InputBuffer starving, flooding;
+    int nextStarving = 1, nextFlooding = 1;
+    for (int frame = 0; frame < 120; frame++) {
+        // Both clients sample 30 moves per second of their clocks, but the
+        // starving one delivers 20 per second and the flooding one 60.
+        if (frame % 3 == 0) {
+            starving.addMove(makeMove(nextStarving++));
+        }
+        flooding.addMove(makeMove(nextFlooding++));
+        starving.consume(FrameDuration, [] (const Move&) {});
+        flooding.consume(FrameDuration, [] (const Move&) {});
+    }
+    REQUIRE(starving.getTimeScale() > 1.0f);
+    REQUIRE(flooding.getTimeScale() < 1.0f);
+    REQUIRE(starving.getTimeScale() <= 1.05f);
+    REQUIRE(flooding.getTimeScale() >= 0.95f);
+}
+
+TEST_CASE("steady input is repeated until moves arrive again", "[InputBuffer]") {
+    InputBuffer buffer;
+    InputState inputState{};
+    inputState.shooting = true;
+    buffer.addMove(Move(inputState, 1, MoveInterval));
+
+    std::vector<Move> consumed;
+    for (int frame = 0; frame < 6; frame++) {
+        buffer.consume(FrameDuration, [&consumed] (const Move& move) {
+            consumed.push_back(move);
+        });
+    }
+    REQUIRE(consumed.size() == 3);
+    REQUIRE(consumed[2].getTick() == 3);
+    REQUIRE(consumed[2].getInputState().shooting);
+    REQUIRE(buffer.getExtrapolatedCount() == 2);
+
+    // The moves of the repeated ticks come too late, the next one is played.
+    buffer.addMove(Move(inputState, 3, MoveInterval));
+    buffer.addMove(Move(inputState, 4, MoveInterval));
+    REQUIRE(buffer.getDepth() == Approx(MoveInterval));
+}
+
+TEST_CASE("a client that sends heartbeats just in time keeps its time scale", "[InputBuffer]") {
+    InputBuffer buffer;
+    uint32_t sentTick = 0;
+    for (int frame = 0; frame < 120; frame++) {
+        // One move per frame, sent every sixth frame one tick ahead.
+        if (frame % 6 == 0) {
+            const auto latestTick = static_cast<uint32_t>(frame + 2);
+            for (auto tick = sentTick + 1; tick <= latestTick; tick++) {
+                buffer.addMove(Move(InputState{}, tick, FrameDuration));
+            }
+            sentTick = latestTick;
+        }
+        buffer.consume(FrameDuration, [] (const Move&) {});
+    }
+    REQUIRE(buffer.getTimeScale() == Approx(1.0f));
+    REQUIRE(buffer.getExtrapolatedCount() == 80);
+}
@@ -0,0 +1,57 @@
+#include "InputHandler.h"
+#include "Move.h"
+
+#include <catch.hpp>
+
+#include <SDL2/SDL.h>
+
+namespace {
+
+const float TickDuration = 1.0f / 60.0f;
+
+}
+
+TEST_CASE("a key press goes into the move of the next tick", "[InputHandler]") {
+    InputHandler inputHandler;
+    inputHandler.update(1, TickDuration);
+    REQUIRE(inputHandler.getAndClearPendingMove()->getInputState().desiredForwardAmount == 0.0f);
+
+    inputHandler.handleInput(KeyAction::Down, SDLK_UP, 20000000);
+    inputHandler.update(2, TickDuration);
+    const auto move = inputHandler.getAndClearPendingMove();
+    REQUIRE(move->getTick() == 2);
+    REQUIRE(move->getInputState().desiredForwardAmount == 1.0f);
+    REQUIRE(inputHandler.getAndClearPendingMove() == nullptr);
+}
+
+TEST_CASE("the latency from a change to its transmission is measured once", "[InputHandler]") {
+    InputHandler inputHandler;
+    inputHandler.handleInput(KeyAction::Down, SDLK_LEFT, 10000000);
+    // A key repeat does not count as another change.
+    inputHandler.handleInput(KeyAction::Down, SDLK_LEFT, 12000000);
+    inputHandler.update(1, TickDuration);
+    inputHandler.update(2, TickDuration);
+
+    inputHandler.handleMovesSent(2, 25000000);
+    inputHandler.handleMovesSent(2, 40000000);
+
+    const auto& latency = inputHandler.getInputLatency();
+    REQUIRE(latency.getCount() == 1);
+    REQUIRE(latency.getMax() == 15000000);
+}
+
+TEST_CASE("a whole input state counts as a change only if it differs", "[InputHandler]") {
+    InputHandler inputHandler;
+    InputState inputState;
+    inputState.shooting = true;
+    inputHandler.setInputState(inputState, 10000000);
+    inputHandler.update(1, TickDuration);
+    REQUIRE(inputHandler.getAndClearPendingMove()->getInputState().shooting);
+    REQUIRE(inputHandler.hasUnsentChanges());
+    inputHandler.handleMovesSent(1, 20000000);
+
+    inputHandler.setInputState(inputState, 30000000);
+    inputHandler.update(2, TickDuration);
+    REQUIRE_FALSE(inputHandler.hasUnsentChanges());
+    REQUIRE(inputHandler.getInputLatency().getCount() == 1);
+}
@@ -0,0 +1,67 @@
+#include "InterpolationBuffer.h"
+#include "Clock.h"
+
+#include <catch.hpp>
+
+namespace {
+
+int64_t seconds(double value) {
+    return Clock::toNanoseconds(value);
+}
+
+BodyState makeState(float x, float velocity) {
+    return BodyState(Vector2d(x, 0), Vector2d(velocity, 0), Vector2d(0, -1), 0.0f, false);
+}
+
+}
+
+TEST_CASE("an empty buffer cannot be sampled", "[InterpolationBuffer]") {
+    InterpolationBuffer buffer(4);
+    BodyState state;
+    REQUIRE(!buffer.sample(seconds(1.0), 0.1f, state));
+}
+
+TEST_CASE("states between two snapshots are interpolated", "[InterpolationBuffer]") {
+    InterpolationBuffer buffer(4);
+    buffer.add(seconds(1.0), makeState(0, 10));
+    buffer.add(seconds(2.0), makeState(10, 10));
+    buffer.add(seconds(3.0), makeState(30, 10));
+
+    BodyState state;
+    REQUIRE(buffer.sample(seconds(1.5), 0.1f, state));
+    REQUIRE(state.position.getX() == Approx(5.0f));
+    REQUIRE(buffer.sample(seconds(2.5), 0.1f, state));
+    REQUIRE(state.position.getX() == Approx(20.0f));
+    REQUIRE(buffer.sample(seconds(0.5), 0.1f, state));
+    REQUIRE(state.position.getX() == 0.0f);
+}
+
+TEST_CASE("extrapolation past the newest snapshot is bounded", "[InterpolationBuffer]") {
+    InterpolationBuffer buffer(4);
+    buffer.add(seconds(1.0), makeState(0, 10));
+
+    BodyState state;
+    REQUIRE(buffer.sample(seconds(1.05), 0.1f, state));
+    REQUIRE(state.position.getX() == Approx(0.5f));
+    REQUIRE(buffer.sample(seconds(5.0), 0.1f, state));
+    REQUIRE(state.position.getX() == Approx(1.0f));
+}
+
+TEST_CASE("old and reordered snapshots are dropped", "[InterpolationBuffer]") {
+    InterpolationBuffer buffer(2);
+    buffer.add(seconds(1.0), makeState(0, 0));
+    buffer.add(seconds(2.0), makeState(10, 0));
+    buffer.add(seconds(1.5), makeState(100, 0));
+    REQUIRE(buffer.getCount() == 2);
+
+    BodyState state;
+    REQUIRE(buffer.sample(seconds(1.5), 0.1f, state));
+    REQUIRE(state.position.getX() == Approx(5.0f));
+
+    buffer.add(seconds(3.0), makeState(20, 0));
+    REQUIRE(buffer.getCount() == 2);
+    REQUIRE(buffer.sample(seconds(1.5), 0.1f, state));
+    REQUIRE(state.position.getX() == 10.0f);
+    REQUIRE(buffer.sample(seconds(2.5), 0.1f, state));
+    REQUIRE(state.position.getX() == Approx(15.0f));
+}
@@ -0,0 +1,119 @@
+#include "Kinematics.h"
+
+#include <catch.hpp>
+
+TEST_CASE("a new body is at rest at its initial position", "[Kinematics]") {
+    Kinematics kinematics;
+    const auto body = kinematics.create(Kinematics::Kind::Ship, Vector2d(10, 20));
+    REQUIRE(kinematics.getPosition(body) == Vector2d(10, 20));
+    REQUIRE(kinematics.getVelocity(body) == Vector2d(0, 0));
+    REQUIRE(kinematics.getLookAt(body) == Vector2d(0, -1));
+    REQUIRE(kinematics.getAngle(body) == 0.0f);
+    REQUIRE_FALSE(kinematics.getThrust(body));
+    REQUIRE(kinematics.getCount(Kinematics::Kind::Ship) == 1);
+    REQUIRE(kinematics.getCount(Kinematics::Kind::Bolt) == 0);
+}
+
+TEST_CASE("destroying a body keeps the other bodies addressable", "[Kinematics]") {
+    Kinematics kinematics;
+    const auto a = kinematics.create(Kinematics::Kind::Bolt, Vector2d(1, 1));
+    const auto b = kinematics.create(Kinematics::Kind::Bolt, Vector2d(2, 2));
+    const auto c = kinematics.create(Kinematics::Kind::Bolt, Vector2d(3, 3));
+
+    kinematics.destroy(a);
+    REQUIRE(kinematics.getCount(Kinematics::Kind::Bolt) == 2);
+    REQUIRE(kinematics.getPosition(b) == Vector2d(2, 2));
+    REQUIRE(kinematics.getPosition(c) == Vector2d(3, 3));
+
+    const auto d = kinematics.create(Kinematics::Kind::Ship, Vector2d(4, 4));
+    REQUIRE(d == a);
+    REQUIRE(kinematics.getPosition(d) == Vector2d(4, 4));
+    REQUIRE(kinematics.getPosition(c) == Vector2d(3, 3));
+}
+
+TEST_CASE("bolts move with constant velocity", "[Kinematics]") {
+    Kinematics kinematics;
+    const auto body = kinematics.create(Kinematics::Kind::Bolt, Vector2d(0, 0));
+    kinematics.setVelocity(body, Vector2d(10, -20));
+
+    kinematics.integrate(0.5f);
+    REQUIRE(kinematics.getPosition(body) == Vector2d(5, -10));
+
+    kinematics.integrate(body, 0.5f);
+    REQUIRE(kinematics.getPosition(body) == Vector2d(10, -20));
+}
+
+TEST_CASE("ships are integrated like a single Vector2d based ship", "[Kinematics]") {
+    Kinematics kinematics;
+    const auto body = kinematics.create(Kinematics::Kind::Ship, Vector2d(100, 100));
+    kinematics.setAngle(body, 2.0f);
+    kinematics.setThrust(body, true);
+
+    float angle = 2.0f;
+    Vector2d position(100, 100), velocity(0, 0), lookat(0, -1);
+    const float elapsed = 1.0f / 60.0f;
+    for (int i = 0; i < 120; ++i) {
+        angle *= 0.99f;
+        lookat.rotate(angle * elapsed);
+        velocity *= 0.99f;
+        if (velocity.length() < 0.8f) {
+            velocity.reset();
+        }
+        velocity += (elapsed * (50.0f * lookat));
+        position += (elapsed * velocity);
+
+        kinematics.integrate(elapsed);
+    }
+
+    REQUIRE(kinematics.getAngle(body) == Approx(angle));
+    REQUIRE(kinematics.getLookAt(body).getX() == Approx(lookat.getX()));
+    REQUIRE(kinematics.getLookAt(body).getY() == Approx(lookat.getY()));
+    REQUIRE(kinematics.getVelocity(body).getX() == Approx(velocity.getX()));
+    REQUIRE(kinematics.getVelocity(body).getY() == Approx(velocity.getY()));
+    REQUIRE(kinematics.getPosition(body).getX() == Approx(position.getX()));
+    REQUIRE(kinematics.getPosition(body).getY() == Approx(position.getY()));
+}
+
+TEST_CASE("integrating a single body leaves the others untouched", "[Kinematics]") {
+    Kinematics kinematics;
+    const auto a = kinematics.create(Kinematics::Kind::Bolt, Vector2d(0, 0));
+    const auto b = kinematics.create(Kinematics::Kind::Bolt, Vector2d(0, 0));
+    kinematics.setVelocity(a, Vector2d(1, 0));
+    kinematics.setVelocity(b, Vector2d(1, 0));
+
+    kinematics.integrate(b, 1.0f);
+    REQUIRE(kinematics.getPosition(a) == Vector2d(0, 0));
+    REQUIRE(kinematics.getPosition(b) == Vector2d(1, 0));
+}
+
+TEST_CASE("ships slow down by the elapsed time, not by the number of steps", "[Kinematics]") {
+    Kinematics kinematics;
+    const auto slow = kinematics.create(Kinematics::Kind::Ship, Vector2d(0, 0));
+    const auto fast = kinematics.create(Kinematics::Kind::Ship, Vector2d(0, 0));
+    kinematics.setVelocity(slow, Vector2d(100, 0));
+    kinematics.setVelocity(fast, Vector2d(100, 0));
+
+    for (int i = 0; i < 30; ++i) {
+        kinematics.integrate(slow, 1.0f / 30.0f);
+    }
+    for (int i = 0; i < 120; ++i) {
+        kinematics.integrate(fast, 1.0f / 120.0f);
+    }
+
+    REQUIRE(kinematics.getVelocity(slow).getX() == Approx(100.0f * 0.5472f).epsilon(0.001f));
+    REQUIRE(kinematics.getVelocity(fast).getX() == Approx(kinematics.getVelocity(slow).getX()).epsilon(0.001f));
+}
+
+TEST_CASE("the position is blended between the last two integrations", "[Kinematics]") {
+    Kinematics kinematics;
+    const auto body = kinematics.create(Kinematics::Kind::Bolt, Vector2d(0, 0));
+    kinematics.setVelocity(body, Vector2d(10, 0));
+
+    kinematics.integrate(1.0f);
+    REQUIRE(kinematics.getPosition(body, 0.0f) == Vector2d(0, 0));
+    REQUIRE(kinematics.getPosition(body, 0.5f) == Vector2d(5, 0));
+    REQUIRE(kinematics.getPosition(body, 1.0f) == Vector2d(10, 0));
+
+    kinematics.setPosition(body, Vector2d(50, 50));
+    REQUIRE(kinematics.getPosition(body, 0.5f) == Vector2d(50, 50));
+}
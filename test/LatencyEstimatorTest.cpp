@@ -0,0 +1,66 @@
+#include "LatencyEstimator.h"
+
+#include <catch.hpp>
+
+TEST_CASE("the first sample initializes the smoothed round trip time", "[LatencyEstimator]") {
+    LatencyEstimator estimator(10);
+    REQUIRE(estimator.getSmoothedRTT() == 0.0f);
+
+    estimator.addRTT(0.1f);
+    REQUIRE(estimator.getSampleCount() == 1);
+    REQUIRE(estimator.getSmoothedRTT() == Approx(0.1f));
+    REQUIRE(estimator.getRTTVariation() == Approx(0.05f));
+    REQUIRE(estimator.getTimeout() == Approx(0.3f));
+
+    estimator.addRTT(0.2f);
+    REQUIRE(estimator.getRTTVariation() == Approx(0.0625f));
+    REQUIRE(estimator.getSmoothedRTT() == Approx(0.1125f));
+}
+
+TEST_CASE("a steady round trip time has little variation", "[LatencyEstimator]") {
+    LatencyEstimator estimator(10);
+    for (int i = 0; i < 100; i++) {
+        estimator.addRTT(0.04f);
+    }
+    REQUIRE(estimator.getSmoothedRTT() == Approx(0.04f));
+    REQUIRE(estimator.getRTTVariation() < 0.0001f);
+    REQUIRE(estimator.getMinRTT() == Approx(0.04f));
+    REQUIRE(estimator.getMedianRTT() == Approx(0.04f));
+    REQUIRE(estimator.getP99RTT() == Approx(0.04f));
+}
+
+TEST_CASE("the percentiles show the spikes that the mean hides", "[LatencyEstimator]") {
+    LatencyEstimator estimator(10);
+    for (int i = 0; i < 100; i++) {
+        estimator.addRTT(i % 20 == 0 ? 0.3f : 0.05f);
+    }
+    REQUIRE(estimator.getMedianRTT() == Approx(0.05f).epsilon(0.05));
+    REQUIRE(estimator.getP95RTT() == Approx(0.05f).epsilon(0.05));
+    REQUIRE(estimator.getP99RTT() == Approx(0.3f).epsilon(0.01));
+}
+
+TEST_CASE("rare spikes survive the decay of the percentiles", "[LatencyEstimator]") {
+    LatencyEstimator estimator(10);
+    // Two spikes in 192 samples, the last of which decays the histogram.
+    for (int i = 1; i <= 192; i++) {
+        estimator.addRTT(i % 100 == 50 ? 0.3f : 0.05f);
+    }
+    REQUIRE(estimator.getMedianRTT() == Approx(0.05f).epsilon(0.05));
+    REQUIRE(estimator.getP99RTT() == Approx(0.3f).epsilon(0.01));
+}
+
+TEST_CASE("the minimum follows the latest samples", "[LatencyEstimator]") {
+    LatencyEstimator estimator(4);
+    estimator.addRTT(0.02f);
+    estimator.addRTT(0.05f);
+    REQUIRE(estimator.getMinRTT() == Approx(0.02f));
+    for (int i = 0; i < 4; i++) {
+        estimator.addRTT(0.08f);
+    }
+    REQUIRE(estimator.getMinRTT() == Approx(0.08f));
+
+    // Implausible samples are ignored.
+    estimator.addRTT(-1.0f);
+    estimator.addRTT(100.0f);
+    REQUIRE(estimator.getSampleCount() == 6);
+}
@@ -0,0 +1,87 @@
+#include "LatencyTrace.h"
+#include "Impairment.h"
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const int64_t Millisecond = 1000000;
+
+std::shared_ptr<LatencyTrace> readTrace(const std::string& text) {
+    std::istringstream stream(text);
+    return LatencyTrace::read(stream);
+}
+
+}
+
+TEST_CASE("a trace is read from CSV", "[LatencyTrace]") {
+    const auto trace = readTrace("time_ms,delay_ms\n# a comment\n0,20\n10,25.5\r\n20,lost\n30,-1\n40,30\n");
+    REQUIRE(trace->getSampleCount() == 5);
+    REQUIRE(trace->getDuration() == 40 * Millisecond);
+    REQUIRE(trace->getSample(0).delay == 20 * Millisecond);
+    REQUIRE(trace->getSample(15 * Millisecond).delay == 25500000);
+    REQUIRE(trace->getSample(20 * Millisecond).isLost());
+    REQUIRE(trace->getSample(35 * Millisecond).isLost());
+    REQUIRE(trace->getSample(100 * Millisecond).delay == 30 * Millisecond);
+    // Before the first sample, the first sample is in effect.
+    REQUIRE(trace->getSample(-Millisecond).delay == 20 * Millisecond);
+
+    REQUIRE_THROWS_AS(readTrace(""), std::runtime_error);
+    REQUIRE_THROWS_AS(readTrace("0,20\n10,x\n"), std::runtime_error);
+}
+
+TEST_CASE("a trace survives the binary format", "[LatencyTrace]") {
+    const auto trace = readTrace("0,20\n10,lost\n20.5,40\n");
+    std::stringstream stream;
+    trace->write(stream);
+    REQUIRE(stream.str().size() == 4 + 4 + 3 * 8);
+
+    const auto copy = LatencyTrace::read(stream);
+    REQUIRE(copy->getSampleCount() == 3);
+    REQUIRE(copy->getDuration() == 20500000);
+    REQUIRE(copy->getSample(0).delay == 20 * Millisecond);
+    REQUIRE(copy->getSample(10 * Millisecond).isLost());
+    REQUIRE(copy->getSample(30 * Millisecond).delay == 40 * Millisecond);
+
+    std::stringstream truncated(stream.str().substr(0, 20));
+    REQUIRE_THROWS_AS(LatencyTrace::read(truncated), std::runtime_error);
+
+    // A corrupt count claims far more samples than the file holds.
+    auto corrupt = stream.str();
+    corrupt.replace(4, 4, "\xff\xff\xff\xff");
+    std::stringstream corrupted(corrupt);
+    REQUIRE_THROWS_AS(LatencyTrace::read(corrupted), std::runtime_error);
+}
+
+TEST_CASE("the model replays a trace at its speed and over and over", "[LatencyTrace]") {
+    Impairment impairment;
+    impairment.trace = readTrace("0,10\n100,lost\n200,30\n300,50\n");
+    impairment.traceSpeed = 2.0f;
+    int64_t releaseTimes[ImpairmentModel::MaxCopies];
+
+    SECTION("the last sample holds at the end") {
+        ImpairmentModel model(impairment);
+        const auto start = 1000 * Millisecond;
+        REQUIRE(model.apply(start, 100, releaseTimes) == 1);
+        REQUIRE(releaseTimes[0] == start + 10 * Millisecond);
+        // At double speed, 50 ms are 100 ms of the trace.
+        REQUIRE(model.apply(start + 50 * Millisecond, 100, releaseTimes) == 0);
+        REQUIRE(model.getLostCount() == 1);
+        REQUIRE(model.apply(start + 100 * Millisecond, 100, releaseTimes) == 1);
+        REQUIRE(releaseTimes[0] == start + 130 * Millisecond);
+        REQUIRE(model.apply(start + 1000 * Millisecond, 100, releaseTimes) == 1);
+        REQUIRE(releaseTimes[0] == start + 1050 * Millisecond);
+    }
+
+    SECTION("a looping trace starts over") {
+        impairment.traceLoop = true;
+        ImpairmentModel model(impairment);
+        REQUIRE(model.apply(0, 100, releaseTimes) == 1);
+        REQUIRE(model.apply(150 * Millisecond, 100, releaseTimes) == 1);
+        REQUIRE(releaseTimes[0] == 160 * Millisecond);
+        REQUIRE(model.apply(200 * Millisecond, 100, releaseTimes) == 0);
+    }
+}
@@ -0,0 +1,127 @@
+#include "LoadGenerator.h"
+#include "Protocol.h"
+#include "Packet.h"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace boost::asio::ip;
+
+namespace {
+
+// Answers HELLO, TICK and INPUT like a server without a world.
+class FakeServer {
+public:
+    FakeServer()
+    : ioService_()
+    , socket_(ioService_, udp::endpoint(address_v4::loopback(), 0))
+    , running_(true)
+    , nextPlayerId_(1)
+    , thread_([this] { run(); }) {
+    }
+
+    ~FakeServer() {
+        running_ = false;
+        thread_.join();
+    }
+
+    udp::endpoint getEndpoint() const {
+        return socket_.local_endpoint();
+    }
+
+private:
+    void run() {
+        Packet packet(1500), reply(1500);
+        while (running_) {
+            if (socket_.available() == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            packet.clear();
+            packet.setSize(static_cast<uint32_t>(socket_.receive_from(boost::asio::buffer(packet.getData(), packet.getCapacity()), packet.getEndpoint())));
+            uint32_t magicNumber = 0, playerId = 0, value = 0;
+            unsigned char version = 0, packetType = 0;
+            packet.read(magicNumber);
+            packet.read(version);
+            packet.read(packetType);
+            if (packetType == PROTOCOL_PACKET_TYPE_HELLO) {
+                createWelcomePacket(&reply, nextPlayerId_, nextPlayerId_, packet.getEndpoint());
+                nextPlayerId_++;
+            } else if (packetType == PROTOCOL_PACKET_TYPE_TICK) {
+                packet.read(playerId);
+                packet.read(value);
+                createTockPacket(&reply, value, 1000000, 2000000, packet.getEndpoint());
+            } else if (packetType == PROTOCOL_PACKET_TYPE_INPUT) {
+                packet.read(playerId);
+                packet.read(value);
+                createStatePacket(&reply, packet.getEndpoint());
+                reply.write(value);
+                reply.write(1.0f);
+                reply.write(uint32_t(0));
+                reply.write(uint8_t(0));
+                reply.write(uint8_t(1));
+                reply.write(uint32_t(0));
+            } else {
+                continue;
+            }
+            socket_.send_to(boost::asio::buffer(reply.getData(), reply.getSize()), reply.getEndpoint());
+        }
+    }
+
+    boost::asio::io_service ioService_;
+    udp::socket socket_;
+    std::atomic<bool> running_;
+    uint32_t nextPlayerId_;
+    std::thread thread_;
+};
+
+}
+
+TEST_CASE("input patterns are parsed", "[LoadGenerator]") {
+    REQUIRE(LoadGenerator::parseInputPattern("random").empty());
+    REQUIRE(LoadGenerator::parseInputPattern("idle").size() == 1);
+
+    const auto steps = LoadGenerator::parseInputPattern("ul:1,s:0.2,-:0.5");
+    REQUIRE(steps.size() == 3);
+    REQUIRE(steps[0].keys == (LoadGenerator::KeyUp | LoadGenerator::KeyLeft));
+    REQUIRE(steps[0].duration == Approx(1.0f));
+    REQUIRE(steps[1].keys == LoadGenerator::KeySpace);
+    REQUIRE(steps[2].keys == 0);
+    REQUIRE(steps[2].duration == Approx(0.5f));
+
+    REQUIRE_THROWS_AS(LoadGenerator::parseInputPattern(""), std::invalid_argument);
+    REQUIRE_THROWS_AS(LoadGenerator::parseInputPattern("u"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LoadGenerator::parseInputPattern("x:1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(LoadGenerator::parseInputPattern("u:0"), std::invalid_argument);
+}
+
+TEST_CASE("the clients speak the protocol with the server", "[LoadGenerator]") {
+    FakeServer server;
+    std::atomic<bool> running(true);
+
+    SECTION("clients that stay") {
+        LoadGenerator loadGenerator(server.getEndpoint(), 3, LoadGenerator::parseInputPattern("u:0.05,-:0.05"), 0.0f, 0.0f, 60);
+        loadGenerator.run(running, 0.4f);
+        const auto& statistics = loadGenerator.getStatistics();
+        REQUIRE(loadGenerator.getConnectedCount() == 3);
+        REQUIRE(statistics.connects == 3);
+        REQUIRE(statistics.disconnects == 0);
+        REQUIRE(statistics.inputPackets > 3);
+        REQUIRE(statistics.statePackets > 3);
+        REQUIRE(statistics.stateBytes > statistics.statePackets * 20);
+        REQUIRE(statistics.tockPackets == 3);
+        REQUIRE(loadGenerator.getRoundTripTime().getCount() == 3);
+        REQUIRE(statistics.sendErrors == 0);
+    }
+
+    SECTION("clients that come and go") {
+        LoadGenerator loadGenerator(server.getEndpoint(), 3, {}, 0.1f, 0.0f, 60);
+        loadGenerator.run(running, 0.6f);
+        const auto& statistics = loadGenerator.getStatistics();
+        REQUIRE(statistics.disconnects > 3);
+        REQUIRE(statistics.connects > 3);
+    }
+}
@@ -3,51 +3,60 @@
 
 #include <catch.hpp>
 
+namespace {
+
+const float TickDuration = 1.0f / 60.0f;
+
+}
+
 TEST_CASE("MoveList::addMove(...) returns the latest move") {
     MoveList moveList;
 
-    const auto latestMove = moveList.addMove(InputState{}, 1.0f);
-    REQUIRE(latestMove->getTimeStamp() == 1.0f);
-    REQUIRE(latestMove->getDeltaTime() == 1.0f);
+    const auto latestMove = moveList.addMove(InputState{}, 1, TickDuration);
+    REQUIRE(latestMove->getTick() == 1);
+    REQUIRE(latestMove->getDeltaTime() == TickDuration);
 }
 
-TEST_CASE("MoveList::addMove(...) calculates the correct delta time") {
+TEST_CASE("MoveList::addMove(...) ignores received moves that are not newer than the latest one") {
     MoveList moveList;
 
-    moveList.addMove(InputState{}, 1.0f);
-    REQUIRE(moveList.getLatestMove()->getDeltaTime() == 1.0f);
+    moveList.addMove(Move(InputState{}, 2, TickDuration));
+    moveList.addMove(Move(InputState{}, 1, TickDuration));
+    moveList.addMove(Move(InputState{}, 2, TickDuration));
+    REQUIRE(moveList.getCount() == 1);
 
-    moveList.addMove(InputState{}, 100.0f);
-    REQUIRE(moveList.getLatestMove()->getDeltaTime() == 99.0f);
+    moveList.addMove(Move(InputState{}, 3, TickDuration));
+    REQUIRE(moveList.getCount() == 2);
+    REQUIRE(moveList.getLatestTick() == 3);
 }
 
 TEST_CASE("MoveList::getLatestMove() returns the latest Move object in the MoveList") {
     MoveList moveList;
 
-    moveList.addMove(InputState{}, 1);
-    REQUIRE(moveList.getLatestMove()->getTimeStamp() == 1);
+    moveList.addMove(InputState{}, 1, TickDuration);
+    REQUIRE(moveList.getLatestMove()->getTick() == 1);
 
-    moveList.addMove(InputState{}, 2);
-    REQUIRE(moveList.getLatestMove()->getTimeStamp() == 2);
+    moveList.addMove(InputState{}, 2, TickDuration);
+    REQUIRE(moveList.getLatestMove()->getTick() == 2);
 
-    moveList.addMove(InputState{}, 3);
-    REQUIRE(moveList.getLatestMove()->getTimeStamp() == 3);
+    moveList.addMove(InputState{}, 3, TickDuration);
+    REQUIRE(moveList.getLatestMove()->getTick() == 3);
 
     moveList.removeMovesUntil(2);
-    REQUIRE(moveList.getLatestMove()->getTimeStamp() == 3);
+    REQUIRE(moveList.getLatestMove()->getTick() == 3);
 }
 
 TEST_CASE("MoveList::getCount() returns the correct count of Move instances in the MoveList") {
     MoveList moveList;
     REQUIRE(moveList.getCount() == 0);
 
-    moveList.addMove(InputState{}, 1);
+    moveList.addMove(InputState{}, 1, TickDuration);
     REQUIRE(moveList.getCount() == 1);
 
-    moveList.addMove(InputState{}, 2);
+    moveList.addMove(InputState{}, 2, TickDuration);
     REQUIRE(moveList.getCount() == 2);
 
-    moveList.addMove(InputState{}, 3);
+    moveList.addMove(InputState{}, 3, TickDuration);
     REQUIRE(moveList.getCount() == 3);
 
     moveList.removeMovesUntil(2);
@@ -61,9 +70,9 @@ TEST_CASE("using MoveList::getLatestMove() returns nullptr if the list empty") {
 
 TEST_CASE("MoveList::clear() removes all Move objects from the MoveList") {
     MoveList moveList;
-    moveList.addMove(InputState{}, 1);
-    moveList.addMove(InputState{}, 2);
-    moveList.addMove(InputState{}, 3);
+    moveList.addMove(InputState{}, 1, TickDuration);
+    moveList.addMove(InputState{}, 2, TickDuration);
+    moveList.addMove(InputState{}, 3, TickDuration);
     REQUIRE(moveList.getCount() == 3);
     moveList.clear();
     REQUIRE(moveList.getCount() == 0);
@@ -73,14 +82,40 @@ TEST_CASE("what is written with MoveList::write(...) can be read with MoveList::
     Packet packet(1500);
     MoveList moveList1, moveList2;
 
-    moveList1.addMove(InputState{}, 1);
-    moveList1.addMove(InputState{}, 2);
-    moveList1.addMove(InputState{}, 3);
+    moveList1.addMove(InputState{}, 1, TickDuration);
+    moveList1.addMove(InputState{}, 2, TickDuration);
+    moveList1.addMove(InputState{}, 3, TickDuration);
     REQUIRE(moveList1.getCount() == 3);
     moveList1.write(&packet);
 
     moveList2.read(&packet);
     REQUIRE(moveList2.getCount() == 3);
-    REQUIRE(moveList2.getLatestMove()->getTimeStamp() == 3);
-    REQUIRE(moveList2.getLatestMove()->getDeltaTime() == 1);
+    REQUIRE(moveList2.getLatestMove()->getTick() == 3);
+    REQUIRE(moveList2.getLatestMove()->getDeltaTime() == TickDuration);
+}
+
+TEST_CASE("MoveList::removeMovesUntil(...) removes exactly the acknowledged moves") {
+    MoveList moveList;
+    for (uint32_t i = 1; i <= 5; i++) {
+        moveList.addMove(InputState{}, i * 10, TickDuration);
+    }
+
+    moveList.removeMovesUntil(5);
+    REQUIRE(moveList.getCount() == 5);
+    moveList.removeMovesUntil(25);
+    REQUIRE(moveList.getCount() == 3);
+    REQUIRE(moveList.begin()->getTick() == 30);
+    moveList.removeMovesUntil(50);
+    REQUIRE(moveList.getCount() == 0);
+}
+
+TEST_CASE("MoveList::findFirstMoveAfter(...) returns the first newer move") {
+    MoveList moveList;
+    moveList.addMove(InputState{}, 1, TickDuration);
+    moveList.addMove(InputState{}, 2, TickDuration);
+    moveList.addMove(InputState{}, 3, TickDuration);
+
+    REQUIRE(moveList.findFirstMoveAfter(0)->getTick() == 1);
+    REQUIRE(moveList.findFirstMoveAfter(2)->getTick() == 3);
+    REQUIRE(moveList.findFirstMoveAfter(3) == moveList.end());
 }
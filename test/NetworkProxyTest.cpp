@@ -0,0 +1,76 @@
+#include "NetworkProxy.h"
+
+#include <catch.hpp>
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+
+using namespace boost::asio::ip;
+
+namespace {
+
+const auto Timeout = std::chrono::seconds(2);
+
+bool receive(udp::socket& socket, std::string& data, udp::endpoint& sender) {
+    const auto deadline = std::chrono::steady_clock::now() + Timeout;
+    while (socket.available() == 0) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    char buffer[1500];
+    const auto size = socket.receive_from(boost::asio::buffer(buffer), sender);
+    data.assign(buffer, size);
+    return true;
+}
+
+}
+
+TEST_CASE("the proxy gives each client a flow of its own and delays both directions", "[NetworkProxy]") {
+    boost::asio::io_service ioService;
+    udp::socket server(ioService, udp::endpoint(address_v4::loopback(), 0));
+    udp::socket first(ioService, udp::endpoint(address_v4::loopback(), 0));
+    udp::socket second(ioService, udp::endpoint(address_v4::loopback(), 0));
+
+    const auto upstream = parseImpairment("latency=20");
+    const auto downstream = parseImpairment("latency=10");
+    NetworkProxy proxy(0, server.local_endpoint(), upstream, downstream);
+    const udp::endpoint proxyEndpoint(address_v4::loopback(), proxy.getPort());
+    std::atomic<bool> running(true);
+    std::thread thread([&proxy, &running] { proxy.run(running); });
+
+    const auto start = std::chrono::steady_clock::now();
+    first.send_to(boost::asio::buffer(std::string("first")), proxyEndpoint);
+    second.send_to(boost::asio::buffer(std::string("second")), proxyEndpoint);
+
+    // The server answers each packet to where it came from.
+    std::set<unsigned short> flowPorts;
+    for (int i = 0; i < 2; i++) {
+        std::string data;
+        udp::endpoint sender;
+        REQUIRE(receive(server, data, sender));
+        REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+        flowPorts.insert(sender.port());
+        server.send_to(boost::asio::buffer("re:" + data), sender);
+    }
+    REQUIRE(flowPorts.size() == 2);
+
+    std::string data;
+    udp::endpoint sender;
+    REQUIRE(receive(first, data, sender));
+    REQUIRE(data == "re:first");
+    REQUIRE(sender == proxyEndpoint);
+    REQUIRE(receive(second, data, sender));
+    REQUIRE(data == "re:second");
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(30));
+
+    running = false;
+    thread.join();
+    REQUIRE(proxy.getFlowCount() == 2);
+    REQUIRE(proxy.getStatistics().upstreamPackets == 2);
+    REQUIRE(proxy.getStatistics().downstreamPackets == 2);
+    REQUIRE(proxy.getStatistics().discardedPackets == 0);
+}
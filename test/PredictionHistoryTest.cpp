@@ -0,0 +1,53 @@
+#include "PredictionHistory.h"
+
+#include <catch.hpp>
+
+namespace {
+
+BodyState makeState(float x) {
+    return BodyState{Vector2d(x, 0), Vector2d(), Vector2d(0, -1), 0.0f, false};
+}
+
+}
+
+TEST_CASE("PredictionHistory::findLatestBefore(...) returns the newest earlier checkpoint", "[PredictionHistory]") {
+    PredictionHistory history(8);
+    REQUIRE(history.findLatestBefore(10) == nullptr);
+    REQUIRE(history.getNewest() == nullptr);
+
+    history.add(10, makeState(1));
+    history.add(20, makeState(2));
+    history.add(30, makeState(3));
+
+    REQUIRE(history.findLatestBefore(10) == nullptr);
+    REQUIRE(history.findLatestBefore(25)->tick == 20);
+    REQUIRE(history.findLatestBefore(30)->state.position.getX() == 2.0f);
+    REQUIRE(history.getNewest()->tick == 30);
+}
+
+TEST_CASE("PredictionHistory::removeBefore(...) removes the older checkpoints", "[PredictionHistory]") {
+    PredictionHistory history(8);
+    for (uint32_t i = 1; i <= 5; i++) {
+        history.add(i, makeState(static_cast<float>(i)));
+    }
+
+    history.removeBefore(3);
+    REQUIRE(history.getCount() == 3);
+    REQUIRE(history.findLatestBefore(4)->tick == 3);
+    REQUIRE(history.findLatestBefore(3) == nullptr);
+
+    history.clear();
+    REQUIRE(history.getCount() == 0);
+}
+
+TEST_CASE("PredictionHistory overwrites the oldest checkpoints when full", "[PredictionHistory]") {
+    PredictionHistory history(4);
+    for (uint32_t i = 1; i <= 10; i++) {
+        history.add(i, makeState(static_cast<float>(i)));
+    }
+
+    REQUIRE(history.getCount() == 4);
+    REQUIRE(history.findLatestBefore(7) == nullptr);
+    REQUIRE(history.findLatestBefore(8)->tick == 7);
+    REQUIRE(history.getNewest()->state.position.getX() == 10.0f);
+}
@@ -0,0 +1,25 @@
+#include "Protocol.h"
+#include "Clock.h"
+
+#include <catch.hpp>
+
+TEST_CASE("time stamps survive the wire to the microsecond", "[Protocol]") {
+    const int64_t time = Clock::toNanoseconds(12.5) + 3456789;
+    REQUIRE(fromProtocolTime(toProtocolTime(time), time) == time - 789);
+    REQUIRE(fromProtocolTime(toProtocolTime(time), 0) == time - 789);
+    REQUIRE(fromProtocolTime(toProtocolTime(-time), 0) == -time - 211);
+}
+
+TEST_CASE("time stamps are unwrapped next to the reference", "[Protocol]") {
+    // The wire form wraps about every 71 minutes, but a month of uptime makes no difference.
+    const int64_t month = Clock::toNanoseconds(30.0 * 24.0 * 3600.0);
+    const int64_t time = month + 123456000;
+    REQUIRE(fromProtocolTime(toProtocolTime(time), month) == time);
+    REQUIRE(fromProtocolTime(toProtocolTime(time), time + Clock::toNanoseconds(1800.0)) == time);
+    REQUIRE(fromProtocolTime(toProtocolTime(time), time - Clock::toNanoseconds(1800.0)) == time);
+
+    // Times of a remote clock only need to be consistent with each other.
+    const auto first = fromProtocolTime(toProtocolTime(time), 0);
+    const auto second = fromProtocolTime(toProtocolTime(time + 50000000), first);
+    REQUIRE(second - first == 50000000);
+}
@@ -0,0 +1,41 @@
+#include "Room.h"
+#include "Renderer.h"
+#include "Clock.h"
+#include "BufferedQueue.h"
+#include "Transceiver.h"
+#include "Protocol.h"
+
+#include <catch.hpp>
+
+using namespace boost::asio::ip;
+
+static void receiveHello(Room& room, BufferedQueue& packetPool, const udp::endpoint& sender, const Clock& clock) {
+    auto packet = packetPool.pop();
+    REQUIRE(packet != nullptr);
+    createHelloPacket(packet, sender);
+    room.handlePacket(packet, clock);
+    packetPool.push(packet);
+}
+
+TEST_CASE("a room adds a client for each new endpoint that says HELLO", "[Room]") {
+    BufferedQueue packetPool(64);
+    Transceiver transceiver(packetPool);
+    Renderer renderer(64, 64);
+    Room room(640, 480, 60, 30, 64 * 1024, 1, renderer, packetPool, transceiver);
+    Clock clock;
+
+    REQUIRE(room.getClientCount() == 0);
+
+    const udp::endpoint first(address::from_string("127.0.0.1"), 9);
+    receiveHello(room, packetPool, first, clock);
+    REQUIRE(room.getClientCount() == 1);
+
+    receiveHello(room, packetPool, first, clock);
+    REQUIRE(room.getClientCount() == 1);
+
+    receiveHello(room, packetPool, udp::endpoint(address::from_string("127.0.0.2"), 9), clock);
+    REQUIRE(room.getClientCount() == 2);
+
+    room.update(clock);
+    REQUIRE(room.getClientCount() == 2);
+}
@@ -0,0 +1,122 @@
+#include "ServerWorld.h"
+#include "TaskScheduler.h"
+#include "Vector2d.h"
+
+#include <catch.hpp>
+
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+class Box : public GameObject {
+public:
+    Box(const Vector2d& position, unsigned int size)
+    : position_(position)
+    , size_(size) {
+    }
+
+    void update(float) override {}
+    void draw(Renderer&, float) override {}
+    void write(Packet*) override {}
+    void read(Packet*) override {}
+    Vector2d getPosition() const override { return position_; }
+    unsigned int getWidth() const override { return size_; }
+    unsigned int getHeight() const override { return size_; }
+    uint32_t getClassId() const override { return 2; }
+
+    void moveTo(const Vector2d& position) { position_ = position; }
+
+private:
+    Vector2d position_;
+    unsigned int size_;
+};
+
+using Collision = std::tuple<uint32_t, uint32_t>;
+
+std::vector<Collision> simulate(unsigned int threadCount, std::vector<uint32_t>& removed) {
+    std::vector<Collision> collisions;
+    TaskScheduler scheduler(threadCount);
+    ServerWorld world(1000, 1000,
+        [&collisions] (uint32_t objectId1, const GameObject*, uint32_t objectId2, const GameObject*) {
+            collisions.emplace_back(objectId1, objectId2);
+            return objectId1 % 2 == 0;
+        },
+        [&removed] (uint32_t objectId) {
+            removed.push_back(objectId);
+        });
+    world.setTaskScheduler(&scheduler);
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-50.0f, 1000.0f);
+    for (uint32_t objectId = 1; objectId <= 3000; objectId++) {
+        world.add(objectId, GameObjectPtr(new Box(Vector2d(position(random), position(random)), 10)));
+    }
+    world.update(0.0f);
+    return collisions;
+}
+
+}
+
+TEST_CASE("overlapping boxes are reported once, smaller ID first", "[ServerWorld]") {
+    std::vector<Collision> collisions;
+    ServerWorld world(100, 100,
+        [&collisions] (uint32_t objectId1, const GameObject*, uint32_t objectId2, const GameObject*) {
+            collisions.emplace_back(objectId1, objectId2);
+            return false;
+        },
+        [] (uint32_t) {});
+    world.add(3, GameObjectPtr(new Box(Vector2d(10, 10), 10)));
+    world.add(1, GameObjectPtr(new Box(Vector2d(15, 15), 10)));
+    world.add(2, GameObjectPtr(new Box(Vector2d(20, 10), 10)));
+    world.add(4, GameObjectPtr(new Box(Vector2d(50, 50), 10)));
+    world.update(0.0f);
+
+    REQUIRE(collisions == std::vector<Collision>({ Collision(1, 2), Collision(1, 3) }));
+    REQUIRE(world.getGameObjectCount() == 4);
+}
+
+TEST_CASE("collisions and removals do not depend on the thread count", "[ServerWorld]") {
+    std::vector<uint32_t> removed1, removed4;
+    const auto collisions1 = simulate(1, removed1);
+    const auto collisions4 = simulate(4, removed4);
+
+    REQUIRE(!collisions1.empty());
+    REQUIRE(collisions1 == collisions4);
+    std::sort(removed1.begin(), removed1.end());
+    std::sort(removed4.begin(), removed4.end());
+    REQUIRE(removed1 == removed4);
+}
+
+TEST_CASE("projectiles hit targets where they were when rewound", "[ServerWorld]") {
+    std::vector<Collision> collisions;
+    ServerWorld world(1000, 1000,
+        [&collisions] (uint32_t objectId1, const GameObject*, uint32_t objectId2, const GameObject*) {
+            collisions.emplace_back(objectId1, objectId2);
+            return false;
+        },
+        [] (uint32_t) {});
+
+    auto target = new Box(Vector2d(100, 100), 10);
+    auto shot = new Box(Vector2d(500, 500), 2);
+    WorldHistory history(4096);
+    world.setLagCompensation(&history,
+        [shot] (const GameObject* gameObject) { return gameObject == shot ? 0.2f : 0.0f; },
+        [target] (const GameObject* gameObject) { return gameObject == target; });
+    world.add(1, GameObjectPtr(target));
+    world.add(2, GameObjectPtr(shot));
+
+    // The target stays at (100, 100) for 0.5 s, then jumps to where the shot is.
+    for (int frame = 0; frame < 5; frame++) {
+        world.update(0.1f);
+    }
+    target->moveTo(Vector2d(500, 500));
+    world.update(0.1f);
+    REQUIRE(collisions.empty());
+
+    // The shooter still sees the target at the old spot 0.1 s after the jump.
+    shot->moveTo(Vector2d(100, 100));
+    world.update(0.1f);
+    REQUIRE(collisions == std::vector<Collision>({ Collision(1, 2) }));
+}
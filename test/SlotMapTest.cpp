@@ -0,0 +1,110 @@
+#include "SlotMap.h"
+
+#include <catch.hpp>
+
+#include <map>
+#include <memory>
+#include <random>
+
+TEST_CASE("a new slot map is empty", "[SlotMap]") {
+    SlotMap<int> slotMap;
+    REQUIRE(slotMap.empty());
+    REQUIRE(slotMap.size() == 0);
+    REQUIRE(slotMap.find(0) == nullptr);
+    REQUIRE(slotMap.find(123) == nullptr);
+}
+
+TEST_CASE("values can be found by their key", "[SlotMap]") {
+    HandleAllocator handles;
+    SlotMap<int> slotMap;
+    const auto a = handles.allocate();
+    const auto b = handles.allocate();
+    slotMap.insert(a, 1);
+    slotMap.insert(b, 2);
+
+    REQUIRE(slotMap.size() == 2);
+    REQUIRE(*slotMap.find(a) == 1);
+    REQUIRE(*slotMap.find(b) == 2);
+
+    REQUIRE(slotMap.erase(a));
+    REQUIRE_FALSE(slotMap.erase(a));
+    REQUIRE(slotMap.find(a) == nullptr);
+    REQUIRE(*slotMap.find(b) == 2);
+}
+
+TEST_CASE("a stale key does not find the value of a reused slot", "[SlotMap]") {
+    HandleAllocator handles;
+    SlotMap<int> slotMap;
+    const auto a = handles.allocate();
+    slotMap.insert(a, 1);
+    slotMap.erase(a);
+    handles.release(a);
+
+    const auto b = handles.allocate();
+    slotMap.insert(b, 2);
+    REQUIRE(slotMap.find(a) == nullptr);
+    REQUIRE_FALSE(slotMap.erase(a));
+    REQUIRE(*slotMap.find(b) == 2);
+}
+
+TEST_CASE("inserting a newer generation replaces the value in the slot", "[SlotMap]") {
+    HandleAllocator handles;
+    SlotMap<std::unique_ptr<int>> slotMap;
+    const auto a = handles.allocate();
+    slotMap.insert(a, std::make_unique<int>(1));
+    handles.release(a);
+    const auto b = handles.allocate();
+    slotMap.insert(b, std::make_unique<int>(2));
+
+    REQUIRE(slotMap.size() == 1);
+    REQUIRE(slotMap.find(a) == nullptr);
+    REQUIRE(**slotMap.find(b) == 2);
+}
+
+TEST_CASE("eraseIf keeps the remaining values addressable", "[SlotMap]") {
+    HandleAllocator handles;
+    SlotMap<uint32_t> slotMap;
+    for (uint32_t i = 0; i < 100; i++) {
+        const auto key = handles.allocate();
+        slotMap.insert(key, i);
+    }
+    slotMap.eraseIf([] (uint32_t, uint32_t value) {
+        return value % 3 == 0;
+    });
+
+    REQUIRE(slotMap.size() == 66);
+    uint32_t count = 0;
+    slotMap.forEach([&slotMap, &count] (uint32_t key, uint32_t value) {
+        REQUIRE(value % 3 != 0);
+        REQUIRE(*slotMap.find(key) == value);
+        count++;
+    });
+    REQUIRE(count == 66);
+}
+
+TEST_CASE("random inserts and erases match std::map", "[SlotMap]") {
+    std::mt19937 random(42);
+    HandleAllocator handles;
+    SlotMap<uint32_t> slotMap;
+    std::map<uint32_t, uint32_t> reference;
+
+    for (uint32_t i = 0; i < 10000; i++) {
+        if (reference.empty() || random() % 3 != 0) {
+            const auto key = handles.allocate();
+            slotMap.insert(key, i);
+            reference[key] = i;
+        } else {
+            auto itr = reference.begin();
+            std::advance(itr, random() % reference.size());
+            REQUIRE(slotMap.erase(itr->first));
+            handles.release(itr->first);
+            reference.erase(itr);
+        }
+    }
+
+    REQUIRE(slotMap.size() == reference.size());
+    for (const auto& pair : reference) {
+        REQUIRE(slotMap.find(pair.first) != nullptr);
+        REQUIRE(*slotMap.find(pair.first) == pair.second);
+    }
+}
@@ -0,0 +1,168 @@
+#include "SnapshotEncoder.h"
+#include "BufferedQueue.h"
+#include "Transceiver.h"
+#include "Protocol.h"
+
+#include <catch.hpp>
+
+#include <set>
+
+using namespace boost::asio::ip;
+
+// Adds objects of 28 bytes: the object ID, the class ID and five more values.
+static void addObjects(WorldSnapshot& snapshot, uint32_t count) {
+    Packet object(1500);
+    for (uint32_t i = 1; i <= count; i++) {
+        object.clear();
+        object.write(i);
+        object.write(uint32_t(1));
+        for (uint32_t j = 0; j < 5; j++) {
+            object.write(i * 10 + j);
+        }
+        REQUIRE(snapshot.addObject(object));
+    }
+}
+
+static std::shared_ptr<WorldSnapshot> createSnapshot() {
+    auto snapshot = std::make_shared<WorldSnapshot>();
+    snapshot->time = 3000000000;
+    Packet object(1500);
+    object.write(uint32_t(7));
+    object.write(uint32_t(1));
+    REQUIRE(snapshot->addObject(object));
+    object.clear();
+    object.write(uint32_t(9));
+    object.write(uint32_t(2));
+    REQUIRE(snapshot->addObject(object));
+    return snapshot;
+}
+
+static void readState(Packet& packet, uint32_t& latestInputTick, uint8_t& part, uint8_t& partCount, uint32_t& objectCount) {
+    uint32_t magicNumber = 0;
+    uint8_t version = 0, type = 0;
+    packet.read(magicNumber);
+    packet.read(version);
+    packet.read(type);
+    REQUIRE(magicNumber == PROTOCOL_MAGIC_NUMBER);
+    REQUIRE(type == PROTOCOL_PACKET_TYPE_STATE);
+    packet.read(latestInputTick);
+    float timeScale = 0;
+    packet.read(timeScale);
+    REQUIRE(timeScale > 0.9f);
+    uint32_t time = 0;
+    packet.read(time);
+    REQUIRE(fromProtocolTime(time, 0) == 3000000000);
+    packet.read(part);
+    packet.read(partCount);
+    packet.read(objectCount);
+    REQUIRE(packet.getHead() == PROTOCOL_STATE_HEADER_SIZE);
+}
+
+TEST_CASE("a STATE packet is the snapshot behind the client specific header", "[SnapshotEncoder]") {
+    const auto snapshot = createSnapshot();
+    const StateRecipient recipient{udp::endpoint(address::from_string("127.0.0.2"), 4321), 750, 0.95f};
+
+    Packet packet(1500);
+    REQUIRE(snapshot->parts.size() == 1);
+    SnapshotEncoder::encode(*snapshot, 0, recipient, &packet);
+    REQUIRE(packet.getEndpoint() == recipient.endpoint);
+
+    uint32_t latestInputTick = 0;
+    uint8_t part = 0, partCount = 0;
+    uint32_t objectCount = 0;
+    readState(packet, latestInputTick, part, partCount, objectCount);
+    REQUIRE(latestInputTick == recipient.latestInputTick);
+    REQUIRE(part == 0);
+    REQUIRE(partCount == 1);
+    REQUIRE(objectCount == 2);
+
+    uint32_t values[4] = {};
+    for (auto& value : values) {
+        packet.read(value);
+    }
+    REQUIRE(values[0] == 7);
+    REQUIRE(values[3] == 2);
+    REQUIRE(packet.getHead() == packet.getSize());
+}
+
+TEST_CASE("encoder threads send one STATE packet per recipient", "[SnapshotEncoder]") {
+    boost::asio::io_service io_service;
+    udp::socket receiver(io_service, udp::endpoint(address::from_string("127.0.0.1"), 0));
+    const auto endpoint = receiver.local_endpoint();
+
+    BufferedQueue packetPool(64);
+    Transceiver transceiver(packetPool);
+    SnapshotEncoder encoder(3, packetPool, transceiver);
+    REQUIRE(encoder.getThreadCount() == 3);
+
+    std::vector<StateRecipient> recipients;
+    for (uint32_t i = 0; i < 8; i++) {
+        recipients.push_back(StateRecipient{endpoint, i, 1.0f});
+    }
+    encoder.publish(createSnapshot(), recipients);
+    encoder.flush();
+
+    std::set<uint32_t> latestInputTicks;
+    for (int i = 0; i < 8; i++) {
+        Packet packet(1500);
+        udp::endpoint sender;
+        packet.setSize(static_cast<uint32_t>(receiver.receive_from(boost::asio::buffer(packet.getData(), packet.getCapacity()), sender)));
+        uint32_t latestInputTick = 0;
+        uint8_t part = 0, partCount = 0;
+        uint32_t objectCount = 0;
+        readState(packet, latestInputTick, part, partCount, objectCount);
+        REQUIRE(objectCount == 2);
+        latestInputTicks.insert(latestInputTick);
+    }
+    REQUIRE(latestInputTicks.size() == 8);
+}
+
+TEST_CASE("a world too big for one packet is split into several STATE packets", "[SnapshotEncoder]") {
+    WorldSnapshot snapshot;
+    snapshot.time = 3000000000;
+    addObjects(snapshot, 200);
+    REQUIRE(snapshot.getObjectCount() == 200);
+    const uint32_t perPart = WorldSnapshot::PartCapacity / 28;
+    REQUIRE(snapshot.parts.size() == (200 + perPart - 1) / perPart);
+
+    const StateRecipient recipient{udp::endpoint(address::from_string("127.0.0.2"), 4321), 750, 1.0f};
+    uint32_t nextObjectId = 1;
+    for (uint32_t i = 0; i < snapshot.parts.size(); i++) {
+        Packet packet(PROTOCOL_MAX_PACKET_SIZE);
+        SnapshotEncoder::encode(snapshot, i, recipient, &packet);
+        REQUIRE(packet.getSize() <= PROTOCOL_MAX_PACKET_SIZE);
+
+        uint32_t latestInputTick = 0;
+        uint8_t part = 0, partCount = 0;
+        uint32_t objectCount = 0;
+        readState(packet, latestInputTick, part, partCount, objectCount);
+        REQUIRE(part == i);
+        REQUIRE(partCount == snapshot.parts.size());
+        // The objects follow each other in order, none split across packets.
+        for (uint32_t j = 0; j < objectCount; j++) {
+            uint32_t values[7] = {};
+            for (auto& value : values) {
+                packet.read(value);
+            }
+            REQUIRE(values[0] == nextObjectId);
+            REQUIRE(values[6] == nextObjectId * 10 + 4);
+            nextObjectId++;
+        }
+        REQUIRE(packet.getHead() == packet.getSize());
+    }
+    REQUIRE(nextObjectId == 201);
+}
+
+TEST_CASE("a snapshot leaves out what does not fit into the largest STATE update", "[SnapshotEncoder]") {
+    WorldSnapshot snapshot;
+    const uint32_t perPart = WorldSnapshot::PartCapacity / 28;
+    addObjects(snapshot, perPart * PROTOCOL_MAX_STATE_PARTS);
+    REQUIRE(snapshot.parts.size() == PROTOCOL_MAX_STATE_PARTS);
+
+    Packet object(1500);
+    object.setSize(28);
+    REQUIRE_FALSE(snapshot.addObject(object));
+    object.setSize(WorldSnapshot::PartCapacity + 1);
+    REQUIRE_FALSE(snapshot.addObject(object));
+    REQUIRE(snapshot.getObjectCount() == perPart * PROTOCOL_MAX_STATE_PARTS);
+}
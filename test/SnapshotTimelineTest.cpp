@@ -0,0 +1,93 @@
+#include "SnapshotTimeline.h"
+#include "Clock.h"
+
+#include <catch.hpp>
+
+namespace {
+
+int64_t seconds(double value) {
+    return Clock::toNanoseconds(value);
+}
+
+}
+
+TEST_CASE("the render time trails the latest snapshot by the interpolation delay", "[SnapshotTimeline]") {
+    SnapshotTimeline timeline;
+    // The source clock is 100 s ahead, snapshots take 50 ms and arrive every 100 ms.
+    for (int i = 0; i < 50; i++) {
+        const auto sourceTime = seconds(100.0 + i * 0.1);
+        timeline.addSnapshot(sourceTime, sourceTime - seconds(100.0 - 0.05));
+        timeline.update(sourceTime - seconds(100.0 - 0.05));
+    }
+
+    REQUIRE(timeline.getSnapshotTime() == seconds(104.9));
+    REQUIRE(timeline.getJitter() < 0.0001f);
+    REQUIRE(timeline.getDelay() == Approx(0.1f).epsilon(0.001f));
+    REQUIRE(Clock::toSeconds(timeline.getRenderTime()) == Approx(104.8f).epsilon(0.0001f));
+}
+
+TEST_CASE("the interpolation delay grows with the arrival jitter", "[SnapshotTimeline]") {
+    SnapshotTimeline steady, jittery;
+    int64_t now = 0;
+    for (int i = 0; i < 200; i++) {
+        const auto sourceTime = seconds(i * 0.1);
+        now = sourceTime + seconds(0.05);
+        steady.addSnapshot(sourceTime, now);
+        jittery.addSnapshot(sourceTime, now + (i % 2 == 0 ? 0 : seconds(0.04)));
+        steady.update(now);
+        jittery.update(now);
+    }
+
+    REQUIRE(jittery.getJitter() > 0.02f);
+    REQUIRE(jittery.getDelay() > steady.getDelay() + 0.05f);
+    REQUIRE(jittery.getDelay() <= 0.5f);
+    REQUIRE(jittery.getRenderTime() < steady.getRenderTime());
+}
+
+TEST_CASE("the render time never goes backwards", "[SnapshotTimeline]") {
+    SnapshotTimeline timeline;
+    timeline.addSnapshot(seconds(0.0), seconds(0.1));
+    timeline.addSnapshot(seconds(0.1), seconds(0.2));
+    timeline.update(seconds(0.2));
+    const auto renderTime = timeline.getRenderTime();
+
+    // A very late snapshot makes the delay grow, but only gradually.
+    timeline.addSnapshot(seconds(0.2), seconds(1.0));
+    timeline.update(seconds(0.21));
+    REQUIRE(timeline.getRenderTime() >= renderTime);
+}
+
+TEST_CASE("shifting the arrival clock keeps the render time", "[SnapshotTimeline]") {
+    SnapshotTimeline shifted, unshifted;
+    for (int i = 0; i < 20; i++) {
+        const auto sourceTime = seconds(i * 0.1);
+        if (i == 10) {
+            shifted.shiftArrivalClock(seconds(5.0));
+        }
+        const auto arrival = sourceTime + seconds(0.05);
+        shifted.addSnapshot(sourceTime, arrival + (i >= 10 ? seconds(5.0) : 0));
+        unshifted.addSnapshot(sourceTime, arrival);
+        shifted.update(arrival + (i >= 10 ? seconds(5.0) : 0));
+        unshifted.update(arrival);
+    }
+    REQUIRE(shifted.getRenderTime() == unshifted.getRenderTime());
+    REQUIRE(shifted.getTransitTime() == seconds(5.05));
+}
+
+TEST_CASE("a source that has run for weeks is rendered smoothly", "[SnapshotTimeline]") {
+    SnapshotTimeline timeline;
+    const auto start = seconds(30.0 * 24.0 * 3600.0);
+    int64_t lastRenderTime = 0;
+    for (int i = 0; i < 100; i++) {
+        const auto sourceTime = start + seconds(i * 0.05);
+        timeline.addSnapshot(sourceTime, sourceTime + seconds(0.02));
+        for (int frame = 0; frame < 3; frame++) {
+            timeline.update(sourceTime + seconds(0.02 + frame / 60.0));
+            if (i > 10) {
+                // The render time advances by a frame, not by whole float steps of a month.
+                REQUIRE(Clock::toSeconds(timeline.getRenderTime() - lastRenderTime) == Approx(1.0f / 60.0f).epsilon(0.01f));
+            }
+            lastRenderTime = timeline.getRenderTime();
+        }
+    }
+}
@@ -0,0 +1,59 @@
+#include "SpscRing.h"
+
+#include <catch.hpp>
+
+#include <thread>
+
+TEST_CASE("The capacity of a ring is rounded up to a power of two", "[SpscRing]") {
+    SpscRing<int> ring(5);
+    REQUIRE(ring.getCapacity() == 8);
+    REQUIRE(ring.getCount() == 0);
+}
+
+TEST_CASE("A ring keeps the order and rejects pushes when full", "[SpscRing]") {
+    SpscRing<int> ring(4);
+    int element = 0;
+    REQUIRE(!ring.pop(element));
+
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(ring.push(round * 10 + i));
+        }
+        REQUIRE(!ring.push(99));
+        REQUIRE(ring.getCount() == 4);
+
+        for (int i = 0; i < 4; i++) {
+            REQUIRE(ring.pop(element));
+            REQUIRE(element == round * 10 + i);
+        }
+        REQUIRE(!ring.pop(element));
+    }
+}
+
+TEST_CASE("A producer and a consumer thread share a ring", "[SpscRing]") {
+    const uint32_t count = 100000;
+    SpscRing<uint32_t> ring(64);
+
+    std::thread producer([&ring] {
+        for (uint32_t i = 0; i < count; i++) {
+            while (!ring.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    bool ordered = true;
+    for (uint32_t expected = 0; expected < count;) {
+        uint32_t element = 0;
+        if (ring.pop(element)) {
+            ordered = ordered && element == expected;
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    REQUIRE(ordered);
+    REQUIRE(ring.getCount() == 0);
+}
@@ -0,0 +1,69 @@
+#include "TaskScheduler.h"
+
+#include <catch.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("parallelFor visits every index exactly once", "[TaskScheduler]") {
+    for (const auto threadCount : { 1u, 2u, 4u, 8u }) {
+        TaskScheduler scheduler(threadCount);
+        REQUIRE(scheduler.getThreadCount() == threadCount);
+
+        for (const auto count : { 0u, 1u, 7u, 1000u, 12345u }) {
+            std::vector<std::atomic<int>> visits(count);
+            for (auto& visit : visits) {
+                visit = 0;
+            }
+            // Catch is not thread safe, so the workers only count and the caller checks.
+            std::atomic<int> badChunks(0);
+            scheduler.parallelFor(count, 64, [&visits, &badChunks, count] (uint32_t begin, uint32_t end) {
+                if (begin >= end || end - begin > 64 || end > count) {
+                    badChunks++;
+                    return;
+                }
+                for (auto i = begin; i < end; i++) {
+                    visits[i]++;
+                }
+            });
+            REQUIRE(badChunks == 0);
+            for (const auto& visit : visits) {
+                REQUIRE(visit == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("a scheduler with one thread runs the loop inline", "[TaskScheduler]") {
+    TaskScheduler scheduler(1);
+    const auto caller = std::this_thread::get_id();
+    bool inline_ = true;
+    scheduler.parallelFor(1000, 10, [&] (uint32_t, uint32_t) {
+        inline_ = inline_ && std::this_thread::get_id() == caller;
+    });
+    REQUIRE(inline_);
+}
+
+TEST_CASE("several threads can run loops on the same scheduler", "[TaskScheduler]") {
+    TaskScheduler scheduler(4);
+    std::atomic<uint64_t> sum(0);
+    std::vector<std::thread> callers;
+    for (int c = 0; c < 4; c++) {
+        callers.emplace_back([&scheduler, &sum] {
+            for (int round = 0; round < 50; round++) {
+                scheduler.parallelFor(1000, 16, [&sum] (uint32_t begin, uint32_t end) {
+                    uint64_t local = 0;
+                    for (auto i = begin; i < end; i++) {
+                        local += i;
+                    }
+                    sum += local;
+                });
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    REQUIRE(sum == 4u * 50u * (999u * 1000u / 2u));
+}
@@ -0,0 +1,65 @@
+#include "TimingWheel.h"
+#include "Packet.h"
+
+#include <catch.hpp>
+
+#include <vector>
+
+namespace {
+
+// Slots of 1 ms, one turn per 8 ms.
+const int64_t Resolution = 1000000;
+const uint32_t SlotCount = 8;
+
+std::vector<Packet*> advance(TimingWheel& timingWheel, int64_t now) {
+    std::vector<Packet*> released;
+    timingWheel.advance(now, [&released] (Packet* packet) { released.push_back(packet); });
+    return released;
+}
+
+}
+
+TEST_CASE("packets are released at their release time", "[TimingWheel]") {
+    Packet a(8), b(8), c(8);
+    TimingWheel timingWheel(Resolution, SlotCount, 4, 0);
+    REQUIRE(timingWheel.getNextReleaseTime() == TimingWheel::NoRelease);
+
+    REQUIRE(timingWheel.schedule(&a, 3500000));
+    REQUIRE(timingWheel.schedule(&b, 1200000));
+    REQUIRE(timingWheel.schedule(&c, 3100000));
+    REQUIRE(timingWheel.getNextReleaseTime() == 1200000);
+
+    REQUIRE(advance(timingWheel, 1100000).empty());
+    REQUIRE(advance(timingWheel, 1200000) == std::vector<Packet*>{&b});
+    REQUIRE(timingWheel.getNextReleaseTime() == 3100000);
+
+    // Within a slot, only what is due is released.
+    REQUIRE(advance(timingWheel, 3200000) == std::vector<Packet*>{&c});
+    REQUIRE(advance(timingWheel, 4000000) == std::vector<Packet*>{&a});
+    REQUIRE(timingWheel.getCount() == 0);
+}
+
+TEST_CASE("packets more than a turn away wait for their turn", "[TimingWheel]") {
+    Packet a(8), b(8);
+    TimingWheel timingWheel(Resolution, SlotCount, 4, 0);
+    timingWheel.schedule(&a, 2500000);
+    timingWheel.schedule(&b, 2500000 + 3 * SlotCount * Resolution);
+    REQUIRE(advance(timingWheel, 3000000) == std::vector<Packet*>{&a});
+    REQUIRE(timingWheel.getNextReleaseTime() == 3000000 + SlotCount * Resolution);
+
+    REQUIRE(advance(timingWheel, 20000000).empty());
+    // A jump over several turns visits every slot once.
+    REQUIRE(advance(timingWheel, 100000000) == std::vector<Packet*>{&b});
+}
+
+TEST_CASE("late packets are released right away and a full wheel refuses more", "[TimingWheel]") {
+    Packet a(8), b(8), c(8);
+    TimingWheel timingWheel(Resolution, SlotCount, 2, 50000000);
+    REQUIRE(timingWheel.schedule(&a, 10000000));
+    REQUIRE(timingWheel.schedule(&b, 50000000));
+    REQUIRE(!timingWheel.schedule(&c, 51000000));
+    REQUIRE(advance(timingWheel, 50000000) == (std::vector<Packet*>{&a, &b}));
+
+    REQUIRE(timingWheel.schedule(&c, 51000000));
+    REQUIRE(advance(timingWheel, 52000000) == std::vector<Packet*>{&c});
+}
@@ -0,0 +1,249 @@
+#include "VirtualNetwork.h"
+#include "VirtualClock.h"
+#include "Clock.h"
+#include "BufferedQueue.h"
+#include "Packet.h"
+#include "Renderer.h"
+#include "GameServer.h"
+#include "GameClient.h"
+#include "GamePeer.h"
+#include "Protocol.h"
+
+#include <catch.hpp>
+
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace boost::asio::ip;
+
+namespace {
+
+const int64_t Millisecond = 1000000;
+
+void send(VirtualNetwork& network, BufferedQueue& packetPool, const udp::endpoint& from, const udp::endpoint& to, uint32_t value) {
+    auto packet = packetPool.pop();
+    REQUIRE(packet != nullptr);
+    packet->clear();
+    packet->write(value);
+    packet->setEndpoint(to);
+    network.send(from, *packet);
+    packetPool.push(packet);
+}
+
+// Sends a packet per millisecond over a lossy link and returns which arrived.
+std::vector<uint32_t> sendOverLossyLink(uint64_t seed) {
+    VirtualClock virtualClock;
+    VirtualNetwork network(virtualClock, seed);
+    network.setDefaultLink(parseImpairment("latency=10,loss=0.3"));
+    BufferedQueue sender(4), receiver(256);
+    const auto from = network.attach(0, sender);
+    const auto to = network.attach(0, receiver);
+    for (uint32_t i = 0; i < 200; i++) {
+        send(network, sender, from, to, i);
+        virtualClock.advance(Millisecond);
+        network.deliver();
+    }
+    virtualClock.advance(20 * Millisecond);
+    network.deliver();
+
+    std::vector<uint32_t> arrived;
+    while (auto packet = receiver.dequeue()) {
+        uint32_t value = 0;
+        packet->read(value);
+        arrived.push_back(value);
+        receiver.push(packet);
+    }
+    return arrived;
+}
+
+// Lets a server play for less than the client timeout with a client that only says HELLO and returns the STATE packets it received.
+std::vector<std::string> playWithSilentClient(uint64_t seed);
+
+// Runs games in lockstep with a virtual clock, each on a clock of its own as in Game::run().
+class Simulation {
+public:
+    Simulation(VirtualClock& virtualClock, VirtualNetwork& network)
+    : virtualClock_(virtualClock)
+    , network_(network)
+    , games_()
+    , clocks_() {
+    }
+
+    void add(Game& game) {
+        games_.push_back(&game);
+        clocks_.push_back(std::make_unique<Clock>(virtualClock_));
+    }
+
+    void run(double seconds, int64_t frameTime) {
+        const auto steps = Clock::toNanoseconds(seconds) / frameTime;
+        for (int64_t i = 0; i < steps; i++) {
+            virtualClock_.advance(frameTime);
+            network_.deliver();
+            for (std::size_t j = 0; j < games_.size(); j++) {
+                clocks_[j]->update();
+                games_[j]->step(*clocks_[j]);
+            }
+        }
+    }
+
+private:
+    VirtualClock& virtualClock_;
+    VirtualNetwork& network_;
+    std::vector<Game*> games_;
+    std::vector<std::unique_ptr<Clock>> clocks_;
+};
+
+std::vector<std::string> playWithSilentClient(uint64_t seed) {
+    VirtualClock virtualClock;
+    VirtualNetwork network(virtualClock, seed);
+    network.setDefaultLink(parseImpairment("latency=10,jitter=2"));
+    const Impairment none;
+
+    Renderer renderer(640, 480);
+    GameServer server(640, 480, 60, 30, none, none, 12345, 1, 0, 64 * 1024, static_cast<uint32_t>(seed), renderer, &network);
+    BufferedQueue client(256);
+    const auto clientEndpoint = network.attach(0, client);
+
+    auto hello = client.pop();
+    REQUIRE(hello != nullptr);
+    createHelloPacket(hello, udp::endpoint(address::from_string("127.0.0.1"), 12345));
+    network.send(clientEndpoint, *hello);
+    client.push(hello);
+
+    Simulation simulation(virtualClock, network);
+    simulation.add(server);
+    simulation.run(0.9, 4 * Millisecond);
+    REQUIRE(server.getClientCount() == 1);
+
+    std::vector<std::string> received;
+    while (auto packet = client.dequeue()) {
+        received.emplace_back(packet->getData(), packet->getSize());
+        client.push(packet);
+    }
+    return received;
+}
+
+}
+
+TEST_CASE("packets arrive over the links of a virtual network when they are due", "[VirtualNetwork]") {
+    VirtualClock virtualClock;
+    VirtualNetwork network(virtualClock, 1);
+    BufferedQueue first(4), second(4);
+    const auto firstEndpoint = network.attach(0, first);
+    const auto secondEndpoint = network.attach(2000, second);
+    REQUIRE(firstEndpoint.address() == address_v4::loopback());
+    REQUIRE(secondEndpoint.port() == 2000);
+    REQUIRE(firstEndpoint.port() != 0);
+    REQUIRE_THROWS_AS(network.attach(2000, first), std::runtime_error);
+
+    network.setLink(firstEndpoint, secondEndpoint, parseImpairment("latency=50"));
+    const auto sendTime = virtualClock.getTime();
+    send(network, first, firstEndpoint, secondEndpoint, 42);
+    const auto deliveryTime = network.getNextDeliveryTime();
+    REQUIRE(deliveryTime >= sendTime + 50 * Millisecond - 1000);
+    REQUIRE(deliveryTime <= sendTime + 50 * Millisecond + 1000);
+
+    virtualClock.advance(49 * Millisecond);
+    REQUIRE(network.deliver() == 0);
+    virtualClock.advance(2 * Millisecond);
+    REQUIRE(network.deliver() == 1);
+
+    auto packet = second.dequeue();
+    REQUIRE(packet != nullptr);
+    uint32_t value = 0;
+    packet->read(value);
+    REQUIRE(value == 42);
+    REQUIRE(packet->getEndpoint() == firstEndpoint);
+    // The packet is stamped with the time it arrived, not the time it was delivered.
+    REQUIRE(packet->getReceiveTime() == std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deliveryTime)));
+    second.push(packet);
+
+    // The way back has no latency of its own.
+    send(network, second, secondEndpoint, firstEndpoint, 43);
+    REQUIRE(network.deliver() == 1);
+    REQUIRE(first.dequeue() != nullptr);
+
+    network.detach(secondEndpoint);
+    send(network, first, firstEndpoint, secondEndpoint, 44);
+    virtualClock.advance(51 * Millisecond);
+    REQUIRE(network.deliver() == 0);
+    REQUIRE(network.getStatistics().sentPackets == 3);
+    REQUIRE(network.getStatistics().deliveredPackets == 2);
+    REQUIRE(network.getStatistics().discardedPackets == 1);
+}
+
+TEST_CASE("a virtual network repeats its losses for the same seed", "[VirtualNetwork]") {
+    const auto arrived = sendOverLossyLink(7);
+    REQUIRE(arrived.size() > 100);
+    REQUIRE(arrived.size() < 180);
+    REQUIRE(sendOverLossyLink(7) == arrived);
+    REQUIRE(sendOverLossyLink(8) != arrived);
+}
+
+TEST_CASE("a server and its clients play a minute over a virtual network", "[VirtualNetwork]") {
+    VirtualClock virtualClock;
+    VirtualNetwork network(virtualClock, 1);
+    network.setDefaultLink(parseImpairment("latency=25"));
+    const Impairment none;
+
+    Renderer serverRenderer(640, 480), firstRenderer(640, 480), secondRenderer(640, 480);
+    GameServer server(640, 480, 60, 30, none, none, 12345, 1, 0, 64 * 1024, 1, serverRenderer, &network);
+    GameClient first(60, none, none, "127.0.0.1", 12345, firstRenderer, &network);
+    GameClient second(60, none, none, "127.0.0.1", 12345, secondRenderer, &network);
+
+    Simulation simulation(virtualClock, network);
+    simulation.add(server);
+    simulation.add(first);
+    simulation.add(second);
+    simulation.run(60.0, 4 * Millisecond);
+
+    REQUIRE(server.getClientCount() == 2);
+    REQUIRE(first.getPlayerId() != PROTOCOL_INVALID_PLAYER_ID);
+    REQUIRE(second.getPlayerId() != PROTOCOL_INVALID_PLAYER_ID);
+    REQUIRE(first.getPlayerId() != second.getPlayerId());
+    for (const auto client : { &first, &second }) {
+        const auto& latencyEstimator = client->getLatencyEstimator();
+        REQUIRE(latencyEstimator.getSampleCount() > 50);
+        REQUIRE(latencyEstimator.getMedianRTT() == Approx(0.05f).epsilon(0.1));
+    }
+}
+
+TEST_CASE("a server plays the same game for the same seed", "[VirtualNetwork]") {
+    const auto received = playWithSilentClient(3);
+    REQUIRE(received.size() > 10);
+    REQUIRE(playWithSilentClient(3) == received);
+    REQUIRE(playWithSilentClient(4) != received);
+}
+
+TEST_CASE("peers find each other and start a game over a virtual network", "[VirtualNetwork]") {
+    VirtualClock virtualClock;
+    VirtualNetwork network(virtualClock, 1);
+    network.setDefaultLink(parseImpairment("latency=15,jitter=2"));
+    const Impairment none;
+
+    std::vector<std::unique_ptr<Renderer>> renderers;
+    std::vector<std::unique_ptr<GamePeer>> peers;
+    renderers.push_back(std::make_unique<Renderer>(640, 480));
+    peers.push_back(std::make_unique<GamePeer>(640, 480, 60, 15, none, none, *renderers.back(), 23456, &network));
+    for (uint32_t i = 0; i < PROTOCOL_NUM_PEERS_FOR_GAME; i++) {
+        renderers.push_back(std::make_unique<Renderer>(640, 480));
+        peers.push_back(std::make_unique<GamePeer>(640, 480, 60, 15, none, none, *renderers.back(), "127.0.0.1", 23456, &network));
+    }
+
+    Simulation simulation(virtualClock, network);
+    for (auto& peer : peers) {
+        simulation.add(*peer);
+    }
+    simulation.run(10.0, 4 * Millisecond);
+
+    std::set<uint32_t> playerIds;
+    for (auto& peer : peers) {
+        REQUIRE(peer->getPeerCount() == PROTOCOL_NUM_PEERS_FOR_GAME);
+        playerIds.insert(peer->getPlayerId());
+    }
+    REQUIRE(playerIds.size() == peers.size());
+    REQUIRE(playerIds.count(PROTOCOL_INVALID_PLAYER_ID) == 0);
+}
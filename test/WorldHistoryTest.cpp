@@ -0,0 +1,107 @@
+#include "WorldHistory.h"
+
+#include <catch.hpp>
+
+static const int64_t Second = 1000000000;
+
+TEST_CASE("boxes are interpolated between frames", "[WorldHistory]") {
+    WorldHistory history(4096);
+    history.addFrame(Second);
+    REQUIRE(history.add(1, Aabb(0, 0, 10, 10)));
+    REQUIRE(history.add(2, Aabb(100, 100, 10, 10)));
+    history.addFrame(2 * Second);
+    REQUIRE(history.add(1, Aabb(20, 0, 10, 10)));
+    REQUIRE(history.add(2, Aabb(100, 100, 10, 10)));
+
+    Aabb box;
+    REQUIRE(history.find(1, Second + Second / 2, box));
+    REQUIRE(box.minX == Approx(10.0f));
+    REQUIRE(box.maxX == Approx(20.0f));
+    REQUIRE(box.minY == Approx(0.0f));
+}
+
+TEST_CASE("times outside the history are clamped", "[WorldHistory]") {
+    WorldHistory history(4096);
+    history.addFrame(Second);
+    history.add(1, Aabb(0, 0, 10, 10));
+    history.addFrame(2 * Second);
+    history.add(1, Aabb(20, 0, 10, 10));
+
+    Aabb box;
+    REQUIRE(history.find(1, 0, box));
+    REQUIRE(box.minX == 0.0f);
+    REQUIRE(history.find(1, 3 * Second, box));
+    REQUIRE(box.minX == 20.0f);
+}
+
+TEST_CASE("missing objects are not found", "[WorldHistory]") {
+    WorldHistory history(4096);
+    Aabb box;
+    REQUIRE(!history.find(1, 0, box));
+
+    history.addFrame(Second);
+    history.add(1, Aabb(0, 0, 10, 10));
+    history.add(3, Aabb(0, 0, 10, 10));
+    REQUIRE(!history.find(2, Second, box));
+
+    // An object that exists in one of the two frames is not interpolated.
+    history.addFrame(2 * Second);
+    history.add(2, Aabb(50, 0, 10, 10));
+    REQUIRE(history.find(2, Second + Second / 2, box));
+    REQUIRE(box.minX == 50.0f);
+}
+
+TEST_CASE("the oldest frames are dropped to stay within the budget", "[WorldHistory]") {
+    WorldHistory history(1024);
+    const auto capacity = history.getBoxCapacity();
+    REQUIRE(capacity > 0);
+
+    for (int frame = 0; frame < 100; frame++) {
+        history.addFrame(frame * Second);
+        for (uint32_t objectId = 0; objectId < 4; objectId++) {
+            REQUIRE(history.add(objectId, Aabb(frame, 0, 10, 10)));
+        }
+    }
+
+    REQUIRE(history.getFrameCount() * 4 <= capacity);
+    REQUIRE(history.getFrameCount() >= 2);
+    REQUIRE(history.getOldestTime() == (100 - history.getFrameCount()) * Second);
+
+    Aabb box;
+    REQUIRE(history.find(3, 99 * Second, box));
+    REQUIRE(box.minX == 99.0f);
+    REQUIRE(history.find(3, 0, box));
+    REQUIRE(box.minX == static_cast<float>(history.getOldestTime() / Second));
+}
+
+TEST_CASE("a frame larger than the budget is truncated", "[WorldHistory]") {
+    WorldHistory history(256);
+    history.addFrame(Second);
+    uint32_t added = 0;
+    while (history.add(added, Aabb(0, 0, 10, 10))) {
+        added++;
+    }
+    REQUIRE(added == history.getBoxCapacity());
+    REQUIRE(history.getFrameCount() == 1);
+
+    history.clear();
+    REQUIRE(history.getFrameCount() == 0);
+    Aabb box;
+    REQUIRE(!history.find(0, Second, box));
+}
+
+TEST_CASE("frames keep their times however long the world runs", "[WorldHistory]") {
+    // After a month a float second would have lost a whole frame.
+    const int64_t month = 30 * 24 * 3600 * Second;
+    const int64_t frame = Second / 60;
+    WorldHistory history(4096);
+    history.addFrame(month);
+    history.add(1, Aabb(0, 0, 10, 10));
+    history.addFrame(month + frame);
+    history.add(1, Aabb(20, 0, 10, 10));
+
+    Aabb box;
+    REQUIRE(history.find(1, month + frame / 2, box));
+    REQUIRE(box.minX == Approx(10.0f));
+    REQUIRE(history.getOldestTime() == month);
+}
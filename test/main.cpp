@@ -1,3 +1,11 @@
-#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_RUNNER
+
+#include "Logging.h"
 
 #include <catch.hpp>
+
+int main(int argc, char** argv) {
+    // Code under test logs through the console logger.
+    INIT_LOGGING(LOG_LEVEL_ERROR);
+    return Catch::Session().run(argc, argv);
+}